@@ -58,6 +58,21 @@ typedef enum {
 } ucp_perf_datatype_t;
 
 
+/*
+ * Traffic pattern between the threads of the sender and the threads of the
+ * receiver. In loopback mode every thread is both a sender and a receiver.
+ */
+typedef enum {
+    UCX_PERF_PATTERN_PAIR,        /* Thread i sends to remote thread i */
+    UCX_PERF_PATTERN_INCAST,      /* All threads send to remote thread 0 */
+    UCX_PERF_PATTERN_FANOUT,      /* Thread 0 sends to all remote threads */
+    UCX_PERF_PATTERN_ALL_TO_ALL,  /* Every thread sends to all remote threads */
+    UCX_PERF_PATTERN_PERMUTATION, /* Thread i sends to remote thread p(i), for
+                                     a random permutation p */
+    UCX_PERF_PATTERN_LAST
+} ucx_perf_pattern_t;
+
+
 typedef enum {
     UCT_PERF_DATA_LAYOUT_SHORT,
     UCT_PERF_DATA_LAYOUT_SHORT_IOV,
@@ -89,7 +104,8 @@ enum ucx_perf_test_flags {
     UCX_PERF_TEST_FLAG_ERR_HANDLING     = UCS_BIT(11), /* Create UCP eps with error handling support */
     UCX_PERF_TEST_FLAG_LOOPBACK         = UCS_BIT(12), /* Use loopback connection */
     UCX_PERF_TEST_FLAG_PREREG           = UCS_BIT(13), /* Pass pre-registered memory handle */
-    UCX_PERF_TEST_FLAG_AM_RECV_COPY     = UCS_BIT(14)  /* Do additional memcopy during AM receive */
+    UCX_PERF_TEST_FLAG_AM_RECV_COPY     = UCS_BIT(14), /* Do additional memcopy during AM receive */
+    UCX_PERF_TEST_FLAG_SHARED_WORKER    = UCS_BIT(15)  /* All threads share a single worker */
 };
 
 
@@ -166,6 +182,17 @@ typedef enum {
 typedef uint64_t ucx_perf_counter_t;
 
 
+/*
+ * Distribution of time samples, in seconds.
+ */
+typedef struct ucx_perf_dist {
+    double                  median;
+    double                  p99;
+    double                  p999;
+    double                  max;
+} ucx_perf_dist_t;
+
+
 /*
  * Performance test result.
  *
@@ -182,6 +209,17 @@ typedef struct ucx_perf_result {
         double              total_average;  /* Average of the whole test */
     }
     latency, bandwidth, msgrate;
+
+    /* Latency distribution over the last sampled iterations */
+    ucx_perf_dist_t         latency_dist;
+
+    /* Time messages spent queued on the way to the receiver, above the lowest
+     * observed one-way delay. Measured only with a traffic pattern. */
+    ucx_perf_dist_t         queue_delay;
+
+    /* Results of each thread in a multi-threaded test, NULL otherwise */
+    unsigned                num_threads;
+    const struct ucx_perf_result *thread_results;
 } ucx_perf_result_t;
 
 
@@ -299,6 +337,8 @@ typedef struct ucx_perf_params {
                                                     used to offload communication */
         struct sockaddr_storage dmn_remote_addr; /* IP and port of remote daemon,
                                                     used to offload communication */
+        ucx_perf_pattern_t      pattern;         /* Traffic pattern between
+                                                    threads */
     } ucp;
 
 } ucx_perf_params_t;
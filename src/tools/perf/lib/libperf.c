@@ -23,6 +23,7 @@
 #include <tools/perf/lib/libperf_int.h>
 #include <uct/api/v2/uct_v2.h>
 
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -219,6 +220,7 @@ void ucx_perf_test_prepare_new_run(ucx_perf_context_t *perf,
     perf->prev.bytes        = 0;
     perf->prev.iters        = 0;
     perf->timing_queue_head = 0;
+    perf->queue_delay_count = 0;
     perf->extra_info[0]     = '\0';
 
     for (i = 0; i < TIMING_QUEUE_SIZE; ++i) {
@@ -227,18 +229,161 @@ void ucx_perf_test_prepare_new_run(ucx_perf_context_t *perf,
     ucx_perf_test_start_clock(perf);
 }
 
-void ucx_perf_calc_result(ucx_perf_context_t *perf, ucx_perf_result_t *result)
+static int ucx_perf_time_compare(const void *elem1, const void *elem2)
 {
-    ucs_time_t percentile;
-    double factor;
+    ucs_time_t t1 = *(const ucs_time_t*)elem1;
+    ucs_time_t t2 = *(const ucs_time_t*)elem2;
 
+    return (t1 > t2) - (t1 < t2);
+}
+
+static double ucx_perf_sorted_percentile(const ucs_time_t *sorted, size_t count,
+                                         double rank, double factor)
+{
+    return ucs_time_to_sec(sorted[(size_t)((count - 1) * (rank / 100.0))]) /
+           factor;
+}
+
+double ucx_perf_latency_factor(const ucx_perf_context_t *perf)
+{
     if ((perf->params.test_type == UCX_PERF_TEST_TYPE_PINGPONG) ||
         (perf->params.test_type == UCX_PERF_TEST_TYPE_PINGPONG_WAIT_MEM)) {
-        factor = 2.0;
-    } else {
-        factor = 1.0;
+        return 2.0;
+    }
+
+    return 1.0;
+}
+
+/* Sorts the samples in place */
+void ucx_perf_calc_dist(ucs_time_t *samples, size_t count, double factor,
+                        ucx_perf_dist_t *dist)
+{
+    if (count == 0) {
+        memset(dist, 0, sizeof(*dist));
+        return;
+    }
+
+    qsort(samples, count, sizeof(*samples), ucx_perf_time_compare);
+
+    dist->median = ucx_perf_sorted_percentile(samples, count, 50.0, factor);
+    dist->p99    = ucx_perf_sorted_percentile(samples, count, 99.0, factor);
+    dist->p999   = ucx_perf_sorted_percentile(samples, count, 99.9, factor);
+    dist->max    = ucs_time_to_sec(samples[count - 1]) / factor;
+}
+
+void ucx_perf_exchange_queue_delay(ucx_perf_context_t *perf,
+                                   ucx_perf_result_t *result)
+{
+    unsigned group_size = rte_call(perf, group_size);
+    struct {
+        uint64_t        count;
+        ucx_perf_dist_t dist;
+    } local, remote;
+    struct iovec vec;
+    void *req = NULL;
+    unsigned i;
+
+    if (perf->params.ucp.pattern == UCX_PERF_PATTERN_PAIR) {
+        return;
     }
 
+    /* Only the receiver measures the queueing delay, so share it with the
+     * side which reports the results */
+    local.count  = perf->queue_delay_count;
+    local.dist   = result->queue_delay;
+    vec.iov_base = &local;
+    vec.iov_len  = sizeof(local);
+
+    rte_call(perf, post_vec, &vec, 1, &req);
+    rte_call(perf, exchange_vec, req);
+
+    for (i = 0; i < group_size; ++i) {
+        remote.count = 0;
+        rte_call(perf, recv, i, &remote, sizeof(remote), req);
+        if (remote.count == 0) {
+            continue;
+        }
+
+        result->queue_delay.median = ucs_max(result->queue_delay.median,
+                                             remote.dist.median);
+        result->queue_delay.p99    = ucs_max(result->queue_delay.p99,
+                                             remote.dist.p99);
+        result->queue_delay.p999   = ucs_max(result->queue_delay.p999,
+                                             remote.dist.p999);
+        result->queue_delay.max    = ucs_max(result->queue_delay.max,
+                                             remote.dist.max);
+    }
+}
+
+void ucx_perf_pattern_peers(const ucx_perf_params_t *params,
+                            unsigned thread_index, unsigned *dsts,
+                            unsigned *num_dsts, unsigned *num_srcs)
+{
+    unsigned thread_count = params->thread_count;
+    unsigned *perm        = ucs_alloca(thread_count * sizeof(*perm));
+    unsigned seed         = thread_count;
+    unsigned i, j, tmp;
+
+    *num_dsts = 0;
+    *num_srcs = 0;
+
+    switch (params->ucp.pattern) {
+    case UCX_PERF_PATTERN_INCAST:
+        dsts[(*num_dsts)++] = 0;
+        *num_srcs           = (thread_index == 0) ? thread_count : 0;
+        break;
+    case UCX_PERF_PATTERN_FANOUT:
+        if (thread_index == 0) {
+            for (i = 0; i < thread_count; ++i) {
+                dsts[(*num_dsts)++] = i;
+            }
+        }
+        *num_srcs = 1;
+        break;
+    case UCX_PERF_PATTERN_ALL_TO_ALL:
+        /* Start from a different peer on every thread to spread the load */
+        for (i = 0; i < thread_count; ++i) {
+            dsts[(*num_dsts)++] = (thread_index + i) % thread_count;
+        }
+        *num_srcs = thread_count;
+        break;
+    case UCX_PERF_PATTERN_PERMUTATION:
+        /* Both sides must generate the same permutation, so the seed depends
+         * only on the test parameters */
+        for (i = 0; i < thread_count; ++i) {
+            perm[i] = i;
+        }
+        for (i = thread_count - 1; i > 0; --i) {
+            j       = rand_r(&seed) % (i + 1);
+            tmp     = perm[i];
+            perm[i] = perm[j];
+            perm[j] = tmp;
+        }
+        dsts[(*num_dsts)++] = perm[thread_index];
+        *num_srcs           = 1;
+        break;
+    case UCX_PERF_PATTERN_PAIR:
+    default:
+        dsts[(*num_dsts)++] = thread_index;
+        *num_srcs           = 1;
+        break;
+    }
+}
+
+void ucx_perf_calc_result(ucx_perf_context_t *perf, ucx_perf_result_t *result)
+{
+    double factor = ucx_perf_latency_factor(perf);
+    ucs_time_t percentile;
+
+    if (perf->current.iters == 0) {
+        /* A thread which has no peers in the traffic pattern */
+        memset(result, 0, sizeof(*result));
+        return;
+    }
+
+    result->num_threads    = 0;
+    result->thread_results = NULL;
+
     result->iters = perf->current.iters;
     result->bytes = perf->current.bytes;
     result->elapsed_time = perf->current.time_acc - perf->start_time_acc;
@@ -249,6 +394,12 @@ void ucx_perf_calc_result(ucx_perf_context_t *perf, ucx_perf_result_t *result)
                                                 perf->params.percentile_rank);
     result->latency.percentile = ucs_time_to_sec(percentile) / factor;
 
+    ucx_perf_calc_dist(perf->timing_queue,
+                       ucs_min(TIMING_QUEUE_SIZE, perf->current.iters), factor,
+                       &result->latency_dist);
+    ucx_perf_calc_dist(perf->queue_delay_samples, perf->queue_delay_count, 1.0,
+                       &result->queue_delay);
+
     result->latency.moment_average =
         (perf->current.time_acc - perf->prev.time_acc)
         / (perf->current.iters - perf->prev.iters)
@@ -329,6 +480,53 @@ static ucs_status_t ucx_perf_test_check_params(ucx_perf_params_t *params)
         }
     }
 
+    if (params->flags & UCX_PERF_TEST_FLAG_SHARED_WORKER) {
+        if ((params->api != UCX_PERF_API_UCP) ||
+            (params->thread_mode != UCS_THREAD_MODE_MULTI)) {
+            if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                ucs_error("Shared worker requires UCP test in multi thread "
+                          "mode (-M multi)");
+            }
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        /* AM handlers are per worker, and a wildcard tag would let a thread
+         * receive messages of another thread */
+        if ((params->command == UCX_PERF_CMD_AM) ||
+            (params->flags & UCX_PERF_TEST_FLAG_TAG_WILDCARD)) {
+            if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                ucs_error("Shared worker is not supported with active "
+                          "messages or wildcard tag");
+            }
+            return UCS_ERR_UNSUPPORTED;
+        }
+    }
+
+    if (params->ucp.pattern != UCX_PERF_PATTERN_PAIR) {
+        if ((params->api != UCX_PERF_API_UCP) ||
+            (params->test_type != UCX_PERF_TEST_TYPE_STREAM_UNI) ||
+            ((params->command != UCX_PERF_CMD_TAG) &&
+             (params->command != UCX_PERF_CMD_TAG_SYNC))) {
+            if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                ucs_error("Traffic patterns are supported only by UCP tag "
+                          "bandwidth tests");
+            }
+            return UCS_ERR_UNSUPPORTED;
+        }
+
+        /* Receivers wait for the number of messages the senders are going to
+         * send, so the test must be limited by iterations */
+        if ((params->max_time != 0.0) || params->ucp.is_daemon_mode ||
+            (params->flags & (UCX_PERF_TEST_FLAG_TAG_WILDCARD |
+                              UCX_PERF_TEST_FLAG_TAG_UNEXP_PROBE))) {
+            if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                ucs_error("Traffic patterns are not supported with time "
+                          "limit, daemon, wildcard tag or tag probe");
+            }
+            return UCS_ERR_UNSUPPORTED;
+        }
+    }
+
     if (params->send_mem_type == UCS_MEMORY_TYPE_RDMA) {
         ucs_error(
                 "Memory type 'rdma' is not supported as a sending memory type, "
@@ -1002,6 +1200,43 @@ static void ucp_perf_test_destroy_self_eps(ucx_perf_context_t *perf)
     ucp_perf_release_requests_in_progress(perf, reqs, num_in_prog);
 }
 
+static void ucp_perf_test_destroy_peer_eps(ucx_perf_context_t *perf)
+{
+    unsigned thread_count  = perf->params.thread_count;
+    unsigned num_in_prog   = 0;
+    ucs_status_ptr_t *reqs = ucs_alloca(thread_count * thread_count *
+                                        sizeof(*reqs));
+    ucp_ep_h *peer_eps;
+    ucs_status_ptr_t req;
+    unsigned i, j;
+
+    for (i = 0; i < thread_count; ++i) {
+        peer_eps = perf->ucp.tctx[i].perf.ucp.peer_eps;
+        if (peer_eps == NULL) {
+            continue;
+        }
+
+        /* The endpoint to the paired thread is destroyed with the others */
+        for (j = 0; j < thread_count; ++j) {
+            if (j == i) {
+                continue;
+            }
+
+            req = ucp_perf_test_destroy_ep(peer_eps[j], i);
+            if (req != NULL) {
+                reqs[num_in_prog++] = req;
+            }
+        }
+    }
+
+    ucp_perf_release_requests_in_progress(perf, reqs, num_in_prog);
+
+    for (i = 0; i < thread_count; ++i) {
+        free(perf->ucp.tctx[i].perf.ucp.peer_eps);
+        perf->ucp.tctx[i].perf.ucp.peer_eps = NULL;
+    }
+}
+
 static void ucp_perf_test_destroy_eps(ucx_perf_context_t *perf)
 {
     unsigned thread_count  = perf->params.thread_count;
@@ -1010,6 +1245,8 @@ static void ucp_perf_test_destroy_eps(ucx_perf_context_t *perf)
     ucs_status_ptr_t req;
     unsigned i;
 
+    ucp_perf_test_destroy_peer_eps(perf);
+
     for (i = 0; i < thread_count; ++i) {
         ucp_perf_test_rkey_destroy(perf->ucp.tctx[i].perf.ucp.rkey);
 
@@ -1130,15 +1367,59 @@ static void ucp_perf_test_init_endpoints(ucx_perf_context_t *perf)
         perf->ucp.tctx[i].perf.ucp.self_ep        = NULL;
         perf->ucp.tctx[i].perf.ucp.self_send_rkey = NULL;
         perf->ucp.tctx[i].perf.ucp.self_recv_rkey = NULL;
+        perf->ucp.tctx[i].perf.ucp.peer_eps       = NULL;
     }
 }
 
+/* Connect every local thread to every remote thread, for traffic patterns
+ * other than the pairwise one */
+static ucs_status_t
+ucp_perf_test_create_peer_eps(ucx_perf_context_t *perf,
+                              const ucp_ep_params_t *base_params,
+                              ucp_address_t **addresses)
+{
+    unsigned thread_count = perf->params.thread_count;
+    ucp_ep_params_t ep_params;
+    ucx_perf_context_t *thread_perf;
+    ucs_status_t status;
+    unsigned i, j;
+
+    for (i = 0; i < thread_count; ++i) {
+        thread_perf               = &perf->ucp.tctx[i].perf;
+        thread_perf->ucp.peer_eps = calloc(thread_count,
+                                           sizeof(*thread_perf->ucp.peer_eps));
+        if (thread_perf->ucp.peer_eps == NULL) {
+            ucs_error("failed to allocate peer endpoints array");
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        for (j = 0; j < thread_count; ++j) {
+            if (j == i) {
+                thread_perf->ucp.peer_eps[j] = thread_perf->ucp.ep;
+                continue;
+            }
+
+            ep_params         = *base_params;
+            ep_params.address = addresses[j];
+            status = UCX_PERF_VERBOSE(error, &perf->params, ucp_ep_create,
+                                      thread_perf->ucp.worker, &ep_params,
+                                      &thread_perf->ucp.peer_eps[j]);
+            if (status != UCS_OK) {
+                return status;
+            }
+        }
+    }
+
+    return UCS_OK;
+}
+
 static ucs_status_t ucp_perf_test_receive_remote_data(ucx_perf_context_t *perf,
                                                       unsigned peer_index)
 {
     unsigned thread_count = perf->params.thread_count;
     void *rkey_buffer     = NULL;
     void *req             = NULL;
+    ucp_address_t **addresses = ucs_alloca(thread_count * sizeof(*addresses));
     ucx_perf_ep_info_t *remote_info;
     ucp_ep_params_t ep_params;
     ucp_address_t *address;
@@ -1168,6 +1449,7 @@ static ucs_status_t ucp_perf_test_receive_remote_data(ucx_perf_context_t *perf,
         rkey_buffer                            = UCS_PTR_BYTE_OFFSET(address,
                                                                      remote_info->ucp.worker_addr_len);
         perf->ucp.tctx[i].perf.ucp.remote_addr = remote_info->recv_buffer;
+        addresses[i]                           = address;
 
         ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
         ep_params.address    = address;
@@ -1197,6 +1479,13 @@ static ucs_status_t ucp_perf_test_receive_remote_data(ucx_perf_context_t *perf,
                                           remote_info->ucp.total_wireup_len);
     }
 
+    if (perf->params.ucp.pattern != UCX_PERF_PATTERN_PAIR) {
+        status = ucp_perf_test_create_peer_eps(perf, &ep_params, addresses);
+        if (status != UCS_OK) {
+            goto err_free_eps_buffer;
+        }
+    }
+
     free(buffer);
     return UCS_OK;
 
@@ -1663,6 +1952,10 @@ ucp_perf_test_destroy_workers(ucx_perf_context_t *perf, unsigned count)
 {
     unsigned i;
 
+    if (perf->params.flags & UCX_PERF_TEST_FLAG_SHARED_WORKER) {
+        count = ucs_min(count, 1);
+    }
+
     for (i = 0; i < count; i++) {
         ucp_worker_destroy(perf->ucp.tctx[i].perf.ucp.worker);
     }
@@ -2074,15 +2367,26 @@ static ucs_status_t ucp_perf_setup(ucx_perf_context_t *perf)
     worker_params.field_mask  = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
     worker_params.thread_mode = perf->params.thread_mode;
 
+    perf->ucp.thread_index = 0;
+
     for (i = 0; i < thread_count; i++) {
-        perf->ucp.tctx[i].tid              = i;
-        perf->ucp.tctx[i].perf             = *perf;
+        perf->ucp.tctx[i].tid                   = i;
+        perf->ucp.tctx[i].perf                  = *perf;
+        perf->ucp.tctx[i].perf.ucp.thread_index = i;
         /* Doctor the src and dst buffers to make them thread specific */
         perf->ucp.tctx[i].perf.send_buffer =
                         UCS_PTR_BYTE_OFFSET(perf->send_buffer, i * message_size);
         perf->ucp.tctx[i].perf.recv_buffer =
                         UCS_PTR_BYTE_OFFSET(perf->recv_buffer, i * message_size);
 
+        if ((i > 0) &&
+            (perf->params.flags & UCX_PERF_TEST_FLAG_SHARED_WORKER)) {
+            /* Every thread has its own endpoints on the shared worker */
+            perf->ucp.tctx[i].perf.ucp.worker =
+                    perf->ucp.tctx[0].perf.ucp.worker;
+            continue;
+        }
+
         status = ucp_worker_create(perf->ucp.context, &worker_params,
                                    &perf->ucp.tctx[i].perf.ucp.worker);
         if (status != UCS_OK) {
@@ -2232,6 +2536,7 @@ ucs_status_t ucx_perf_run(const ucx_perf_params_t *params,
             perf->ucp.self_ep        = perf->ucp.tctx[0].perf.ucp.self_ep;
             perf->ucp.self_send_rkey = perf->ucp.tctx[0].perf.ucp.self_send_rkey;
             perf->ucp.self_recv_rkey = perf->ucp.tctx[0].perf.ucp.self_recv_rkey;
+            perf->ucp.peer_eps       = perf->ucp.tctx[0].perf.ucp.peer_eps;
         }
 
         status = ucx_perf_do_warmup(perf, params);
@@ -2244,6 +2549,7 @@ ucs_status_t ucx_perf_run(const ucx_perf_params_t *params,
         ucx_perf_funcs[params->api].barrier(perf);
         if (status == UCS_OK) {
             ucx_perf_calc_result(perf, result);
+            ucx_perf_exchange_queue_delay(perf, result);
             perf->params.report_func(perf->params.rte_group, result,
                                      perf->params.report_arg, perf->extra_info,
                                      1, 0);
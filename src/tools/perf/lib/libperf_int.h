@@ -100,6 +100,10 @@ struct ucx_perf_context {
     ucs_time_t                   timing_queue[TIMING_QUEUE_SIZE];
     unsigned                     timing_queue_head;
 
+    /* Receiver queueing delay samples, filled by traffic pattern tests */
+    ucs_time_t                   queue_delay_samples[TIMING_QUEUE_SIZE];
+    unsigned                     queue_delay_count;
+
     const ucx_perf_allocator_t   *send_allocator;
     const ucx_perf_allocator_t   *recv_allocator;
 
@@ -136,6 +140,10 @@ struct ucx_perf_context {
             ucp_ep_h                   self_ep;
             ucp_rkey_h                 self_send_rkey;
             ucp_rkey_h                 self_recv_rkey;
+            unsigned                   thread_index;
+            ucp_ep_h                   *peer_eps; /* Endpoints to all remote
+                                                     threads, for traffic
+                                                     patterns */
         } ucp;
     };
 };
@@ -174,6 +182,14 @@ void uct_perf_iface_flush_b(ucx_perf_context_t *perf);
 ucs_status_t uct_perf_test_dispatch(ucx_perf_context_t *perf);
 ucs_status_t ucp_perf_test_dispatch(ucx_perf_context_t *perf);
 void ucx_perf_calc_result(ucx_perf_context_t *perf, ucx_perf_result_t *result);
+double ucx_perf_latency_factor(const ucx_perf_context_t *perf);
+void ucx_perf_calc_dist(ucs_time_t *samples, size_t count, double factor,
+                        ucx_perf_dist_t *dist);
+void ucx_perf_exchange_queue_delay(ucx_perf_context_t *perf,
+                                   ucx_perf_result_t *result);
+void ucx_perf_pattern_peers(const ucx_perf_params_t *params,
+                            unsigned thread_index, unsigned *dsts,
+                            unsigned *num_dsts, unsigned *num_srcs);
 void uct_perf_barrier(ucx_perf_context_t *perf);
 void ucp_perf_thread_barrier(ucx_perf_context_t *perf);
 void ucp_perf_barrier(ucx_perf_context_t *perf);
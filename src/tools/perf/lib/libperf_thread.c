@@ -59,11 +59,15 @@ static void ucx_perf_thread_report_aggregated_results(ucx_perf_context_t *perf)
     ucx_perf_thread_context_t* tctx = perf->ucp.tctx;  /* all the thread contexts on perf */
     unsigned i, thread_count        = perf->params.thread_count;
     double lat_sum_total_avegare    = 0.0;
+    ucx_perf_result_t *thread_results;
     ucx_perf_result_t agg_result;
+    ucs_time_t *samples;
+    size_t num_samples, count;
+    unsigned num_active;
 
-    agg_result.iters        = tctx[0].result.iters;
-    agg_result.bytes        = tctx[0].result.bytes;
-    agg_result.elapsed_time = tctx[0].result.elapsed_time;
+    agg_result.iters        = 0;
+    agg_result.bytes        = 0;
+    agg_result.elapsed_time = 0.0;
 
     agg_result.bandwidth.total_average  = 0.0;
     agg_result.bandwidth.percentile     = 0.0; /* Undefined since used only for latency calculations */
@@ -85,16 +89,72 @@ static void ucx_perf_thread_report_aggregated_results(ucx_perf_context_t *perf)
      * the threads, while the latency value is the average latency from the
      * threads. */
 
+    num_active = 0;
     for (i = 0; i < thread_count; i++) {
+        if (tctx[i].result.iters == 0) {
+            /* Thread had no peers in the traffic pattern */
+            continue;
+        }
+
+        if (num_active == 0) {
+            agg_result.bytes        = tctx[i].result.bytes;
+            agg_result.elapsed_time = tctx[i].result.elapsed_time;
+        }
+
+        agg_result.iters                     = ucs_max(agg_result.iters,
+                                                       tctx[i].result.iters);
         agg_result.bandwidth.total_average  += tctx[i].result.bandwidth.total_average;
         agg_result.msgrate.total_average    += tctx[i].result.msgrate.total_average;
         lat_sum_total_avegare               += tctx[i].result.latency.total_average;
+        ++num_active;
     }
 
-    agg_result.latency.total_average = lat_sum_total_avegare / thread_count;
+    agg_result.latency.total_average = lat_sum_total_avegare /
+                                       ucs_max(num_active, 1);
+
+    /* The latency distribution is calculated over the samples of all the
+     * threads together, so a single slow thread shows up in the tail */
+    samples        = calloc(thread_count * TIMING_QUEUE_SIZE, sizeof(*samples));
+    thread_results = calloc(thread_count, sizeof(*thread_results));
+    if ((samples == NULL) || (thread_results == NULL)) {
+        ucs_error("failed to allocate memory for aggregated results");
+        memset(&agg_result.latency_dist, 0, sizeof(agg_result.latency_dist));
+        memset(&agg_result.queue_delay, 0, sizeof(agg_result.queue_delay));
+        agg_result.num_threads    = 0;
+        agg_result.thread_results = NULL;
+    } else {
+        num_samples = 0;
+        for (i = 0; i < thread_count; i++) {
+            count = ucs_min(TIMING_QUEUE_SIZE, tctx[i].perf.current.iters);
+            memcpy(&samples[num_samples], tctx[i].perf.timing_queue,
+                   count * sizeof(*samples));
+            num_samples      += count;
+            thread_results[i] = tctx[i].result;
+        }
+
+        ucx_perf_calc_dist(samples, num_samples, ucx_perf_latency_factor(perf),
+                           &agg_result.latency_dist);
 
+        num_samples = 0;
+        for (i = 0; i < thread_count; i++) {
+            count = tctx[i].perf.queue_delay_count;
+            memcpy(&samples[num_samples], tctx[i].perf.queue_delay_samples,
+                   count * sizeof(*samples));
+            num_samples += count;
+        }
+
+        ucx_perf_calc_dist(samples, num_samples, 1.0, &agg_result.queue_delay);
+        perf->queue_delay_count   = num_samples;
+        agg_result.num_threads    = thread_count;
+        agg_result.thread_results = thread_results;
+    }
+
+    ucx_perf_exchange_queue_delay(perf, &agg_result);
     perf->params.report_func(perf->params.rte_group, &agg_result,
                              perf->params.report_arg, "", 1, 1);
+
+    free(thread_results);
+    free(samples);
 }
 
 ucs_status_t ucx_perf_thread_spawn(ucx_perf_context_t *perf,
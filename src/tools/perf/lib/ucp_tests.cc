@@ -33,11 +33,19 @@ public:
 
     ucp_perf_test_runner(ucx_perf_context_t &perf) :
         m_perf(perf),
+        /* Threads may share a worker, so each one matches its own tag */
+        m_tag(TAG + perf.ucp.thread_index),
         m_recvs_outstanding(0),
         m_sends_outstanding(0),
         m_max_outstanding(m_perf.params.max_outstanding),
         m_am_rx_buffer(NULL),
-        m_am_rx_length(0ul)
+        m_am_rx_length(0ul),
+        m_pattern_timestamp(false),
+        m_pattern_recv_buffer(NULL),
+        m_qd_total(0),
+        m_qd_min(NULL),
+        m_qd_delay(NULL),
+        m_qd_src(NULL)
     {
         memset(&m_am_rx_params, 0, sizeof(m_am_rx_params));
         memset(&m_send_params, 0, sizeof(m_send_params));
@@ -309,6 +317,16 @@ public:
         ucp_request_free(request);
     }
 
+    static void pattern_recv_cb(void *request, ucs_status_t status,
+                                const ucp_tag_recv_info_t *info,
+                                void *user_data)
+    {
+        ucp_perf_test_runner *test = (ucp_perf_test_runner*)user_data;
+        test->recv_completed();
+        test->pattern_recv_completed(info->sender_tag);
+        ucp_request_free(request);
+    }
+
     static void am_data_recv_cb(void *request, ucs_status_t status,
                                 size_t length, void *user_data)
     {
@@ -514,10 +532,11 @@ public:
         /* coverity[switch_selector_expr_is_constant] */
         switch (CMD) {
         case UCX_PERF_CMD_TAG:
-            request = ucp_tag_send_nbx(ep, buffer, length, TAG, param);
+            request = ucp_tag_send_nbx(ep, buffer, length, m_tag, param);
             break;
         case UCX_PERF_CMD_TAG_SYNC:
-            request = ucp_tag_send_sync_nbx(ep, buffer, length, TAG, param);
+            request = ucp_tag_send_sync_nbx(ep, buffer, length, m_tag,
+                                            param);
             break;
         case UCX_PERF_CMD_STREAM:
             request = ucp_stream_send_nbx(ep, buffer, length, param);
@@ -587,11 +606,12 @@ public:
             wait_recv_window(1);
             if (FLAGS & UCX_PERF_TEST_FLAG_TAG_UNEXP_PROBE) {
                 ucp_tag_recv_info_t tag_info;
-                while (ucp_tag_probe_nb(worker, TAG, TAG_MASK, 0, &tag_info) == NULL) {
+                while (ucp_tag_probe_nb(worker, m_tag, TAG_MASK, 0,
+                                        &tag_info) == NULL) {
                     progress_responder();
                 }
             }
-            request = ucp_tag_recv_nbx(worker, buffer, length, TAG, TAG_MASK,
+            request = ucp_tag_recv_nbx(worker, buffer, length, m_tag, TAG_MASK,
                                        &m_recv_params);
             if (ucs_likely(!UCS_PTR_IS_PTR(request))) {
                 return UCS_PTR_STATUS(request);
@@ -932,6 +952,201 @@ public:
         return UCS_OK;
     }
 
+    static ucp_tag_t pattern_tag(unsigned dst, unsigned src)
+    {
+        return (TAG << 32) | ((ucp_tag_t)dst << 16) | src;
+    }
+
+    /* The sender writes its clock to the beginning of every message, and the
+     * receiver measures the time above the lowest delay seen from the same
+     * sender, which cancels the clock offset between the hosts */
+    void pattern_recv_completed(ucp_tag_t sender_tag)
+    {
+        unsigned src = sender_tag & UCS_MASK(16);
+        ucs_time_t timestamp;
+        int64_t delay;
+        size_t index;
+
+        if (!m_pattern_timestamp) {
+            return;
+        }
+
+        memcpy(&timestamp, m_pattern_recv_buffer, sizeof(timestamp));
+        delay = (int64_t)(ucs_get_time() - timestamp);
+
+        index             = m_qd_total++ % TIMING_QUEUE_SIZE;
+        m_qd_delay[index] = delay;
+        m_qd_src[index]   = src;
+        m_qd_min[src]     = ucs_min(m_qd_min[src], delay);
+    }
+
+    void pattern_send(ucp_ep_h ep, void *buffer, size_t length,
+                      ucp_tag_t tag)
+    {
+        ucs_time_t timestamp;
+        void *request;
+
+        wait_send_window(1);
+
+        if (m_pattern_timestamp) {
+            timestamp = ucs_get_time();
+            memcpy(buffer, &timestamp, sizeof(timestamp));
+        }
+
+        if (CMD == UCX_PERF_CMD_TAG_SYNC) {
+            request = ucp_tag_send_sync_nbx(ep, buffer, length, tag,
+                                            &m_send_params);
+        } else {
+            request = ucp_tag_send_nbx(ep, buffer, length, tag,
+                                       &m_send_params);
+        }
+
+        if (UCS_PTR_IS_PTR(request)) {
+            send_started();
+        }
+    }
+
+    void pattern_recv(ucp_worker_h worker, void *buffer, size_t length,
+                      ucp_tag_t tag, const ucp_request_param_t *param)
+    {
+        void *request;
+
+        wait_recv_window(1);
+        request = ucp_tag_recv_nbx(worker, buffer, length, tag,
+                                   ~(ucp_tag_t)UCS_MASK(16), param);
+        if (UCS_PTR_IS_PTR(request)) {
+            recv_started();
+        } else if (UCS_PTR_STATUS(request) == UCS_OK) {
+            pattern_recv_completed(m_pattern_tag_info.sender_tag);
+        }
+    }
+
+    void pattern_finalize_queue_delay()
+    {
+        size_t count = ucs_min(m_qd_total, (size_t)TIMING_QUEUE_SIZE);
+        size_t i;
+
+        for (i = 0; i < count; ++i) {
+            m_perf.queue_delay_samples[i] = m_qd_delay[i] -
+                                            m_qd_min[m_qd_src[i]];
+        }
+
+        m_perf.queue_delay_count = count;
+    }
+
+    /* Every thread sends to, and receives from, the threads selected by the
+     * traffic pattern. One iteration is one round of messages of the thread.
+     * In a two-process test the client threads are the senders and the server
+     * threads are the receivers, in loopback every thread plays both roles. */
+    ucs_status_t run_pattern()
+    {
+        unsigned thread_count = m_perf.params.thread_count;
+        unsigned thread_index = m_perf.ucp.thread_index;
+        bool loopback         = m_perf.params.flags &
+                                UCX_PERF_TEST_FLAG_LOOPBACK;
+        unsigned *dsts        = (unsigned*)ucs_alloca(thread_count *
+                                                    sizeof(*dsts));
+        int64_t *qd_min       = (int64_t*)ucs_alloca(thread_count *
+                                                     sizeof(*qd_min));
+        ucp_request_param_t recv_params;
+        unsigned my_index, num_dsts, num_srcs, num_msgs, i;
+        void *send_buffer, *recv_buffer;
+        ucp_datatype_t send_datatype, recv_datatype;
+        size_t length, send_length, recv_length;
+        ucp_tag_t recv_tag;
+
+        if ((CMD != UCX_PERF_CMD_TAG) && (CMD != UCX_PERF_CMD_TAG_SYNC)) {
+            return UCS_ERR_UNSUPPORTED;
+        }
+
+        send_buffer = m_perf.send_buffer;
+        recv_buffer = m_perf.recv_buffer;
+
+        ucp_perf_init_common_params(&length, &send_length, &send_datatype,
+                                    &send_buffer, &recv_length, &recv_datatype,
+                                    &recv_buffer);
+
+        ucx_perf_pattern_peers(&m_perf.params, thread_index, dsts,
+                               &num_dsts, &num_srcs);
+
+        my_index = rte_call(&m_perf, group_index);
+        if (!loopback && (my_index == 0)) {
+            num_dsts = 0;
+        } else if (!loopback && (my_index == 1)) {
+            num_srcs = 0;
+        }
+
+        m_pattern_timestamp   =
+                (m_perf.params.send_mem_type == UCS_MEMORY_TYPE_HOST) &&
+                (m_perf.params.recv_mem_type == UCS_MEMORY_TYPE_HOST) &&
+                (m_perf.params.ucp.send_datatype == UCP_PERF_DATATYPE_CONTIG) &&
+                (m_perf.params.ucp.recv_datatype == UCP_PERF_DATATYPE_CONTIG) &&
+                (length >= sizeof(ucs_time_t));
+        m_pattern_recv_buffer = recv_buffer;
+        m_qd_total            = 0;
+        m_qd_min              = qd_min;
+        m_qd_delay            = (int64_t*)malloc(TIMING_QUEUE_SIZE *
+                                                 sizeof(*m_qd_delay));
+        m_qd_src              = (unsigned*)malloc(TIMING_QUEUE_SIZE *
+                                                  sizeof(*m_qd_src));
+        if ((m_qd_delay == NULL) || (m_qd_src == NULL)) {
+            ucs_error("failed to allocate queue delay samples");
+            free(m_qd_src);
+            free(m_qd_delay);
+            return UCS_ERR_NO_MEMORY;
+        }
+        for (i = 0; i < thread_count; ++i) {
+            m_qd_min[i] = std::numeric_limits<int64_t>::max();
+        }
+
+        recv_params                     = m_recv_params;
+        recv_params.op_attr_mask       |= UCP_OP_ATTR_FIELD_RECV_INFO;
+        recv_params.cb.recv             = pattern_recv_cb;
+        recv_params.recv_info.tag_info  = &m_pattern_tag_info;
+        recv_tag                        = pattern_tag(thread_index, 0);
+        num_msgs                        = ucs_max(num_dsts, num_srcs);
+
+        ucp_perf_barrier(&m_perf);
+
+        ucx_perf_test_start_clock(&m_perf);
+
+        ucx_perf_omp_barrier(&m_perf);
+
+        if (num_msgs > 0) {
+            UCX_PERF_TEST_FOREACH(&m_perf) {
+                for (i = 0; i < num_dsts; ++i) {
+                    pattern_send(m_perf.ucp.peer_eps[dsts[i]], send_buffer,
+                                 send_length, pattern_tag(dsts[i],
+                                                          thread_index));
+                }
+
+                for (i = 0; i < num_srcs; ++i) {
+                    pattern_recv(m_perf.ucp.worker, recv_buffer, recv_length,
+                                 recv_tag, &recv_params);
+                }
+
+                m_perf.current.msgs += num_msgs - 1;
+                ucx_perf_update(&m_perf, 1, length * num_msgs);
+            }
+
+            wait_send_window(m_max_outstanding);
+            wait_recv_window(m_max_outstanding);
+        }
+
+        pattern_finalize_queue_delay();
+        free(m_qd_src);
+        free(m_qd_delay);
+
+        flush();
+
+        ucx_perf_omp_barrier(&m_perf);
+
+        ucx_perf_get_time(&m_perf);
+
+        ucp_perf_barrier(&m_perf);
+        return UCS_OK;
+    }
+
     ucs_status_t run()
     {
         /* coverity[switch_selector_expr_is_constant] */
@@ -940,6 +1155,9 @@ public:
         case UCX_PERF_TEST_TYPE_PINGPONG_WAIT_MEM:
             return run_pingpong();
         case UCX_PERF_TEST_TYPE_STREAM_UNI:
+            if (m_perf.params.ucp.pattern != UCX_PERF_PATTERN_PAIR) {
+                return run_pattern();
+            }
             return run_stream_uni();
         case UCX_PERF_TEST_TYPE_STREAM_BI:
         default:
@@ -1015,6 +1233,7 @@ private:
     }
 
     ucx_perf_context_t &m_perf;
+    const ucp_tag_t    m_tag;
     int                m_recvs_outstanding;
     int                m_sends_outstanding;
     const int          m_max_outstanding;
@@ -1029,6 +1248,14 @@ private:
     ucp_request_param_t m_send_get_info_params;
     ucp_request_param_t m_recv_params;
     ucp_atomic_op_t     m_atomic_op;
+    /* Traffic pattern receiver state */
+    bool                  m_pattern_timestamp;
+    const void            *m_pattern_recv_buffer;
+    ucp_tag_recv_info_t   m_pattern_tag_info;
+    size_t                m_qd_total;
+    int64_t               *m_qd_min; /* Lowest delay from each sender */
+    int64_t               *m_qd_delay;
+    unsigned              *m_qd_src;
 };
 
 
@@ -23,7 +23,8 @@ enum {
     TEST_FLAG_NUMERIC_FMT      = UCS_BIT(9),
     TEST_FLAG_PRINT_FINAL      = UCS_BIT(10),
     TEST_FLAG_PRINT_CSV        = UCS_BIT(11),
-    TEST_FLAG_PRINT_EXTRA_INFO = UCS_BIT(12)
+    TEST_FLAG_PRINT_EXTRA_INFO = UCS_BIT(12),
+    TEST_FLAG_PRINT_JSON       = UCS_BIT(13)
 };
 
 
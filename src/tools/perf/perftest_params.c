@@ -19,6 +19,8 @@ const struct option TEST_PARAMS_ARGS_LONG[] =
 {
     {"daemon-local",  required_argument, 0, 'g'},
     {"daemon-remote", required_argument, 0, 'G'},
+    {"shared-worker", no_argument,       0, 'a'},
+    {"pattern",       required_argument, 0, 'Q'},
     {0, 0, 0, 0}
 };
 
@@ -106,6 +108,7 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("     -N             use numeric formatting (thousands separator)\n");
     printf("     -f             print only final numbers\n");
     printf("     -v             print CSV-formatted output\n");
+    printf("     -j             print JSON-formatted output\n");
     printf("     -I             print extra information about the operation\n");
     printf("     -q             do not print error messages\n");
     printf("\n");
@@ -133,6 +136,17 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("                        single     - only the master thread can access\n");
     printf("                        serialized - one thread can access at a time\n");
     printf("                        multi      - multiple threads can access\n");
+    printf("     -a, --shared-worker\n");
+    printf("                    all threads share a single worker, each thread with\n");
+    printf("                    its own endpoints (requires -M multi, no AM tests)\n");
+    printf("     -Q, --pattern <pattern>\n");
+    printf("                    traffic pattern between the threads, for tag bandwidth\n");
+    printf("                    tests (pair)\n");
+    printf("                        pair        - each thread to the same remote thread\n");
+    printf("                        incast      - all threads to remote thread 0\n");
+    printf("                        fanout      - thread 0 to all remote threads\n");
+    printf("                        all2all     - all threads to all remote threads\n");
+    printf("                        permutation - each thread to a random remote thread\n");
     printf("     -D <layout>[,<layout>]\n");
     printf("                    data layout for sender and receiver side (contig)\n");
     printf("                        contig - Continuous datatype\n");
@@ -510,6 +524,30 @@ ucs_status_t parse_test_params(perftest_params_t *params, char opt,
     case 'z':
         params->super.flags |= UCX_PERF_TEST_FLAG_PREREG;
         return UCS_OK;
+    case 'a':
+        params->super.flags |= UCX_PERF_TEST_FLAG_SHARED_WORKER;
+        return UCS_OK;
+    case 'Q':
+        if (!strcmp(opt_arg, "pair")) {
+            params->super.ucp.pattern = UCX_PERF_PATTERN_PAIR;
+            return UCS_OK;
+        } else if (!strcmp(opt_arg, "incast")) {
+            params->super.ucp.pattern = UCX_PERF_PATTERN_INCAST;
+            return UCS_OK;
+        } else if (!strcmp(opt_arg, "fanout")) {
+            params->super.ucp.pattern = UCX_PERF_PATTERN_FANOUT;
+            return UCS_OK;
+        } else if (!strcmp(opt_arg, "all2all") ||
+                   !strcmp(opt_arg, "all_to_all")) {
+            params->super.ucp.pattern = UCX_PERF_PATTERN_ALL_TO_ALL;
+            return UCS_OK;
+        } else if (!strcmp(opt_arg, "permutation")) {
+            params->super.ucp.pattern = UCX_PERF_PATTERN_PERMUTATION;
+            return UCS_OK;
+        } else {
+            ucs_error("Invalid option argument for -Q");
+            return UCS_ERR_INVALID_PARAM;
+        }
     default:
        return UCS_ERR_INVALID_PARAM;
     }
@@ -649,7 +687,7 @@ ucs_status_t parse_opts(struct perftest_context *ctx, int mpi_initialized,
 
     optind = 1;
     while ((c = getopt_long(argc, argv,
-                            "p:b:6NfvIc:P:hK:g:G:k" TEST_PARAMS_ARGS,
+                            "p:b:6NfvjIc:P:hK:g:G:k" TEST_PARAMS_ARGS,
                             TEST_PARAMS_ARGS_LONG, NULL)) != -1) {
         switch (c) {
         case 'p':
@@ -675,6 +713,9 @@ ucs_status_t parse_opts(struct perftest_context *ctx, int mpi_initialized,
         case 'v':
             ctx->flags |= TEST_FLAG_PRINT_CSV;
             break;
+        case 'j':
+            ctx->flags |= TEST_FLAG_PRINT_JSON;
+            break;
         case 'I':
             ctx->flags |= TEST_FLAG_PRINT_EXTRA_INFO;
             break;
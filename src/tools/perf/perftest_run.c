@@ -20,6 +20,113 @@
 #include <locale.h>
 
 
+static void print_json_result(ucs_string_buffer_t *strb,
+                              const ucx_perf_result_t *result)
+{
+    ucs_string_buffer_appendf(strb,
+                              "\"iterations\":%.0f,"
+                              "\"latency_usec\":{\"average\":%.3f,"
+                              "\"median\":%.3f,\"p99\":%.3f,"
+                              "\"p99.9\":%.3f,\"max\":%.3f},"
+                              "\"bandwidth_mbs\":%.2f,\"msgrate\":%.0f",
+                              (double)result->iters,
+                              result->latency.total_average * 1000000.0,
+                              result->latency_dist.median * 1000000.0,
+                              result->latency_dist.p99 * 1000000.0,
+                              result->latency_dist.p999 * 1000000.0,
+                              result->latency_dist.max * 1000000.0,
+                              result->bandwidth.total_average /
+                                      (1024.0 * 1024.0),
+                              result->msgrate.total_average);
+}
+
+/* Print the final result as a single JSON object per line */
+static void print_json(struct perftest_context *ctx,
+                       const ucx_perf_result_t *result)
+{
+    ucs_string_buffer_t strb = UCS_STRING_BUFFER_INITIALIZER;
+    unsigned i;
+
+    ucs_string_buffer_appendf(&strb, "{");
+    if (ctx->num_batch_files > 0) {
+        ucs_string_buffer_appendf(&strb, "\"test\":\"");
+        ucs_string_buffer_append_array(&strb, "/", "%s", ctx->test_names,
+                                       ctx->num_batch_files);
+        ucs_string_buffer_appendf(&strb, "\",");
+    }
+
+    print_json_result(&strb, result);
+
+    if (result->queue_delay.max > 0) {
+        ucs_string_buffer_appendf(&strb,
+                                  ",\"queue_delay_usec\":{\"median\":%.3f,"
+                                  "\"p99\":%.3f,\"p99.9\":%.3f,\"max\":%.3f}",
+                                  result->queue_delay.median * 1000000.0,
+                                  result->queue_delay.p99 * 1000000.0,
+                                  result->queue_delay.p999 * 1000000.0,
+                                  result->queue_delay.max * 1000000.0);
+    }
+
+    if (result->num_threads == 0) {
+        ucs_string_buffer_appendf(&strb, ",\"percentile_rank\":%.1f,"
+                                  "\"percentile_lat_usec\":%.3f",
+                                  ctx->params.super.percentile_rank,
+                                  result->latency.percentile * 1000000.0);
+    } else {
+        ucs_string_buffer_appendf(&strb, ",\"threads\":[");
+        for (i = 0; i < result->num_threads; ++i) {
+            ucs_string_buffer_appendf(&strb, "%s{\"thread\":%u,",
+                                      (i == 0) ? "" : ",", i);
+            print_json_result(&strb, &result->thread_results[i]);
+            ucs_string_buffer_appendf(&strb, "}");
+        }
+        ucs_string_buffer_appendf(&strb, "]");
+    }
+
+    ucs_string_buffer_appendf(&strb, "}");
+    fprintf(stdout, "%s\n", ucs_string_buffer_cstr(&strb));
+    fflush(stdout);
+    ucs_string_buffer_cleanup(&strb);
+}
+
+static void print_latency_dist(struct perftest_context *ctx,
+                               const ucx_perf_result_t *result)
+{
+    if (ctx->flags & TEST_FLAG_PRINT_CSV) {
+        printf(",%.3f,%.3f,%.3f,%.3f", result->latency_dist.median * 1000000.0,
+               result->latency_dist.p99 * 1000000.0,
+               result->latency_dist.p999 * 1000000.0,
+               result->latency_dist.max * 1000000.0);
+    } else {
+        printf("  latency (usec) median %.3f p99 %.3f p99.9 %.3f max %.3f",
+               result->latency_dist.median * 1000000.0,
+               result->latency_dist.p99 * 1000000.0,
+               result->latency_dist.p999 * 1000000.0,
+               result->latency_dist.max * 1000000.0);
+    }
+}
+
+/* Per-thread breakdown of a multi-threaded test */
+static void print_thread_results(struct perftest_context *ctx,
+                                 const ucx_perf_result_t *result)
+{
+    const ucx_perf_result_t *thread_result;
+    unsigned i;
+
+    for (i = 0; i < result->num_threads; ++i) {
+        thread_result = &result->thread_results[i];
+        printf((ctx->flags & TEST_FLAG_PRINT_CSV) ?
+                       "thread%u,%.0f,%.3f,%.2f,%.0f" :
+                       "[thread %u] %9.0f %29.3f %22.2f %23.0f",
+               i, (double)thread_result->iters,
+               thread_result->latency.total_average * 1000000.0,
+               thread_result->bandwidth.total_average / (1024.0 * 1024.0),
+               thread_result->msgrate.total_average);
+        print_latency_dist(ctx, thread_result);
+        printf("\n");
+    }
+}
+
 void print_progress(void *UCS_V_UNUSED rte_group,
                     const ucx_perf_result_t *result, void *arg,
                     const char *extra_info, int final, int is_multi_thread)
@@ -39,6 +146,13 @@ void print_progress(void *UCS_V_UNUSED rte_group,
         return;
     }
 
+    if (ctx->flags & TEST_FLAG_PRINT_JSON) {
+        if (final) {
+            print_json(ctx, result);
+        }
+        return;
+    }
+
     if (ctx->flags & TEST_FLAG_PRINT_CSV) {
         for (i = 0; i < ctx->num_batch_files; ++i) {
             ucs_string_buffer_appendf(&strb, "%s,", ctx->test_names[i]);
@@ -100,7 +214,25 @@ void print_progress(void *UCS_V_UNUSED rte_group,
         ucs_string_buffer_appendf(&strb, "  %s", extra_info);
     }
 
-    fprintf(stdout, "%s\n", ucs_string_buffer_cstr(&strb));
+    fprintf(stdout, "%s", ucs_string_buffer_cstr(&strb));
+    if ((ctx->flags & TEST_FLAG_PRINT_CSV) || (final && is_multi_thread)) {
+        print_latency_dist(ctx, result);
+    }
+    fprintf(stdout, "\n");
+
+    if (final && is_multi_thread) {
+        print_thread_results(ctx, result);
+    }
+
+    /* Receiver-side queueing delay of a traffic pattern test */
+    if (final && !(ctx->flags & TEST_FLAG_PRINT_CSV) &&
+        (result->queue_delay.max > 0)) {
+        printf("  queue delay (usec) median %.3f p99 %.3f p99.9 %.3f max %.3f\n",
+               result->queue_delay.median * 1000000.0,
+               result->queue_delay.p99 * 1000000.0,
+               result->queue_delay.p999 * 1000000.0,
+               result->queue_delay.max * 1000000.0);
+    }
     fflush(stdout);
 }
 
@@ -112,6 +244,11 @@ static void print_header(struct perftest_context *ctx)
     test_type_t *test;
     unsigned i;
 
+    if (ctx->flags & TEST_FLAG_PRINT_JSON) {
+        /* Every result line is self-contained */
+        return;
+    }
+
     test = (ctx->params.test_id == TEST_ID_UNDEFINED) ? NULL :
            &tests[ctx->params.test_id];
 
@@ -163,7 +300,7 @@ static void print_header(struct perftest_context *ctx)
             for (i = 0; i < ctx->num_batch_files; ++i) {
                 printf("%s,", ucs_basename(ctx->batch_files[i]));
             }
-            printf("iterations,%.1f_percentile_lat,avg_lat,overall_lat,avg_bw,overall_bw,avg_mr,overall_mr\n", ctx->params.super.percentile_rank);
+            printf("iterations,%.1f_percentile_lat,avg_lat,overall_lat,avg_bw,overall_bw,avg_mr,overall_mr,median_lat,p99_lat,p99.9_lat,max_lat\n", ctx->params.super.percentile_rank);
         }
     } else {
         if (ctx->flags & TEST_FLAG_PRINT_RESULTS) {
@@ -187,7 +324,8 @@ static void print_test_name(struct perftest_context *ctx)
     char buf[200];
     unsigned i, pos;
 
-    if (!(ctx->flags & (TEST_FLAG_PRINT_CSV | TEST_FLAG_PRINT_FINAL)) &&
+    if (!(ctx->flags & (TEST_FLAG_PRINT_CSV | TEST_FLAG_PRINT_FINAL |
+                        TEST_FLAG_PRINT_JSON)) &&
         (ctx->num_batch_files > 0)) {
         strcpy(buf, "+--------------+--------------+----------+---------+---------+----------+----------+-----------+-----------+");
 
@@ -18,6 +18,7 @@
 #include <sys/stat.h>
 #include <stdlib.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <string.h>
@@ -31,6 +32,8 @@
 #define PAGER_LESS_CMD     PAGER_LESS " -R"
 #define FUNC_NAME_MAX_LEN  35
 #define MAX_THREADS        256
+#define HIST_MAX_BUCKETS   64
+#define HIST_BAR_WIDTH     40
 
 #define TERM_COLOR_CLEAR   "\x1B[0m"
 #define TERM_COLOR_RED     "\x1B[31m"
@@ -65,6 +68,8 @@ typedef enum {
 typedef struct options {
     const char                   *filename;
     int                          raw;
+    int                          histogram;
+    int                          requests;
     time_units_t                 time_units;
     int                          thread_list[MAX_THREADS + 1];
 } options_t;
@@ -86,9 +91,27 @@ typedef struct {
     char                         *env_variables;
     uint32_t                     num_locations;
     unsigned                     num_threads;
+    unsigned                     mode;     /* Data available in the file */
+    uint64_t                     dropped;  /* Records dropped in stream mode */
+
+    /* Data rebuilt from a stream mode file */
+    struct {
+        ucs_profile_location_t        *locations;
+        ucs_profile_thread_header_t   *headers;
+        ucs_profile_thread_location_t *thread_locations;
+        ucs_profile_record_t          *records;
+    } stream;
 } profile_data_t;
 
 
+/* Collected time intervals of a single location */
+typedef struct {
+    uint64_t                     *values;
+    size_t                       count;
+    size_t                       capacity;
+} profile_intervals_t;
+
+
 typedef struct {
     uint64_t                     total_time;
     size_t                       count;
@@ -108,6 +131,201 @@ static const char* time_units_str[] = {
     [TIME_UNITS_LAST] = NULL
 };
 
+static int stream_find_thread(profile_data_t *data, uint32_t tid)
+{
+    unsigned thread_idx;
+
+    for (thread_idx = 0; thread_idx < data->num_threads; ++thread_idx) {
+        if (data->stream.headers[thread_idx].tid == tid) {
+            return thread_idx;
+        }
+    }
+
+    if (data->num_threads >= MAX_THREADS) {
+        print_error("the profile contains more than %d threads", MAX_THREADS);
+        return -EINVAL;
+    }
+
+    memset(&data->stream.headers[data->num_threads], 0,
+           sizeof(*data->stream.headers));
+    data->stream.headers[data->num_threads].tid = tid;
+    return data->num_threads++;
+}
+
+/* Walk over stream chunks, and either count or copy the locations and records */
+static int stream_read_chunks(profile_data_t *data, size_t *record_offsets,
+                              int copy)
+{
+    const void *ptr, *end;
+    const ucs_profile_stream_chunk_t *chunk;
+    ucs_profile_thread_header_t *thread_hdr;
+    uint32_t num_locations = 0;
+    size_t entry_size;
+    int thread_idx;
+
+    ptr = UCS_PTR_BYTE_OFFSET(data->mem, data->header->threads.offset);
+    end = UCS_PTR_BYTE_OFFSET(ptr, data->header->threads.size);
+    if (UCS_PTR_BYTE_DIFF(data->mem, end) > data->length) {
+        print_error("stream file is truncated");
+        return -EINVAL;
+    }
+
+    while (ptr < end) {
+        chunk = ptr;
+        if (chunk->type == UCS_PROFILE_STREAM_CHUNK_LOCATIONS) {
+            entry_size = sizeof(ucs_profile_location_t);
+            if (copy) {
+                memcpy(&data->stream.locations[num_locations], chunk + 1,
+                       chunk->count * entry_size);
+            }
+            num_locations += chunk->count;
+        } else if (chunk->type == UCS_PROFILE_STREAM_CHUNK_RECORDS) {
+            entry_size = sizeof(ucs_profile_record_t);
+            thread_idx = stream_find_thread(data, chunk->tid);
+            if (thread_idx < 0) {
+                return thread_idx;
+            }
+
+            thread_hdr = &data->stream.headers[thread_idx];
+            if (copy) {
+                memcpy(&data->stream.records[record_offsets[thread_idx] +
+                                             thread_hdr->num_records],
+                       chunk + 1, chunk->count * entry_size);
+            } else {
+                data->dropped += chunk->dropped;
+            }
+            thread_hdr->num_records += chunk->count;
+        } else {
+            print_error("invalid stream chunk type %u at offset %zu",
+                        chunk->type, UCS_PTR_BYTE_DIFF(data->mem, chunk));
+            return -EINVAL;
+        }
+
+        ptr = UCS_PTR_BYTE_OFFSET(chunk + 1, chunk->count * entry_size);
+        if (ptr > end) {
+            print_error("stream chunk at offset %zu exceeds the data size",
+                        UCS_PTR_BYTE_DIFF(data->mem, chunk));
+            return -EINVAL;
+        }
+    }
+
+    data->num_locations = num_locations;
+    return 0;
+}
+
+/* Calculate per-location accumulated times, as done by the accumulate mode */
+static void stream_accumulate(profile_data_t *data, unsigned thread_idx)
+{
+    profile_thread_data_t *thread = &data->threads[thread_idx];
+    size_t num_records            = thread->header->num_records;
+    ucs_profile_thread_location_t *locations;
+    ucs_time_t stack[UCS_PROFILE_STACK_MAX];
+    const ucs_profile_record_t *rec;
+    int stack_top = -1;
+
+    locations = &data->stream.thread_locations[thread_idx *
+                                               data->num_locations];
+    for (rec = thread->records; rec < thread->records + num_records; ++rec) {
+        switch (data->locations[rec->location].type) {
+        case UCS_PROFILE_TYPE_SCOPE_BEGIN:
+            if (stack_top < (UCS_PROFILE_STACK_MAX - 1)) {
+                stack[++stack_top] = rec->timestamp;
+            }
+            break;
+        case UCS_PROFILE_TYPE_SCOPE_END:
+            /* The scope begin could be dropped */
+            if (stack_top >= 0) {
+                locations[rec->location].total_time += rec->timestamp -
+                                                       stack[stack_top--];
+            }
+            break;
+        default:
+            break;
+        }
+        ++locations[rec->location].count;
+    }
+}
+
+static int read_stream_data(profile_data_t *data)
+{
+    size_t *record_offsets = NULL;
+    size_t total_num_records;
+    ucs_profile_thread_header_t *thread_hdr;
+    profile_thread_data_t *thread;
+    unsigned thread_idx;
+    int ret;
+
+    data->stream.headers = calloc(MAX_THREADS, sizeof(*data->stream.headers));
+    record_offsets       = calloc(MAX_THREADS, sizeof(*record_offsets));
+    if ((data->stream.headers == NULL) || (record_offsets == NULL)) {
+        print_error("failed to allocate stream threads");
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    /* First pass: count locations and records of each thread */
+    ret = stream_read_chunks(data, NULL, 0);
+    if (ret < 0) {
+        goto out;
+    }
+
+    total_num_records = 0;
+    for (thread_idx = 0; thread_idx < data->num_threads; ++thread_idx) {
+        thread_hdr                  = &data->stream.headers[thread_idx];
+        record_offsets[thread_idx]  = total_num_records;
+        total_num_records          += thread_hdr->num_records;
+        thread_hdr->num_records     = 0;
+    }
+
+    data->stream.locations        = calloc(data->num_locations + 1,
+                                           sizeof(*data->stream.locations));
+    data->stream.thread_locations = calloc((data->num_locations *
+                                            data->num_threads) + 1,
+                                           sizeof(*data->stream.thread_locations));
+    data->stream.records          = calloc(total_num_records + 1,
+                                           sizeof(*data->stream.records));
+    data->threads                 = calloc(data->num_threads + 1,
+                                           sizeof(*data->threads));
+    if ((data->stream.locations == NULL) ||
+        (data->stream.thread_locations == NULL) ||
+        (data->stream.records == NULL) || (data->threads == NULL)) {
+        print_error("failed to allocate stream data");
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    /* Second pass: concatenate the records of every thread */
+    ret = stream_read_chunks(data, record_offsets, 1);
+    if (ret < 0) {
+        goto out;
+    }
+
+    data->locations = data->stream.locations;
+    for (thread_idx = 0; thread_idx < data->num_threads; ++thread_idx) {
+        thread_hdr        = &data->stream.headers[thread_idx];
+        thread            = &data->threads[thread_idx];
+        thread->header    = thread_hdr;
+        thread->records   = &data->stream.records[record_offsets[thread_idx]];
+        thread->locations = &data->stream.thread_locations[
+                                    thread_idx * data->num_locations];
+        if (thread_hdr->num_records > 0) {
+            thread_hdr->start_time = thread->records[0].timestamp;
+            thread_hdr->end_time   =
+                    thread->records[thread_hdr->num_records - 1].timestamp;
+        }
+
+        stream_accumulate(data, thread_idx);
+    }
+
+    /* The stream contains all records, so show both accumulated and log data */
+    data->mode = UCS_BIT(UCS_PROFILE_MODE_ACCUM) | UCS_BIT(UCS_PROFILE_MODE_LOG);
+    ret        = 0;
+
+out:
+    free(record_offsets);
+    return ret;
+}
+
 static int read_profile_data(const char *file_name, profile_data_t *data)
 {
     size_t total_num_records = 0;
@@ -167,6 +385,16 @@ static int read_profile_data(const char *file_name, profile_data_t *data)
            env_vars_size);
     data->env_variables[env_vars_size] = '\0';
 
+    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_STREAM)) {
+        ret = read_stream_data(data);
+        if (ret < 0) {
+            goto err_stream;
+        }
+
+        goto out_close;
+    }
+
+    data->mode          = data->header->mode;
     data->num_locations = data->header->locations.size /
                           sizeof(ucs_profile_location_t);
     data->locations     = UCS_PTR_BYTE_OFFSET(data->mem,
@@ -205,6 +433,12 @@ out_close:
 out:
     return ret;
 
+err_stream:
+    free(data->stream.locations);
+    free(data->stream.thread_locations);
+    free(data->stream.records);
+    free(data->stream.headers);
+    free(data->threads);
 err_env_variables:
     free(data->env_variables);
 err_munmap:
@@ -214,6 +448,10 @@ err_munmap:
 
 static void release_profile_data(profile_data_t *data)
 {
+    free(data->stream.locations);
+    free(data->stream.thread_locations);
+    free(data->stream.records);
+    free(data->stream.headers);
     free(data->threads);
     free(data->env_variables);
     munmap(data->mem, data->length);
@@ -629,6 +867,293 @@ static void show_profile_data_log(profile_data_t *data, options_t *opts,
     free(scope_ends);
 }
 
+static int intervals_add(profile_intervals_t *intervals, uint64_t value)
+{
+    size_t new_capacity;
+    uint64_t *values;
+
+    if (intervals->count == intervals->capacity) {
+        new_capacity = ucs_max(16, intervals->capacity * 2);
+        values       = realloc(intervals->values,
+                               new_capacity * sizeof(*values));
+        if (values == NULL) {
+            print_error("failed to allocate intervals array");
+            return -ENOMEM;
+        }
+
+        intervals->values   = values;
+        intervals->capacity = new_capacity;
+    }
+
+    intervals->values[intervals->count++] = value;
+    return 0;
+}
+
+static void intervals_release(profile_intervals_t *intervals, unsigned count)
+{
+    unsigned i;
+
+    for (i = 0; i < count; ++i) {
+        free(intervals[i].values);
+    }
+    free(intervals);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t v1 = *(const uint64_t*)a;
+    uint64_t v2 = *(const uint64_t*)b;
+    return (v1 < v2) ? -1 : (v1 > v2) ? +1 : 0;
+}
+
+/* Intervals must be sorted */
+static uint64_t intervals_percentile(const profile_intervals_t *intervals,
+                                     double percent)
+{
+    size_t idx = (size_t)(percent * (intervals->count - 1) / 100.0 + 0.5);
+    return intervals->values[idx];
+}
+
+/* Intervals must be sorted */
+static uint64_t intervals_average(const profile_intervals_t *intervals)
+{
+    uint64_t total = 0;
+    size_t i;
+
+    for (i = 0; i < intervals->count; ++i) {
+        total += intervals->values[i];
+    }
+    return total / intervals->count;
+}
+
+static void show_intervals_title(options_t *opts, const char *title)
+{
+    printf("%s%s %s%s\n\n", HEAD_COLOR, title, time_units_str[opts->time_units],
+           CLEAR_COLOR);
+    printf("%s%*s %12s %10s %10s %10s %10s %10s %10s %18s%-6s  %s%s\n",
+           HEAD_COLOR, FUNC_NAME_MAX_LEN, "NAME", "COUNT", "MIN", "AVG", "P50",
+           "P90", "P99", "MAX", "FILE", ":LINE", "FUNCTION", CLEAR_COLOR);
+}
+
+/* Sorts the intervals */
+static void show_intervals(profile_data_t *data, options_t *opts,
+                           const ucs_profile_location_t *loc,
+                           profile_intervals_t *intervals)
+{
+    qsort(intervals->values, intervals->count, sizeof(*intervals->values),
+          compare_u64);
+
+    printf("%s%*.*s%s %12zu %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f "
+           "%s%18s:%-6d %s%s\n",
+           NAME_COLOR, FUNC_NAME_MAX_LEN, FUNC_NAME_MAX_LEN, loc->name,
+           CLEAR_COLOR, intervals->count,
+           time_to_units(data, opts, intervals->values[0]),
+           time_to_units(data, opts, intervals_average(intervals)),
+           time_to_units(data, opts, intervals_percentile(intervals, 50)),
+           time_to_units(data, opts, intervals_percentile(intervals, 90)),
+           time_to_units(data, opts, intervals_percentile(intervals, 99)),
+           time_to_units(data, opts, intervals->values[intervals->count - 1]),
+           LOC_COLOR, ucs_basename(loc->file), loc->line, loc->function,
+           CLEAR_COLOR);
+}
+
+/* Intervals must be sorted. Every bucket is twice as wide as the previous one,
+ * starting from the minimal interval. */
+static void show_intervals_histogram(profile_data_t *data, options_t *opts,
+                                     const profile_intervals_t *intervals)
+{
+    size_t counts[HIST_MAX_BUCKETS] = {0};
+    uint64_t base                   = ucs_max(intervals->values[0], 1);
+    size_t max_count                = 0;
+    unsigned bucket, num_buckets;
+    size_t i;
+
+    num_buckets = 1;
+    for (i = 0; i < intervals->count; ++i) {
+        bucket = ucs_min(ucs_ilog2(ucs_max(intervals->values[i], base) / base),
+                         HIST_MAX_BUCKETS - 1);
+        ++counts[bucket];
+        max_count   = ucs_max(max_count, counts[bucket]);
+        num_buckets = ucs_max(num_buckets, bucket + 1);
+    }
+
+    for (bucket = 0; bucket < num_buckets; ++bucket) {
+        printf("%*s%10.3f .. %-10.3f %12zu  %.*s\n", FUNC_NAME_MAX_LEN - 20, "",
+               time_to_units(data, opts, base << bucket),
+               time_to_units(data, opts, base << (bucket + 1)), counts[bucket],
+               (int)((counts[bucket] * HIST_BAR_WIDTH + max_count - 1) /
+                     max_count),
+               "########################################");
+    }
+}
+
+static int show_profile_data_histogram(profile_data_t *data, options_t *opts)
+{
+    const ucs_profile_record_t *stack[UCS_PROFILE_STACK_MAX];
+    const profile_thread_data_t *thread;
+    const ucs_profile_record_t *rec;
+    profile_intervals_t *intervals;
+    unsigned location_idx;
+    int ret, stack_top;
+    int *t;
+
+    intervals = calloc(data->num_locations + 1, sizeof(*intervals));
+    if (intervals == NULL) {
+        print_error("failed to allocate intervals");
+        return -ENOMEM;
+    }
+
+    /* Match scope begin and end records of every thread, and collect the time
+     * of every scope by its end location, which holds the scope name */
+    for (t = opts->thread_list; *t != -1; ++t) {
+        thread    = &data->threads[*t - 1];
+        stack_top = -1;
+        for (rec = thread->records;
+             rec < thread->records + thread->header->num_records; ++rec) {
+            switch (data->locations[rec->location].type) {
+            case UCS_PROFILE_TYPE_SCOPE_BEGIN:
+                if (stack_top < (UCS_PROFILE_STACK_MAX - 1)) {
+                    stack[++stack_top] = rec;
+                }
+                break;
+            case UCS_PROFILE_TYPE_SCOPE_END:
+                if (stack_top < 0) {
+                    break; /* scope begin was not recorded */
+                }
+
+                ret = intervals_add(&intervals[rec->location],
+                                    rec->timestamp -
+                                    stack[stack_top--]->timestamp);
+                if (ret < 0) {
+                    goto out;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    show_intervals_title(opts, "Scope latency");
+    for (location_idx = 0; location_idx < data->num_locations; ++location_idx) {
+        if (intervals[location_idx].count == 0) {
+            continue;
+        }
+
+        show_intervals(data, opts, &data->locations[location_idx],
+                       &intervals[location_idx]);
+        show_intervals_histogram(data, opts, &intervals[location_idx]);
+    }
+
+    ret = 0;
+
+out:
+    intervals_release(intervals, data->num_locations + 1);
+    return ret;
+}
+
+KHASH_MAP_INIT_INT64(request_start, const ucs_profile_record_t*)
+
+static int show_profile_data_requests(profile_data_t *data, options_t *opts)
+{
+    const profile_thread_data_t *thread;
+    const ucs_profile_location_t *loc;
+    const ucs_profile_record_t *rec;
+    khash_t(request_start) requests;
+    profile_intervals_t *lifetimes, *offsets;
+    size_t num_unfinished;
+    unsigned location_idx;
+    int hash_extra_status;
+    khiter_t hash_it;
+    uint64_t elapsed;
+    int ret;
+    int *t;
+
+    lifetimes = calloc(data->num_locations + 1, sizeof(*lifetimes));
+    offsets   = calloc(data->num_locations + 1, sizeof(*offsets));
+    if ((lifetimes == NULL) || (offsets == NULL)) {
+        print_error("failed to allocate intervals");
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    /* Collect the lifetime of every request by the location which created it,
+     * and the time from creation to every event and release of the request */
+    num_unfinished = 0;
+    for (t = opts->thread_list; *t != -1; ++t) {
+        thread = &data->threads[*t - 1];
+        kh_init_inplace(request_start, &requests);
+        for (rec = thread->records;
+             rec < thread->records + thread->header->num_records; ++rec) {
+            loc = &data->locations[rec->location];
+            switch (loc->type) {
+            case UCS_PROFILE_TYPE_REQUEST_NEW:
+                hash_it = kh_put(request_start, &requests, rec->param64,
+                                 &hash_extra_status);
+                if (hash_it != kh_end(&requests)) {
+                    /* replaces an old request which was not released */
+                    kh_value(&requests, hash_it) = rec;
+                }
+                break;
+            case UCS_PROFILE_TYPE_REQUEST_EVENT:
+            case UCS_PROFILE_TYPE_REQUEST_FREE:
+                hash_it = kh_get(request_start, &requests, rec->param64);
+                if (hash_it == kh_end(&requests)) {
+                    break; /* request creation was not recorded */
+                }
+
+                elapsed = rec->timestamp -
+                          kh_value(&requests, hash_it)->timestamp;
+                ret     = intervals_add(&offsets[rec->location], elapsed);
+                if ((ret == 0) && (loc->type == UCS_PROFILE_TYPE_REQUEST_FREE)) {
+                    ret = intervals_add(
+                            &lifetimes[kh_value(&requests, hash_it)->location],
+                            elapsed);
+                    kh_del(request_start, &requests, hash_it);
+                }
+                if (ret < 0) {
+                    kh_destroy_inplace(request_start, &requests);
+                    goto out;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        num_unfinished += kh_size(&requests);
+        kh_destroy_inplace(request_start, &requests);
+    }
+
+    show_intervals_title(opts, "Request lifetime, by creation location");
+    for (location_idx = 0; location_idx < data->num_locations; ++location_idx) {
+        if (lifetimes[location_idx].count > 0) {
+            show_intervals(data, opts, &data->locations[location_idx],
+                           &lifetimes[location_idx]);
+        }
+    }
+    printf("\n%zu requests were not released\n\n", num_unfinished);
+
+    show_intervals_title(opts, "Request events, time since creation");
+    for (location_idx = 0; location_idx < data->num_locations; ++location_idx) {
+        if (offsets[location_idx].count > 0) {
+            show_intervals(data, opts, &data->locations[location_idx],
+                           &offsets[location_idx]);
+        }
+    }
+
+    ret = 0;
+
+out:
+    if (offsets != NULL) {
+        intervals_release(offsets, data->num_locations + 1);
+    }
+    if (lifetimes != NULL) {
+        intervals_release(lifetimes, data->num_locations + 1);
+    }
+    return ret;
+}
+
 static void close_pipes()
 {
     close(output_pipefds[0]);
@@ -654,13 +1179,27 @@ static int redirect_output(const profile_data_t *data, options_t *opts)
     num_lines = 6 + /* header */
                 1; /* footer */
 
-    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
+    if (opts->histogram) {
+        num_lines += 3 + /* title */
+                     (data->num_locations * 16); /* scopes and buckets */
+    }
+
+    if (opts->requests) {
+        num_lines += 10 + /* titles and footer */
+                     (data->num_locations * 2); /* request locations */
+    }
+
+    if (opts->histogram || opts->requests) {
+        goto check_lines;
+    }
+
+    if (data->mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
         num_lines += 1 + /* locations title */
                      data->num_locations + /* locations data */
                      1; /* locations footer */
     }
 
-    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+    if (data->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
         for (t = opts->thread_list; *t != -1; ++t) {
             num_lines += 3; /* thread header */
             /* Suppressing a false positive for null value dereference */
@@ -671,6 +1210,7 @@ static int redirect_output(const profile_data_t *data, options_t *opts)
         }
     }
 
+check_lines:
     if (num_lines <= wsz.ws_row) {
         return 0; /* no need to use 'less' */
     }
@@ -741,6 +1281,9 @@ static void show_header(profile_data_t *data, options_t *opts)
     printf("   pid     : %d\n", data->header->pid);
     printf("   version : %d\n", data->header->version);
     printf("   env     : %s\n", env_present ? data->env_variables : "N/A");
+    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_STREAM)) {
+        printf("   dropped : %" PRIu64 " records\n", data->dropped);
+    }
 
     printf("   threads : %-3d", data->num_threads);
     if (opts->thread_list[0] != -1) {
@@ -808,12 +1351,37 @@ static int show_profile_data(profile_data_t *data, options_t *opts)
 
     show_header(data, opts);
 
-    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
+    if (opts->histogram || opts->requests) {
+        if (!(data->mode & UCS_BIT(UCS_PROFILE_MODE_LOG))) {
+            print_error("latency analysis requires log or stream mode profile");
+            return -EINVAL;
+        }
+
+        if (opts->histogram) {
+            ret = show_profile_data_histogram(data, opts);
+            if (ret < 0) {
+                return ret;
+            }
+            printf("\n");
+        }
+
+        if (opts->requests) {
+            ret = show_profile_data_requests(data, opts);
+            if (ret < 0) {
+                return ret;
+            }
+            printf("\n");
+        }
+
+        return 0;
+    }
+
+    if (data->mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
         show_profile_data_accum(data, opts);
         printf("\n");
     }
 
-    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+    if (data->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
         for (t = opts->thread_list; *t != -1; ++t) {
             show_profile_data_log(data, opts, *t - 1);
         }
@@ -828,6 +1396,9 @@ static void usage()
     printf("Usage: ucx_read_profile [options] [profile-file]\n");
     printf("Options are:\n");
     printf("  -r              Show raw output\n");
+    printf("  -H              Show latency histogram of every scope\n");
+    printf("  -R              Show lifetime of requests, and time from "
+           "request creation to its events\n");
     printf("  -T <threads>    Comma-separated list of threads to show, "
            "e.g. \"1,2,3\", or \"all\" to show all threads\n");
     printf("  -t <units>      Select time units to use:\n");
@@ -843,17 +1414,25 @@ static int parse_args(int argc, char **argv, options_t *opts)
     int ret, c;
 
     opts->raw         = !isatty(fileno(stdout));
+    opts->histogram   = 0;
+    opts->requests    = 0;
     opts->time_units  = TIME_UNITS_USEC;
     ret = parse_thread_list(opts->thread_list, "all");
     if (ret < 0) {
         return ret;
     }
 
-    while ( (c = getopt(argc, argv, "rT:t:h")) != -1 ) {
+    while ( (c = getopt(argc, argv, "rHRT:t:h")) != -1 ) {
         switch (c) {
         case 'r':
             opts->raw = 1;
             break;
+        case 'H':
+            opts->histogram = 1;
+            break;
+        case 'R':
+            opts->requests = 1;
+            break;
         case 'T':
             ret = parse_thread_list(opts->thread_list, optarg);
             if (ret < 0) {
@@ -12,7 +12,9 @@
 
 #include "ucp_context.h"
 #include "ucp_request.h"
+#include "ucp_mm_prereg.h"
 
+#include <ucp/dt/dt_generic.h>
 #include <ucs/config/parser.h>
 #include <ucs/algorithm/crc.h>
 #include <ucs/arch/atomic.h>
@@ -55,7 +57,8 @@
     _macro(UCP_AM_ID_AM_SINGLE) \
     _macro(UCP_AM_ID_AM_FIRST) \
     _macro(UCP_AM_ID_AM_MIDDLE) \
-    _macro(UCP_AM_ID_AM_SINGLE_REPLY)
+    _macro(UCP_AM_ID_AM_SINGLE_REPLY) \
+    _macro(UCP_AM_ID_EAGER_ONLY_CSUM)
 
 #define UCP_AM_HANDLER_DECL(_id) extern ucp_am_handler_t ucp_am_handler_##_id;
 
@@ -64,6 +67,8 @@
 #define UCP_CPU_EST_BCOPY_BW_DEFAULT         (7000 * UCS_MBYTE)
 #define UCP_CPU_EST_BCOPY_BW_DEFAULT_PROTOV1 (5800 * UCS_MBYTE)
 #define UCP_CPU_EST_BCOPY_BW_AMD_PROTOV1     (5008 * UCS_MBYTE)
+#define UCP_CPU_EST_CSUM_BW_HW               (6000 * UCS_MBYTE)
+#define UCP_CPU_EST_CSUM_BW_SW               (1000 * UCS_MBYTE)
 
 #define UCP_TL_AUX_SUFFIX    "aux"
 #define UCP_TL_AUX(_tl_name) _tl_name ":" UCP_TL_AUX_SUFFIX
@@ -171,6 +176,48 @@ static ucs_config_field_t ucp_context_config_table[] = {
    ucs_offsetof(ucp_context_config_t, rndv_memtype_direct_size),
    UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"MEM_PREREG", "n",
+   "Track host memory mappings reported by memory hooks and register them in\n"
+   "the registration cache from worker progress, ahead of the first send\n"
+   "operation which uses them. Requires the registration cache.",
+   ucs_offsetof(ucp_context_config_t, mem_prereg), UCS_CONFIG_TYPE_BOOL},
+
+  {"MEM_PREREG_MIN_SIZE", "1m",
+   "Minimal size of a memory mapping to be considered for pre-registration.",
+   ucs_offsetof(ucp_context_config_t, mem_prereg_min_size),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"MEM_PREREG_MAX_SIZE", "256m",
+   "Maximal size of a pre-registered region. Adjacent mappings are coalesced\n"
+   "into one region up to this size, and larger mappings are not tracked.",
+   ucs_offsetof(ucp_context_config_t, mem_prereg_max_size),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"GENERIC_DT_PACK_THREADS", "0",
+   "Number of helper threads which pack large messages of generic datatypes\n"
+   "ahead of the network transfer, in chunks. The pack callback of generic\n"
+   "datatypes must support concurrent calls with the same state at different\n"
+   "offsets. 0 disables packing ahead.",
+   ucs_offsetof(ucp_context_config_t, generic_dt_pack_threads),
+   UCS_CONFIG_TYPE_UINT},
+
+  {"GENERIC_DT_PACK_THRESH", "1m",
+   "Minimal message size to pack a generic datatype ahead.",
+   ucs_offsetof(ucp_context_config_t, generic_dt_pack_thresh),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"GENERIC_DT_PACK_CHUNK", "256k",
+   "Size of a chunk packed ahead by a single helper thread.",
+   ucs_offsetof(ucp_context_config_t, generic_dt_pack_chunk),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"GENERIC_DT_PACK_WINDOW", "8",
+   "Maximal number of chunks of a single message packed ahead of the send.\n"
+   "Each message which is packed ahead uses a staging buffer of this number of\n"
+   "chunks.",
+   ucs_offsetof(ucp_context_config_t, generic_dt_pack_window),
+   UCS_CONFIG_TYPE_UINT},
+
   {"BCOPY_THRESH", "auto",
    "Threshold for switching from short to bcopy protocol",
    ucs_offsetof(ucp_context_config_t, bcopy_thresh), UCS_CONFIG_TYPE_MEMUNITS},
@@ -266,6 +313,20 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "Estimation of buffer copy bandwidth",
    ucs_offsetof(ucp_context_config_t, bcopy_bw), UCS_CONFIG_TYPE_BW},
 
+  {"PAYLOAD_CHECKSUM", "n",
+   "Protect the payload of tag messages by a CRC32C checksum, which is verified\n"
+   "by the receiver. Eager messages carry the checksum after the payload, and a\n"
+   "mismatch completes the receive request with an error. For rendezvous\n"
+   "protocols which fetch the data by the receiver, the checksum of the received\n"
+   "data is returned in the acknowledgment, and a mismatch completes the send\n"
+   "request with an error. Eager protocols which cannot carry the checksum are\n"
+   "disabled. Requires protocols v2.",
+   ucs_offsetof(ucp_context_config_t, payload_checksum), UCS_CONFIG_TYPE_BOOL},
+
+  {"PAYLOAD_CHECKSUM_BW", "auto",
+   "Estimation of payload checksum calculation bandwidth",
+   ucs_offsetof(ucp_context_config_t, payload_checksum_bw), UCS_CONFIG_TYPE_BW},
+
   {"ATOMIC_MODE", "guess",
    "Atomic operations synchronization mode.\n"
    " cpu    - atomic operations are consistent with respect to the CPU.\n"
@@ -301,6 +362,13 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "y      - Use mutex for multithreading support in UCP.",
    ucs_offsetof(ucp_context_config_t, use_mt_mutex), UCS_CONFIG_TYPE_BOOL},
 
+  {"MT_REQ_CACHE", "16",
+   "Number of requests moved at once between a per-thread request cache and\n"
+   "the worker request pool, for workers created with UCS_THREAD_MODE_MULTI.\n"
+   "Each thread caches up to twice this number of requests. 0 disables the\n"
+   "per-thread caches.",
+   ucs_offsetof(ucp_context_config_t, mt_req_cache), UCS_CONFIG_TYPE_UINT},
+
   {"ADAPTIVE_PROGRESS", "y",
    "Enable adaptive progress mechanism, which turns on polling only on active\n"
    "transport interfaces.",
@@ -337,6 +405,23 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "selected automatically according to the performance characteristics.",
    ucs_offsetof(ucp_context_config_t, tm_sw_rndv), UCS_CONFIG_TYPE_TERNARY},
 
+  {"TM_MASK_CLASSES", "0",
+   "Maximal number of distinct tag masks of wildcard receive requests which are\n"
+   "indexed by the software tag matching. Requests which share a tag mask are\n"
+   "kept in a hash table keyed by the masked tag, so matching an incoming\n"
+   "message does not require scanning all posted wildcard receives. Requests\n"
+   "with other tag masks are kept in a single wildcard queue. The value 0\n"
+   "disables the index.",
+   ucs_offsetof(ucp_context_config_t, tm_mask_classes), UCS_CONFIG_TYPE_UINT},
+
+  {"TM_UNEXP_BINS", "0",
+   "Number of bins in the array-based store of unexpected tag messages. When\n"
+   "enabled, the tags of unexpected messages are kept in compact arrays, one per\n"
+   "group of senders (as defined by the tag sender mask), which are scanned\n"
+   "sequentially by receive and probe operations instead of walking a linked\n"
+   "list of descriptors. The value 0 disables the array-based store.",
+   ucs_offsetof(ucp_context_config_t, tm_unexp_bins), UCS_CONFIG_TYPE_UINT},
+
   {"NUM_EPS", "auto",
    "An optimization hint of how many endpoints would be created on this context.\n"
    "Does not affect semantics, but only transport selection criteria and the\n"
@@ -426,7 +511,8 @@ static ucs_config_field_t ucp_context_config_table[] = {
    UCS_CONFIG_TYPE_TIME_UNITS},
 
   {"KEEPALIVE_NUM_EPS", "128",
-   "Maximal number of endpoints to check on every keepalive round\n"
+   "Maximal number of endpoints to check on every keepalive round, endpoints\n"
+   "which are due beyond that are checked on the following rounds\n"
    "(inf - check all endpoints on every round, must be greater than 0)",
    ucs_offsetof(ucp_context_config_t, keepalive_num_eps), UCS_CONFIG_TYPE_UINT},
 
@@ -2045,6 +2131,14 @@ static double ucp_context_get_protov1_memcpy_bw()
                    UCP_CPU_EST_BCOPY_BW_DEFAULT_PROTOV1;
 }
 
+static double ucp_context_get_payload_checksum_bw()
+{
+    return (ucs_crc32c_impl_is_supported(UCS_CRC32C_IMPL_SSE42) ||
+            ucs_crc32c_impl_is_supported(UCS_CRC32C_IMPL_ARMV8)) ?
+                   UCP_CPU_EST_CSUM_BW_HW :
+                   UCP_CPU_EST_CSUM_BW_SW;
+}
+
 static int
 ucp_dynamic_tl_switch_config_valid(const ucp_context_config_t *config)
 {
@@ -2106,6 +2200,17 @@ static ucs_status_t ucp_fill_config(ucp_context_h context,
     }
     ucs_debug("estimated bcopy bandwidth is %f", context->config.ext.bcopy_bw);
 
+    if (context->config.ext.payload_checksum &&
+        !context->config.ext.proto_enable) {
+        ucs_warn("payload checksum is not supported by protocols v1");
+        context->config.ext.payload_checksum = 0;
+    }
+
+    if (UCS_CONFIG_DBL_IS_AUTO(context->config.ext.payload_checksum_bw)) {
+        context->config.ext.payload_checksum_bw =
+                ucp_context_get_payload_checksum_bw();
+    }
+
     if (config->protos.mode == UCS_CONFIG_ALLOW_LIST_ALLOW_ALL) {
         context->proto_bitmap = UCS_MASK(ucp_protocols_count());
     } else {
@@ -2405,6 +2510,24 @@ ucs_status_t ucp_init_version(unsigned api_major_version, unsigned api_minor_ver
         memset(&context->cache_md_map, 0, sizeof(context->cache_md_map));
     }
 
+    status = ucp_mem_prereg_init(context);
+    if (status != UCS_OK) {
+        goto err_rcache_cleanup;
+    }
+
+    if (context->config.ext.generic_dt_pack_threads > 0) {
+        status = ucp_dt_generic_pack_pool_create(
+                context->config.ext.generic_dt_pack_threads,
+                context->config.ext.generic_dt_pack_chunk,
+                context->config.ext.generic_dt_pack_window,
+                &context->dt_pack_pool);
+        if (status != UCS_OK) {
+            goto err_prereg_cleanup;
+        }
+    } else {
+        context->dt_pack_pool = NULL;
+    }
+
     if (dfl_config != NULL) {
         ucp_config_release(dfl_config);
     }
@@ -2419,6 +2542,10 @@ ucs_status_t ucp_init_version(unsigned api_major_version, unsigned api_minor_ver
     *context_p = context;
     return UCS_OK;
 
+err_prereg_cleanup:
+    ucp_mem_prereg_cleanup(context);
+err_rcache_cleanup:
+    ucp_mem_rcache_cleanup(context);
 err_free_res:
     ucp_free_resources(context);
 err_thread_lock_finalize:
@@ -2437,6 +2564,10 @@ err:
 void ucp_cleanup(ucp_context_h context)
 {
     ucs_vfs_obj_remove(context);
+    if (context->dt_pack_pool != NULL) {
+        ucp_dt_generic_pack_pool_destroy(context->dt_pack_pool);
+    }
+    ucp_mem_prereg_cleanup(context);
     ucp_mem_rcache_cleanup(context);
     ucp_free_resources(context);
     ucp_free_config(context);
@@ -82,6 +82,10 @@ typedef struct ucp_context_config {
     size_t                                 rkey_ptr_seg_size;
     /** Estimation of bcopy bandwidth */
     double                                 bcopy_bw;
+    /** Add a checksum to the message payload and verify it by the receiver */
+    int                                    payload_checksum;
+    /** Estimation of payload checksum calculation bandwidth */
+    double                                 payload_checksum_bw;
     /** Segment size in the worker pre-registered memory pool */
     size_t                                 seg_size;
     /** RNDV pipeline fragment size */
@@ -108,6 +112,10 @@ typedef struct ucp_context_config {
     size_t                                 tm_max_bb_size;
     /** Enabling SW rndv protocol with tag offload mode */
     ucs_ternary_auto_value_t               tm_sw_rndv;
+    /** Maximal number of distinct wildcard tag masks indexed by tag matching */
+    unsigned                               tm_mask_classes;
+    /** Number of sender bins in the array-based unexpected tags store */
+    unsigned                               tm_unexp_bins;
     /** Pack debug information in worker address */
     int                                    address_debug_info;
     /** Maximal size of worker address name for debugging */
@@ -116,6 +124,8 @@ typedef struct ucp_context_config {
     ucp_atomic_mode_t                      atomic_mode;
     /** If use mutex for MT support or not */
     int                                    use_mt_mutex;
+    /** Batch size of per-thread request caches for multi-threaded workers */
+    unsigned                               mt_req_cache;
     /** On-demand progress */
     int                                    adaptive_progress;
     /** Eager-am multi-lane support */
@@ -166,6 +176,20 @@ typedef struct ucp_context_config {
     int                                    rndv_put_force_flush;
     /** Maximum size of mem type direct rndv*/
     size_t                                 rndv_memtype_direct_size;
+    /** Pre-register newly mapped host memory in the background */
+    int                                    mem_prereg;
+    /** Minimal size of a mapping to be pre-registered */
+    size_t                                 mem_prereg_min_size;
+    /** Maximal size of a pre-registered region after coalescing */
+    size_t                                 mem_prereg_max_size;
+    /** Number of threads which pack generic datatypes ahead */
+    unsigned                               generic_dt_pack_threads;
+    /** Minimal message size to pack generic datatypes ahead */
+    size_t                                 generic_dt_pack_thresh;
+    /** Size of a chunk packed ahead by a single thread */
+    size_t                                 generic_dt_pack_chunk;
+    /** Maximal number of chunks packed ahead of the send */
+    unsigned                               generic_dt_pack_window;
     /** UCP sockaddr private data format version */
     ucp_object_version_t                   sa_client_min_hdr_version;
     /** Remote keys with that many remote MDs or less would be allocated from a
@@ -395,6 +419,12 @@ typedef struct ucp_context {
     /* Hash of rcaches which contain imported memory handles got from peers */
     ucp_context_imported_mem_hash_t *imported_mem_hash;
 
+    /* Predictive memory pre-registration engine, NULL if disabled */
+    struct ucp_mem_prereg         *prereg;
+
+    /* Threads which pack generic datatypes ahead, NULL if disabled */
+    struct ucp_dt_generic_pack_pool *dt_pack_pool;
+
     struct {
 
         /* Bitmap of features supported by the context */
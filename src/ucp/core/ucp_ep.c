@@ -222,6 +222,8 @@ static ucp_ep_h ucp_ep_allocate(ucp_worker_h worker, const char *peer_name)
     ep->ext->remote_ep_id                 = UCS_PTR_MAP_KEY_INVALID;
     ep->ext->err_cb                       = NULL;
     ep->ext->close_req                    = NULL;
+    ucs_wtimer_init(&ep->ext->ka_timer, ucp_worker_keepalive_timer);
+    ep->ext->ka_last_rx                   = 0;
 #if UCS_ENABLE_ASSERT
     ep->ext->ka_last_round                = 0;
 #endif
@@ -370,6 +372,7 @@ ucs_status_t ucp_ep_create_base(ucp_worker_h worker, unsigned ep_init_flags,
         goto err;
     }
 
+    UCP_WORKER_STAT_HIST_START(worker, ep->ext->create_time);
     ucp_stream_ep_init(ep);
     ucp_am_ep_init(ep);
 
@@ -1187,10 +1190,13 @@ static void ucp_ep_params_check_err_handling(ucp_ep_h ep,
 ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
                            ucp_ep_h *ep_p)
 {
-    ucp_ep_h ep    = NULL;
-    unsigned flags = UCP_PARAM_VALUE(EP, params, flags, FLAGS, 0);
+    ucp_ep_h ep                        = NULL;
+    unsigned flags                     = UCP_PARAM_VALUE(EP, params, flags,
+                                                         FLAGS, 0);
+    ucs_time_t UCS_V_UNUSED start_time = 0;
     ucs_status_t status;
 
+    UCP_WORKER_STAT_HIST_START(worker, start_time);
     UCS_ASYNC_BLOCK(&worker->async);
 
     if (flags & UCP_EP_PARAMS_FLAGS_CLIENT_SERVER) {
@@ -1216,6 +1222,7 @@ ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
 
         ucp_ep_params_check_err_handling(ep, params);
         ucp_ep_update_flags(ep, UCP_EP_FLAG_USED, 0);
+        UCP_WORKER_STAT_HIST_TIME(worker, EP_CREATE, start_time);
         *ep_p = ep;
     } else {
         ++worker->counters.ep_creation_failures;
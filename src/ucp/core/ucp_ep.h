@@ -21,6 +21,7 @@
 #include <ucs/datastruct/strided_alloc.h>
 #include <ucs/debug/assert.h>
 #include <ucs/stats/stats.h>
+#include <ucs/time/timer_wheel.h>
 
 
 #define UCP_MAX_IOV                16UL
@@ -519,9 +520,15 @@ typedef struct ucp_ep_ext {
                                                     used by 2-stage ppln rndv proto */
     /* List of requests which are waiting for remote completion */
     ucs_hlist_head_t              proto_reqs;
+    ucs_wtimer_t                  ka_timer;      /* Next keepalive check */
+    ucs_time_t                    ka_last_rx;    /* Last time a message was
+                                                    received on the EP */
 #if UCS_ENABLE_ASSERT
     ucs_time_t                    ka_last_round; /* Time of last KA round done */
 #endif
+#ifdef ENABLE_STATS
+    ucs_time_t                    create_time;   /* Time the EP was created */
+#endif
 
     /* Endpoint match context and remote completion status are mutually exclusive,
      * since remote completions are counted only after the endpoint is already
@@ -43,7 +43,12 @@ enum {
     /**
      * Avoid using registration cache for the particular memory region.
      */
-    UCP_MEMH_FLAG_NO_RCACHE    = UCS_BIT(3)
+    UCP_MEMH_FLAG_NO_RCACHE    = UCS_BIT(3),
+
+    /**
+     * Memory region was registered by the pre-registration engine.
+     */
+    UCP_MEMH_FLAG_PREREG       = UCS_BIT(4)
 };
 
 
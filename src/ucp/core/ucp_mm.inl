@@ -8,6 +8,7 @@
 #define UCP_MM_INL_
 
 #include "ucp_mm.h"
+#include "ucp_mm_prereg.h"
 
 #include <ucs/memory/rcache.inl>
 
@@ -67,6 +68,7 @@ ucp_memh_get(ucp_context_h context, void *address, size_t length,
                     ucs_test_all_flags(memh->uct_flags,
                                        UCP_MM_UCT_ACCESS_FLAGS(uct_flags)))) {
             ucp_memh_rcache_print(memh, address, length);
+            UCP_MEM_PREREG_STAT_HIT(memh);
             *memh_p = memh;
             UCP_THREAD_CS_EXIT(&context->mt_lock);
             return UCS_OK;
@@ -74,6 +76,7 @@ ucp_memh_get(ucp_context_h context, void *address, size_t length,
 
         ucs_rcache_region_put_unsafe(context->rcache, rregion);
 not_found:
+        UCP_MEM_PREREG_STAT_MISS(context, mem_type);
         UCP_THREAD_CS_EXIT(&context->mt_lock);
     }
 
@@ -0,0 +1,343 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2025. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ucp_mm_prereg.h"
+#include "ucp_context.h"
+#include "ucp_mm.inl"
+
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/sys.h>
+#include <ucm/api/ucm.h>
+#include <sys/mman.h>
+
+
+#define UCP_MEM_PREREG_EVENTS (UCM_EVENT_VM_MAPPED | UCM_EVENT_VM_UNMAPPED)
+
+
+#ifdef ENABLE_STATS
+static ucs_stats_class_t ucp_mem_prereg_stats_class = {
+    .name         = "ucp_mem_prereg",
+    .num_counters = UCP_MEM_PREREG_STAT_LAST,
+    .class_id     = UCS_STATS_CLASS_ID_INVALID,
+    .counter_names = {
+        [UCP_MEM_PREREG_STAT_TRACKED]   = "tracked",
+        [UCP_MEM_PREREG_STAT_DROPPED]   = "dropped",
+        [UCP_MEM_PREREG_STAT_REGS]      = "regs",
+        [UCP_MEM_PREREG_STAT_REG_BYTES] = "reg_bytes",
+        [UCP_MEM_PREREG_STAT_FAILED]    = "failed",
+        [UCP_MEM_PREREG_STAT_HIT]       = "hit",
+        [UCP_MEM_PREREG_STAT_MISS]      = "miss"
+    }
+};
+#endif
+
+
+static UCS_F_ALWAYS_INLINE ucp_mem_prereg_range_t *
+ucp_mem_prereg_queue_elem(ucp_mem_prereg_t *prereg, unsigned index)
+{
+    return &prereg->queue[(prereg->head + index) % UCP_MEM_PREREG_QUEUE_SIZE];
+}
+
+static UCS_F_ALWAYS_INLINE int
+ucp_mem_prereg_range_extend(const ucp_mem_prereg_t *prereg,
+                            ucp_mem_prereg_range_t *range, uintptr_t start,
+                            uintptr_t end)
+{
+    if ((start == range->end) && ((end - range->start) <= prereg->max_size)) {
+        range->end = end;
+        return 1;
+    }
+
+    if ((end == range->start) && ((range->end - start) <= prereg->max_size)) {
+        range->start = start;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Called from the context of the thread which mapped the memory, possibly with
+ * allocator locks held, so it must not allocate memory.
+ */
+static void ucp_mem_prereg_track(ucp_mem_prereg_t *prereg, uintptr_t start,
+                                 uintptr_t end)
+{
+    ucp_mem_prereg_range_t *range;
+
+    if ((end - start) > prereg->max_size) {
+        return;
+    }
+
+    ucs_spin_lock(&prereg->lock);
+
+    if ((prereg->count > 0) &&
+        ucp_mem_prereg_range_extend(prereg,
+                                    ucp_mem_prereg_queue_elem(prereg,
+                                                              prereg->count - 1),
+                                    start, end)) {
+        goto out;
+    }
+
+    if (prereg->count == UCP_MEM_PREREG_QUEUE_SIZE) {
+        UCS_STATS_UPDATE_COUNTER(prereg->stats, UCP_MEM_PREREG_STAT_DROPPED, 1);
+        goto out;
+    }
+
+    range        = ucp_mem_prereg_queue_elem(prereg, prereg->count);
+    range->start = start;
+    range->end   = end;
+    ++prereg->count;
+    UCS_STATS_UPDATE_COUNTER(prereg->stats, UCP_MEM_PREREG_STAT_TRACKED, 1);
+
+out:
+    ucs_spin_unlock(&prereg->lock);
+}
+
+static void ucp_mem_prereg_untrack(ucp_mem_prereg_t *prereg, uintptr_t start,
+                                   uintptr_t end)
+{
+    ucp_mem_prereg_range_t *range;
+    size_t head_size, tail_size;
+    unsigned i;
+
+    ucs_spin_lock(&prereg->lock);
+
+    for (i = 0; i < prereg->count; ++i) {
+        range = ucp_mem_prereg_queue_elem(prereg, i);
+        if ((range->start >= end) || (start >= range->end)) {
+            continue;
+        }
+
+        /* Keep the larger part of a coalesced range which remains mapped;
+         * empty ranges are skipped by the progress */
+        head_size = (start > range->start) ? (start - range->start) : 0;
+        tail_size = (end < range->end) ? (range->end - end) : 0;
+        if (head_size >= tail_size) {
+            range->end = range->start + head_size;
+        } else {
+            range->start = range->end - tail_size;
+        }
+
+        if (range->start == range->end) {
+            UCS_STATS_UPDATE_COUNTER(prereg->stats,
+                                     UCP_MEM_PREREG_STAT_DROPPED, 1);
+        }
+    }
+
+    if ((prereg->last.start < end) && (start < prereg->last.end)) {
+        prereg->last.start = prereg->last.end = 0;
+    }
+
+    ucs_spin_unlock(&prereg->lock);
+}
+
+static void ucp_mem_prereg_event_handler(ucm_event_type_t event_type,
+                                         ucm_event_t *event, void *arg)
+{
+    ucp_mem_prereg_t *prereg = arg;
+    uintptr_t start          = (uintptr_t)event->vm_mapped.address;
+    uintptr_t end            = start + event->vm_mapped.size;
+
+    if (event_type == UCM_EVENT_VM_MAPPED) {
+        ucp_mem_prereg_track(prereg, start, end);
+    } else {
+        ucp_mem_prereg_untrack(prereg, start, end);
+    }
+}
+
+/* Pop the next range which is large enough, and drop smaller ones */
+static int
+ucp_mem_prereg_pop(ucp_mem_prereg_t *prereg, ucp_mem_prereg_range_t *range)
+{
+    while (prereg->count > 0) {
+        *range       = prereg->queue[prereg->head];
+        prereg->head = (prereg->head + 1) % UCP_MEM_PREREG_QUEUE_SIZE;
+        --prereg->count;
+
+        if ((range->end - range->start) >= prereg->min_size) {
+            /* Coalesce with the previous region, so the registration cache
+             * will merge them to a single one */
+            ucp_mem_prereg_range_extend(prereg, range, prereg->last.start,
+                                        prereg->last.end);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int ucp_mem_prereg_register(ucp_mem_prereg_t *prereg,
+                                   const ucp_mem_prereg_range_t *range)
+{
+    ucp_context_h context = prereg->context;
+    void *address         = (void*)range->start;
+    size_t length         = range->end - range->start;
+    uint64_t reg_id       = context->next_memh_reg_id;
+    ucs_status_t status;
+    ucp_mem_h memh;
+
+    /* Memory may be reserved with no access, and made accessible later */
+    if (!ucs_test_all_flags(ucs_get_mem_prot(range->start, range->end),
+                            PROT_READ | PROT_WRITE)) {
+        ucs_trace("prereg: skip address %p length %zu without access",
+                  address, length);
+        UCS_STATS_UPDATE_COUNTER(prereg->stats, UCP_MEM_PREREG_STAT_DROPPED, 1);
+        return 0;
+    }
+
+    status = ucp_memh_get_slow(context, address, length, UCS_MEMORY_TYPE_HOST,
+                               prereg->md_map,
+                               UCT_MD_MEM_ACCESS_RMA |
+                               UCT_MD_MEM_FLAG_HIDE_ERRORS,
+                               "prereg", &memh);
+    if (status != UCS_OK) {
+        ucs_debug("prereg: failed to register address %p length %zu: %s",
+                  address, length, ucs_status_string(status));
+        UCS_STATS_UPDATE_COUNTER(prereg->stats, UCP_MEM_PREREG_STAT_FAILED, 1);
+        return 0;
+    }
+
+    UCP_THREAD_CS_ENTER(&context->mt_lock);
+    /* Do not take credit for regions which were registered by the user */
+    if (memh->reg_id >= reg_id) {
+        memh->flags |= UCP_MEMH_FLAG_PREREG;
+    }
+    UCP_THREAD_CS_EXIT(&context->mt_lock);
+
+    ucs_trace("prereg: memh %p address %p length %zu md_map 0x%" PRIx64,
+              memh, address, length, memh->md_map);
+
+    /* The region remains in the registration cache after release */
+    ucp_memh_put(memh);
+
+    ucs_spin_lock(&prereg->lock);
+    prereg->last = *range;
+    ucs_spin_unlock(&prereg->lock);
+
+    UCS_STATS_UPDATE_COUNTER(prereg->stats, UCP_MEM_PREREG_STAT_REGS, 1);
+    UCS_STATS_UPDATE_COUNTER(prereg->stats, UCP_MEM_PREREG_STAT_REG_BYTES,
+                             length);
+    return 1;
+}
+
+unsigned ucp_mem_prereg_progress(void *arg)
+{
+    ucp_mem_prereg_t *prereg = arg;
+    ucp_mem_prereg_range_t range;
+    int found;
+
+    if (ucs_likely(prereg->count == 0)) {
+        return 0;
+    }
+
+    ucs_spin_lock(&prereg->lock);
+    found = ucp_mem_prereg_pop(prereg, &range);
+    ucs_spin_unlock(&prereg->lock);
+
+    if (!found) {
+        return 0;
+    }
+
+    return ucp_mem_prereg_register(prereg, &range);
+}
+
+ucs_status_t ucp_mem_prereg_init(ucp_context_h context)
+{
+    const ucp_context_config_t *config = &context->config.ext;
+    ucp_mem_prereg_t *prereg;
+    ucs_status_t status;
+
+    context->prereg = NULL;
+
+    if (!config->mem_prereg) {
+        return UCS_OK;
+    }
+
+    if (context->rcache == NULL) {
+        ucs_diag("memory pre-registration requires registration cache");
+        return UCS_OK;
+    }
+
+    if ((context->reg_md_map[UCS_MEMORY_TYPE_HOST] &
+         context->cache_md_map[UCS_MEMORY_TYPE_HOST]) == 0) {
+        ucs_debug("no memory domains require host memory registration,"
+                  " memory pre-registration is disabled");
+        return UCS_OK;
+    }
+
+    if (config->mem_prereg_min_size > config->mem_prereg_max_size) {
+        ucs_error("invalid memory pre-registration sizes: min %zu > max %zu",
+                  config->mem_prereg_min_size, config->mem_prereg_max_size);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    prereg = ucs_calloc(1, sizeof(*prereg), "ucp_mem_prereg");
+    if (prereg == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    prereg->context  = context;
+    prereg->min_size = config->mem_prereg_min_size;
+    prereg->max_size = config->mem_prereg_max_size;
+    prereg->md_map   = context->reg_md_map[UCS_MEMORY_TYPE_HOST] &
+                       context->cache_md_map[UCS_MEMORY_TYPE_HOST];
+
+    status = ucs_spinlock_init(&prereg->lock, 0);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    status = UCS_STATS_NODE_ALLOC(&prereg->stats, &ucp_mem_prereg_stats_class,
+                                  ucs_stats_get_root(), "-%p", context);
+    if (status != UCS_OK) {
+        goto err_destroy_lock;
+    }
+
+    status = ucm_set_event_handler(UCP_MEM_PREREG_EVENTS, 1000,
+                                   ucp_mem_prereg_event_handler, prereg);
+    if (status != UCS_OK) {
+        ucs_diag("failed to install memory pre-registration events: %s",
+                 ucs_status_string(status));
+        UCS_STATS_NODE_FREE(prereg->stats);
+        ucs_spinlock_destroy(&prereg->lock);
+        ucs_free(prereg);
+        return UCS_OK;
+    }
+
+    ucs_debug("context %p: memory pre-registration enabled, sizes %zu..%zu"
+              " md_map 0x%" PRIx64, context, prereg->min_size,
+              prereg->max_size, prereg->md_map);
+    context->prereg = prereg;
+    return UCS_OK;
+
+err_destroy_lock:
+    ucs_spinlock_destroy(&prereg->lock);
+err_free:
+    ucs_free(prereg);
+    return status;
+}
+
+void ucp_mem_prereg_cleanup(ucp_context_h context)
+{
+    ucp_mem_prereg_t *prereg = context->prereg;
+
+    if (prereg == NULL) {
+        return;
+    }
+
+    ucm_unset_event_handler(UCP_MEM_PREREG_EVENTS,
+                            ucp_mem_prereg_event_handler, prereg);
+    UCS_STATS_NODE_FREE(prereg->stats);
+    ucs_spinlock_destroy(&prereg->lock);
+    ucs_free(prereg);
+    context->prereg = NULL;
+}
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2025. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_MM_PREREG_H_
+#define UCP_MM_PREREG_H_
+
+#include "ucp_types.h"
+
+#include <ucs/stats/stats.h>
+#include <ucs/type/spinlock.h>
+#include <ucs/type/status.h>
+
+
+/* Maximal number of mappings waiting for pre-registration */
+#define UCP_MEM_PREREG_QUEUE_SIZE 64
+
+
+/**
+ * Pre-registration statistics counters.
+ */
+enum {
+    /* Number of tracked memory mappings */
+    UCP_MEM_PREREG_STAT_TRACKED,
+    /* Number of mappings dropped because the queue was full or the memory
+       was unmapped before it was pre-registered */
+    UCP_MEM_PREREG_STAT_DROPPED,
+    /* Number of pre-registered regions */
+    UCP_MEM_PREREG_STAT_REGS,
+    /* Total size of pre-registered regions */
+    UCP_MEM_PREREG_STAT_REG_BYTES,
+    /* Number of failed pre-registrations */
+    UCP_MEM_PREREG_STAT_FAILED,
+    /* Host memory lookups served by a pre-registered region */
+    UCP_MEM_PREREG_STAT_HIT,
+    /* Host memory lookups which had to register memory inline */
+    UCP_MEM_PREREG_STAT_MISS,
+    UCP_MEM_PREREG_STAT_LAST
+};
+
+
+/**
+ * Address range of a memory mapping.
+ */
+typedef struct {
+    uintptr_t start;
+    uintptr_t end;
+} ucp_mem_prereg_range_t;
+
+
+/**
+ * Predictive memory pre-registration engine.
+ *
+ * Host memory mappings reported by UCM events are queued from the context of
+ * the mapping thread, and registered in the context registration cache from
+ * worker progress. Adjacent mappings are coalesced into a single region, up
+ * to a configurable maximal size.
+ */
+typedef struct ucp_mem_prereg {
+    ucp_context_h          context;
+    ucs_spinlock_t         lock;      /* Protects the pending queue */
+    size_t                 min_size;  /* Minimal size of a region */
+    size_t                 max_size;  /* Maximal size of a region */
+    ucp_md_map_t           md_map;    /* Memory domains to register on */
+    unsigned               head;      /* First pending range */
+    volatile unsigned      count;     /* Number of pending ranges */
+    ucp_mem_prereg_range_t last;      /* Last pre-registered range */
+    ucp_mem_prereg_range_t queue[UCP_MEM_PREREG_QUEUE_SIZE];
+    UCS_STATS_NODE_DECLARE(stats)
+} ucp_mem_prereg_t;
+
+
+#ifdef ENABLE_STATS
+#define UCP_MEM_PREREG_STAT_HIT(_memh) \
+    if (ucs_unlikely((_memh)->flags & UCP_MEMH_FLAG_PREREG)) { \
+        UCS_STATS_UPDATE_COUNTER((_memh)->context->prereg->stats, \
+                                 UCP_MEM_PREREG_STAT_HIT, 1); \
+    }
+
+#define UCP_MEM_PREREG_STAT_MISS(_context, _mem_type) \
+    if (((_context)->prereg != NULL) && \
+        ((_mem_type) == UCS_MEMORY_TYPE_HOST)) { \
+        UCS_STATS_UPDATE_COUNTER((_context)->prereg->stats, \
+                                 UCP_MEM_PREREG_STAT_MISS, 1); \
+    }
+#else
+#define UCP_MEM_PREREG_STAT_HIT(_memh)
+#define UCP_MEM_PREREG_STAT_MISS(_context, _mem_type)
+#endif
+
+
+ucs_status_t ucp_mem_prereg_init(ucp_context_h context);
+
+
+void ucp_mem_prereg_cleanup(ucp_context_h context);
+
+
+/**
+ * Worker progress callback which registers pending ranges.
+ *
+ * @param [in] arg  Pre-registration engine.
+ *
+ * @return Number of registered regions.
+ */
+unsigned ucp_mem_prereg_progress(void *arg);
+
+#endif
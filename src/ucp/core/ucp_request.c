@@ -28,6 +28,7 @@ static const char *ucp_request_flag_names[] = {
     [ucs_ilog2(UCP_REQUEST_FLAG_COMPLETED)]             = "cpml",
     [ucs_ilog2(UCP_REQUEST_FLAG_RELEASED)]              = "rls",
     [ucs_ilog2(UCP_REQUEST_FLAG_PROTO_SEND)]            = "proto",
+    [ucs_ilog2(UCP_REQUEST_FLAG_PROTO_TAG_SEND)]        = "proto_tag",
     [ucs_ilog2(UCP_REQUEST_FLAG_SYNC_LOCAL_COMPLETED)]  = "loc_cmpl",
     [ucs_ilog2(UCP_REQUEST_FLAG_SYNC_REMOTE_COMPLETED)] = "rm_cmpl",
     [ucs_ilog2(UCP_REQUEST_FLAG_CALLBACK)]              = "cb",
@@ -37,6 +37,7 @@ enum {
     UCP_REQUEST_FLAG_COMPLETED             = UCS_BIT(0),
     UCP_REQUEST_FLAG_RELEASED              = UCS_BIT(1),
     UCP_REQUEST_FLAG_PROTO_SEND            = UCS_BIT(2),
+    UCP_REQUEST_FLAG_PROTO_TAG_SEND        = UCS_BIT(3),
     UCP_REQUEST_FLAG_SYNC_LOCAL_COMPLETED  = UCS_BIT(4),
     UCP_REQUEST_FLAG_SYNC_REMOTE_COMPLETED = UCS_BIT(5),
     UCP_REQUEST_FLAG_CALLBACK              = UCS_BIT(6),
@@ -107,8 +108,10 @@ enum {
                                                          because UCT AM callback is still in
                                                          the call stack and descriptor is not
                                                          initialized yet. */
-    UCP_RECV_DESC_FLAG_RELEASED         = UCS_BIT(10) /* Indicates that the descriptor was
-                                                         released and cannot be used. */
+    UCP_RECV_DESC_FLAG_RELEASED         = UCS_BIT(10), /* Indicates that the descriptor was
+                                                          released and cannot be used. */
+    UCP_RECV_DESC_FLAG_CSUM_ERROR       = UCS_BIT(11)  /* Payload checksum verification
+                                                          failed. */
 };
 
 
@@ -138,6 +141,11 @@ struct ucp_request {
                                                  by protocols */
     };
 
+#ifdef ENABLE_STATS
+    /* Time the operation was posted, for latency histograms */
+    ucs_time_t        start_time;
+#endif
+
     union {
 
         /* "send" part - used for tag_send, am_send, stream_send, put, get, and atomic
@@ -487,6 +495,11 @@ struct ucp_request {
 struct ucp_recv_desc {
     union {
         ucs_list_link_t     tag_list[2];     /* Hash list TAG-element */
+        struct {
+            uint32_t        bin;             /* Unexpected tags bin */
+            uint32_t        index;           /* Index in the bin arrays */
+        } tag_unexp;                         /* Location in unexpected tags
+                                                array TAG-element */
         ucs_queue_elem_t    stream_queue;    /* Queue STREAM-element */
         ucs_queue_elem_t    tag_frag_queue;  /* Tag fragments queue */
         ucp_am_first_desc_t am_first;        /* AM first fragment data needed
@@ -16,6 +16,7 @@
 #include <ucs/profile/profile.h>
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/datastruct/mpool_set.inl>
+#include <ucs/datastruct/mpool_tcache.inl>
 #include <ucs/datastruct/ptr_map.inl>
 #include <ucs/debug/debug_int.h>
 #include <ucp/dt/datatype_iter.inl>
@@ -26,6 +27,19 @@
 UCS_PTR_MAP_IMPL(request, 0);
 
 
+static UCS_F_ALWAYS_INLINE ucp_request_t *ucp_request_mp_get(ucp_worker_h worker)
+{
+#if ENABLE_MT
+    if (ucs_unlikely(worker->flags & UCP_WORKER_FLAG_REQ_TCACHE)) {
+        return (ucp_request_t*)ucs_mpool_tcache_get_inline(
+                &worker->req_tcache);
+    }
+#endif
+
+    return (ucp_request_t*)ucs_mpool_get_inline(&worker->req_mp);
+}
+
+
 #define UCP_REQUEST_FLAGS_FMT \
     "%c%c%c%c%c%c"
 
@@ -56,7 +70,7 @@ UCS_PTR_MAP_IMPL(request, 0);
 /* defined as a macro to print the call site */
 #define ucp_request_get(_worker) \
     ({ \
-        ucp_request_t *_req = ucs_mpool_get_inline(&(_worker)->req_mp); \
+        ucp_request_t *_req = ucp_request_mp_get(_worker); \
         if (_req != NULL) { \
             ucs_trace_req("allocated request %p", _req); \
             ucp_request_reset_internal(_req, _worker); \
@@ -230,6 +244,21 @@ ucp_request_reset_internal(ucp_request_t *req, ucp_worker_h worker)
     ucp_request_id_check(req, ==, UCS_PTR_MAP_KEY_INVALID);
 }
 
+static UCS_F_ALWAYS_INLINE void ucp_request_mp_put(ucp_request_t *req)
+{
+#if ENABLE_MT
+    ucp_worker_h worker = ucs_container_of(ucs_mpool_obj_owner(req),
+                                           ucp_worker_t, req_mp);
+
+    if (ucs_unlikely(worker->flags & UCP_WORKER_FLAG_REQ_TCACHE)) {
+        ucs_mpool_tcache_put_inline(&worker->req_tcache, req);
+        return;
+    }
+#endif
+
+    ucs_mpool_put_inline(req);
+}
+
 static UCS_F_ALWAYS_INLINE void
 ucp_request_put(ucp_request_t *req)
 {
@@ -237,7 +266,7 @@ ucp_request_put(ucp_request_t *req)
     ucp_request_id_check(req, ==, UCS_PTR_MAP_KEY_INVALID);
     UCS_PROFILE_REQUEST_FREE(req);
     UCP_REQUEST_RESET(req);
-    ucs_mpool_put_inline(req);
+    ucp_request_mp_put(req);
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -248,6 +277,11 @@ ucp_request_complete_send(ucp_request_t *req, ucs_status_t status)
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_send", status);
+    if (req->flags &
+        (UCP_REQUEST_FLAG_SEND_TAG | UCP_REQUEST_FLAG_PROTO_TAG_SEND)) {
+        UCP_WORKER_STAT_HIST_TIME(req->send.ep->worker, TAG_SEND,
+                                  req->start_time);
+    }
     /* Coverity wrongly resolves completion callback function to
      * 'ucp_cm_client_connect_progress'/'ucp_cm_server_conn_request_progress'
      */
@@ -264,6 +298,7 @@ ucp_request_complete_tag_recv(ucp_request_t *req, ucs_status_t status)
                   req->recv.tag.info.sender_tag, req->recv.tag.info.length,
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_tag_recv", status);
+    UCP_WORKER_STAT_HIST_TIME(req->recv.worker, TAG_RECV, req->start_time);
     /* coverity[address_free] */
     /* coverity[offset_free] */
     ucp_request_complete(req, recv.tag.cb, status, &req->recv.tag.info,
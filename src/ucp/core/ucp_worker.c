@@ -13,6 +13,7 @@
 #include "ucp_ep_vfs.h"
 #include "ucp_worker.h"
 #include "ucp_rkey.h"
+#include "ucp_mm_prereg.h"
 #include "ucp_request.inl"
 
 #include <ucp/proto/proto_common.inl>
@@ -47,6 +48,9 @@
 #define UCP_WORKER_USAGE_TRACKER_EXP_DECAY_MULTIPLIER 0.8
 #define UCP_WORKER_USAGE_TRACKER_EXP_DECAY_ADDER      0.2
 
+/* Number of keepalive timer wheel ticks in a keepalive interval */
+#define UCP_WORKER_KEEPALIVE_TICKS 64
+
 
 #define UCP_WIFACE_FMT "iface %p (" UCT_TL_RESOURCE_DESC_FMT ")"
 #define UCP_WIFACE_ARG(_wiface) \
@@ -81,11 +85,21 @@ static ucs_stats_class_t ucp_worker_tm_offload_stats_class = {
     }
 };
 
+static const char *ucp_worker_stats_histogram_names[] = {
+    [UCP_WORKER_STAT_HIST_TAG_SEND]  = "tag_send_lat",
+    [UCP_WORKER_STAT_HIST_TAG_RECV]  = "tag_recv_lat",
+    [UCP_WORKER_STAT_HIST_RNDV_RTR]  = "rndv_rtr_lat",
+    [UCP_WORKER_STAT_HIST_EP_CREATE] = "ep_create_lat",
+    [UCP_WORKER_STAT_HIST_WIREUP]    = "wireup_lat"
+};
+
 static ucs_stats_class_t ucp_worker_stats_class = {
-    .name           = "ucp_worker",
-    .num_counters   = UCP_WORKER_STAT_LAST,
-    .class_id       = UCS_STATS_CLASS_ID_INVALID,
-    .counter_names  = {
+    .name            = "ucp_worker",
+    .num_counters    = UCP_WORKER_STAT_LAST,
+    .class_id        = UCS_STATS_CLASS_ID_INVALID,
+    .num_histograms  = UCP_WORKER_STAT_HIST_LAST,
+    .histogram_names = ucp_worker_stats_histogram_names,
+    .counter_names   = {
         [UCP_WORKER_STAT_TAG_RX_EAGER_MSG]         = "tag_rx_eager_msg",
         [UCP_WORKER_STAT_TAG_RX_EAGER_SYNC_MSG]    = "tag_rx_sync_msg",
         [UCP_WORKER_STAT_TAG_RX_EAGER_CHUNK_EXP]   = "tag_rx_eager_chunk_exp",
@@ -97,7 +111,8 @@ static ucs_stats_class_t ucp_worker_stats_class = {
         [UCP_WORKER_STAT_RNDV_GET_ZCOPY]           = "rndv_get_zcopy",
         [UCP_WORKER_STAT_RNDV_RTR]                 = "rndv_rtr",
         [UCP_WORKER_STAT_RNDV_RTR_MTYPE]           = "rndv_rtr_mtype",
-        [UCP_WORKER_STAT_RNDV_RKEY_PTR]            = "rndv_rkey_ptr"
+        [UCP_WORKER_STAT_RNDV_RKEY_PTR]            = "rndv_rkey_ptr",
+        [UCP_WORKER_STAT_PAYLOAD_CSUM_ERROR]       = "payload_csum_error"
     }
 };
 #endif
@@ -1903,6 +1918,15 @@ ucp_worker_print_used_tls(ucp_worker_h worker, ucp_worker_cfg_index_t cfg_index)
     ucs_info("%s", ucs_string_buffer_cstr(&strb));
 }
 
+static void ucp_worker_req_mp_cleanup(ucp_worker_h worker, int leak_check)
+{
+    if (worker->flags & UCP_WORKER_FLAG_REQ_TCACHE) {
+        ucs_mpool_tcache_cleanup(&worker->req_tcache);
+        worker->flags &= ~UCP_WORKER_FLAG_REQ_TCACHE;
+    }
+    ucs_mpool_cleanup(&worker->req_mp, leak_check);
+}
+
 static ucs_status_t ucp_worker_init_mpools(ucp_worker_h worker)
 {
     size_t           max_mp_entry_size = 0;
@@ -1937,6 +1961,19 @@ static ucs_status_t ucp_worker_init_mpools(ucp_worker_h worker)
         goto err;
     }
 
+    /* Multi-threaded workers allocate requests through per-thread caches,
+     * which refill from the request pool in batches */
+    if ((worker->flags & UCP_WORKER_FLAG_THREAD_MULTI) &&
+        (context->config.ext.mt_req_cache > 0)) {
+        status = ucs_mpool_tcache_init(&worker->req_tcache, &worker->req_mp,
+                                       context->config.ext.mt_req_cache);
+        if (status != UCS_OK) {
+            goto err_req_mp_cleanup;
+        }
+
+        worker->flags |= UCP_WORKER_FLAG_REQ_TCACHE;
+    }
+
     if (worker->context->config.ext.rkey_mpool_max_md >= 0) {
         /* Create memory pool for small rkeys.
          *
@@ -2015,7 +2052,7 @@ err_rkey_mp_cleanup:
         ucs_mpool_cleanup(&worker->rkey_mp, 0);
     }
 err_req_mp_cleanup:
-    ucs_mpool_cleanup(&worker->req_mp, 0);
+    ucp_worker_req_mp_cleanup(worker, 0);
 err:
     return status;
 }
@@ -2041,8 +2078,8 @@ static void ucp_worker_destroy_mpools(ucp_worker_h worker)
     if (worker->context->config.ext.rkey_mpool_max_md >= 0) {
         ucs_mpool_cleanup(&worker->rkey_mp, 1);
     }
-    ucs_mpool_cleanup(&worker->req_mp,
-                      !(worker->flags & UCP_WORKER_FLAG_IGNORE_REQUEST_LEAK));
+    ucp_worker_req_mp_cleanup(worker, !(worker->flags &
+                                        UCP_WORKER_FLAG_IGNORE_REQUEST_LEAK));
 }
 
 static unsigned ucp_worker_ep_config_free_cb(void *arg)
@@ -2254,10 +2291,29 @@ static void ucp_worker_keepalive_reset(ucp_worker_h worker)
     worker->keepalive.last_round  = 0;
     worker->keepalive.ep_count    = 0;
     worker->keepalive.iter_count  = 0;
-    worker->keepalive.iter        = &worker->all_eps;
     worker->keepalive.round_count = 0;
 }
 
+static ucs_status_t ucp_worker_keepalive_init(ucp_worker_h worker)
+{
+    ucs_time_t ka_interval = worker->context->config.ext.keepalive_interval;
+
+    ucs_array_init_dynamic(&worker->keepalive.batch);
+
+    /* Wheel resolution is a fraction of the interval, to spread the checks of
+     * endpoints created at different times */
+    return ucs_twheel_init(&worker->keepalive.twheel,
+                           ucs_max(ka_interval / UCP_WORKER_KEEPALIVE_TICKS, 1),
+                           ucs_get_time());
+}
+
+static void ucp_worker_keepalive_cleanup(ucp_worker_h worker)
+{
+    ucs_assert(ucs_array_is_empty(&worker->keepalive.batch));
+    ucs_array_cleanup_dynamic(&worker->keepalive.batch);
+    ucs_twheel_cleanup(&worker->keepalive.twheel);
+}
+
 static void ucp_worker_destroy_configs(ucp_worker_h worker)
 {
     ucp_ep_config_t *ep_config;
@@ -2495,6 +2551,7 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     worker->num_ifaces           = 0;
     worker->am_message_id        = ucs_generate_uuid(0);
     worker->rkey_ptr_cb_id       = UCS_CALLBACKQ_ID_NULL;
+    worker->prereg_cb_id         = UCS_CALLBACKQ_ID_NULL;
     worker->num_all_eps          = 0;
     ucp_worker_keepalive_reset(worker);
     ucs_queue_head_init(&worker->rkey_ptr_reqs);
@@ -2579,11 +2636,16 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
      * of the use-cases. Will be extended automatically otherwise. */
     ucs_array_reserve(&worker->ep_config, 32);
 
+    status = ucp_worker_keepalive_init(worker);
+    if (status != UCS_OK) {
+        goto err_destroy_request_map;
+    }
+
     /* Create statistics */
     status = UCS_STATS_NODE_ALLOC(&worker->stats, &ucp_worker_stats_class,
                                   ucs_stats_get_root(), "-%p", worker);
     if (status != UCS_OK) {
-        goto err_destroy_request_map;
+        goto err_keepalive_cleanup;
     }
 
     status = UCS_STATS_NODE_ALLOC(&worker->tm_offload_stats,
@@ -2648,7 +2710,7 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     }
 
     /* Initialize tag matching */
-    status = ucp_tag_match_init(&worker->tm);
+    status = ucp_tag_match_init(&worker->tm, context);
     if (status != UCS_OK) {
         goto err_destroy_mpools;
     }
@@ -2679,6 +2741,12 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         goto err_am_cleanup;
     }
 
+    if (context->prereg != NULL) {
+        uct_worker_progress_register_safe(worker->uct, ucp_mem_prereg_progress,
+                                          context->prereg, 0,
+                                          &worker->prereg_cb_id);
+    }
+
     *worker_p = worker;
     return UCS_OK;
 
@@ -2705,6 +2773,8 @@ err_free_tm_offload_stats:
     UCS_STATS_NODE_FREE(worker->tm_offload_stats);
 err_free_stats:
     UCS_STATS_NODE_FREE(worker->stats);
+err_keepalive_cleanup:
+    ucp_worker_keepalive_cleanup(worker);
 err_destroy_request_map:
     UCS_PTR_MAP_DESTROY(request, &worker->request_map);
 err_destroy_ep_map:
@@ -2913,6 +2983,7 @@ void ucp_worker_destroy(ucp_worker_h worker)
 
     UCS_ASYNC_BLOCK(&worker->async);
     uct_worker_progress_unregister_safe(worker->uct, &worker->keepalive.cb_id);
+    uct_worker_progress_unregister_safe(worker->uct, &worker->prereg_cb_id);
     ucp_worker_usage_tracker_destroy(worker);
     ucp_worker_discard_uct_ep_cleanup(worker);
     ucp_worker_destroy_eps(worker, &worker->all_eps, "all");
@@ -2958,6 +3029,7 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucs_async_context_cleanup(&worker->async);
     UCS_STATS_NODE_FREE(worker->tm_offload_stats);
     UCS_STATS_NODE_FREE(worker->stats);
+    ucp_worker_keepalive_cleanup(worker);
     UCS_PTR_MAP_DESTROY(request, &worker->request_map);
     UCS_PTR_MAP_DESTROY(ep, &worker->ep_map);
     ucs_strided_alloc_cleanup(&worker->ep_alloc);
@@ -3419,27 +3491,16 @@ ucp_worker_keepalive_complete(ucp_worker_h worker, ucs_time_t now)
     worker->keepalive.round_count++;
 }
 
-static int ucp_worker_do_ep_keepalive(ucp_worker_h worker, ucs_time_t now)
+static int ucp_worker_do_ep_keepalive(ucp_ep_h ep, ucs_time_t now)
 {
+    ucp_worker_h worker = ep->worker;
     ucp_lane_index_t lane;
     ucp_rsc_index_t rsc_index;
     ucs_status_t status;
-    ucp_ep_h ep;
     uct_ep_h uct_ep;
 
     UCP_WORKER_THREAD_CS_CHECK_IS_BLOCKED(worker);
 
-    if (worker->keepalive.iter == &worker->all_eps) {
-        goto out_done;
-    }
-
-    ep = ucs_container_of(worker->keepalive.iter, ucp_ep_ext_t, ep_list)->ep;
-    if ((ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL) ||
-        (ep->flags & UCP_EP_FLAG_FAILED) ||
-        (ucp_ep_config(ep)->key.keepalive_lane == UCP_NULL_LANE)) {
-        goto out_done;
-    }
-
     lane      = ucp_ep_config(ep)->key.keepalive_lane;
     uct_ep    = ucp_ep_get_lane(ep, lane);
     rsc_index = ucp_ep_get_rsc_index(ep, lane);
@@ -3481,26 +3542,131 @@ static int ucp_worker_do_ep_keepalive(ucp_worker_h worker, ucs_time_t now)
     ep->ext->ka_last_round = now;
 #endif
 
-out_done:
-    worker->keepalive.iter = worker->keepalive.iter->next;
     return 1;
 }
 
+/* Delay of the next keepalive check, rounded up to the wheel resolution so the
+ * check is never done earlier than the keepalive interval */
+static UCS_F_ALWAYS_INLINE ucs_time_t
+ucp_worker_keepalive_delay(ucp_worker_h worker)
+{
+    return worker->context->config.ext.keepalive_interval +
+           worker->keepalive.twheel.res;
+}
+
+static int ucp_worker_keepalive_is_ep_valid(ucp_ep_h ep)
+{
+    return (ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL) &&
+           !(ep->flags & UCP_EP_FLAG_FAILED) &&
+           (ucp_ep_config(ep)->key.keepalive_lane != UCP_NULL_LANE);
+}
+
+static void ucp_worker_keepalive_ep_done(ucp_ep_h ep, int is_done)
+{
+    ucp_worker_h worker  = ep->worker;
+    ucs_twheel_t *twheel = &worker->keepalive.twheel;
+
+    if (is_done) {
+        worker->keepalive.ep_count++;
+        ucs_wtimer_add(twheel, &ep->ext->ka_timer,
+                       ucp_worker_keepalive_delay(worker));
+    } else {
+        /* In case if EP has no resources to send keepalive message, retry
+         * on the next tick of the timer wheel */
+        ucs_wtimer_add(twheel, &ep->ext->ka_timer, twheel->res);
+    }
+}
+
+void ucp_worker_keepalive_timer(ucs_wtimer_t *timer)
+{
+    ucp_ep_h ep         = ucs_container_of(timer, ucp_ep_ext_t, ka_timer)->ep;
+    ucp_worker_h worker = ep->worker;
+    ucs_time_t now      = ucs_twheel_get_time(&worker->keepalive.twheel);
+    ucp_ep_h *ep_p;
+
+    if (!ucp_worker_keepalive_is_ep_valid(ep)) {
+        /* The timer is added again when the endpoint lanes are set */
+        return;
+    }
+
+    if ((now - ep->ext->ka_last_rx) <
+        worker->context->config.ext.keepalive_interval) {
+        /* The peer was active recently, check it one interval after that */
+        ucs_wtimer_add(&worker->keepalive.twheel, timer,
+                       ep->ext->ka_last_rx - now +
+                       ucp_worker_keepalive_delay(worker));
+        return;
+    }
+
+    ep_p = ucs_array_append(&worker->keepalive.batch,
+                            ucp_worker_keepalive_ep_done(
+                                    ep, ucp_worker_do_ep_keepalive(ep, now));
+                            return);
+    *ep_p = ep;
+}
+
+static ucp_rsc_index_t ucp_worker_keepalive_ep_rsc(ucp_ep_h ep)
+{
+    return ucp_ep_get_rsc_index(ep, ucp_ep_config(ep)->key.keepalive_lane);
+}
+
+static int ucp_worker_keepalive_ep_compare(const void *elem1,
+                                           const void *elem2)
+{
+    return (int)ucp_worker_keepalive_ep_rsc(*(const ucp_ep_h*)elem1) -
+           (int)ucp_worker_keepalive_ep_rsc(*(const ucp_ep_h*)elem2);
+}
+
+/* Check the endpoints which are due, grouped by transport, and stop checking
+ * the endpoints of a transport once it runs out of resources */
+static void ucp_worker_keepalive_batch_progress(ucp_worker_h worker)
+{
+    ucs_time_t now            = ucs_twheel_get_time(&worker->keepalive.twheel);
+    ucp_ep_ptr_arr_t *batch   = &worker->keepalive.batch;
+    ucp_rsc_index_t rsc_index = UCP_NULL_RESOURCE;
+    int is_done               = 1;
+    unsigned i;
+    ucp_ep_h ep;
+
+    qsort(ucs_array_begin(batch), ucs_array_length(batch), sizeof(ucp_ep_h),
+          ucp_worker_keepalive_ep_compare);
+
+    for (i = 0; i < ucs_array_length(batch); ++i) {
+        ep = ucs_array_elem(batch, i);
+        if ((ep == NULL) || !ucp_worker_keepalive_is_ep_valid(ep)) {
+            continue;
+        }
+
+        if ((i == 0) || (ucp_worker_keepalive_ep_rsc(ep) != rsc_index)) {
+            rsc_index = ucp_worker_keepalive_ep_rsc(ep);
+            is_done   = 1;
+        }
+
+        if (is_done) {
+            is_done = ucp_worker_do_ep_keepalive(ep, now);
+        }
+
+        /* The endpoint could be destroyed by the check */
+        if (ucs_array_elem(batch, i) != NULL) {
+            ucp_worker_keepalive_ep_done(ep, is_done);
+        }
+    }
+
+    ucs_array_clear(batch);
+}
+
 static UCS_F_NOINLINE unsigned
 ucp_worker_do_keepalive_progress(ucp_worker_h worker)
 {
-    unsigned progress_count = 0;
     unsigned max_ep_count   = worker->context->config.ext.keepalive_num_eps;
+    unsigned progress_count = 0;
     ucs_time_t now;
 
-    ucs_assertv(worker->keepalive.ep_count < max_ep_count,
-                "worker %p: ep_count=%u max_ep_count=%u",
-                worker, worker->keepalive.ep_count, max_ep_count);
     ucs_assert(worker->context->config.ext.keepalive_num_eps != 0);
 
     now = ucs_get_time();
     if (ucs_likely((now - worker->keepalive.last_round) <
-                   worker->context->config.ext.keepalive_interval)) {
+                   worker->keepalive.twheel.res)) {
         goto out;
     }
 
@@ -3508,35 +3674,24 @@ ucp_worker_do_keepalive_progress(ucp_worker_h worker)
      * initialized and new EP configuration set from an asynchronous thread
      * when processing WIREUP_MSGs */
     UCS_ASYNC_BLOCK(&worker->async);
-    ucs_trace("worker %p: keepalive round", worker);
 
-    if (ucs_unlikely(ucs_list_is_empty(&worker->all_eps))) {
-        ucs_assert(worker->keepalive.iter == &worker->all_eps);
-        ucs_trace("worker %p: keepalive ep list is empty - disabling",
-                  worker);
+    if (ucs_unlikely(ucs_twheel_is_empty(&worker->keepalive.twheel))) {
+        ucs_trace("worker %p: no endpoints to keepalive - disabling", worker);
         uct_worker_progress_unregister_safe(worker->uct,
                                             &worker->keepalive.cb_id);
         goto out_unblock;
     }
 
-    /* Use own loop for elements because standard for_each skips
-     * head element */
-    /* TODO: use more optimal algo to enumerate EPs to keepalive
-     * (linked list) */
-    do {
-        if (!ucp_worker_do_ep_keepalive(worker, now)) {
-            /* In case if EP has no resources to send keepalive message
-             * then just return without update of last_round timestamp,
-             * on next progress iteration we will continue from this point */
-            goto out_unblock;
-        }
-
-        progress_count++;
-        worker->keepalive.ep_count++;
-    } while ((worker->keepalive.ep_count < max_ep_count) &&
-             (worker->keepalive.iter != &worker->all_eps));
-
-    ucp_worker_keepalive_complete(worker, now);
+    /* Endpoints which are due are checked in batches of up to max_ep_count,
+     * the rest are checked by the following rounds, so the work done by a
+     * single progress call is bounded */
+    worker->keepalive.last_round = now;
+    progress_count = ucs_twheel_sweep_limit(&worker->keepalive.twheel, now,
+                                            max_ep_count);
+    if (progress_count > 0) {
+        ucp_worker_keepalive_batch_progress(worker);
+        ucp_worker_keepalive_complete(worker, now);
+    }
 
 out_unblock:
     UCS_ASYNC_UNBLOCK(&worker->async);
@@ -3559,6 +3714,7 @@ static unsigned ucp_worker_keepalive_progress(void *arg)
 void ucp_worker_keepalive_add_ep(ucp_ep_h ep)
 {
     ucp_worker_h worker = ep->worker;
+    ucs_twheel_t *twheel = &worker->keepalive.twheel;
 
     if (ucp_ep_config(ep)->key.keepalive_lane == UCP_NULL_LANE) {
         ucs_trace("ep %p flags 0x%x cfg_index %d err_mode %d: keepalive lane"
@@ -3570,33 +3726,29 @@ void ucp_worker_keepalive_add_ep(ucp_ep_h ep)
     ucp_worker_keepalive_timerfd_init(worker);
     ucs_trace("ep %p flags 0x%x: set keepalive lane to %u", ep,
               ep->flags, ucp_ep_config(ep)->key.keepalive_lane);
+
+    /* The timer wheel could be idle for a while, so take into account the
+     * time passed since it was last updated */
+    ucs_wtimer_add(twheel, &ep->ext->ka_timer,
+                   ucs_get_time() - ucs_twheel_get_time(twheel) +
+                   ucp_worker_keepalive_delay(worker));
     uct_worker_progress_register_safe(worker->uct,
                                       ucp_worker_keepalive_progress, worker, 0,
                                       &worker->keepalive.cb_id);
 }
 
-/* EP is removed from worker, advance iterator if it points to the EP */
+/* EP is removed from worker, cancel its keepalive timer */
 void ucp_worker_keepalive_remove_ep(ucp_ep_h ep)
 {
     ucp_worker_h worker = ep->worker;
+    ucp_ep_h *ep_p;
 
-    if ((ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL) ||
-        (ucp_ep_config(ep)->key.keepalive_lane == UCP_NULL_LANE)) {
-        return;
-    }
-
-    ucs_assert(!(ep->flags & UCP_EP_FLAG_INTERNAL));
-
-    if (worker->keepalive.iter == &ep->ext->ep_list) {
-        ucs_debug("worker %p: removed keepalive current ep %p, moving to next",
-                  worker, ep);
-        worker->keepalive.iter = worker->keepalive.iter->next;
-        ucs_assert(worker->keepalive.iter != &ep->ext->ep_list);
+    ucs_wtimer_remove(&worker->keepalive.twheel, &ep->ext->ka_timer);
 
-        if (worker->keepalive.iter == &worker->all_eps) {
-            ucs_debug("worker %p: all_eps was reached after %p was removed -"
-                      "complete keepalive", worker, ep);
-            ucp_worker_keepalive_complete(worker, ucs_get_time());
+    /* EP could be removed while the keepalive batch is being checked */
+    ucs_array_for_each(ep_p, &worker->keepalive.batch) {
+        if (*ep_p == ep) {
+            *ep_p = NULL;
         }
     }
 }
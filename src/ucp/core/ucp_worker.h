@@ -17,6 +17,7 @@
 #include <ucp/tag/tag_match.h>
 #include <ucs/datastruct/mpool.h>
 #include <ucs/datastruct/mpool_set.h>
+#include <ucs/datastruct/mpool_tcache.h>
 #include <ucs/datastruct/queue_types.h>
 #include <ucs/datastruct/strided_alloc.h>
 #include <ucs/datastruct/conn_match.h>
@@ -110,7 +111,11 @@ enum {
 
     /** Indicates that UCT EP discarding was disabled on this worker */
     UCP_WORKER_FLAG_DISCARD_DISABLED =
-            UCS_BIT(UCP_WORKER_INTERNAL_FLAGS_SHIFT + 5)
+            UCS_BIT(UCP_WORKER_INTERNAL_FLAGS_SHIFT + 5),
+
+    /** Requests are allocated through per-thread caches on this worker */
+    UCP_WORKER_FLAG_REQ_TCACHE =
+            UCS_BIT(UCP_WORKER_INTERNAL_FLAGS_SHIFT + 6)
 };
 
 
@@ -155,10 +160,31 @@ enum {
     UCP_WORKER_STAT_RNDV_RTR_MTYPE,
     UCP_WORKER_STAT_RNDV_RKEY_PTR,
 
+    /* Number of messages whose payload checksum verification failed */
+    UCP_WORKER_STAT_PAYLOAD_CSUM_ERROR,
+
     UCP_WORKER_STAT_LAST
 };
 
 
+/**
+ * UCP worker statistics histograms, in nanoseconds
+ */
+enum {
+    /* From posting a tag send request until its completion */
+    UCP_WORKER_STAT_HIST_TAG_SEND,
+    /* From posting a tag receive request until its completion */
+    UCP_WORKER_STAT_HIST_TAG_RECV,
+    /* From posting a rendezvous tag send until the first RTR arrives */
+    UCP_WORKER_STAT_HIST_RNDV_RTR,
+    /* Duration of ucp_ep_create() */
+    UCP_WORKER_STAT_HIST_EP_CREATE,
+    /* From creating an endpoint until it is connected to the remote peer */
+    UCP_WORKER_STAT_HIST_WIREUP,
+    UCP_WORKER_STAT_HIST_LAST
+};
+
+
 /**
  * UCP worker tag offload statistics counters
  */
@@ -198,6 +224,19 @@ enum {
     UCS_STATS_UPDATE_COUNTER((_worker)->tm_offload_stats, \
                              UCP_WORKER_STAT_TAG_OFFLOAD_##_name, 1);
 
+#ifdef ENABLE_STATS
+#define UCP_WORKER_STAT_HIST_START(_worker, _start_time) \
+    if ((_worker)->stats != NULL) { \
+        UCS_STATS_START_TIME(_start_time); \
+    }
+#else
+#define UCP_WORKER_STAT_HIST_START(_worker, _start_time)
+#endif
+
+#define UCP_WORKER_STAT_HIST_TIME(_worker, _name, _start_time) \
+    UCS_STATS_UPDATE_HISTOGRAM_TIME((_worker)->stats, \
+                                    UCP_WORKER_STAT_HIST_##_name, _start_time);
+
 #define ucp_worker_mpool_get(_mp) \
     ({ \
         ucp_mem_desc_t *_rdesc = ucs_mpool_get_inline(_mp); \
@@ -234,6 +273,10 @@ typedef khash_t(ucp_worker_mpool_hash) ucp_worker_mpool_hash_t;
 UCS_ARRAY_DECLARE_TYPE(ucp_ep_config_arr_t, unsigned, ucp_ep_config_t);
 
 
+/* Array of endpoints */
+UCS_ARRAY_DECLARE_TYPE(ucp_ep_ptr_arr_t, unsigned, ucp_ep_h);
+
+
 /**
  * UCP worker iface, which encapsulates UCT iface, its attributes and
  * some auxiliary info needed for tag matching offloads.
@@ -282,6 +325,7 @@ typedef struct ucp_worker {
     uint64_t                         client_id;           /* Worker client id for wireup */
     uct_worker_h                     uct;                 /* UCT worker handle */
     ucs_mpool_t                      req_mp;              /* Memory pool for requests */
+    ucs_mpool_tcache_t               req_tcache;          /* Per-thread request caches */
     ucs_mpool_t                      rkey_mp;             /* Pool for small memory keys */
     ucp_tl_bitmap_t                  atomic_tls;          /* Which resources can be used for atomics */
 
@@ -322,6 +366,7 @@ typedef struct ucp_worker {
     ucs_queue_head_t                 rkey_ptr_reqs;       /* Queue of submitted RKEY PTR requests that
                                                            * are in-progress */
     uct_worker_cb_id_t               rkey_ptr_cb_id;      /* RKEY PTR worker callback queue ID */
+    uct_worker_cb_id_t               prereg_cb_id;        /* Memory pre-registration callback ID */
     ucp_tag_match_t                  tm;                  /* Tag-matching queues and offload info */
     ucp_am_info_t                    am;                  /* Array of AM callbacks and their data */
     uint64_t                         am_message_id;       /* For matching long AMs */
@@ -353,7 +398,8 @@ typedef struct ucp_worker {
                                                            * the next keepalive round must be done */
         uct_worker_cb_id_t           cb_id;               /* Keepalive callback id */
         ucs_time_t                   last_round;          /* Last round timestamp */
-        ucs_list_link_t              *iter;               /* Last EP processed keepalive */
+        ucs_twheel_t                 twheel;              /* Keepalive timers of EPs */
+        ucp_ep_ptr_arr_t             batch;               /* EPs to check in current round */
         unsigned                     ep_count;            /* Number of EPs processed in current time slot */
         unsigned                     iter_count;          /* Number of progress iterations to skip,
                                                            * used to minimize call of ucs_get_time */
@@ -416,6 +462,9 @@ int ucp_worker_iface_is_activated(const ucp_worker_iface_t *wiface);
 
 void ucp_worker_keepalive_add_ep(ucp_ep_h );
 
+/* Keepalive timer callback of an endpoint */
+void ucp_worker_keepalive_timer(ucs_wtimer_t *timer);
+
 /* EP should be removed from worker all_eps prior to call this function */
 void ucp_worker_keepalive_remove_ep(ucp_ep_h ep);
 
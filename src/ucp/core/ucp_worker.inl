@@ -259,6 +259,15 @@ static UCS_F_ALWAYS_INLINE void ucp_worker_track_ep_usage(ucp_request_t *req)
     ucp_worker_track_ep_usage_always(req);
 }
 
+/**
+ * Record a message received from the remote peer of the endpoint, so keepalive
+ * does not check the endpoint in the following interval.
+ */
+static UCS_F_ALWAYS_INLINE void ucp_worker_keepalive_rx(ucp_ep_h ep)
+{
+    ep->ext->ka_last_rx = ucs_twheel_get_time(&ep->worker->keepalive.twheel);
+}
+
 #define UCP_WORKER_GET_EP_BY_ID(_ep_p, _worker, _ep_id, _action, _fmt_str, ...) \
     { \
         ucs_status_t __status; \
@@ -269,6 +278,8 @@ static UCS_F_ALWAYS_INLINE void ucp_worker_track_ep_usage(ucp_request_t *req)
                            " was not found, drop" _fmt_str, \
                            _worker, _ep_id, ##__VA_ARGS__); \
             _action; \
+        } else { \
+            ucp_worker_keepalive_rx(*(_ep_p)); \
         } \
     }
 
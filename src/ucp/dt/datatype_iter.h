@@ -48,6 +48,7 @@ typedef struct {
             size_t                count;      /* Count, needed for restart */
             ucp_dt_generic_t      *dt_gen;    /* Generic datatype handle */
             void                  *state;     /* User-defined state */
+            ucp_dt_generic_ppack_t *ppack;    /* Pack-ahead state, or NULL */
         } generic;
         struct {
             const ucp_dt_iov_t    *iov;       /* IOV list */
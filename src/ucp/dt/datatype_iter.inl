@@ -110,6 +110,14 @@ ucp_datatype_generic_iter_init(ucp_context_h context, void *buffer,
     dt_iter->type.generic.dt_gen = dt_gen;
     dt_iter->type.generic.state  = state;
     ucp_memory_info_set_host(&dt_iter->mem_info);
+
+    if (is_pack && (context->dt_pack_pool != NULL) &&
+        (dt_iter->length >= context->config.ext.generic_dt_pack_thresh)) {
+        dt_iter->type.generic.ppack = ucp_dt_generic_ppack_start(
+                context->dt_pack_pool, dt_gen, state, dt_iter->length);
+    } else {
+        dt_iter->type.generic.ppack = NULL;
+    }
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -337,6 +345,9 @@ ucp_datatype_iter_cleanup(ucp_datatype_iter_t *dt_iter, int dereg,
         ucp_datatype_iter_iov_cleanup(dt_iter, dereg);
     } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_GENERIC,
                                           dt_mask)) {
+        if (dt_iter->type.generic.ppack != NULL) {
+            ucp_dt_generic_ppack_finish(dt_iter->type.generic.ppack);
+        }
         dt_iter->type.generic.dt_gen->ops.finish(dt_iter->type.generic.state);
     }
 }
@@ -394,13 +405,17 @@ ucp_datatype_iter_next_pack(const ucp_datatype_iter_t *dt_iter,
                               dt_iter->length);
         break;
     case UCP_DATATYPE_GENERIC:
-        if (max_length != 0) {
+        if (max_length == 0) {
+            length = 0;
+        } else if (dt_iter->type.generic.ppack != NULL) {
+            length = UCS_PROFILE_CALL(ucp_dt_generic_ppack_pack,
+                                      dt_iter->type.generic.ppack,
+                                      dt_iter->offset, dest, max_length);
+        } else {
             dt_gen = dt_iter->type.generic.dt_gen;
             length = UCS_PROFILE_NAMED_CALL("dt_pack", dt_gen->ops.pack,
                                             dt_iter->type.generic.state,
                                             dt_iter->offset, dest, max_length);
-        } else {
-            length = 0;
         }
         break;
     default:
@@ -10,8 +10,55 @@
 
 #include "dt_generic.h"
 
-#include <ucs/sys/math.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/debug/log.h>
 #include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/sys.h>
+#include <pthread.h>
+#include <string.h>
+
+
+typedef enum {
+    UCP_DT_GENERIC_PPACK_SLOT_EMPTY,
+    UCP_DT_GENERIC_PPACK_SLOT_BUSY,   /* Being packed */
+    UCP_DT_GENERIC_PPACK_SLOT_READY   /* Packed, waiting to be sent */
+} ucp_dt_generic_ppack_slot_state_t;
+
+
+typedef struct {
+    ucp_dt_generic_ppack_slot_state_t state;
+    size_t                            chunk;  /* Chunk index held by the slot */
+    size_t                            length; /* Packed length of the chunk */
+} ucp_dt_generic_ppack_slot_t;
+
+
+struct ucp_dt_generic_ppack {
+    ucs_list_link_t             list;       /* Entry in the pool sends list */
+    ucp_dt_generic_pack_pool_t  *pool;
+    ucp_dt_generic_t            *dt_gen;
+    void                        *state;     /* User pack state */
+    size_t                      length;     /* Total packed length */
+    size_t                      num_chunks;
+    size_t                      next_chunk; /* Next chunk to pack ahead */
+    unsigned                    num_slots;
+    unsigned                    num_busy;   /* Slots being packed */
+    void                        *buffer;    /* Staging buffer of all slots */
+    ucp_dt_generic_ppack_slot_t slots[];
+};
+
+
+struct ucp_dt_generic_pack_pool {
+    pthread_mutex_t lock;       /* Protects the pool and all its sends */
+    pthread_cond_t  work_cond;  /* Signaled when a chunk can be packed */
+    pthread_cond_t  done_cond;  /* Signaled when a chunk was packed */
+    ucs_list_link_t sends;      /* Sends with chunks to pack ahead */
+    int             stop;
+    size_t          chunk_size;
+    unsigned        window;     /* Maximal number of chunks packed ahead */
+    unsigned        num_threads;
+    pthread_t       threads[];
+};
 
 
 ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *context,
@@ -48,3 +95,298 @@ void ucp_dt_destroy(ucp_datatype_t datatype)
         break;
     }
 }
+
+
+static UCS_F_ALWAYS_INLINE void *
+ucp_dt_generic_ppack_slot_buffer(const ucp_dt_generic_ppack_t *ppack,
+                                 const ucp_dt_generic_ppack_slot_t *slot)
+{
+    return UCS_PTR_BYTE_OFFSET(ppack->buffer,
+                               (slot - ppack->slots) * ppack->pool->chunk_size);
+}
+
+/* Called with the pool lock held */
+static ucp_dt_generic_ppack_slot_t *
+ucp_dt_generic_ppack_claim(ucp_dt_generic_ppack_t *ppack)
+{
+    ucp_dt_generic_ppack_slot_t *slot;
+
+    if (ppack->next_chunk >= ppack->num_chunks) {
+        return NULL;
+    }
+
+    /* The slot is still used by a chunk which was not sent yet */
+    slot = &ppack->slots[ppack->next_chunk % ppack->num_slots];
+    if (slot->state != UCP_DT_GENERIC_PPACK_SLOT_EMPTY) {
+        return NULL;
+    }
+
+    slot->state = UCP_DT_GENERIC_PPACK_SLOT_BUSY;
+    slot->chunk = ppack->next_chunk++;
+    ++ppack->num_busy;
+    return slot;
+}
+
+/* Called without the pool lock */
+static void ucp_dt_generic_ppack_slot_pack(ucp_dt_generic_ppack_t *ppack,
+                                           ucp_dt_generic_ppack_slot_t *slot)
+{
+    size_t offset = slot->chunk * ppack->pool->chunk_size;
+
+    slot->length = ppack->dt_gen->ops.pack(
+            ppack->state, offset, ucp_dt_generic_ppack_slot_buffer(ppack, slot),
+            ucs_min(ppack->pool->chunk_size, ppack->length - offset));
+}
+
+/* Called with the pool lock held */
+static void ucp_dt_generic_ppack_slot_done(ucp_dt_generic_ppack_t *ppack,
+                                           ucp_dt_generic_ppack_slot_t *slot)
+{
+    slot->state = UCP_DT_GENERIC_PPACK_SLOT_READY;
+    --ppack->num_busy;
+    pthread_cond_broadcast(&ppack->pool->done_cond);
+}
+
+static void *ucp_dt_generic_pack_thread(void *arg)
+{
+    ucp_dt_generic_pack_pool_t *pool = arg;
+    ucp_dt_generic_ppack_slot_t *slot;
+    ucp_dt_generic_ppack_t *ppack;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stop) {
+        slot = NULL;
+        ucs_list_for_each(ppack, &pool->sends, list) {
+            slot = ucp_dt_generic_ppack_claim(ppack);
+            if (slot != NULL) {
+                break;
+            }
+        }
+
+        if (slot == NULL) {
+            pthread_cond_wait(&pool->work_cond, &pool->lock);
+            continue;
+        }
+
+        /* Round-robin between concurrent sends */
+        ucs_list_del(&ppack->list);
+        ucs_list_add_tail(&pool->sends, &ppack->list);
+
+        pthread_mutex_unlock(&pool->lock);
+        ucp_dt_generic_ppack_slot_pack(ppack, slot);
+        pthread_mutex_lock(&pool->lock);
+
+        ucp_dt_generic_ppack_slot_done(ppack, slot);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+ucs_status_t
+ucp_dt_generic_pack_pool_create(unsigned num_threads, size_t chunk_size,
+                                unsigned window,
+                                ucp_dt_generic_pack_pool_t **pool_p)
+{
+    ucp_dt_generic_pack_pool_t *pool;
+    ucs_status_t status;
+    unsigned i;
+
+    if ((chunk_size == 0) || (window == 0)) {
+        ucs_error("invalid generic datatype pack chunk size %zu or window %u",
+                  chunk_size, window);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    pool = ucs_malloc(sizeof(*pool) + (num_threads * sizeof(*pool->threads)),
+                      "ucp_dt_generic_pack_pool");
+    if (pool == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+    ucs_list_head_init(&pool->sends);
+    pool->stop        = 0;
+    pool->chunk_size  = chunk_size;
+    pool->window      = window;
+    pool->num_threads = 0;
+
+    for (i = 0; i < num_threads; ++i) {
+        status = ucs_pthread_create(&pool->threads[i],
+                                    ucp_dt_generic_pack_thread, pool,
+                                    "ucp_dt_pack#%u", i);
+        if (status != UCS_OK) {
+            ucp_dt_generic_pack_pool_destroy(pool);
+            return status;
+        }
+
+        ++pool->num_threads;
+    }
+
+    ucs_debug("created generic datatype pack pool %p with %u threads, "
+              "chunk size %zu window %u", pool, num_threads, chunk_size,
+              window);
+    *pool_p = pool;
+    return UCS_OK;
+}
+
+void ucp_dt_generic_pack_pool_destroy(ucp_dt_generic_pack_pool_t *pool)
+{
+    unsigned i;
+
+    pthread_mutex_lock(&pool->lock);
+    ucs_assertv(ucs_list_is_empty(&pool->sends), "pool=%p", pool);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i = 0; i < pool->num_threads; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->lock);
+    ucs_free(pool);
+}
+
+ucp_dt_generic_ppack_t *
+ucp_dt_generic_ppack_start(ucp_dt_generic_pack_pool_t *pool,
+                           ucp_dt_generic_t *dt_gen, void *state,
+                           size_t length)
+{
+    size_t num_chunks = ucs_div_round_up(length, pool->chunk_size);
+    unsigned num_slots = ucs_min(num_chunks, pool->window);
+    ucp_dt_generic_ppack_t *ppack;
+    unsigned i;
+
+    ppack = ucs_malloc(sizeof(*ppack) + (num_slots * sizeof(*ppack->slots)),
+                       "ucp_dt_generic_ppack");
+    if (ppack == NULL) {
+        goto err;
+    }
+
+    ppack->buffer = ucs_malloc(num_slots * pool->chunk_size,
+                               "ucp_dt_generic_ppack_buffer");
+    if (ppack->buffer == NULL) {
+        goto err_free_ppack;
+    }
+
+    ppack->pool       = pool;
+    ppack->dt_gen     = dt_gen;
+    ppack->state      = state;
+    ppack->length     = length;
+    ppack->num_chunks = num_chunks;
+    ppack->next_chunk = 0;
+    ppack->num_slots  = num_slots;
+    ppack->num_busy   = 0;
+    for (i = 0; i < num_slots; ++i) {
+        ppack->slots[i].state = UCP_DT_GENERIC_PPACK_SLOT_EMPTY;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    ucs_list_add_tail(&pool->sends, &ppack->list);
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    return ppack;
+
+err_free_ppack:
+    ucs_free(ppack);
+err:
+    ucs_debug("failed to allocate pack-ahead state for length %zu", length);
+    return NULL;
+}
+
+size_t ucp_dt_generic_ppack_pack(ucp_dt_generic_ppack_t *ppack, size_t offset,
+                                 void *dest, size_t max_length)
+{
+    ucp_dt_generic_pack_pool_t *pool = ppack->pool;
+    size_t packed_length             = 0;
+    ucp_dt_generic_ppack_slot_t *slot;
+    size_t chunk, chunk_offset, length;
+    void *src;
+
+    pthread_mutex_lock(&pool->lock);
+    while ((packed_length < max_length) && (offset < ppack->length)) {
+        chunk        = offset / pool->chunk_size;
+        chunk_offset = offset % pool->chunk_size;
+        slot         = &ppack->slots[chunk % ppack->num_slots];
+
+        if ((slot->state == UCP_DT_GENERIC_PPACK_SLOT_EMPTY) &&
+            (chunk == ppack->next_chunk)) {
+            /* Helper threads are behind, pack the chunk here */
+            slot = ucp_dt_generic_ppack_claim(ppack);
+            pthread_mutex_unlock(&pool->lock);
+            ucp_dt_generic_ppack_slot_pack(ppack, slot);
+            pthread_mutex_lock(&pool->lock);
+            ucp_dt_generic_ppack_slot_done(ppack, slot);
+            continue;
+        }
+
+        if ((slot->state == UCP_DT_GENERIC_PPACK_SLOT_BUSY) &&
+            (slot->chunk == chunk)) {
+            pthread_cond_wait(&pool->done_cond, &pool->lock);
+            continue;
+        }
+
+        if ((slot->state != UCP_DT_GENERIC_PPACK_SLOT_READY) ||
+            (slot->chunk != chunk) || (chunk_offset >= slot->length)) {
+            /* The chunk is not in the window, for example when the data is
+             * sent again, so pack it directly */
+            pthread_mutex_unlock(&pool->lock);
+            length = ppack->dt_gen->ops.pack(
+                    ppack->state, offset,
+                    UCS_PTR_BYTE_OFFSET(dest, packed_length),
+                    ucs_min(max_length - packed_length,
+                            pool->chunk_size - chunk_offset));
+            pthread_mutex_lock(&pool->lock);
+            if (length == 0) {
+                break;
+            }
+
+            packed_length += length;
+            offset        += length;
+            continue;
+        }
+
+        /* Only the sending thread releases ready slots, so the data can be
+         * copied without the lock */
+        length = ucs_min(slot->length - chunk_offset,
+                         max_length - packed_length);
+        src    = UCS_PTR_BYTE_OFFSET(ucp_dt_generic_ppack_slot_buffer(ppack,
+                                                                      slot),
+                                     chunk_offset);
+        pthread_mutex_unlock(&pool->lock);
+        memcpy(UCS_PTR_BYTE_OFFSET(dest, packed_length), src, length);
+        pthread_mutex_lock(&pool->lock);
+
+        packed_length += length;
+        offset        += length;
+        if ((chunk_offset + length) == slot->length) {
+            /* The chunk was sent, reuse the slot for the next one */
+            slot->state = UCP_DT_GENERIC_PPACK_SLOT_EMPTY;
+            pthread_cond_signal(&pool->work_cond);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return packed_length;
+}
+
+void ucp_dt_generic_ppack_finish(ucp_dt_generic_ppack_t *ppack)
+{
+    ucp_dt_generic_pack_pool_t *pool = ppack->pool;
+
+    pthread_mutex_lock(&pool->lock);
+    ucs_list_del(&ppack->list);
+    while (ppack->num_busy > 0) {
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    ucs_free(ppack->buffer);
+    ucs_free(ppack);
+}
@@ -20,6 +20,19 @@ typedef struct ucp_dt_generic {
 } ucp_dt_generic_t;
 
 
+/**
+ * Pool of helper threads which pack large generic datatype messages ahead of
+ * the network transfer.
+ */
+typedef struct ucp_dt_generic_pack_pool ucp_dt_generic_pack_pool_t;
+
+
+/**
+ * Pack-ahead state of a single generic datatype send.
+ */
+typedef struct ucp_dt_generic_ppack ucp_dt_generic_ppack_t;
+
+
 #define UCP_DT_IS_GENERIC(_datatype) \
     (((_datatype) & UCP_DATATYPE_CLASS_MASK) == UCP_DATATYPE_GENERIC)
 
@@ -37,4 +50,51 @@ ucp_datatype_t ucp_dt_from_generic(ucp_dt_generic_t* dt_gen)
     return ((uintptr_t)dt_gen) | UCP_DATATYPE_GENERIC;
 }
 
+
+ucs_status_t
+ucp_dt_generic_pack_pool_create(unsigned num_threads, size_t chunk_size,
+                                unsigned window,
+                                ucp_dt_generic_pack_pool_t **pool_p);
+
+
+void ucp_dt_generic_pack_pool_destroy(ucp_dt_generic_pack_pool_t *pool);
+
+
+/**
+ * Start packing a generic datatype send ahead on the helper threads.
+ *
+ * The message is split to chunks, and up to a window of chunks is packed to a
+ * staging buffer by calling the datatype pack callback from the helper
+ * threads, concurrently with each other and with the calling thread.
+ *
+ * @param [in]  pool    Helper threads pool.
+ * @param [in]  dt_gen  Generic datatype.
+ * @param [in]  state   Pack state returned by the datatype start_pack.
+ * @param [in]  length  Total packed length of the message.
+ *
+ * @return Pack-ahead state, or NULL if it could not be allocated, in which
+ *         case the message should be packed serially.
+ */
+ucp_dt_generic_ppack_t *
+ucp_dt_generic_ppack_start(ucp_dt_generic_pack_pool_t *pool,
+                           ucp_dt_generic_t *dt_gen, void *state,
+                           size_t length);
+
+
+/**
+ * Pack data at the given offset, copying chunks which were already packed
+ * ahead, and packing the rest in the calling thread.
+ *
+ * @return Number of bytes packed to @a dest.
+ */
+size_t ucp_dt_generic_ppack_pack(ucp_dt_generic_ppack_t *ppack, size_t offset,
+                                 void *dest, size_t max_length);
+
+
+/**
+ * Wait for the helper threads to stop using the pack state, and release the
+ * pack-ahead state. Must be called before the datatype finish callback.
+ */
+void ucp_dt_generic_ppack_finish(ucp_dt_generic_ppack_t *ppack);
+
 #endif
@@ -35,6 +35,7 @@
     _macro(ucp_eager_short_proto) \
     _macro(ucp_eager_bcopy_single_proto) \
     _macro(ucp_eager_zcopy_single_proto) \
+    _macro(ucp_eager_bcopy_single_csum_proto) \
     _macro(ucp_tag_rndv_proto) \
     _macro(ucp_eager_tag_offload_short_proto) \
     _macro(ucp_eager_sync_bcopy_single_proto) \
@@ -76,7 +76,10 @@ typedef enum {
 
     /* Supports starting the request when its datatype iterator offset is > 0 */
     UCP_PROTO_COMMON_INIT_FLAG_RESUME        = UCS_BIT(10),
-    UCP_PROTO_COMMON_KEEP_MD_MAP             = UCS_BIT(11)
+    UCP_PROTO_COMMON_KEEP_MD_MAP             = UCS_BIT(11),
+
+    /* Checksum of the payload is calculated by both sender and receiver */
+    UCP_PROTO_COMMON_INIT_FLAG_PAYLOAD_CSUM  = UCS_BIT(12)
 } ucp_proto_common_init_flags_t;
 
 
@@ -483,6 +483,26 @@ ucp_proto_init_add_buffer_perf(const ucp_proto_common_init_params_t *params,
     return status;
 }
 
+static ucs_status_t
+ucp_proto_init_add_payload_csum_time(
+        const ucp_proto_common_init_params_t *params, size_t range_start,
+        size_t range_end, ucp_proto_perf_t *perf)
+{
+    ucp_context_h context                 = params->super.worker->context;
+    ucp_proto_perf_factors_t perf_factors = UCP_PROTO_PERF_FACTORS_INITIALIZER;
+    ucp_proto_perf_node_t *perf_node;
+    ucs_linear_func_t csum_time;
+
+    csum_time = ucs_linear_func_make(
+            0, 1.0 / context->config.ext.payload_checksum_bw);
+    perf_factors[UCP_PROTO_PERF_FACTOR_LOCAL_CPU]  = csum_time;
+    perf_factors[UCP_PROTO_PERF_FACTOR_REMOTE_CPU] = csum_time;
+
+    perf_node = ucp_proto_perf_node_new_data("payload checksum", "crc32c");
+    return ucp_proto_perf_add_funcs(perf, range_start, range_end, perf_factors,
+                                    perf_node, NULL);
+}
+
 static int
 ucp_proto_common_check_mem_access(const ucp_proto_common_init_params_t *params)
 {
@@ -545,6 +565,14 @@ ucs_status_t ucp_proto_init_perf(const ucp_proto_common_init_params_t *params,
             goto err_cleanup_perf;
         }
 
+        if (params->flags & UCP_PROTO_COMMON_INIT_FLAG_PAYLOAD_CSUM) {
+            status = ucp_proto_init_add_payload_csum_time(
+                    params, ucs_max(1, range_start), range_end, perf);
+            if (status != UCS_OK) {
+                goto err_cleanup_perf;
+            }
+        }
+
         /* Add range that represents sending many fragments */
         if ((range_end < params->max_length) &&
             !(params->flags & UCP_PROTO_COMMON_INIT_FLAG_SINGLE_FRAG)) {
@@ -13,6 +13,7 @@
 #include <ucp/proto/proto_init.h>
 #include <ucp/proto/proto_debug.h>
 #include <ucp/proto/proto_common.inl>
+#include <ucs/algorithm/crc.h>
 
 
 static void
@@ -680,12 +681,65 @@ ucs_status_t ucp_proto_rndv_ats_complete(ucp_request_t *req)
     return ucp_proto_rndv_recv_complete(req);
 }
 
+ucs_status_t
+ucp_proto_rndv_ats_csum_check(ucp_worker_h worker, ucp_request_t *req,
+                              const ucp_rndv_ack_csum_hdr_t *csum_hdr)
+{
+    const ucp_datatype_iter_t *dt_iter = &req->send.state.dt_iter;
+
+    if ((csum_hdr->super.size != dt_iter->length) ||
+        (dt_iter->dt_class != UCP_DATATYPE_CONTIG) ||
+        !UCP_MEM_IS_HOST(dt_iter->mem_info.type) ||
+        (ucs_crc32c(0, dt_iter->type.contig.buffer, dt_iter->length) ==
+         csum_hdr->csum)) {
+        return UCS_OK;
+    }
+
+    ucs_diag("worker %p: payload checksum mismatch in rendezvous request %p "
+             "length %zu", worker, req, dt_iter->length);
+    UCS_STATS_UPDATE_COUNTER(worker->stats, UCP_WORKER_STAT_PAYLOAD_CSUM_ERROR,
+                             1);
+    return UCS_ERR_IO_ERROR;
+}
+
+static size_t ucp_proto_rndv_pack_ats_csum(void *dest, void *arg)
+{
+    ucp_request_t *req                = arg;
+    ucp_rndv_ack_csum_hdr_t *csum_hdr = dest;
+
+    ucp_proto_rndv_common_pack_ack(&csum_hdr->super, req);
+    csum_hdr->csum = ucs_crc32c(0, req->send.state.dt_iter.type.contig.buffer,
+                                req->send.state.dt_iter.length);
+    return sizeof(*csum_hdr);
+}
+
+/* Check if the ATS should carry the checksum of the received data */
+static int ucp_proto_rndv_ats_need_csum(ucp_request_t *req)
+{
+    return req->send.ep->worker->context->config.ext.payload_checksum &&
+           (ucp_proto_select_op_id(&req->send.proto_config->select_param) ==
+            UCP_OP_ID_RNDV_RECV) &&
+           (req->send.state.dt_iter.dt_class == UCP_DATATYPE_CONTIG) &&
+           UCP_MEM_IS_HOST(req->send.state.dt_iter.mem_info.type) &&
+           (req->send.state.dt_iter.length > 0);
+}
+
 ucs_status_t ucp_proto_rndv_ats_progress(uct_pending_req_t *uct_req)
 {
-    ucp_request_t *req = ucs_container_of(uct_req, ucp_request_t, send.uct);
+    ucp_request_t *req                     = ucs_container_of(uct_req,
+                                                              ucp_request_t,
+                                                              send.uct);
+    const ucp_proto_rndv_ack_priv_t *apriv = req->send.proto_config->priv;
+
+    if (ucs_unlikely(ucp_proto_rndv_ats_need_csum(req))) {
+        return ucp_proto_am_bcopy_single_progress(
+                req, UCP_AM_ID_RNDV_ATS, apriv->lane,
+                ucp_proto_rndv_pack_ats_csum, req,
+                sizeof(ucp_rndv_ack_csum_hdr_t), ucp_proto_rndv_ats_complete,
+                0);
+    }
 
-    return ucp_proto_rndv_ack_progress(req, req->send.proto_config->priv,
-                                       UCP_AM_ID_RNDV_ATS,
+    return ucp_proto_rndv_ack_progress(req, apriv, UCP_AM_ID_RNDV_ATS,
                                        ucp_proto_rndv_common_pack_ack,
                                        ucp_proto_rndv_ats_complete);
 }
@@ -849,7 +903,7 @@ UCS_PROFILE_FUNC_VOID(ucp_proto_rndv_receive_start,
                                        rkey_buffer, rkey_length, sg_count);
     if (status != UCS_OK) {
         ucp_datatype_iter_cleanup(&req->send.state.dt_iter, 1, UCP_DT_MASK_ALL);
-        ucs_mpool_put(req);
+        ucp_request_mp_put(req);
         return;
     }
 
@@ -923,6 +977,10 @@ ucp_proto_rndv_handle_rtr(void *arg, void *data, size_t length, unsigned flags)
     ucp_trace_req(req, "recv RTR offset %zu length %zu/%zu req %p", rtr->offset,
                   rtr->size, req->send.state.dt_iter.length, req);
 
+    if ((req->flags & UCP_REQUEST_FLAG_PROTO_TAG_SEND) && (rtr->offset == 0)) {
+        UCP_WORKER_STAT_HIST_TIME(worker, RNDV_RTR, req->start_time);
+    }
+
     if (req->flags & UCP_REQUEST_FLAG_OFFLOADED) {
         ucp_tag_offload_cancel_rndv(req);
         ucs_assert(!ucp_ep_use_indirect_id(req->send.ep));
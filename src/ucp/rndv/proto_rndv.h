@@ -189,6 +189,12 @@ size_t ucp_proto_rndv_common_pack_ack(void *dest, void *arg);
 
 ucs_status_t ucp_proto_rndv_ats_complete(ucp_request_t *req);
 
+
+ucs_status_t
+ucp_proto_rndv_ats_csum_check(ucp_worker_h worker, ucp_request_t *req,
+                              const ucp_rndv_ack_csum_hdr_t *csum_hdr);
+
+
 void ucp_proto_rndv_bulk_query(const ucp_proto_query_params_t *params,
                                ucp_proto_query_attr_t *attr);
 
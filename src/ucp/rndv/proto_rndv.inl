@@ -63,6 +63,17 @@ ucp_proto_rndv_rts_request_init(ucp_request_t *req)
     return UCS_OK;
 }
 
+/* Returns the init flags of a protocol which sends the checksum of the received
+ * data in ATS */
+static UCS_F_ALWAYS_INLINE unsigned
+ucp_proto_rndv_ats_csum_flags(const ucp_proto_init_params_t *init_params)
+{
+    return (init_params->worker->context->config.ext.payload_checksum &&
+            UCP_MEM_IS_HOST(init_params->select_param->mem_type)) ?
+                   UCP_PROTO_COMMON_INIT_FLAG_PAYLOAD_CSUM :
+                   0;
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_proto_rndv_ats_handler(void *arg, void *data, size_t length, unsigned flags)
 {
@@ -82,6 +93,13 @@ ucp_proto_rndv_ats_handler(void *arg, void *data, size_t length, unsigned flags)
     if (length >= sizeof(*ats)) {
         /* ATS message carries a size field */
         ats = ucs_derived_of(rephdr, ucp_rndv_ack_hdr_t);
+        if (ucs_unlikely(length >= sizeof(ucp_rndv_ack_csum_hdr_t)) &&
+            (status == UCS_OK)) {
+            /* ATS message carries the checksum of the received data */
+            status = ucp_proto_rndv_ats_csum_check(
+                    worker, req, ucs_derived_of(ats, ucp_rndv_ack_csum_hdr_t));
+        }
+
         if (!ucp_proto_common_frag_complete(req, ats->size, "rndv_ats")) {
             return UCS_OK; /* Not completed */
         }
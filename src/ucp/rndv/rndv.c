@@ -2289,6 +2289,11 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_rtr_handler,
                   "0x%"PRIx64, rndv_rtr_hdr->address, rndv_rtr_hdr->rreq_id);
     UCS_PROFILE_REQUEST_EVENT(sreq, "rndv_rtr_recv", 0);
 
+    if ((sreq->flags & UCP_REQUEST_FLAG_SEND_TAG) &&
+        (rndv_rtr_hdr->offset == 0)) {
+        UCP_WORKER_STAT_HIST_TIME(worker, RNDV_RTR, sreq->start_time);
+    }
+
     if (sreq->flags & UCP_REQUEST_FLAG_OFFLOADED) {
         /* Do not deregister memory here, because am zcopy rndv may
          * need it registered (if am and tag is the same lane). */
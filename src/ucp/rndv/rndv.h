@@ -74,6 +74,17 @@ typedef struct {
 } UCS_S_PACKED ucp_rndv_ack_hdr_t;
 
 
+/*
+ * RNDV_ATS with checksum of the received data
+ */
+typedef struct {
+    ucp_rndv_ack_hdr_t super;
+
+    /* CRC32C of the received data */
+    uint32_t           csum;
+} UCS_S_PACKED ucp_rndv_ack_csum_hdr_t;
+
+
 ucs_status_t ucp_rndv_send_rts(ucp_request_t *sreq, uct_pack_callback_t pack_cb,
                                size_t rts_body_size);
 
@@ -22,6 +22,8 @@
     "eager " UCP_PROTO_COPY_IN_DESC " " UCP_PROTO_COPY_OUT_DESC
 #define UCP_PROTO_EAGER_ZCOPY_DESC \
     "eager " UCP_PROTO_ZCOPY_DESC " " UCP_PROTO_COPY_OUT_DESC
+#define UCP_PROTO_EAGER_CSUM_DESC \
+    UCP_PROTO_EAGER_BCOPY_DESC " with checksum"
 
 /*
  * EAGER_ONLY, EAGER_MIDDLE
@@ -31,6 +33,13 @@ typedef struct {
 } UCS_S_PACKED ucp_eager_hdr_t;
 
 
+/*
+ * EAGER_ONLY_CSUM message is an EAGER_ONLY message followed by the CRC32C
+ * checksum of its payload
+ */
+typedef uint32_t ucp_eager_csum_t;
+
+
 /*
  * EAGER_FIRST
  */
@@ -93,7 +102,10 @@ ucp_tag_eager_check_op_id(const ucp_proto_init_params_t *init_params,
 {
     return ucp_proto_init_check_op(init_params, UCS_BIT(op_id)) &&
            (offload_enabled ==
-            ucp_ep_config_key_has_tag_lane(init_params->ep_config_key));
+            ucp_ep_config_key_has_tag_lane(init_params->ep_config_key)) &&
+           /* Only the checksum protocol is used when payload checksum is
+            * enabled */
+           !init_params->worker->context->config.ext.payload_checksum;
 }
 
 #endif
@@ -14,6 +14,7 @@
 
 #include <ucp/core/ucp_context.h>
 #include <ucp/core/ucp_worker.h>
+#include <ucs/algorithm/crc.h>
 #include <ucs/datastruct/queue.h>
 #include <ucp/core/ucp_request.inl>
 
@@ -105,6 +106,10 @@ ucp_eager_tagged_handler(void *arg, void *data, size_t length, unsigned am_flags
             req->recv.tag.info.length = recv_len;
             status = ucp_request_recv_data_unpack(req, payload, recv_len, 0, 0,
                                                   1);
+            if (ucs_unlikely(flags & UCP_RECV_DESC_FLAG_CSUM_ERROR) &&
+                (status == UCS_OK)) {
+                status = UCS_ERR_IO_ERROR;
+            }
             ucp_request_complete_tag_recv(req, status);
         } else {
             /* Multi fragment tag offload flow does not use this handler */
@@ -146,6 +151,36 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_only_handler,
                                     "eager_only_handler");
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_only_csum_handler,
+                 (arg, data, length, am_flags),
+                 void *arg, void *data, size_t length, unsigned am_flags)
+{
+    ucp_worker_h worker        = arg;
+    ucp_eager_hdr_t *eager_hdr = data;
+    uint16_t flags             = UCP_RECV_DESC_FLAG_EAGER |
+                                 UCP_RECV_DESC_FLAG_EAGER_ONLY;
+    ucp_eager_csum_t csum;
+    size_t msg_length;
+
+    ucs_assert(length >= (sizeof(*eager_hdr) + sizeof(csum)));
+    msg_length = length - sizeof(csum);
+    memcpy(&csum, UCS_PTR_BYTE_OFFSET(data, msg_length), sizeof(csum));
+
+    if (ucs_unlikely(ucs_crc32c(0, eager_hdr + 1,
+                                msg_length - sizeof(*eager_hdr)) != csum)) {
+        ucs_diag("worker %p: payload checksum mismatch in eager message with "
+                 "tag 0x%" PRIx64 " length %zu", worker, eager_hdr->super.tag,
+                 msg_length - sizeof(*eager_hdr));
+        UCS_STATS_UPDATE_COUNTER(worker->stats,
+                                 UCP_WORKER_STAT_PAYLOAD_CSUM_ERROR, 1);
+        flags |= UCP_RECV_DESC_FLAG_CSUM_ERROR;
+    }
+
+    return ucp_eager_tagged_handler(arg, data, msg_length, am_flags, flags,
+                                    sizeof(ucp_eager_hdr_t), 0,
+                                    "eager_only_csum_handler");
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_first_handler,
                  (arg, data, length, am_flags),
                  void *arg, void *data, size_t length, unsigned am_flags)
@@ -502,6 +537,10 @@ static void ucp_eager_dump(ucp_worker_h worker, uct_am_trace_type_t type,
         snprintf(buffer, max, "EGR_O tag %"PRIx64, eager_hdr->super.tag);
         header_len = sizeof(*eager_hdr);
         break;
+    case UCP_AM_ID_EAGER_ONLY_CSUM:
+        snprintf(buffer, max, "EGR_OC tag %"PRIx64, eager_hdr->super.tag);
+        header_len = sizeof(*eager_hdr);
+        break;
     case UCP_AM_ID_EAGER_FIRST:
         snprintf(buffer, max, "EGR_F tag %"PRIx64" msgid %"PRIx64" len %zu",
                  eager_first_hdr->super.super.tag, eager_first_hdr->msg_id,
@@ -553,6 +592,8 @@ static void ucp_eager_dump(ucp_worker_h worker, uct_am_trace_type_t type,
 
 UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_ONLY,
                          ucp_eager_only_handler, ucp_eager_dump, 0);
+UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_ONLY_CSUM,
+                         ucp_eager_only_csum_handler, ucp_eager_dump, 0);
 UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_FIRST,
                          ucp_eager_first_handler, ucp_eager_dump, 0);
 UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_MIDDLE,
@@ -12,6 +12,7 @@
 
 #include <ucp/core/ucp_mm.h>
 #include <ucp/core/ucp_worker.h>
+#include <ucs/algorithm/crc.h>
 #include <ucs/sys/string.h>
 
 #include <ucp/core/ucp_request.inl>
@@ -118,8 +119,9 @@ static ucs_status_t ucp_eager_bcopy_single_progress(uct_pending_req_t *self)
             req, SIZE_MAX, ucp_proto_request_bcopy_complete_success, 1);
 }
 
-static void
-ucp_proto_eager_bcopy_single_probe(const ucp_proto_init_params_t *init_params)
+static void ucp_proto_eager_bcopy_single_common_probe(
+        const ucp_proto_init_params_t *init_params, size_t trailer_size,
+        unsigned flags)
 {
     ucp_context_t *context                = init_params->worker->context;
     ucp_proto_single_init_params_t params = {
@@ -134,10 +136,11 @@ ucp_proto_eager_bcopy_single_probe(const ucp_proto_init_params_t *init_params)
         .super.min_frag_offs = UCP_PROTO_COMMON_OFFSET_INVALID,
         .super.max_frag_offs = ucs_offsetof(uct_iface_attr_t, cap.am.max_bcopy),
         .super.max_iov_offs  = UCP_PROTO_COMMON_OFFSET_INVALID,
-        .super.hdr_size      = sizeof(ucp_tag_hdr_t),
+        .super.hdr_size      = sizeof(ucp_tag_hdr_t) + trailer_size,
         .super.send_op       = UCT_EP_OP_AM_BCOPY,
         .super.memtype_op    = UCT_EP_OP_GET_SHORT,
-        .super.flags         = UCP_PROTO_COMMON_INIT_FLAG_SINGLE_FRAG |
+        .super.flags         = flags |
+                               UCP_PROTO_COMMON_INIT_FLAG_SINGLE_FRAG |
                                UCP_PROTO_COMMON_INIT_FLAG_CAP_SEG_SIZE |
                                UCP_PROTO_COMMON_INIT_FLAG_ERR_HANDLING,
         .super.exclude_map   = 0,
@@ -146,12 +149,18 @@ ucp_proto_eager_bcopy_single_probe(const ucp_proto_init_params_t *init_params)
         .tl_cap_flags        = UCT_IFACE_FLAG_AM_BCOPY
     };
 
+    ucp_proto_single_probe(&params);
+}
+
+static void
+ucp_proto_eager_bcopy_single_probe(const ucp_proto_init_params_t *init_params)
+{
     /* AM based proto can not be used if tag offload lane configured */
     if (!ucp_tag_eager_check_op_id(init_params, UCP_OP_ID_TAG_SEND, 0)) {
         return;
     }
 
-    ucp_proto_single_probe(&params);
+    ucp_proto_eager_bcopy_single_common_probe(init_params, 0, 0);
 }
 
 ucp_proto_t ucp_eager_bcopy_single_proto = {
@@ -165,6 +174,58 @@ ucp_proto_t ucp_eager_bcopy_single_proto = {
     .reset    = ucp_proto_request_bcopy_reset
 };
 
+static size_t ucp_eager_single_csum_pack(void *dest, void *arg)
+{
+    size_t packed_size = ucp_eager_single_pack(dest, arg);
+    ucp_eager_csum_t csum;
+
+    csum = ucs_crc32c(0, UCS_PTR_BYTE_OFFSET(dest, sizeof(ucp_eager_hdr_t)),
+                      packed_size - sizeof(ucp_eager_hdr_t));
+
+    /* The trailer is not aligned */
+    memcpy(UCS_PTR_BYTE_OFFSET(dest, packed_size), &csum, sizeof(csum));
+    return packed_size + sizeof(csum);
+}
+
+static ucs_status_t
+ucp_eager_bcopy_single_csum_progress(uct_pending_req_t *self)
+{
+    ucp_request_t                   *req = ucs_container_of(self, ucp_request_t,
+                                                            send.uct);
+    const ucp_proto_single_priv_t *spriv = req->send.proto_config->priv;
+
+    return ucp_proto_am_bcopy_single_progress(
+            req, UCP_AM_ID_EAGER_ONLY_CSUM, spriv->super.lane,
+            ucp_eager_single_csum_pack, req, SIZE_MAX,
+            ucp_proto_request_bcopy_complete_success, 1);
+}
+
+static void ucp_proto_eager_bcopy_single_csum_probe(
+        const ucp_proto_init_params_t *init_params)
+{
+    if (!init_params->worker->context->config.ext.payload_checksum ||
+        !ucp_proto_init_check_op(init_params, UCS_BIT(UCP_OP_ID_TAG_SEND)) ||
+        /* AM based proto can not be used if tag offload lane configured */
+        ucp_ep_config_key_has_tag_lane(init_params->ep_config_key)) {
+        return;
+    }
+
+    ucp_proto_eager_bcopy_single_common_probe(
+            init_params, sizeof(ucp_eager_csum_t),
+            UCP_PROTO_COMMON_INIT_FLAG_PAYLOAD_CSUM);
+}
+
+ucp_proto_t ucp_eager_bcopy_single_csum_proto = {
+    .name     = "egr/single/csum",
+    .desc     = UCP_PROTO_EAGER_CSUM_DESC,
+    .flags    = 0,
+    .probe    = ucp_proto_eager_bcopy_single_csum_probe,
+    .query    = ucp_proto_single_query,
+    .progress = {ucp_eager_bcopy_single_csum_progress},
+    .abort    = ucp_proto_request_bcopy_abort,
+    .reset    = ucp_proto_request_bcopy_reset
+};
+
 static void
 ucp_proto_eager_zcopy_single_probe(const ucp_proto_init_params_t *init_params)
 {
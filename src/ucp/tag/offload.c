@@ -80,11 +80,15 @@ ucp_tag_offload_release_buf(ucp_request_t *req)
 UCS_PROFILE_FUNC_VOID(ucp_tag_offload_tag_consumed, (self),
                       uct_tag_context_t *self)
 {
-    ucp_request_t *req = ucs_container_of(self, ucp_request_t, recv.uct_ctx);
-    ucs_queue_head_t *queue;
-
-    queue = &ucp_tag_exp_get_req_queue(&req->recv.worker->tm, req)->queue;
-    ucs_queue_remove(queue, &req->recv.queue);
+    ucp_request_t *req  = ucs_container_of(self, ucp_request_t, recv.uct_ctx);
+    ucp_tag_match_t *tm = &req->recv.worker->tm;
+    ucp_request_queue_t *req_queue;
+
+    req_queue = ucp_tag_exp_get_req_queue(tm, req);
+    ucs_queue_remove(&req_queue->queue, &req->recv.queue);
+    tm->expected.mask_index.count -=
+            ucp_tag_exp_is_mask_class_queue(tm, req->recv.tag.tag_mask,
+                                            req_queue);
 }
 
 /* Message is scattered to user buffer by the transport, complete the request */
@@ -453,6 +457,7 @@ UCS_PROFILE_FUNC(int, ucp_tag_offload_post, (req, req_queue),
             return 0;
         }
     } else if (worker->tm.expected.wildcard.sw_count ||
+               worker->tm.expected.mask_index.sw_count ||
                (req_queue->sw_count && !ucp_tag_offload_post_sw_reqs(req, req_queue))) {
         /* There are some requests which must be completed in SW */
         UCP_WORKER_STAT_TAG_OFFLOAD(worker, BLOCK_SW_PEND);
@@ -108,6 +108,9 @@ ucp_tag_offload_try_post(ucp_worker_t *worker, ucp_request_t *req,
 
     ++worker->tm.expected.sw_all_count;
     ++req_queue->sw_count;
+    worker->tm.expected.mask_index.sw_count +=
+            ucp_tag_exp_is_mask_class_queue(&worker->tm,
+                                            req->recv.tag.tag_mask, req_queue);
     req_queue->block_count += !!(req->flags & UCP_REQUEST_FLAG_BLOCK_OFFLOAD);
 }
 
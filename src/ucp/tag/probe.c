@@ -59,7 +59,7 @@ UCS_PROFILE_FUNC(ucp_tag_message_h, ucp_tag_probe_nb,
         }
 
         if (rem) {
-             ucp_tag_unexp_remove(rdesc);
+             ucp_tag_unexp_remove(&worker->tm, rdesc);
         }
 
         ucs_trace_req(
@@ -10,36 +10,86 @@
 
 #include "tag_match.inl"
 #include <ucp/tag/offload.h>
+#include <ucs/arch/cpu.h>
 
 
-ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm)
+/* Minimal length of a bin array which is compacted when most of its elements
+ * were removed */
+#define UCP_TAG_UNEXP_BIN_COMPACT_MIN 64
+
+
+static void ucp_tag_exp_queue_init(ucp_request_queue_t *req_queue)
+{
+    req_queue->sw_count    = 0;
+    req_queue->block_count = 0;
+    ucs_queue_head_init(&req_queue->queue);
+}
+
+ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm, ucp_context_h context)
 {
+    unsigned max_mask_classes = context->config.ext.tm_mask_classes;
+    unsigned num_unexp_bins   = context->config.ext.tm_unexp_bins;
     size_t hash_size, bucket;
+    unsigned bin;
 
     hash_size = ucs_roundup_pow2(UCP_TAG_MATCH_HASH_SIZE);
 
     tm->expected.sn           = 0;
     tm->expected.sw_all_count = 0;
-    ucs_queue_head_init(&tm->expected.wildcard.queue);
+    ucp_tag_exp_queue_init(&tm->expected.wildcard);
     ucs_list_head_init(&tm->unexpected.all);
 
+    tm->expected.mask_index.classes     = NULL;
+    tm->expected.mask_index.num_classes = 0;
+    tm->expected.mask_index.max_classes = max_mask_classes;
+    tm->expected.mask_index.count       = 0;
+    tm->expected.mask_index.sw_count    = 0;
+
+    tm->unexpected.array.bins        = NULL;
+    tm->unexpected.array.num_bins    = num_unexp_bins;
+    tm->unexpected.array.count       = 0;
+    tm->unexpected.array.sender_mask = context->config.tag_sender_mask;
+    tm->unexpected.array.sn          = 0;
+
     tm->expected.hash = ucs_malloc(sizeof(*tm->expected.hash) * hash_size,
                                    "ucp_tm_exp_hash");
     if (tm->expected.hash == NULL) {
-        return UCS_ERR_NO_MEMORY;
+        goto err;
     }
 
     tm->unexpected.hash = ucs_malloc(sizeof(*tm->unexpected.hash) * hash_size,
                                      "ucp_tm_unexp_hash");
     if (tm->unexpected.hash == NULL) {
-        ucs_free(tm->expected.hash);
-        return UCS_ERR_NO_MEMORY;
+        goto err_free_exp_hash;
+    }
+
+    if (max_mask_classes > 0) {
+        tm->expected.mask_index.classes = ucs_calloc(
+                max_mask_classes, sizeof(*tm->expected.mask_index.classes),
+                "ucp_tm_mask_classes");
+        if (tm->expected.mask_index.classes == NULL) {
+            goto err_free_unexp_hash;
+        }
+    }
+
+    if (num_unexp_bins > 0) {
+        tm->unexpected.array.bins = ucs_malloc(
+                num_unexp_bins * sizeof(*tm->unexpected.array.bins),
+                "ucp_tm_unexp_bins");
+        if (tm->unexpected.array.bins == NULL) {
+            goto err_free_mask_classes;
+        }
+
+        for (bin = 0; bin < num_unexp_bins; ++bin) {
+            ucs_array_init_dynamic(&tm->unexpected.array.bins[bin].tags);
+            ucs_array_init_dynamic(&tm->unexpected.array.bins[bin].descs);
+            tm->unexpected.array.bins[bin].first = 0;
+            tm->unexpected.array.bins[bin].count = 0;
+        }
     }
 
     for (bucket = 0; bucket < hash_size; ++bucket) {
-        tm->expected.hash[bucket].sw_count    = 0;
-        tm->expected.hash[bucket].block_count = 0;
-        ucs_queue_head_init(&tm->expected.hash[bucket].queue);
+        ucp_tag_exp_queue_init(&tm->expected.hash[bucket]);
         ucs_list_head_init(&tm->unexpected.hash[bucket]);
     }
 
@@ -51,28 +101,71 @@ ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm)
     tm->offload.iface        = NULL;
 
     return UCS_OK;
+
+err_free_mask_classes:
+    ucs_free(tm->expected.mask_index.classes);
+err_free_unexp_hash:
+    ucs_free(tm->unexpected.hash);
+err_free_exp_hash:
+    ucs_free(tm->expected.hash);
+err:
+    return UCS_ERR_NO_MEMORY;
+}
+
+static void ucp_tag_unexp_array_cleanup(ucp_tag_match_t *tm)
+{
+    ucp_tag_unexp_bin_t *bin;
+    ucp_tag_unexp_desc_t *desc;
+
+    ucs_carray_for_each(bin, tm->unexpected.array.bins,
+                        tm->unexpected.array.num_bins) {
+        ucs_array_for_each(desc, &bin->descs) {
+            if (desc->rdesc != NULL) {
+                ucs_warn("unexpected tag-receive descriptor %p was not matched",
+                         desc->rdesc);
+                ucp_recv_desc_release(desc->rdesc);
+            }
+        }
+
+        ucs_array_cleanup_dynamic(&bin->descs);
+        ucs_array_cleanup_dynamic(&bin->tags);
+    }
+
+    ucs_free(tm->unexpected.array.bins);
 }
 
 void ucp_tag_match_cleanup(ucp_tag_match_t *tm)
 {
     ucp_recv_desc_t *rdesc, *tmp_rdesc;
+    ucp_tag_mask_class_t *mask_class;
 
     ucs_list_for_each_safe(rdesc, tmp_rdesc, &tm->unexpected.all,
                            tag_list[UCP_RDESC_ALL_LIST]) {
         ucs_warn("unexpected tag-receive descriptor %p was not matched", rdesc);
-        ucp_tag_unexp_remove(rdesc);
+        ucp_tag_unexp_remove(tm, rdesc);
         ucp_recv_desc_release(rdesc);
     }
 
+    if (ucp_tag_unexp_is_array(tm)) {
+        ucp_tag_unexp_array_cleanup(tm);
+    }
+
     kh_destroy_inplace(ucp_tag_offload_hash, &tm->offload.tag_hash);
     kh_destroy_inplace(ucp_tag_frag_hash, &tm->frag_hash);
+    ucs_carray_for_each(mask_class, tm->expected.mask_index.classes,
+                        tm->expected.mask_index.num_classes) {
+        ucs_free(mask_class->hash);
+    }
+
+    ucs_free(tm->expected.mask_index.classes);
     ucs_free(tm->unexpected.hash);
     ucs_free(tm->expected.hash);
 }
 
 int ucp_tag_unexp_is_empty(ucp_tag_match_t *tm)
 {
-    return ucs_list_is_empty(&tm->unexpected.all);
+    return ucs_list_is_empty(&tm->unexpected.all) &&
+           (tm->unexpected.array.count == 0);
 }
 
 int ucp_tag_exp_remove(ucp_tag_match_t *tm, ucp_request_t *req)
@@ -149,6 +242,322 @@ ucp_tag_exp_search_all(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
     return NULL;
 }
 
+ucp_request_queue_t*
+ucp_tag_exp_mask_class_add(ucp_tag_match_t *tm, ucp_tag_t tag,
+                           ucp_tag_t tag_mask)
+{
+    ucp_tag_mask_class_t *mask_class;
+    size_t hash_size, bucket;
+
+    ucs_assert(tag_mask != UCP_TAG_MASK_FULL);
+
+    mask_class = ucp_tag_exp_find_mask_class(tm, tag_mask);
+    if (ucs_likely(mask_class != NULL)) {
+        goto out;
+    }
+
+    if (tm->expected.mask_index.num_classes >=
+        tm->expected.mask_index.max_classes) {
+        return &tm->expected.wildcard;
+    }
+
+    mask_class = &tm->expected.mask_index.classes[
+                                        tm->expected.mask_index.num_classes];
+    hash_size  = ucs_roundup_pow2(UCP_TAG_MATCH_HASH_SIZE);
+    mask_class->hash = ucs_malloc(sizeof(*mask_class->hash) * hash_size,
+                                  "ucp_tm_mask_class_hash");
+    if (mask_class->hash == NULL) {
+        /* Do not create any more classes, since requests with this mask are
+         * already going to the wildcard queue */
+        ucs_debug("tm %p: failed to allocate mask class for tag_mask %"PRIx64,
+                  tm, tag_mask);
+        tm->expected.mask_index.max_classes =
+                tm->expected.mask_index.num_classes;
+        return &tm->expected.wildcard;
+    }
+
+    for (bucket = 0; bucket < hash_size; ++bucket) {
+        ucp_tag_exp_queue_init(&mask_class->hash[bucket]);
+    }
+
+    mask_class->tag_mask = tag_mask;
+    ++tm->expected.mask_index.num_classes;
+    ucs_trace("tm %p: created mask class %u for tag_mask %"PRIx64, tm,
+              tm->expected.mask_index.num_classes - 1, tag_mask);
+
+out:
+    return ucp_tag_exp_get_mask_class_queue(mask_class, tag);
+}
+
+/* Find the oldest request in the queue which matches the tag and was posted
+ * before the current best match, if any */
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_exp_queue_find(ucp_request_queue_t *req_queue, ucp_tag_t tag,
+                       ucp_request_t **req_p, ucp_request_queue_t **queue_p,
+                       ucs_queue_iter_t *iter_p)
+{
+    ucs_queue_iter_t iter;
+    ucp_request_t *req;
+
+    ucs_queue_for_each_safe(req, iter, &req_queue->queue, recv.queue) {
+        if ((*req_p != NULL) && (req->recv.tag.sn > (*req_p)->recv.tag.sn)) {
+            /* The queue is ordered by sequence number */
+            return;
+        }
+
+        if (ucp_tag_is_match(tag, req->recv.tag.tag, req->recv.tag.tag_mask)) {
+            *req_p   = req;
+            *queue_p = req_queue;
+            *iter_p  = iter;
+            return;
+        }
+    }
+}
+
+ucp_request_t*
+ucp_tag_exp_search_masked(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
+                          ucp_tag_t tag)
+{
+    ucp_request_queue_t *match_queue = NULL;
+    ucs_queue_iter_t iter            = NULL;
+    ucp_request_t *req               = NULL;
+    ucp_tag_mask_class_t *mask_class;
+
+    /* Take the oldest matching request among the specific tag queue, the
+     * generic wildcard queue and the hash bucket of every mask class */
+    ucp_tag_exp_queue_find(req_queue, tag, &req, &match_queue, &iter);
+    ucp_tag_exp_queue_find(&tm->expected.wildcard, tag, &req, &match_queue,
+                           &iter);
+    ucs_carray_for_each(mask_class, tm->expected.mask_index.classes,
+                        tm->expected.mask_index.num_classes) {
+        ucp_tag_exp_queue_find(ucp_tag_exp_get_mask_class_queue(mask_class,
+                                                                tag),
+                               tag, &req, &match_queue, &iter);
+    }
+
+    if (req == NULL) {
+        return NULL;
+    }
+
+    ucs_trace_req("matched received tag %"PRIx64" to req %p", tag, req);
+    ucp_tag_exp_delete(req, tm, match_queue, iter);
+    return req;
+}
+
+static UCS_F_ALWAYS_INLINE unsigned
+ucp_tag_unexp_array_bin_index(ucp_tag_match_t *tm, ucp_tag_t tag)
+{
+    return ucp_tag_match_calc_hash(tag & tm->unexpected.array.sender_mask) %
+           tm->unexpected.array.num_bins;
+}
+
+/* Return the index of the first tag in [start, end) which matches the given
+ * tag under the mask, or 'end' if not found */
+static UCS_F_ALWAYS_INLINE unsigned
+ucp_tag_unexp_tags_find(const ucp_tag_t *tags, unsigned start, unsigned end,
+                        ucp_tag_t tag, ucp_tag_t tag_mask)
+{
+    unsigned i = start;
+#if defined(__AVX2__)
+    __m256i vtag  = _mm256_set1_epi64x(tag);
+    __m256i vmask = _mm256_set1_epi64x(tag_mask);
+    __m256i vzero = _mm256_setzero_si256();
+    __m256i vdiff;
+    int match_bits;
+
+    for (; (i + 4) <= end; i += 4) {
+        vdiff      = _mm256_xor_si256(
+                _mm256_loadu_si256((const __m256i*)&tags[i]), vtag);
+        vdiff      = _mm256_and_si256(vdiff, vmask);
+        match_bits = _mm256_movemask_pd(
+                _mm256_castsi256_pd(_mm256_cmpeq_epi64(vdiff, vzero)));
+        if (match_bits != 0) {
+            return i + ucs_count_trailing_zero_bits(match_bits);
+        }
+    }
+#elif defined(__ARM_NEON)
+    uint64x2_t vtag  = vdupq_n_u64(tag);
+    uint64x2_t vmask = vdupq_n_u64(tag_mask);
+    uint64x2_t vmatch;
+
+    for (; (i + 2) <= end; i += 2) {
+        vmatch = vceqzq_u64(vandq_u64(veorq_u64(vld1q_u64(&tags[i]), vtag),
+                                      vmask));
+        if (vgetq_lane_u64(vmatch, 0)) {
+            return i;
+        } else if (vgetq_lane_u64(vmatch, 1)) {
+            return i + 1;
+        }
+    }
+#endif
+
+    for (; i < end; ++i) {
+        if (ucp_tag_is_match(tags[i], tag, tag_mask)) {
+            return i;
+        }
+    }
+
+    return end;
+}
+
+/* Find the first present element in the bin which matches the tag */
+static UCS_F_ALWAYS_INLINE unsigned
+ucp_tag_unexp_array_bin_find(ucp_tag_unexp_bin_t *bin, ucp_tag_t tag,
+                             ucp_tag_t tag_mask)
+{
+    const ucp_tag_t *tags = ucs_array_begin(&bin->tags);
+    unsigned length       = ucs_array_length(&bin->tags);
+    unsigned index        = bin->first;
+
+    for (;;) {
+        index = ucp_tag_unexp_tags_find(tags, index, length, tag, tag_mask);
+        if ((index == length) ||
+            (ucs_array_elem(&bin->descs, index).rdesc != NULL)) {
+            return index;
+        }
+
+        /* Skip removed element */
+        ++index;
+    }
+}
+
+static void ucp_tag_unexp_array_bin_compact(ucp_tag_unexp_bin_t *bin)
+{
+    unsigned length = ucs_array_length(&bin->tags);
+    unsigned index, new_index;
+    ucp_tag_unexp_desc_t *desc;
+
+    new_index = 0;
+    for (index = bin->first; index < length; ++index) {
+        desc = &ucs_array_elem(&bin->descs, index);
+        if (desc->rdesc == NULL) {
+            continue;
+        }
+
+        desc->rdesc->tag_unexp.index = new_index;
+        ucs_array_elem(&bin->tags, new_index)  = ucs_array_elem(&bin->tags,
+                                                                index);
+        ucs_array_elem(&bin->descs, new_index) = *desc;
+        ++new_index;
+    }
+
+    ucs_assert(new_index == bin->count);
+    ucs_array_set_length(&bin->tags, new_index);
+    ucs_array_set_length(&bin->descs, new_index);
+    bin->first = 0;
+}
+
+void ucp_tag_unexp_array_add(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc,
+                             ucp_tag_t tag)
+{
+    unsigned bin_index       = ucp_tag_unexp_array_bin_index(tm, tag);
+    ucp_tag_unexp_bin_t *bin = &tm->unexpected.array.bins[bin_index];
+    ucp_tag_unexp_desc_t *desc;
+    ucp_tag_t *tag_elem;
+
+    tag_elem = ucs_array_append(&bin->tags,
+                                ucs_fatal("tm %p: failed to grow unexpected "
+                                          "tags array", tm));
+    desc     = ucs_array_append(&bin->descs,
+                                ucs_fatal("tm %p: failed to grow unexpected "
+                                          "descriptors array", tm));
+
+    *tag_elem              = tag;
+    desc->rdesc            = rdesc;
+    desc->sn               = tm->unexpected.array.sn++;
+    rdesc->tag_unexp.bin   = bin_index;
+    rdesc->tag_unexp.index = ucs_array_length(&bin->tags) - 1;
+    ++bin->count;
+    ++tm->unexpected.array.count;
+
+    ucs_trace_req("unexp "UCP_RECV_DESC_FMT" tag %"PRIx64" bin %u index %u",
+                  UCP_RECV_DESC_ARG(rdesc), tag, bin_index,
+                  rdesc->tag_unexp.index);
+}
+
+void ucp_tag_unexp_array_remove(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc)
+{
+    ucp_tag_unexp_bin_t *bin = &tm->unexpected.array.bins[rdesc->tag_unexp.bin];
+    unsigned length          = ucs_array_length(&bin->descs);
+
+    ucs_assert(ucs_array_elem(&bin->descs, rdesc->tag_unexp.index).rdesc ==
+               rdesc);
+    ucs_array_elem(&bin->descs, rdesc->tag_unexp.index).rdesc = NULL;
+    --bin->count;
+    --tm->unexpected.array.count;
+
+    if (bin->count == 0) {
+        ucs_array_clear(&bin->tags);
+        ucs_array_clear(&bin->descs);
+        bin->first = 0;
+        return;
+    }
+
+    while (ucs_array_elem(&bin->descs, bin->first).rdesc == NULL) {
+        ++bin->first;
+    }
+
+    /* Compact the arrays when most of the elements were removed, to keep the
+     * scanned memory proportional to the number of present elements */
+    if ((length >= UCP_TAG_UNEXP_BIN_COMPACT_MIN) &&
+        ((length - bin->count) > bin->count)) {
+        ucp_tag_unexp_array_bin_compact(bin);
+    }
+}
+
+ucp_recv_desc_t*
+ucp_tag_unexp_array_search(ucp_tag_match_t *tm, ucp_tag_t tag,
+                           ucp_tag_t tag_mask, int rem, const char *title)
+{
+    ucp_tag_unexp_desc_t *desc = NULL;
+    ucp_tag_unexp_bin_t *bin;
+    ucp_recv_desc_t *rdesc;
+    unsigned index;
+
+    if (tm->unexpected.array.count == 0) {
+        return NULL;
+    }
+
+    if ((tag_mask & tm->unexpected.array.sender_mask) ==
+        tm->unexpected.array.sender_mask) {
+        /* Specific sender - all matching tags are in the same bin */
+        bin   = &tm->unexpected.array.bins[
+                                        ucp_tag_unexp_array_bin_index(tm, tag)];
+        index = ucp_tag_unexp_array_bin_find(bin, tag, tag_mask);
+        if (index < ucs_array_length(&bin->descs)) {
+            desc = &ucs_array_elem(&bin->descs, index);
+        }
+    } else {
+        /* Sender wildcard - take the earliest arrived match from all bins */
+        ucs_carray_for_each(bin, tm->unexpected.array.bins,
+                            tm->unexpected.array.num_bins) {
+            if (bin->count == 0) {
+                continue;
+            }
+
+            index = ucp_tag_unexp_array_bin_find(bin, tag, tag_mask);
+            if ((index < ucs_array_length(&bin->descs)) &&
+                ((desc == NULL) ||
+                 (ucs_array_elem(&bin->descs, index).sn < desc->sn))) {
+                desc = &ucs_array_elem(&bin->descs, index);
+            }
+        }
+    }
+
+    if (desc == NULL) {
+        return NULL;
+    }
+
+    rdesc = desc->rdesc;
+    ucs_trace_req("matched unexp " UCP_RECV_DESC_FMT " to %s tag %"PRIx64
+                  "/%"PRIx64, UCP_RECV_DESC_ARG(rdesc), title, tag, tag_mask);
+    if (rem) {
+        ucp_tag_unexp_array_remove(tm, rdesc);
+    }
+
+    return rdesc;
+}
+
 /* Used in SW tag flow only, because fragments hash is not relevant for tag
  * offload flow.
  */
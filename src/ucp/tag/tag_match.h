@@ -11,6 +11,7 @@
 #include <ucp/core/ucp_types.h>
 #include <ucs/datastruct/queue_types.h>
 #include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/array.h>
 #include <ucs/sys/compiler_def.h>
 #include <ucs/stats/stats.h>
 
@@ -42,6 +43,43 @@ typedef struct {
 } ucp_request_queue_t;
 
 
+/**
+ * Class of expected wildcard requests which share the same tag mask. Requests
+ * of a class are indexed by their masked tag, so an incoming tag is looked up
+ * with one hash probe per class instead of scanning all wildcard requests.
+ */
+typedef struct {
+    ucp_tag_t             tag_mask;    /* Tag mask of all requests in the class */
+    ucp_request_queue_t   *hash;       /* Hash table of requests by masked tag */
+} ucp_tag_mask_class_t;
+
+
+/**
+ * Unexpected descriptor in array-based unexpected store
+ */
+typedef struct {
+    ucp_recv_desc_t       *rdesc;      /* Receive descriptor, NULL if removed */
+    uint64_t              sn;          /* Arrival sequence number */
+} ucp_tag_unexp_desc_t;
+
+
+UCS_ARRAY_DECLARE_TYPE(ucp_tag_unexp_tags_t, unsigned, ucp_tag_t);
+UCS_ARRAY_DECLARE_TYPE(ucp_tag_unexp_descs_t, unsigned, ucp_tag_unexp_desc_t);
+
+
+/**
+ * Bin of unexpected tags from a subset of senders. Tags are kept in a compact
+ * array which is scanned sequentially, and the descriptors are kept in a
+ * separate array with the same indices.
+ */
+typedef struct {
+    ucp_tag_unexp_tags_t  tags;        /* Tags, in arrival order */
+    ucp_tag_unexp_descs_t descs;       /* Descriptors of the tags */
+    unsigned              first;       /* Index of the first present element */
+    unsigned              count;       /* Number of present elements */
+} ucp_tag_unexp_bin_t;
+
+
 /**
  * Hash table entry for tag message fragments
  */
@@ -67,12 +105,37 @@ typedef struct ucp_tag_match {
         uint64_t              sn;
         unsigned              sw_all_count; /* Number of all expected requests which
                                                are not posted to offload */
+
+        /* Index of wildcard requests by tag mask */
+        struct {
+            ucp_tag_mask_class_t *classes;      /* Array of mask classes */
+            unsigned             num_classes;   /* Number of used mask classes */
+            unsigned             max_classes;   /* Maximal number of mask classes,
+                                                   0 - index is disabled */
+            unsigned             count;         /* Number of requests in all
+                                                   mask classes */
+            unsigned             sw_count;      /* Number of requests in all mask
+                                                   classes which are not posted
+                                                   to offload */
+        } mask_index;
     } expected;
 
     /* Unexpected queue */
     struct {
         ucs_list_link_t       all;        /* Linked list of all tags */
         ucs_list_link_t       *hash;      /* Hash table of unexpected tags */
+
+        /* Array-based unexpected store, used instead of the lists if enabled */
+        struct {
+            ucp_tag_unexp_bin_t *bins;       /* Bins by sender, NULL if the
+                                                array store is disabled */
+            unsigned             num_bins;   /* Number of bins */
+            unsigned             count;      /* Number of descriptors in all
+                                                bins */
+            ucp_tag_t            sender_mask; /* Mask of sender bits in a tag,
+                                                 used to select a bin */
+            uint64_t             sn;         /* Next arrival sequence number */
+        } array;
     } unexpected;
 
     /* Hash for fragment assembly, the key is a globally unique tag message id */
@@ -101,7 +164,20 @@ typedef struct ucp_tag_match {
 } ucp_tag_match_t;
 
 
-ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm);
+/**
+ * Check whether a request with the given tag mask, which resides on the given
+ * queue, is accounted in the mask classes index.
+ */
+static UCS_F_ALWAYS_INLINE int
+ucp_tag_exp_is_mask_class_queue(ucp_tag_match_t *tm, ucp_tag_t tag_mask,
+                                ucp_request_queue_t *req_queue)
+{
+    return (tag_mask != UCP_TAG_MASK_FULL) &&
+           (req_queue != &tm->expected.wildcard);
+}
+
+
+ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm, ucp_context_h context);
 
 void ucp_tag_match_cleanup(ucp_tag_match_t *tm);
 
@@ -113,6 +189,23 @@ ucp_request_t*
 ucp_tag_exp_search_all(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
                        ucp_tag_t tag);
 
+ucp_request_queue_t*
+ucp_tag_exp_mask_class_add(ucp_tag_match_t *tm, ucp_tag_t tag,
+                           ucp_tag_t tag_mask);
+
+ucp_request_t*
+ucp_tag_exp_search_masked(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
+                          ucp_tag_t tag);
+
+void ucp_tag_unexp_array_add(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc,
+                             ucp_tag_t tag);
+
+void ucp_tag_unexp_array_remove(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc);
+
+ucp_recv_desc_t*
+ucp_tag_unexp_array_search(ucp_tag_match_t *tm, ucp_tag_t tag,
+                           ucp_tag_t tag_mask, int rem, const char *title);
+
 void ucp_tag_frag_list_process_queue(ucp_tag_match_t *tm, ucp_request_t *req,
                                      uint64_t msg_id
                                      UCS_STATS_ARG(int counter_idx));
@@ -56,14 +56,60 @@ ucp_tag_exp_get_queue_for_tag(ucp_tag_match_t *tm, ucp_tag_t tag)
     return &tm->expected.hash[ucp_tag_match_calc_hash(tag)];
 }
 
+static UCS_F_ALWAYS_INLINE ucp_tag_mask_class_t*
+ucp_tag_exp_find_mask_class(ucp_tag_match_t *tm, ucp_tag_t tag_mask)
+{
+    ucp_tag_mask_class_t *mask_class;
+
+    ucs_carray_for_each(mask_class, tm->expected.mask_index.classes,
+                        tm->expected.mask_index.num_classes) {
+        if (mask_class->tag_mask == tag_mask) {
+            return mask_class;
+        }
+    }
+
+    return NULL;
+}
+
+static UCS_F_ALWAYS_INLINE ucp_request_queue_t*
+ucp_tag_exp_get_mask_class_queue(ucp_tag_mask_class_t *mask_class,
+                                 ucp_tag_t tag)
+{
+    return &mask_class->hash[ucp_tag_match_calc_hash(tag &
+                                                     mask_class->tag_mask)];
+}
+
 static UCS_F_ALWAYS_INLINE ucp_request_queue_t*
 ucp_tag_exp_get_queue(ucp_tag_match_t *tm, ucp_tag_t tag, ucp_tag_t tag_mask)
 {
+    ucp_tag_mask_class_t *mask_class;
+
     if (tag_mask == UCP_TAG_MASK_FULL) {
         return ucp_tag_exp_get_queue_for_tag(tm, tag);
-    } else {
-        return &tm->expected.wildcard;
     }
+
+    /* Mask classes are never released before cleanup, so a given mask is
+     * always mapped to the same queue */
+    mask_class = ucp_tag_exp_find_mask_class(tm, tag_mask);
+    if (mask_class != NULL) {
+        return ucp_tag_exp_get_mask_class_queue(mask_class, tag);
+    }
+
+    return &tm->expected.wildcard;
+}
+
+/* Get the queue for posting a new expected request, and create a mask class
+ * for its tag mask if needed */
+static UCS_F_ALWAYS_INLINE ucp_request_queue_t*
+ucp_tag_exp_get_post_queue(ucp_tag_match_t *tm, ucp_tag_t tag,
+                           ucp_tag_t tag_mask)
+{
+    if ((tag_mask == UCP_TAG_MASK_FULL) ||
+        (tm->expected.mask_index.max_classes == 0)) {
+        return ucp_tag_exp_get_queue(tm, tag, tag_mask);
+    }
+
+    return ucp_tag_exp_mask_class_add(tm, tag, tag_mask);
 }
 
 static UCS_F_ALWAYS_INLINE ucp_request_queue_t*
@@ -77,6 +123,9 @@ ucp_tag_exp_push(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
                  ucp_request_t *req)
 {
     req->recv.tag.sn = tm->expected.sn++;
+    tm->expected.mask_index.count +=
+            ucp_tag_exp_is_mask_class_queue(tm, req->recv.tag.tag_mask,
+                                            req_queue);
     ucs_queue_push(&req_queue->queue, &req->recv.queue);
 }
 
@@ -84,13 +133,19 @@ static UCS_F_ALWAYS_INLINE void
 ucp_tag_exp_delete(ucp_request_t *req, ucp_tag_match_t *tm,
                    ucp_request_queue_t *req_queue, ucs_queue_iter_t iter)
 {
+    int is_mask_class = ucp_tag_exp_is_mask_class_queue(tm,
+                                                        req->recv.tag.tag_mask,
+                                                        req_queue);
+
     if (!(req->flags & UCP_REQUEST_FLAG_OFFLOADED)) {
         --tm->expected.sw_all_count;
         --req_queue->sw_count;
+        tm->expected.mask_index.sw_count -= is_mask_class;
         if (req->flags & UCP_REQUEST_FLAG_BLOCK_OFFLOAD) {
             --req_queue->block_count;
         }
     }
+    tm->expected.mask_index.count -= is_mask_class;
     ucs_queue_del_iter(&req_queue->queue, iter);
 }
 
@@ -101,13 +156,17 @@ ucp_tag_exp_search(ucp_tag_match_t *tm, ucp_tag_t tag)
     ucs_queue_iter_t iter;
     ucp_request_t *req;
 
+    req_queue = ucp_tag_exp_get_queue_for_tag(tm, tag);
+
+    if (ucs_unlikely(tm->expected.mask_index.count != 0)) {
+        return ucp_tag_exp_search_masked(tm, req_queue, tag);
+    }
+
     if (ucs_unlikely(!ucs_queue_is_empty(&tm->expected.wildcard.queue))) {
-        req_queue = ucp_tag_exp_get_queue_for_tag(tm, tag);
         return ucp_tag_exp_search_all(tm, req_queue, tag);
     }
 
     /* fast path - wildcard queue is empty, search only the specific queue */
-    req_queue = ucp_tag_exp_get_queue_for_tag(tm, tag);
     ucs_queue_for_each_safe(req, iter, &req_queue->queue, recv.queue) {
         req = ucs_container_of(*iter, ucp_request_t, recv.queue);
         ucs_trace_data("checking req %p tag %"PRIx64"/%"PRIx64" with tag %"PRIx64,
@@ -132,9 +191,20 @@ ucp_tag_unexp_get_list_for_tag(ucp_tag_match_t *tm, ucp_tag_t tag)
     return &tm->unexpected.hash[ucp_tag_match_calc_hash(tag)];
 }
 
+static UCS_F_ALWAYS_INLINE int
+ucp_tag_unexp_is_array(ucp_tag_match_t *tm)
+{
+    return tm->unexpected.array.bins != NULL;
+}
+
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_unexp_remove(ucp_recv_desc_t *rdesc)
+ucp_tag_unexp_remove(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc)
 {
+    if (ucs_unlikely(ucp_tag_unexp_is_array(tm))) {
+        ucp_tag_unexp_array_remove(tm, rdesc);
+        return;
+    }
+
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_HASH_LIST]);
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_ALL_LIST] );
 }
@@ -144,6 +214,11 @@ ucp_tag_unexp_recv(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc, ucp_tag_t tag)
 {
     ucs_list_link_t *hash_list;
 
+    if (ucs_unlikely(ucp_tag_unexp_is_array(tm))) {
+        ucp_tag_unexp_array_add(tm, rdesc, tag);
+        return;
+    }
+
     hash_list = ucp_tag_unexp_get_list_for_tag(tm, tag);
     ucs_list_add_tail(hash_list,           &rdesc->tag_list[UCP_RDESC_HASH_LIST]);
     ucs_list_add_tail(&tm->unexpected.all, &rdesc->tag_list[UCP_RDESC_ALL_LIST]);
@@ -170,6 +245,10 @@ ucp_tag_unexp_search(ucp_tag_match_t *tm, ucp_tag_t tag, uint64_t tag_mask,
     ucs_list_link_t *list;
     int i_list;
 
+    if (ucs_unlikely(ucp_tag_unexp_is_array(tm))) {
+        return ucp_tag_unexp_array_search(tm, tag, tag_mask, rem, title);
+    }
+
     /* fast check of global unexpected queue */
     if (ucs_list_is_empty(&tm->unexpected.all)) {
         return NULL;
@@ -197,7 +276,7 @@ ucp_tag_unexp_search(ucp_tag_match_t *tm, ucp_tag_t tag, uint64_t tag_mask,
                           "%s tag %"PRIx64"/%"PRIx64, UCP_RECV_DESC_ARG(rdesc),
                           title, tag, tag_mask);
             if (rem) {
-                ucp_tag_unexp_remove(rdesc);
+                ucp_tag_unexp_remove(tm, rdesc);
             }
             return rdesc;
         }
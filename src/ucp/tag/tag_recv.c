@@ -97,6 +97,10 @@ static UCS_F_ALWAYS_INLINE ucs_status_ptr_t ucp_tag_recv_common(
                                                  UCS_PTR_BYTE_OFFSET(rdesc + 1,
                                                                      hdr_len),
                                                  recv_len, 1, param);
+        if (ucs_unlikely(rdesc->flags & UCP_RECV_DESC_FLAG_CSUM_ERROR) &&
+            (status == UCS_OK)) {
+            status = UCS_ERR_IO_ERROR;
+        }
         ucp_recv_desc_release(rdesc);
 
         req->status = status;
@@ -115,6 +119,7 @@ static UCS_F_ALWAYS_INLINE ucs_status_ptr_t ucp_tag_recv_common(
     req->status      = UCS_OK;
     req->flags       = UCP_REQUEST_FLAG_RECV_TAG;
     req->recv.worker = worker;
+    UCP_WORKER_STAT_HIST_START(worker, req->start_time);
 
     status = ucp_datatype_iter_init_unpack(worker->context, buffer, count,
                                            &req->recv.dt_iter, param);
@@ -152,7 +157,7 @@ static UCS_F_ALWAYS_INLINE ucs_status_ptr_t ucp_tag_recv_common(
         }
     } else {
         /* Not found on unexpected, wait until it arrives. */
-        req_queue = ucp_tag_exp_get_queue(&worker->tm, tag, tag_mask);
+        req_queue = ucp_tag_exp_get_post_queue(&worker->tm, tag, tag_mask);
 
         /* If offload supported, post this tag to transport as well.
          * TODO: need to distinguish the cases when posting is not needed. */
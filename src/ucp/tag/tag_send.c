@@ -133,6 +133,7 @@ ucp_tag_send_req_init(ucp_request_t *req, ucp_ep_h ep, const void *buffer,
 {
     req->flags              = flags | UCP_REQUEST_FLAG_SEND_TAG;
     req->send.ep            = ep;
+    UCP_WORKER_STAT_HIST_START(ep->worker, req->start_time);
     req->send.buffer        = (void*)buffer;
     req->send.datatype      = datatype;
     req->send.msg_proto.tag = tag;
@@ -291,9 +292,11 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_nbx,
 
     if (worker->context->config.ext.proto_enable) {
         req->send.msg_proto.tag = tag;
+        UCP_WORKER_STAT_HIST_START(worker, req->start_time);
 
         ret = ucp_proto_request_send_op(ep, &ucp_ep_config(ep)->proto_select,
-                                        UCP_WORKER_CFG_INDEX_NULL, req, 0,
+                                        UCP_WORKER_CFG_INDEX_NULL, req,
+                                        UCP_REQUEST_FLAG_PROTO_TAG_SEND,
                                         UCP_OP_ID_TAG_SEND, buffer, count,
                                         datatype, contig_length, param, 0, 0);
     } else {
@@ -340,11 +343,13 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_sync_nbx,
 
     if (worker->context->config.ext.proto_enable) {
         req->send.msg_proto.tag = tag;
+        UCP_WORKER_STAT_HIST_START(worker, req->start_time);
         if (UCP_DT_IS_CONTIG(datatype)) {
             contig_length = ucp_contig_dt_length(datatype, count);
         }
         ret = ucp_proto_request_send_op(ep, &ucp_ep_config(ep)->proto_select,
-                                        UCP_WORKER_CFG_INDEX_NULL, req, 0,
+                                        UCP_WORKER_CFG_INDEX_NULL, req,
+                                        UCP_REQUEST_FLAG_PROTO_TAG_SEND,
                                         UCP_OP_ID_TAG_SEND_SYNC, buffer, count,
                                         datatype, contig_length, param, 0, 0);
     } else {
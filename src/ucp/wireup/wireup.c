@@ -570,6 +570,10 @@ void ucp_wireup_remote_connected(ucp_ep_h ep)
          * in ucp_ep_close_flushed_callback() when a peer was already
          * disconnected, but we set REMOTE_CONNECTED flag again) */
         ucp_ep_update_flags(ep, UCP_EP_FLAG_REMOTE_CONNECTED, 0);
+        if (!(ep->flags & UCP_EP_FLAG_INTERNAL)) {
+            UCP_WORKER_STAT_HIST_TIME(ep->worker, WIREUP,
+                                      ep->ext->create_time);
+        }
     }
 
     ucp_wireup_update_flags(ep,
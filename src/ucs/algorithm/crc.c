@@ -9,9 +9,19 @@
 #endif
 
 #include <ucs/algorithm/crc.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/debug/assert.h>
+#include <ucs/type/init_once.h>
 
 #include <string.h>
 
+#if defined(__x86_64__)
+#  include <immintrin.h>
+#elif defined(__aarch64__)
+#  include <sys/auxv.h>
+#  include <asm/hwcap.h>
+#endif
+
 
 /* CRC-16-CCITT */
 #define UCS_CRC16_POLY    0x8408u
@@ -19,32 +29,299 @@
 /* CRC-32 (ISO 3309) */
 #define UCS_CRC32_POLY    0xedb88320l
 
-#define UCS_CRC_CALC(_width, _buffer, _size, _crc) \
-    do { \
-        const uint8_t *end = (const uint8_t*)(UCS_PTR_BYTE_OFFSET(_buffer, _size)); \
-        const uint8_t *p; \
-        uint8_t bit; \
-        \
-        if ((_size) != 0) { \
-            for (p = (_buffer); p < end; ++p) { \
-                (_crc) ^= *p; \
-                for (bit = 0; bit < 8; ++bit) { \
-                    (_crc) = ((_crc) >> 1) ^ (-(int)((_crc) & 1) & \
-                                              UCS_CRC ## _width ## _POLY); \
-                } \
-            } \
-        } \
-        (_crc) = ~(_crc); \
-    } while (0)
+/* CRC-32C (Castagnoli) */
+#define UCS_CRC32C_POLY   0x82f63b78l
 
+/* Number of bytes processed together by slice-by-8 tables */
+#define UCS_CRC_SLICE_LEN 8
 
-uint16_t ucs_crc16(const void *buffer, size_t size)
+/* Length of each of the 3 streams processed by the PCLMUL kernel */
+#define UCS_CRC32C_PCLMUL_BLOCK_LEN 512
+
+
+/* Calculate a CRC register update by the remaining bytes of a buffer */
+typedef uint32_t (*ucs_crc32c_func_t)(uint32_t crc, const void *buffer,
+                                      size_t size);
+
+
+/* Slice-by-8 lookup tables of a reflected CRC of width <= 32 bits.
+ * table[0] holds the CRC of every byte value, table[k] holds the CRC of the
+ * byte value followed by k zero bytes. */
+typedef uint32_t ucs_crc_table_t[UCS_CRC_SLICE_LEN][256];
+
+
+static struct {
+    ucs_crc_table_t   crc16;
+    ucs_crc_table_t   crc32;
+    ucs_crc_table_t   crc32c;
+    struct {
+        uint32_t      k1;      /* x^(8 * BLOCK_LEN - 33) mod P */
+        uint32_t      k2;      /* x^(16 * BLOCK_LEN - 33) mod P */
+    } pclmul;
+    ucs_crc32c_func_t crc32c_func;
+    int               initialized;
+} ucs_crc_ctx;
+
+
+const char *ucs_crc32c_impl_names[] = {
+    [UCS_CRC32C_IMPL_SLICE8] = "slice8",
+    [UCS_CRC32C_IMPL_SSE42]  = "sse42",
+    [UCS_CRC32C_IMPL_PCLMUL] = "pclmul",
+    [UCS_CRC32C_IMPL_ARMV8]  = "armv8",
+    [UCS_CRC32C_IMPL_LAST]   = NULL
+};
+
+
+static void ucs_crc_table_init(ucs_crc_table_t table, uint32_t poly)
+{
+    uint32_t crc;
+    unsigned i, k;
+    uint8_t bit;
+
+    for (i = 0; i < 256; ++i) {
+        crc = i;
+        for (bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (-(int)(crc & 1) & poly);
+        }
+        table[0][i] = crc;
+    }
+
+    for (i = 0; i < 256; ++i) {
+        for (k = 1; k < UCS_CRC_SLICE_LEN; ++k) {
+            table[k][i] = (table[k - 1][i] >> 8) ^
+                          table[0][table[k - 1][i] & 0xff];
+        }
+    }
+}
+
+static UCS_F_ALWAYS_INLINE uint32_t
+ucs_crc_table_byte(ucs_crc_table_t table, uint32_t crc, uint8_t byte)
+{
+    return table[0][(crc ^ byte) & 0xff] ^ (crc >> 8);
+}
+
+static uint32_t ucs_crc_slice8(ucs_crc_table_t table, uint32_t crc,
+                               const void *buffer, size_t size)
+{
+    const uint8_t *p = buffer;
+    uint64_t word;
+
+    for (; (size > 0) && ((uintptr_t)p % UCS_CRC_SLICE_LEN); --size) {
+        crc = ucs_crc_table_byte(table, crc, *(p++));
+    }
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; size >= UCS_CRC_SLICE_LEN; size -= UCS_CRC_SLICE_LEN) {
+        word = *(const uint64_t*)p ^ crc;
+        crc  = table[7][word & 0xff] ^
+               table[6][(word >> 8) & 0xff] ^
+               table[5][(word >> 16) & 0xff] ^
+               table[4][(word >> 24) & 0xff] ^
+               table[3][(word >> 32) & 0xff] ^
+               table[2][(word >> 40) & 0xff] ^
+               table[1][(word >> 48) & 0xff] ^
+               table[0][word >> 56];
+        p   += UCS_CRC_SLICE_LEN;
+    }
+#endif
+
+    for (; size > 0; --size) {
+        crc = ucs_crc_table_byte(table, crc, *(p++));
+    }
+
+    return crc;
+}
+
+static uint32_t
+ucs_crc32c_slice8(uint32_t crc, const void *buffer, size_t size)
+{
+    return ucs_crc_slice8(ucs_crc_ctx.crc32c, crc, buffer, size);
+}
+
+/* Calculate x^n mod P of a reflected CRC32 polynomial */
+static uint32_t ucs_crc32_xpow(uint32_t poly, unsigned n)
+{
+    uint32_t crc = UCS_BIT(31); /* x^0 */
+
+    while (n-- > 0) {
+        crc = (crc >> 1) ^ (-(int)(crc & 1) & poly);
+    }
+
+    return crc;
+}
+
+#if defined(__x86_64__)
+
+static __attribute__((target("sse4.2"))) uint32_t
+ucs_crc32c_sse42(uint32_t crc, const void *buffer, size_t size)
+{
+    const uint8_t *p = buffer;
+    uint64_t crc64;
+
+    for (; (size > 0) && ((uintptr_t)p % sizeof(uint64_t)); --size) {
+        crc = _mm_crc32_u8(crc, *(p++));
+    }
+
+    crc64 = crc;
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+        crc64 = _mm_crc32_u64(crc64, *(const uint64_t*)p);
+        p    += sizeof(uint64_t);
+    }
+
+    crc = crc64;
+    for (; size > 0; --size) {
+        crc = _mm_crc32_u8(crc, *(p++));
+    }
+
+    return crc;
+}
+
+/* Multiply the CRC by x^(n + 33) mod P, where k = x^n mod P */
+static __attribute__((target("sse4.2,pclmul"))) UCS_F_ALWAYS_INLINE uint64_t
+ucs_crc32c_pclmul_shift(uint32_t crc, uint32_t k)
+{
+    return _mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi32_si128(crc),
+                                                  _mm_cvtsi32_si128(k), 0));
+}
+
+/*
+ * The crc32 instruction has a latency of 3 cycles and a throughput of 1, so
+ * 3 independent streams of the buffer are calculated in parallel. The CRCs of
+ * the first streams are then moved to the end of the last stream by
+ * carry-less multiplication and merged into it.
+ */
+static __attribute__((target("sse4.2,pclmul"))) uint32_t
+ucs_crc32c_pclmul(uint32_t crc, const void *buffer, size_t size)
 {
-    uint16_t crc = UINT16_MAX;
-    UCS_CRC_CALC(16, buffer, size, crc);
+    const size_t chunk_len = 3 * UCS_CRC32C_PCLMUL_BLOCK_LEN;
+    const uint64_t *p0, *p1, *p2;
+    uint64_t crc0, crc1, crc2;
+    const uint8_t *p;
+    unsigned i;
+
+    p    = buffer;
+    crc0 = crc;
+    for (; (size > 0) && ((uintptr_t)p % sizeof(uint64_t)); --size) {
+        crc0 = _mm_crc32_u8(crc0, *(p++));
+    }
+
+    for (; size >= chunk_len; size -= chunk_len) {
+        p0   = (const uint64_t*)p;
+        p1   = (const uint64_t*)(p + UCS_CRC32C_PCLMUL_BLOCK_LEN);
+        p2   = (const uint64_t*)(p + (2 * UCS_CRC32C_PCLMUL_BLOCK_LEN));
+        crc1 = 0;
+        crc2 = 0;
+        for (i = 0; i < (UCS_CRC32C_PCLMUL_BLOCK_LEN / sizeof(uint64_t)); ++i) {
+            crc0 = _mm_crc32_u64(crc0, p0[i]);
+            crc1 = _mm_crc32_u64(crc1, p1[i]);
+            crc2 = _mm_crc32_u64(crc2, p2[i]);
+        }
+
+        crc0 = crc2 ^ _mm_crc32_u64(0,
+                        ucs_crc32c_pclmul_shift(crc0, ucs_crc_ctx.pclmul.k2) ^
+                        ucs_crc32c_pclmul_shift(crc1, ucs_crc_ctx.pclmul.k1));
+        p   += chunk_len;
+    }
+
+    return ucs_crc32c_sse42(crc0, p, size);
+}
+
+#elif defined(__aarch64__)
+
+static __attribute__((target("+crc"))) uint32_t
+ucs_crc32c_armv8(uint32_t crc, const void *buffer, size_t size)
+{
+    const uint8_t *p = buffer;
+
+    for (; (size > 0) && ((uintptr_t)p % sizeof(uint64_t)); --size) {
+        asm("crc32cb %w0, %w0, %w1" : "+r"(crc) : "r"(*(p++)));
+    }
+
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+        asm("crc32cx %w0, %w0, %x1" : "+r"(crc) : "r"(*(const uint64_t*)p));
+        p += sizeof(uint64_t);
+    }
+
+    for (; size > 0; --size) {
+        asm("crc32cb %w0, %w0, %w1" : "+r"(crc) : "r"(*(p++)));
+    }
+
     return crc;
 }
 
+#endif
+
+static ucs_crc32c_func_t ucs_crc32c_impl_func(ucs_crc32c_impl_t impl)
+{
+    switch (impl) {
+    case UCS_CRC32C_IMPL_SLICE8:
+        return ucs_crc32c_slice8;
+#if defined(__x86_64__)
+    case UCS_CRC32C_IMPL_SSE42:
+        return (ucs_arch_get_cpu_flag() & UCS_CPU_FLAG_SSE42) ?
+               ucs_crc32c_sse42 : NULL;
+    case UCS_CRC32C_IMPL_PCLMUL:
+        return ((ucs_arch_get_cpu_flag() &
+                 (UCS_CPU_FLAG_SSE42 | UCS_CPU_FLAG_PCLMUL)) ==
+                (UCS_CPU_FLAG_SSE42 | UCS_CPU_FLAG_PCLMUL)) ?
+               ucs_crc32c_pclmul : NULL;
+#elif defined(__aarch64__) && defined(HWCAP_CRC32)
+    case UCS_CRC32C_IMPL_ARMV8:
+        return (getauxval(AT_HWCAP) & HWCAP_CRC32) ? ucs_crc32c_armv8 : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+static void ucs_crc_init()
+{
+    static ucs_init_once_t init_once = UCS_INIT_ONCE_INITIALIZER;
+    ucs_crc32c_impl_t impl;
+
+    UCS_INIT_ONCE(&init_once) {
+        ucs_crc_table_init(ucs_crc_ctx.crc16, UCS_CRC16_POLY);
+        ucs_crc_table_init(ucs_crc_ctx.crc32, UCS_CRC32_POLY);
+        ucs_crc_table_init(ucs_crc_ctx.crc32c, UCS_CRC32C_POLY);
+
+        ucs_crc_ctx.pclmul.k1 = ucs_crc32_xpow(UCS_CRC32C_POLY,
+                                               (8 * UCS_CRC32C_PCLMUL_BLOCK_LEN) -
+                                               33);
+        ucs_crc_ctx.pclmul.k2 = ucs_crc32_xpow(UCS_CRC32C_POLY,
+                                               (16 * UCS_CRC32C_PCLMUL_BLOCK_LEN) -
+                                               33);
+
+        /* The last supported implementation is the fastest one */
+        for (impl = UCS_CRC32C_IMPL_SLICE8; impl < UCS_CRC32C_IMPL_LAST;
+             ++impl) {
+            if (ucs_crc32c_impl_func(impl) != NULL) {
+                ucs_crc_ctx.crc32c_func = ucs_crc32c_impl_func(impl);
+            }
+        }
+
+        ucs_memory_cpu_store_fence();
+        ucs_crc_ctx.initialized = 1;
+    }
+}
+
+/*
+ * The tables are built by the library constructor, before any other thread
+ * is created. The check is needed only for calls from other constructors,
+ * which are done by the initializing thread.
+ */
+static UCS_F_ALWAYS_INLINE void ucs_crc_check_init()
+{
+    if (ucs_unlikely(!ucs_crc_ctx.initialized)) {
+        ucs_crc_init();
+    }
+}
+
+uint16_t ucs_crc16(const void *buffer, size_t size)
+{
+    ucs_crc_check_init();
+    return ~ucs_crc_slice8(ucs_crc_ctx.crc16, UINT16_MAX, buffer, size);
+}
+
 uint16_t ucs_crc16_string(const char *s)
 {
     return ucs_crc16((const char*)s, strlen(s));
@@ -52,7 +329,31 @@ uint16_t ucs_crc16_string(const char *s)
 
 uint32_t ucs_crc32(uint32_t prev_crc, const void *buffer, size_t size)
 {
-    uint32_t crc = ~prev_crc;
-    UCS_CRC_CALC(32, buffer, size, crc);
-    return crc;
+    ucs_crc_check_init();
+    return ~ucs_crc_slice8(ucs_crc_ctx.crc32, ~prev_crc, buffer, size);
+}
+
+int ucs_crc32c_impl_is_supported(ucs_crc32c_impl_t impl)
+{
+    return ucs_crc32c_impl_func(impl) != NULL;
+}
+
+uint32_t ucs_crc32c_impl(ucs_crc32c_impl_t impl, uint32_t prev_crc,
+                         const void *buffer, size_t size)
+{
+    ucs_crc32c_func_t func = ucs_crc32c_impl_func(impl);
+
+    ucs_assertv(func != NULL, "impl=%s", ucs_crc32c_impl_names[impl]);
+    ucs_crc_check_init();
+    return ~func(~prev_crc, buffer, size);
+}
+
+uint32_t ucs_crc32c(uint32_t prev_crc, const void *buffer, size_t size)
+{
+    ucs_crc_check_init();
+    return ~ucs_crc_ctx.crc32c_func(~prev_crc, buffer, size);
+}
+
+UCS_STATIC_INIT {
+    ucs_crc_init();
 }
@@ -48,6 +48,60 @@ uint16_t ucs_crc16_string(const char *s);
  */
 uint32_t ucs_crc32(uint32_t prev_crc, const void *buffer, size_t size);
 
+
+/**
+ * CRC32C implementations.
+ */
+typedef enum {
+    UCS_CRC32C_IMPL_SLICE8, /**< Slice-by-8 lookup tables */
+    UCS_CRC32C_IMPL_SSE42,  /**< x86 SSE4.2 crc32 instruction */
+    UCS_CRC32C_IMPL_PCLMUL, /**< x86 SSE4.2 crc32 instruction on 3 interleaved
+                                 streams, folded by carry-less multiplication */
+    UCS_CRC32C_IMPL_ARMV8,  /**< ARMv8 crc32c instructions */
+    UCS_CRC32C_IMPL_LAST
+} ucs_crc32c_impl_t;
+
+
+extern const char *ucs_crc32c_impl_names[];
+
+
+/**
+ * Check whether a CRC32C implementation is supported by the host CPU.
+ *
+ * @param [in]  impl       Implementation to check.
+ *
+ * @return Nonzero if the implementation can be used.
+ */
+int ucs_crc32c_impl_is_supported(ucs_crc32c_impl_t impl);
+
+
+/**
+ * Calculate CRC32C (Castagnoli) of an arbitrary buffer using a specific
+ * implementation, which must be supported by the host CPU.
+ *
+ * @param [in]  impl       Implementation to use.
+ * @param [in]  prev_crc   Initial CRC value.
+ * @param [in]  buffer     Buffer to compute crc for.
+ * @param [in]  size       Buffer size.
+ *
+ * @return crc32c() function of the buffer.
+ */
+uint32_t ucs_crc32c_impl(ucs_crc32c_impl_t impl, uint32_t prev_crc,
+                         const void *buffer, size_t size);
+
+
+/**
+ * Calculate CRC32C (Castagnoli) of an arbitrary buffer. The fastest
+ * implementation supported by the host CPU is used.
+ *
+ * @param [in]  prev_crc   Initial CRC value.
+ * @param [in]  buffer     Buffer to compute crc for.
+ * @param [in]  size       Buffer size.
+ *
+ * @return crc32c() function of the buffer.
+ */
+uint32_t ucs_crc32c(uint32_t prev_crc, const void *buffer, size_t size);
+
 END_C_DECLS
 
 #endif
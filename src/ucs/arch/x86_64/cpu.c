@@ -531,6 +531,9 @@ int ucs_arch_get_cpu_flag()
             if (_ecx & 1) {
                 result |= UCS_CPU_FLAG_SSE3;
             }
+            if (_ecx & (1 << 1)) {
+                result |= UCS_CPU_FLAG_PCLMUL;
+            }
             if (_ecx & (1 << 9)) {
                 result |= UCS_CPU_FLAG_SSSE3;
             }
@@ -13,6 +13,7 @@
 #include "pipe.h"
 
 #include <ucs/arch/atomic.h>
+#include <ucs/config/global_opts.h>
 #include <ucs/sys/checker.h>
 #include <ucs/sys/stubs.h>
 #include <ucs/sys/event_set.h>
@@ -188,7 +189,8 @@ static ucs_status_t ucs_async_thread_start(ucs_async_thread_t **thread_p)
         goto err_timerq_cleanup;
     }
 
-    status = ucs_event_set_create(&thread->event_set);
+    status = ucs_event_set_create_backend(&thread->event_set,
+                                          ucs_global_opts.event_set_backend);
     if (status != UCS_OK) {
         goto err_close_pipe;
     }
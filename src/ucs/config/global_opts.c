@@ -30,6 +30,7 @@ ucs_global_opts_t ucs_global_opts = {
     .log_buffer_size       = 1024,
     .log_data_size         = 0,
     .mpool_fifo            = 0,
+    .mpool_numa_arena      = { NULL, 0 },
     .handle_errors         = UCS_BIT(UCS_HANDLE_ERROR_BACKTRACE),
     .error_signals         = { NULL, 0 },
     .error_mail_to         = "",
@@ -40,6 +41,7 @@ ucs_global_opts_t ucs_global_opts = {
     .warn_unused_env_vars  = 1,
     .enable_memtype_cache  = UCS_TRY,
     .async_signo           = SIGALRM,
+    .event_set_backend     = UCS_EVENT_SET_BACKEND_EPOLL,
     .stats_dest            = "",
     .tuning_path           = "",
     .memtrack_dest         = "",
@@ -118,6 +120,15 @@ static ucs_config_field_t ucs_global_opts_table[] = {
   "Enable output of ucs_print(). This option is intended for use by the library developers.",
   ucs_offsetof(ucs_global_opts_t, log_print_enable), UCS_CONFIG_TYPE_BOOL},
 
+ {"MPOOL_NUMA_ARENA", "",
+  "Comma-separated list of glob patterns of memory pool names, for example\n"
+  "'ucp_requests,uct_tcp*'. Matching memory pools which allocate their chunks\n"
+  "from the heap use a NUMA arena instead. The arena maps huge-page aligned\n"
+  "segments backed by transparent huge pages, and binds them to the NUMA\n"
+  "node of the thread which grows the memory pool.",
+  ucs_offsetof(ucs_global_opts_t, mpool_numa_arena),
+  UCS_CONFIG_TYPE_STRING_ARRAY},
+
 #if ENABLE_DEBUG_DATA
  {"MPOOL_FIFO", "n",
   "Enable FIFO behavior for memory pool, instead of LIFO. Useful for\n"
@@ -177,6 +188,16 @@ static ucs_config_field_t ucs_global_opts_table[] = {
   "Signal number used for async signaling.",
   ucs_offsetof(ucs_global_opts_t, async_signo), UCS_CONFIG_TYPE_SIGNO},
 
+ {"EVENT_SET_BACKEND", "epoll",
+  "Mechanism used by the async thread and TCP transport to wait for events\n"
+  "on file descriptors:\n"
+  " epoll    - epoll_wait() system call on every wait.\n"
+  " io_uring - poll requests are submitted in batches and completions are\n"
+  "            reaped from a shared ring without system calls. Falls back to\n"
+  "            epoll if io_uring is not supported.",
+  ucs_offsetof(ucs_global_opts_t, event_set_backend),
+  UCS_CONFIG_TYPE_ENUM(ucs_event_set_backend_names)},
+
  {"MEMTRACK_LIMIT", "inf",
   "Memory limit allocated by memtrack. In case if limit is reached then\n"
   "memtrack report is generated and process is terminated.",
@@ -282,8 +303,8 @@ static ucs_config_field_t ucs_global_opts_read_only_table[] = {
 
  {"STATS_FILTER", "*",
   "Used for filter counters summary.\n"
-  "Comma-separated list of glob patterns specifying counters.\n"
-  "Statistics summary will contain only the matching counters.\n"
+  "Comma-separated list of glob patterns specifying counters and histograms.\n"
+  "Statistics summary will contain only the matching counters and histograms.\n"
   "The order is not meaningful.\n"
   "Each expression in the list may contain any of the following wildcard:\n"
   "  *     - matches any number of any characters including none.\n"
@@ -310,8 +331,11 @@ static ucs_config_field_t ucs_global_opts_read_only_table[] = {
 
  {"PROFILE_MODE", "",
   "Profile collection modes. If none is specified, profiling is disabled.\n"
-  " - log   - Record all timestamps.\n"
-  " - accum - Accumulate measurements per location.",
+  " - log    - Record all timestamps.\n"
+  " - accum  - Accumulate measurements per location.\n"
+  " - stream - Record all timestamps, and flush them to the profiling file\n"
+  "            continuously from a background thread. Cannot be combined with\n"
+  "            other modes.",
   ucs_offsetof(ucs_global_opts_t, profile_mode),
   UCS_CONFIG_TYPE_BITMAP(ucs_profile_mode_names)},
 
@@ -324,6 +348,13 @@ static ucs_config_field_t ucs_global_opts_read_only_table[] = {
   "Maximal size of profiling log. New records will replace old records.",
   ucs_offsetof(ucs_global_opts_t, profile_log_size), UCS_CONFIG_TYPE_MEMUNITS},
 
+ {"PROFILE_STREAM_INTERVAL", "100ms",
+  "How often to flush the per-thread profiling records to the profiling file\n"
+  "in stream mode. Each thread keeps up to PROFILE_LOG_SIZE of records which\n"
+  "were not flushed yet; records produced when it is full are dropped.",
+  ucs_offsetof(ucs_global_opts_t, profile_stream_interval),
+  UCS_CONFIG_TYPE_TIME},
+
  {"RCACHE_STAT_MIN", "4k",
   "Registration cache minimum region size, for power-of-2 size distribution "
   "statistics.\nStatistics about smaller regions will be attributed to this "
@@ -13,6 +13,7 @@
 #include <ucs/type/status.h>
 #include <ucs/sys/compiler_def.h>
 #include <ucs/sys/topo/base/topo.h>
+#include <ucs/sys/event_set.h>
 #include <ucs/arch/global_opts.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -53,6 +54,9 @@ typedef struct {
      * debugging because object pointers are not recycled. */
     int                        mpool_fifo;
 
+    /* Memory pools which allocate heap chunks from the NUMA arena */
+    ucs_config_names_array_t   mpool_numa_arena;
+
     /* Handle errors mode */
     uint64_t                   handle_errors;
 
@@ -97,6 +101,9 @@ typedef struct {
     /* Signal number used by async handler (for signal mode) */
     unsigned                   async_signo;
 
+    /* Backend of event sets used by async thread and TCP transport */
+    ucs_event_set_backend_t    event_set_backend;
+
     /* Destination for detailed memory tracking results: none / stdout / stderr
      */
     char                       *memtrack_dest;
@@ -113,6 +120,9 @@ typedef struct {
     /* Limit for profiling log size */
     size_t                     profile_log_size;
 
+    /* Interval for flushing profiling records in stream mode */
+    double                     profile_stream_interval;
+
     /* Counters to be included in statistics summary */
     ucs_config_names_array_t   stats_filter;
 
@@ -297,6 +297,21 @@ AS_IF([test "x$enable_builtin_memcpy" != xno],
 AC_CHECK_FUNCS([__clear_cache], [], [])
 AC_CHECK_FUNCS([__aarch64_sync_cache_range], [], [])
 
+#
+# Check for io_uring support in event sets
+#
+io_uring_happy=yes
+AC_CHECK_HEADER([linux/io_uring.h], [], [io_uring_happy=no])
+AS_IF([test "x$io_uring_happy" = xyes],
+      [AC_CHECK_DECLS([__NR_io_uring_setup, __NR_io_uring_enter,
+                       IORING_FEAT_EXT_ARG, IORING_POLL_ADD_MULTI,
+                       IORING_SETUP_CQSIZE, IORING_SQ_CQ_OVERFLOW],
+                      [], [io_uring_happy=no],
+                      [[#include <sys/syscall.h>
+                        #include <linux/io_uring.h>]])])
+AS_IF([test "x$io_uring_happy" = xyes],
+      [AC_DEFINE([HAVE_IO_URING], [1], [Enable io_uring event set])])
+
 
 AC_CONFIG_FILES([src/ucs/Makefile
                  src/ucs/signal/Makefile
@@ -12,11 +12,14 @@
 #include "mpool.inl"
 #include "queue.h"
 
+#include <ucs/config/global_opts.h>
 #include <ucs/debug/log.h>
+#include <ucs/memory/numa_arena.h>
 #include <ucs/sys/ptr_arith.h>
 #include <ucs/sys/checker.h>
 #include <ucs/sys/sys.h>
 #include <ucs/arch/cpu.h>
+#include <fnmatch.h>
 
 
 static size_t ucs_mpool_elem_total_size(ucs_mpool_data_t *data)
@@ -72,6 +75,26 @@ void ucs_mpool_params_reset(ucs_mpool_params_t *params)
     params->name            = "";
 }
 
+static int ucs_mpool_use_numa_arena(const ucs_mpool_params_t *params)
+{
+    const ucs_config_names_array_t *patterns =
+            &ucs_global_opts.mpool_numa_arena;
+    unsigned i;
+
+    /* Only pools which use the default heap allocator are affected */
+    if (params->ops->chunk_alloc != ucs_mpool_chunk_malloc) {
+        return 0;
+    }
+
+    for (i = 0; i < patterns->count; ++i) {
+        if (fnmatch(patterns->names[i], params->name, 0) == 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 static size_t ucs_mpool_chunk_size(ucs_mpool_t *mp, unsigned num_elems)
 {
     return sizeof(ucs_mpool_chunk_t) + mp->data->alignment +
@@ -111,6 +134,7 @@ ucs_status_t ucs_mpool_init(const ucs_mpool_params_t *params, ucs_mpool_t *mp)
     mp->data->align_offset    = sizeof(ucs_mpool_elem_t) + params->align_offset;
     mp->data->elems_per_chunk = params->elems_per_chunk;
     mp->data->malloc_safe     = params->malloc_safe;
+    mp->data->numa_arena      = ucs_mpool_use_numa_arena(params);
     mp->data->quota           = params->max_elems;
     mp->data->tail            = NULL;
     mp->data->chunks          = NULL;
@@ -133,9 +157,9 @@ ucs_status_t ucs_mpool_init(const ucs_mpool_params_t *params, ucs_mpool_t *mp)
 
     VALGRIND_CREATE_MEMPOOL(mp, 0, 0);
 
-    ucs_debug("mpool %s: align %zu, maxelems %u, elemsize %zu",
+    ucs_debug("mpool %s: align %zu, maxelems %u, elemsize %zu%s",
               ucs_mpool_name(mp), mp->data->alignment, params->max_elems,
-              mp->data->elem_size);
+              mp->data->elem_size, mp->data->numa_arena ? ", numa arena" : "");
     return UCS_OK;
 
 err_free_name:
@@ -325,13 +349,21 @@ void *ucs_mpool_get_grow(ucs_mpool_t *mp)
 
 ucs_status_t ucs_mpool_chunk_malloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p)
 {
+    if (mp->data->numa_arena) {
+        return ucs_numa_arena_alloc(size_p, chunk_p, ucs_mpool_name(mp));
+    }
+
     *chunk_p = ucs_malloc(*size_p, ucs_mpool_name(mp));
     return (*chunk_p == NULL) ? UCS_ERR_NO_MEMORY : UCS_OK;
 }
 
 void ucs_mpool_chunk_free(ucs_mpool_t *mp, void *chunk)
 {
-    ucs_free(chunk);
+    if (mp->data->numa_arena) {
+        ucs_numa_arena_free(chunk);
+    } else {
+        ucs_free(chunk);
+    }
 }
 
 
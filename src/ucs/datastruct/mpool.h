@@ -82,6 +82,7 @@ struct ucs_mpool_data {
     unsigned               elems_per_chunk; /* Number of elements per chunk */
     unsigned               quota;           /* How many more elements can be allocated */
     int                    malloc_safe;     /* Avoid triggering malloc() during put/get */
+    int                    numa_arena;      /* Heap chunks come from the NUMA arena */
     ucs_mpool_elem_t       *tail;           /* Free list tail */
     ucs_mpool_chunk_t      *chunks;         /* List of allocated chunks */
     const ucs_mpool_ops_t  *ops;            /* Memory pool operations */
@@ -348,6 +349,8 @@ unsigned ucs_mpool_num_elems_per_chunk(ucs_mpool_t *mp,
 
 /**
  * heap-based chunk allocator.
+ * Pools whose name matches UCX_MPOOL_NUMA_ARENA allocate their chunks from a
+ * NUMA-local, huge-page aligned arena instead of the heap.
  */
 ucs_status_t ucs_mpool_chunk_malloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p);
 void ucs_mpool_chunk_free(ucs_mpool_t *mp, void *chunk);
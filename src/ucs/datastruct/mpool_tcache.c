@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2025. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "mpool_tcache.h"
+#include "mpool_tcache.inl"
+#include "mpool.inl"
+
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack_int.h>
+#include <string.h>
+
+
+static void
+ucs_mpool_tcache_magazine_flush(ucs_mpool_tcache_magazine_t *mag)
+{
+    unsigned i;
+
+    for (i = 0; i < mag->count; ++i) {
+        ucs_mpool_put_inline(mag->objs[i]);
+    }
+    mag->count = 0;
+}
+
+static void ucs_mpool_tcache_key_destr(void *arg)
+{
+    ucs_mpool_tcache_magazine_t *mag = arg;
+    ucs_mpool_tcache_t *tcache       = mag->tcache;
+
+    ucs_spin_lock(&tcache->lock);
+    ucs_mpool_tcache_magazine_flush(mag);
+    ucs_list_del(&mag->list);
+    ucs_spin_unlock(&tcache->lock);
+
+    ucs_free(mag);
+}
+
+ucs_status_t ucs_mpool_tcache_init(ucs_mpool_tcache_t *tcache, ucs_mpool_t *mp,
+                                   unsigned batch)
+{
+    ucs_status_t status;
+    int ret;
+
+    if (batch == 0) {
+        ucs_error("mpool %s: invalid thread cache batch size",
+                  ucs_mpool_name(mp));
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    status = ucs_spinlock_init(&tcache->lock, 0);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ret = pthread_key_create(&tcache->key, ucs_mpool_tcache_key_destr);
+    if (ret != 0) {
+        ucs_error("mpool %s: pthread_key_create() failed: %s",
+                  ucs_mpool_name(mp), strerror(ret));
+        ucs_spinlock_destroy(&tcache->lock);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    tcache->mp    = mp;
+    tcache->batch = batch;
+    ucs_list_head_init(&tcache->magazines);
+
+    ucs_debug("mpool %s: created thread cache with batch %u",
+              ucs_mpool_name(mp), batch);
+    return UCS_OK;
+}
+
+void ucs_mpool_tcache_flush(ucs_mpool_tcache_t *tcache)
+{
+    ucs_mpool_tcache_magazine_t *mag;
+
+    ucs_spin_lock(&tcache->lock);
+    ucs_list_for_each(mag, &tcache->magazines, list) {
+        ucs_mpool_tcache_magazine_flush(mag);
+    }
+    ucs_spin_unlock(&tcache->lock);
+}
+
+void ucs_mpool_tcache_cleanup(ucs_mpool_tcache_t *tcache)
+{
+    ucs_mpool_tcache_magazine_t *mag, *tmp;
+
+    /* Deleting the key prevents the destructor from being called for threads
+     * which exit after this point */
+    pthread_key_delete(tcache->key);
+
+    ucs_list_for_each_safe(mag, tmp, &tcache->magazines, list) {
+        ucs_mpool_tcache_magazine_flush(mag);
+        ucs_list_del(&mag->list);
+        ucs_free(mag);
+    }
+
+    ucs_spinlock_destroy(&tcache->lock);
+}
+
+static ucs_mpool_tcache_magazine_t *
+ucs_mpool_tcache_magazine_get(ucs_mpool_tcache_t *tcache)
+{
+    ucs_mpool_tcache_magazine_t *mag = pthread_getspecific(tcache->key);
+
+    if (mag != NULL) {
+        return mag;
+    }
+
+    mag = ucs_malloc(sizeof(*mag) + (2 * tcache->batch * sizeof(void*)),
+                     "mpool_tcache_magazine");
+    if (mag == NULL) {
+        ucs_debug("mpool %s: failed to allocate thread magazine",
+                  ucs_mpool_name(tcache->mp));
+        return NULL;
+    }
+
+    mag->count  = 0;
+    mag->tcache = tcache;
+
+    ucs_spin_lock(&tcache->lock);
+    ucs_list_add_tail(&tcache->magazines, &mag->list);
+    ucs_spin_unlock(&tcache->lock);
+
+    pthread_setspecific(tcache->key, mag);
+    return mag;
+}
+
+void *ucs_mpool_tcache_get_refill(ucs_mpool_tcache_t *tcache)
+{
+    ucs_mpool_tcache_magazine_t *mag = ucs_mpool_tcache_magazine_get(tcache);
+    void *obj;
+
+    ucs_spin_lock(&tcache->lock);
+    if (ucs_unlikely(mag == NULL)) {
+        /* Could not allocate a magazine, use the central pool directly */
+        obj = ucs_mpool_get_inline(tcache->mp);
+        ucs_spin_unlock(&tcache->lock);
+        return obj;
+    }
+
+    while (mag->count < tcache->batch) {
+        obj = ucs_mpool_get_inline(tcache->mp);
+        if (obj == NULL) {
+            break;
+        }
+
+        mag->objs[mag->count++] = obj;
+    }
+    ucs_spin_unlock(&tcache->lock);
+
+    if (mag->count == 0) {
+        return NULL;
+    }
+
+    return mag->objs[--mag->count];
+}
+
+void ucs_mpool_tcache_put_drain(ucs_mpool_tcache_t *tcache, void *obj)
+{
+    ucs_mpool_tcache_magazine_t *mag = ucs_mpool_tcache_magazine_get(tcache);
+    unsigned i;
+
+    if (ucs_unlikely(mag == NULL)) {
+        ucs_spin_lock(&tcache->lock);
+        ucs_mpool_put_inline(obj);
+        ucs_spin_unlock(&tcache->lock);
+        return;
+    }
+
+    if (mag->count >= (2 * tcache->batch)) {
+        /* Return the least recently used objects, and keep the hot ones */
+        ucs_spin_lock(&tcache->lock);
+        for (i = 0; i < tcache->batch; ++i) {
+            ucs_mpool_put_inline(mag->objs[i]);
+        }
+        ucs_spin_unlock(&tcache->lock);
+
+        mag->count -= tcache->batch;
+        memmove(mag->objs, mag->objs + tcache->batch,
+                mag->count * sizeof(*mag->objs));
+    }
+
+    mag->objs[mag->count++] = obj;
+}
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2025. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCS_MPOOL_TCACHE_H_
+#define UCS_MPOOL_TCACHE_H_
+
+#include <ucs/datastruct/mpool.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/type/spinlock.h>
+
+#include <pthread.h>
+
+BEGIN_C_DECLS
+
+/** @file mpool_tcache.h */
+
+typedef struct ucs_mpool_tcache          ucs_mpool_tcache_t;
+typedef struct ucs_mpool_tcache_magazine ucs_mpool_tcache_magazine_t;
+
+
+/**
+ * Per-thread magazine of objects taken from the central memory pool.
+ * Objects in the magazine are allocated from the point of view of the central
+ * pool, so they are not visible to other threads until the magazine is flushed.
+ */
+struct ucs_mpool_tcache_magazine {
+    unsigned               count;    /* Number of cached objects */
+    ucs_mpool_tcache_t     *tcache;  /* Owner thread cache */
+    ucs_list_link_t        list;     /* Entry in the list of all magazines */
+    void                   *objs[];  /* Cached objects */
+};
+
+
+/**
+ * Thread cache on top of a memory pool.
+ *
+ * Every thread which gets or puts objects has its own magazine, which is
+ * refilled from the central pool, or returned to it, in batches of @a batch
+ * objects. The central pool is accessed only under the thread cache lock, so
+ * the objects may be allocated and released by multiple threads concurrently
+ * without any other synchronization.
+ */
+struct ucs_mpool_tcache {
+    ucs_mpool_t            *mp;        /* Central memory pool */
+    unsigned               batch;      /* Number of objects to move at once */
+    pthread_key_t          key;        /* Current thread magazine */
+    ucs_spinlock_t         lock;       /* Protects the central pool and the
+                                          list of magazines */
+    ucs_list_link_t        magazines;  /* List of all magazines */
+};
+
+
+/**
+ * Initialize a thread cache on top of a memory pool.
+ *
+ * @param tcache     Thread cache to initialize.
+ * @param mp         Central memory pool. It must not be accessed directly
+ *                   while the thread cache is in use.
+ * @param batch      Number of objects moved between a thread magazine and the
+ *                   central pool at once. Every magazine holds up to twice
+ *                   this number of objects.
+ *
+ * @return UCS status code.
+ */
+ucs_status_t ucs_mpool_tcache_init(ucs_mpool_tcache_t *tcache, ucs_mpool_t *mp,
+                                   unsigned batch);
+
+
+/**
+ * Return all cached objects to the central pool and release the thread cache.
+ * The central pool itself is not released.
+ *
+ * @param tcache     Thread cache to clean up.
+ */
+void ucs_mpool_tcache_cleanup(ucs_mpool_tcache_t *tcache);
+
+
+/**
+ * Return the objects cached by all threads to the central pool.
+ * Must not be called concurrently with get or put operations.
+ *
+ * @param tcache     Thread cache to flush.
+ */
+void ucs_mpool_tcache_flush(ucs_mpool_tcache_t *tcache);
+
+
+/**
+ * Slow path of @ref ucs_mpool_tcache_get_inline: create the current thread
+ * magazine if needed, and refill it from the central pool.
+ */
+void *ucs_mpool_tcache_get_refill(ucs_mpool_tcache_t *tcache);
+
+
+/**
+ * Slow path of @ref ucs_mpool_tcache_put_inline: create the current thread
+ * magazine if needed, and return a batch of objects to the central pool.
+ */
+void ucs_mpool_tcache_put_drain(ucs_mpool_tcache_t *tcache, void *obj);
+
+
+END_C_DECLS
+
+#endif /* UCS_MPOOL_TCACHE_H_ */
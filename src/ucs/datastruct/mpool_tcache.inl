@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2025. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCS_MPOOL_TCACHE_INL_
+#define UCS_MPOOL_TCACHE_INL_
+
+#include "mpool_tcache.h"
+
+#include <ucs/sys/compiler_def.h>
+
+
+/**
+ * Get an object using the current thread magazine.
+ *
+ * @param tcache           Thread cache structure.
+ *
+ * @return New allocated object, or NULL if cannot allocate.
+ */
+static UCS_F_ALWAYS_INLINE void*
+ucs_mpool_tcache_get_inline(ucs_mpool_tcache_t *tcache)
+{
+    ucs_mpool_tcache_magazine_t *mag = (ucs_mpool_tcache_magazine_t*)
+            pthread_getspecific(tcache->key);
+
+    if (ucs_likely((mag != NULL) && (mag->count > 0))) {
+        return mag->objs[--mag->count];
+    }
+
+    return ucs_mpool_tcache_get_refill(tcache);
+}
+
+
+/**
+ * Return an object to the current thread magazine.
+ *
+ * @param tcache           Thread cache structure.
+ * @param obj              Object to return.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucs_mpool_tcache_put_inline(ucs_mpool_tcache_t *tcache, void *obj)
+{
+    ucs_mpool_tcache_magazine_t *mag = (ucs_mpool_tcache_magazine_t*)
+            pthread_getspecific(tcache->key);
+
+    if (ucs_likely((mag != NULL) && (mag->count < (2 * tcache->batch)))) {
+        mag->objs[mag->count++] = obj;
+        return;
+    }
+
+    ucs_mpool_tcache_put_drain(tcache, obj);
+}
+
+#endif
@@ -507,6 +507,44 @@ ucs_pgt_region_t *ucs_pgtable_lookup(const ucs_pgtable_t *pgtable,
     }
 }
 
+ucs_pgt_region_t *ucs_pgtable_lookup_concurrent(const ucs_pgtable_t *pgtable,
+                                                ucs_pgt_addr_t address)
+{
+    const volatile ucs_pgtable_t *vpgtable = pgtable;
+    const volatile ucs_pgt_dir_t *dir;
+    ucs_pgt_region_t *region;
+    ucs_pgt_addr_t value;
+    unsigned shift;
+
+    if ((address & vpgtable->mask) != vpgtable->base) {
+        return NULL;
+    }
+
+    /* The page table may be modified while we descend, so every entry is read
+     * exactly once, and an inconsistent view results in a miss rather than an
+     * assertion failure.
+     */
+    value = vpgtable->root.value;
+    shift = vpgtable->shift;
+    for (;;) {
+        if (value & UCS_PGT_ENTRY_FLAG_REGION) {
+            region = (ucs_pgt_region_t*)(value & UCS_PGT_ENTRY_PTR_MASK);
+            if ((address < region->start) || (address >= region->end)) {
+                return NULL;
+            }
+
+            return region;
+        } else if ((value & UCS_PGT_ENTRY_FLAG_DIR) &&
+                   (shift >= (UCS_PGT_ADDR_SHIFT + UCS_PGT_ENTRY_SHIFT))) {
+            dir    = (ucs_pgt_dir_t*)(value & UCS_PGT_ENTRY_PTR_MASK);
+            shift -= UCS_PGT_ENTRY_SHIFT;
+            value  = dir->entries[(address >> shift) & UCS_PGT_ENTRY_MASK].value;
+        } else {
+            return NULL;
+        }
+    }
+}
+
 static void ucs_pgtable_search_recurs(const ucs_pgtable_t *pgtable,
                                       ucs_pgt_addr_t address, unsigned order,
                                       const ucs_pgt_entry_t *pte, unsigned shift,
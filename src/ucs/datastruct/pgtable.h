@@ -209,6 +209,23 @@ ucs_pgt_region_t *ucs_pgtable_lookup(const ucs_pgtable_t *pgtable,
                                      ucs_pgt_addr_t address);
 
 
+/*
+ * Find a region which contains the given address, while the page table may be
+ * concurrently modified by another thread.
+ *
+ * The caller must guarantee that page table directories and regions are not
+ * released during the lookup, and must validate the result, since it may not
+ * reflect the latest state of the page table.
+ *
+ * @param [in]  pgtable     Page table to search the address in.
+ * @param [in]  address     Address to search.
+ *
+ * @return Region which contains 'address', or NULL if not found.
+ */
+ucs_pgt_region_t *ucs_pgtable_lookup_concurrent(const ucs_pgtable_t *pgtable,
+                                                ucs_pgt_addr_t address);
+
+
 /**
  * Search for all regions overlapping with a given address range.
  *
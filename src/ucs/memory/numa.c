@@ -19,6 +19,9 @@
 #include <stdint.h>
 #include <sched.h>
 #include <dirent.h>
+#include <errno.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #define UCS_NUMA_MIN_DISTANCE       10
 #define UCS_NUMA_NODE_MAX           INT16_MAX
@@ -26,6 +29,9 @@
 #define UCS_NUMA_NODES_DIR_PATH     UCS_SYS_FS_SYSTEM_PATH "/node"
 #define UCS_NUMA_NODE_DISTANCE_PATH UCS_NUMA_NODES_DIR_PATH "/node%d/distance"
 
+/* Memory policy mode from linux/mempolicy.h, to avoid depending on libnuma */
+#define UCS_NUMA_MPOL_PREFERRED     1
+
 
 KHASH_MAP_INIT_INT(numa_distance, ucs_numa_distance_t);
 
@@ -253,6 +259,42 @@ ucs_numa_distance(ucs_numa_node_t node1, ucs_numa_node_t node2)
     return distance;
 }
 
+ucs_numa_node_t ucs_numa_current_node()
+{
+    int cpu = sched_getcpu();
+
+    if ((cpu < 0) || (cpu >= __CPU_SETSIZE)) {
+        return UCS_NUMA_NODE_UNDEFINED;
+    }
+
+    return ucs_numa_node_of_cpu(cpu);
+}
+
+ucs_status_t ucs_numa_mbind(void *address, size_t length, ucs_numa_node_t node)
+{
+#ifdef SYS_mbind
+    unsigned long nodemask;
+    long ret;
+
+    if ((node < 0) || (node >= (sizeof(nodemask) * 8))) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    nodemask = UCS_BIT(node);
+    /* The kernel ignores the last bit of the mask */
+    ret      = syscall(SYS_mbind, address, length, UCS_NUMA_MPOL_PREFERRED,
+                       &nodemask, (sizeof(nodemask) * 8) + 1, 0);
+    if (ret != 0) {
+        ucs_debug("mbind(%p, %zu, node=%d) failed: %m", address, length, node);
+        return (errno == ENOSYS) ? UCS_ERR_UNSUPPORTED : UCS_ERR_IO_ERROR;
+    }
+
+    return UCS_OK;
+#else
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
 void ucs_numa_init()
 {
     ucs_spinlock_init(&ucs_numa_global_ctx.lock, 0);
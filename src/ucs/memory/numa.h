@@ -8,6 +8,8 @@
 #define UCS_NUMA_H_
 
 #include <ucs/sys/compiler_def.h>
+#include <ucs/type/status.h>
+#include <stddef.h>
 #include <stdint.h>
 
 BEGIN_C_DECLS
@@ -69,6 +71,27 @@ ucs_numa_node_t ucs_numa_node_of_device(const char *dev_path);
 ucs_numa_distance_t
 ucs_numa_distance(ucs_numa_node_t node1, ucs_numa_node_t node2);
 
+
+/**
+ * @return The NUMA node of the CPU the calling thread is running on, or
+ *         @ref UCS_NUMA_NODE_UNDEFINED if it cannot be determined.
+ */
+ucs_numa_node_t ucs_numa_current_node(void);
+
+
+/**
+ * Set a preferred NUMA node for the pages of a memory range. Pages which were
+ * already faulted in are not migrated.
+ *
+ * @param [in]  address  Start of the memory range, must be page-aligned.
+ * @param [in]  length   Length of the memory range.
+ * @param [in]  node     NUMA node to allocate the pages from.
+ *
+ * @return UCS_OK if the policy was set, or an error if the node is out of
+ *         range or the system does not support memory policies.
+ */
+ucs_status_t ucs_numa_mbind(void *address, size_t length, ucs_numa_node_t node);
+
 END_C_DECLS
 
 #endif
@@ -0,0 +1,252 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2025. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "numa_arena.h"
+#include "numa.h"
+
+#include <ucs/arch/cpu.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/ptr_arith.h>
+#include <ucs/sys/sys.h>
+#include <ucs/type/spinlock.h>
+#include <sys/mman.h>
+
+
+/* Number of NUMA nodes which have their own arena; allocations from other
+ * nodes, or when the node is unknown, use a shared arena with no binding */
+#define UCS_NUMA_ARENA_MAX_NODES    64
+
+/* Minimal size of an arena segment */
+#define UCS_NUMA_ARENA_SEGMENT_SIZE (4 * UCS_MBYTE)
+
+/* Fallback for systems which do not report the huge page size */
+#define UCS_NUMA_ARENA_HUGE_PAGE    (2 * UCS_MBYTE)
+
+#define UCS_NUMA_ARENA_BLOCK_ALIGN  UCS_SYS_CACHE_LINE_SIZE
+
+
+typedef struct ucs_numa_arena_segment {
+    size_t          size;     /* Mapped size of the segment */
+    size_t          offset;   /* Offset of the first free byte */
+    unsigned        refcount; /* Number of allocated blocks */
+    ucs_numa_node_t node;     /* NUMA node the segment is bound to */
+    unsigned        index;    /* Arena index */
+} ucs_numa_arena_segment_t;
+
+
+/* Placed right before each allocated block */
+typedef struct {
+    ucs_numa_arena_segment_t *segment;
+} ucs_numa_arena_block_hdr_t;
+
+
+static struct {
+    ucs_spinlock_t           lock;
+    ucs_numa_arena_segment_t *current[UCS_NUMA_ARENA_MAX_NODES + 1];
+} ucs_numa_arena_ctx;
+
+
+static size_t ucs_numa_arena_huge_page_size()
+{
+    ssize_t huge_page_size = ucs_get_huge_page_size();
+
+    return (huge_page_size > 0) ? huge_page_size : UCS_NUMA_ARENA_HUGE_PAGE;
+}
+
+static ucs_numa_arena_segment_t *
+ucs_numa_arena_segment_create(size_t min_size, ucs_numa_node_t node,
+                              unsigned index)
+{
+    size_t huge_page_size = ucs_numa_arena_huge_page_size();
+    ucs_numa_arena_segment_t *segment;
+    size_t size, head, tail;
+    void *ptr;
+
+    size = ucs_align_up(ucs_max(min_size, UCS_NUMA_ARENA_SEGMENT_SIZE),
+                        huge_page_size);
+
+    /* Over-allocate to align the segment to the huge page size */
+    ptr = mmap(NULL, size + huge_page_size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        ucs_debug("failed to map numa arena segment of %zu bytes: %m", size);
+        return NULL;
+    }
+
+    head = ucs_padding((uintptr_t)ptr, huge_page_size);
+    tail = huge_page_size - head;
+    if (head > 0) {
+        munmap(ptr, head);
+    }
+    if (tail > 0) {
+        munmap(UCS_PTR_BYTE_OFFSET(ptr, head + size), tail);
+    }
+
+    segment = UCS_PTR_BYTE_OFFSET(ptr, head);
+
+    if (madvise(segment, size, MADV_HUGEPAGE) != 0) {
+        ucs_debug("madvise(%p, %zu, MADV_HUGEPAGE) failed: %m", segment,
+                  size);
+    }
+
+    if (node != UCS_NUMA_NODE_UNDEFINED) {
+        ucs_numa_mbind(segment, size, node);
+    }
+
+    segment->size     = size;
+    segment->offset   = sizeof(*segment);
+    segment->refcount = 0;
+    segment->node     = node;
+    segment->index    = index;
+
+    ucs_trace("created numa arena segment %p size %zu node %d", segment, size,
+              node);
+    return segment;
+}
+
+static void ucs_numa_arena_segment_destroy(ucs_numa_arena_segment_t *segment)
+{
+    ucs_trace("destroying numa arena segment %p size %zu node %d", segment,
+              segment->size, segment->node);
+    munmap(segment, segment->size);
+}
+
+/* Allocate a block from the segment, return NULL if there is no space */
+static void *
+ucs_numa_arena_segment_alloc(ucs_numa_arena_segment_t *segment, size_t size)
+{
+    uintptr_t start = (uintptr_t)segment + segment->offset;
+    ucs_numa_arena_block_hdr_t *hdr;
+    uintptr_t ptr;
+
+    ptr = ucs_align_up_pow2(start + sizeof(*hdr), UCS_NUMA_ARENA_BLOCK_ALIGN);
+    if ((ptr + size) > ((uintptr_t)segment + segment->size)) {
+        return NULL;
+    }
+
+    hdr             = (ucs_numa_arena_block_hdr_t*)ptr - 1;
+    hdr->segment    = segment;
+    segment->offset = (ptr + size) - (uintptr_t)segment;
+    ++segment->refcount;
+    return (void*)ptr;
+}
+
+ucs_status_t ucs_numa_arena_alloc(size_t *size_p, void **ptr_p,
+                                  const char *name)
+{
+    ucs_numa_node_t node = ucs_numa_current_node();
+    size_t size          = ucs_align_up_pow2(*size_p,
+                                             UCS_NUMA_ARENA_BLOCK_ALIGN);
+    ucs_numa_arena_segment_t *segment;
+    unsigned index;
+    void *ptr;
+
+    if ((node < 0) || (node >= UCS_NUMA_ARENA_MAX_NODES)) {
+        node  = UCS_NUMA_NODE_UNDEFINED;
+        index = UCS_NUMA_ARENA_MAX_NODES;
+    } else {
+        index = node;
+    }
+
+    ucs_spin_lock(&ucs_numa_arena_ctx.lock);
+
+    segment = ucs_numa_arena_ctx.current[index];
+    if (segment != NULL) {
+        ptr = ucs_numa_arena_segment_alloc(segment, size);
+        if (ptr != NULL) {
+            goto out;
+        }
+    }
+
+    segment = ucs_numa_arena_segment_create(sizeof(*segment) +
+                                            sizeof(ucs_numa_arena_block_hdr_t) +
+                                            UCS_NUMA_ARENA_BLOCK_ALIGN + size,
+                                            node, index);
+    if (segment == NULL) {
+        ucs_spin_unlock(&ucs_numa_arena_ctx.lock);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ptr = ucs_numa_arena_segment_alloc(segment, size);
+    ucs_assert(ptr != NULL);
+
+    /* Keep allocating from the segment which has more free space, and release
+     * the previous segment if it is no longer used */
+    if ((ucs_numa_arena_ctx.current[index] == NULL) ||
+        ((segment->size - segment->offset) >=
+         (ucs_numa_arena_ctx.current[index]->size -
+          ucs_numa_arena_ctx.current[index]->offset))) {
+        if ((ucs_numa_arena_ctx.current[index] != NULL) &&
+            (ucs_numa_arena_ctx.current[index]->refcount == 0)) {
+            ucs_numa_arena_segment_destroy(ucs_numa_arena_ctx.current[index]);
+        }
+        ucs_numa_arena_ctx.current[index] = segment;
+    }
+
+out:
+    ucs_spin_unlock(&ucs_numa_arena_ctx.lock);
+
+    ucs_memtrack_allocated(ptr, size, name);
+    *size_p = size;
+    *ptr_p  = ptr;
+    return UCS_OK;
+}
+
+void ucs_numa_arena_free(void *ptr)
+{
+    ucs_numa_arena_block_hdr_t *hdr = (ucs_numa_arena_block_hdr_t*)ptr - 1;
+    ucs_numa_arena_segment_t *segment;
+
+    ucs_memtrack_releasing(ptr);
+
+    ucs_spin_lock(&ucs_numa_arena_ctx.lock);
+
+    segment = hdr->segment;
+    ucs_assert(segment->refcount > 0);
+    if (--segment->refcount == 0) {
+        if (ucs_numa_arena_ctx.current[segment->index] == segment) {
+            /* Reuse the current segment from the beginning */
+            segment->offset = sizeof(*segment);
+        } else {
+            ucs_numa_arena_segment_destroy(segment);
+        }
+    }
+
+    ucs_spin_unlock(&ucs_numa_arena_ctx.lock);
+}
+
+void ucs_numa_arena_init()
+{
+    unsigned index;
+
+    ucs_spinlock_init(&ucs_numa_arena_ctx.lock, 0);
+    for (index = 0; index <= UCS_NUMA_ARENA_MAX_NODES; ++index) {
+        ucs_numa_arena_ctx.current[index] = NULL;
+    }
+}
+
+void ucs_numa_arena_cleanup()
+{
+    ucs_numa_arena_segment_t *segment;
+    unsigned index;
+
+    /* Segments with allocated blocks are leaked on purpose, since the blocks
+     * may still be used */
+    for (index = 0; index <= UCS_NUMA_ARENA_MAX_NODES; ++index) {
+        segment = ucs_numa_arena_ctx.current[index];
+        if ((segment != NULL) && (segment->refcount == 0)) {
+            ucs_numa_arena_segment_destroy(segment);
+        }
+        ucs_numa_arena_ctx.current[index] = NULL;
+    }
+
+    ucs_spinlock_destroy(&ucs_numa_arena_ctx.lock);
+}
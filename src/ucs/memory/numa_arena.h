@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2025. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCS_NUMA_ARENA_H_
+#define UCS_NUMA_ARENA_H_
+
+#include <ucs/sys/compiler_def.h>
+#include <ucs/type/status.h>
+#include <stddef.h>
+
+BEGIN_C_DECLS
+
+
+/**
+ * Allocate a memory block from the arena of the NUMA node the calling thread
+ * is running on.
+ *
+ * Arena segments are aligned to the huge page size, backed by transparent huge
+ * pages when the system allows it, and their pages are preferably allocated on
+ * the arena NUMA node. Blocks are carved out of the current segment of the
+ * node, and a segment is released when all of its blocks are released.
+ *
+ * @param [inout] size_p  Minimal size to allocate, filled with the actual size.
+ * @param [out]   ptr_p   Filled with a pointer to the allocated block.
+ * @param [in]    name    Allocation name, for memory tracking.
+ *
+ * @return Error status.
+ */
+ucs_status_t ucs_numa_arena_alloc(size_t *size_p, void **ptr_p,
+                                  const char *name);
+
+
+/**
+ * Release a memory block allocated by @ref ucs_numa_arena_alloc.
+ *
+ * @param [in]  ptr  Memory block to release.
+ */
+void ucs_numa_arena_free(void *ptr);
+
+
+void ucs_numa_arena_init(void);
+
+
+void ucs_numa_arena_cleanup(void);
+
+END_C_DECLS
+
+#endif
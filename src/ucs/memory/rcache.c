@@ -20,6 +20,7 @@
 #include <ucs/sys/math.h>
 #include <ucs/sys/sys.h>
 #include <ucs/sys/string.h>
+#include <ucs/time/time.h>
 #include <ucs/arch/cpu.h>
 #include <ucs/type/spinlock.h>
 #include <ucs/vfs/base/vfs_obj.h>
@@ -76,11 +77,17 @@ typedef struct {
 
 
 #ifdef ENABLE_STATS
+static const char *ucs_rcache_stats_histogram_names[] = {
+    [UCS_RCACHE_HIST_MEM_REG] = "mem_reg_lat"
+};
+
 static ucs_stats_class_t ucs_rcache_stats_class = {
-    .name          = "rcache",
-    .num_counters  = UCS_RCACHE_STAT_LAST,
-    .class_id      = UCS_STATS_CLASS_ID_INVALID,
-    .counter_names = {
+    .name            = "rcache",
+    .num_counters    = UCS_RCACHE_STAT_LAST,
+    .class_id        = UCS_STATS_CLASS_ID_INVALID,
+    .num_histograms  = UCS_RCACHE_HIST_LAST,
+    .histogram_names = ucs_rcache_stats_histogram_names,
+    .counter_names   = {
         [UCS_RCACHE_GETS]               = "gets",
         [UCS_RCACHE_HITS_FAST]          = "hits_fast",
         [UCS_RCACHE_HITS_SLOW]          = "hits_slow",
@@ -212,6 +219,113 @@ static int ucs_rcache_stat_min_lz()
     return ucs_count_leading_zero_bits(UCS_RCACHE_STAT_MIN_POW2);
 }
 
+static void ucs_rcache_reader_key_destr(void *arg)
+{
+    ucs_rcache_reader_t *reader = arg;
+    ucs_rcache_t *rcache        = reader->rcache;
+
+    ucs_spin_lock(&rcache->readers.lock);
+    ucs_list_del(&reader->list);
+    ucs_spin_unlock(&rcache->readers.lock);
+
+    ucs_free(reader);
+}
+
+static ucs_rcache_reader_t *ucs_rcache_reader_get(ucs_rcache_t *rcache)
+{
+    ucs_rcache_reader_t *reader;
+    int ret;
+
+    reader = pthread_getspecific(rcache->readers.key);
+    if (ucs_likely(reader != NULL)) {
+        return reader;
+    }
+
+    ret = ucs_posix_memalign((void**)&reader, UCS_SYS_CACHE_LINE_SIZE,
+                             sizeof(*reader), "rcache_reader");
+    if (ret != 0) {
+        ucs_debug("%s: failed to allocate reader state", rcache->name);
+        return NULL;
+    }
+
+    reader->epoch       = 0;
+    reader->last_region = NULL;
+    reader->last_seq    = 0;
+    reader->rcache      = rcache;
+
+    ucs_spin_lock(&rcache->readers.lock);
+    ucs_list_add_tail(&rcache->readers.list, &reader->list);
+    ucs_spin_unlock(&rcache->readers.lock);
+
+    pthread_setspecific(rcache->readers.key, reader);
+    return reader;
+}
+
+static void ucs_rcache_readers_cleanup(ucs_rcache_t *rcache)
+{
+    ucs_rcache_reader_t *reader, *tmp;
+
+    if (rcache->readers.enabled) {
+        /* Deleting the key prevents the destructor from being called for
+         * threads which exit after this point */
+        pthread_key_delete(rcache->readers.key);
+        rcache->readers.enabled = 0;
+    }
+
+    ucs_list_for_each_safe(reader, tmp, &rcache->readers.list, list) {
+        ucs_list_del(&reader->list);
+        ucs_free(reader);
+    }
+
+    ucs_spinlock_destroy(&rcache->readers.lock);
+}
+
+/*
+ * Wait until all lock-free readers which could have observed a page table
+ * directory or a region before it was unlinked have completed their lookup.
+ * Must not be called by a thread which is inside a lock-free lookup.
+ */
+static void ucs_rcache_readers_synchronize(ucs_rcache_t *rcache)
+{
+    ucs_rcache_reader_t *reader;
+    uint64_t reader_epoch, epoch;
+
+    if (!rcache->readers.enabled) {
+        return;
+    }
+
+    epoch = ucs_atomic_fadd64(&rcache->readers.epoch, 1) + 1;
+    ucs_memory_cpu_fence();
+
+    ucs_spin_lock(&rcache->readers.lock);
+    ucs_list_for_each(reader, &rcache->readers.list, list) {
+        for (;;) {
+            reader_epoch = reader->epoch;
+            if ((reader_epoch == 0) || (reader_epoch >= epoch)) {
+                break;
+            }
+
+            sched_yield();
+        }
+    }
+    ucs_spin_unlock(&rcache->readers.lock);
+}
+
+/* Lock must be held in write mode */
+static UCS_F_ALWAYS_INLINE void ucs_rcache_pgt_modify_start(ucs_rcache_t *rcache)
+{
+    ucs_assert(!(rcache->pgt_seq & 1));
+    ++rcache->pgt_seq;
+    ucs_memory_cpu_store_fence();
+}
+
+/* Lock must be held in write mode */
+static UCS_F_ALWAYS_INLINE void ucs_rcache_pgt_modify_end(ucs_rcache_t *rcache)
+{
+    ucs_memory_cpu_store_fence();
+    ++rcache->pgt_seq;
+}
+
 static ucs_pgt_dir_t *ucs_rcache_pgt_dir_alloc(const ucs_pgtable_t *pgtable)
 {
     ucs_rcache_t *rcache = ucs_container_of(pgtable, ucs_rcache_t, pgtable);
@@ -229,6 +343,9 @@ static void ucs_rcache_pgt_dir_release(const ucs_pgtable_t *pgtable,
 {
     ucs_rcache_t *rcache = ucs_container_of(pgtable, ucs_rcache_t, pgtable);
 
+    /* Lock-free readers may still be descending through this directory */
+    ucs_rcache_readers_synchronize(rcache);
+
     ucs_spin_lock(&rcache->lock);
     ucs_mpool_put(dir);
     ucs_spin_unlock(&rcache->lock);
@@ -312,7 +429,7 @@ static void ucs_rcache_region_validate_pfn_cb(unsigned page_num,
                             pfn);
 }
 
-/* Lock must be held for read */
+/* Lock must be held for read, or the region must be held */
 static void ucs_rcache_region_validate_pfn(ucs_rcache_t *rcache,
                                            ucs_rcache_region_t *region)
 {
@@ -370,9 +487,22 @@ static void ucs_rcache_find_regions(ucs_rcache_t *rcache, ucs_pgt_addr_t from,
                              ucs_rcache_region_collect_callback, list);
 }
 
+/* Whether regions can be evicted, so their usage should be tracked */
+static UCS_F_ALWAYS_INLINE int ucs_rcache_lru_enabled(ucs_rcache_t *rcache)
+{
+    return (rcache->params.max_regions != UCS_ULUNITS_INF) ||
+           (rcache->params.max_size != UCS_MEMUNITS_INF);
+}
+
 static void
 ucs_rcache_region_lru_get(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
 {
+    /* Avoid contending on the LRU lock when eviction is disabled */
+    if (!ucs_rcache_lru_enabled(rcache) &&
+        !(region->lru_flags & UCS_RCACHE_LRU_FLAG_IN_LRU)) {
+        return;
+    }
+
     /* A used region cannot be evicted */
     ucs_spin_lock(&rcache->lru.lock);
     ucs_rcache_region_lru_remove(rcache, region);
@@ -382,6 +512,10 @@ ucs_rcache_region_lru_get(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
 static void
 ucs_rcache_region_lru_put(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
 {
+    if (!ucs_rcache_lru_enabled(rcache)) {
+        return;
+    }
+
     /* When we finish using a region, it's a candidate for LRU eviction */
     ucs_spin_lock(&rcache->lru.lock);
     ucs_rcache_region_lru_add(rcache, region);
@@ -463,6 +597,7 @@ void ucs_mem_region_destroy_internal(ucs_rcache_t *rcache,
         ucs_spin_unlock(&rcache->lock);
     }
 
+    ucs_rcache_readers_synchronize(rcache);
     ucs_free(region);
     /* coverity[missing_unlock] */
 }
@@ -517,7 +652,9 @@ static void ucs_rcache_region_invalidate_internal(ucs_rcache_t *rcache,
 
     /* Remove the memory region from page table, if it's there */
     if (region->flags & UCS_RCACHE_REGION_FLAG_PGTABLE) {
+        ucs_rcache_pgt_modify_start(rcache);
         status = ucs_pgtable_remove(&rcache->pgtable, &region->super);
+        ucs_rcache_pgt_modify_end(rcache);
         if (status != UCS_OK) {
             ucs_rcache_region_warn(rcache, region, "failed to remove (%s)",
                                    ucs_status_string(status));
@@ -738,13 +875,13 @@ static void ucs_rcache_lru_evict(ucs_rcache_t *rcache)
         ucs_spin_unlock(&rcache->lru.lock);
 
         /* The region is expected to have refcount=1 and present in pgt, so it
-         * would be destroyed immediately by this function
+         * would usually be destroyed immediately by this function. A lock-free
+         * reader may still hold a transient reference, in which case the
+         * region is destroyed when the reader releases it.
          */
         ucs_rcache_region_trace(rcache, region, "evict");
         ucs_rcache_region_invalidate_internal(
-                rcache, region,
-                UCS_RCACHE_REGION_PUT_FLAG_MUST_DESTROY |
-                        UCS_RCACHE_REGION_PUT_FLAG_IN_PGTABLE);
+                rcache, region, UCS_RCACHE_REGION_PUT_FLAG_IN_PGTABLE);
         ++num_evicted;
 
         ucs_spin_lock(&rcache->lru.lock);
@@ -936,6 +1073,7 @@ ucs_status_t ucs_rcache_create_region(ucs_rcache_t *rcache, void *address,
     int error, merged;
     size_t region_size;
     ucs_rcache_distribution_t *distribution_bin;
+    ucs_time_t UCS_V_UNUSED reg_start_time;
 
     ucs_trace_func("rcache=%s, address=%p, length=%zu", rcache->name, address,
                    length);
@@ -985,10 +1123,13 @@ retry:
 
     region->super.start = start;
     region->super.end   = end;
+    ucs_rcache_pgt_modify_start(rcache);
     status = UCS_PROFILE_CALL(ucs_pgtable_insert, &rcache->pgtable, &region->super);
+    ucs_rcache_pgt_modify_end(rcache);
     if (status != UCS_OK) {
         ucs_error("failed to insert region " UCS_PGT_REGION_FMT ": %s",
                   UCS_PGT_REGION_ARG(&region->super), ucs_status_string(status));
+        ucs_rcache_readers_synchronize(rcache);
         ucs_free(region);
         goto out_unlock;
     }
@@ -1014,9 +1155,12 @@ retry:
     ++distribution_bin->count;
     distribution_bin->total_size += region_size;
 
+    UCS_STATS_START_TIME(reg_start_time);
     region->status = status = UCS_PROFILE_NAMED_CALL_ALWAYS(
             "mem_reg", rcache->params.ops->mem_reg, rcache->params.context,
             rcache, arg, region, merged ? UCS_RCACHE_MEM_REG_HIDE_ERRORS : 0);
+    UCS_STATS_UPDATE_HISTOGRAM_TIME(rcache->stats, UCS_RCACHE_HIST_MEM_REG,
+                                    reg_start_time);
     if (status != UCS_OK) {
         if (merged) {
             /* failure may be due to merge, because memory of the merged
@@ -1071,17 +1215,129 @@ void ucs_rcache_region_hold(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
     ucs_rcache_region_trace(rcache, region, "hold");
 }
 
+static UCS_F_ALWAYS_INLINE int
+ucs_rcache_region_try_hold(ucs_rcache_region_t *region)
+{
+    uint32_t refcount;
+
+    /* A region whose reference count dropped to 0 is being destroyed, and must
+     * not be revived */
+    do {
+        refcount = region->refcount;
+        if (refcount == 0) {
+            return 0;
+        }
+    } while (!ucs_atomic_bool_cswap32(&region->refcount, refcount,
+                                      refcount + 1));
+
+    return 1;
+}
+
+/*
+ * Look up a region without taking the page table lock. The reader announces
+ * the current epoch so that regions and page table directories it may observe
+ * are not released, and validates the result with the page table sequence
+ * number. Returns a held region, or NULL if the slow path should be used.
+ */
+static ucs_rcache_region_t *
+ucs_rcache_lookup_lockfree(ucs_rcache_t *rcache, ucs_rcache_reader_t *reader,
+                           ucs_pgt_addr_t start, size_t length,
+                           size_t alignment, int prot)
+{
+    ucs_rcache_region_t *region, *stale_region;
+    ucs_pgt_region_t *pgt_region;
+    uint64_t seq;
+
+    ucs_atomic_swap64(&reader->epoch, rcache->readers.epoch);
+    ucs_memory_cpu_fence();
+
+    region       = NULL;
+    stale_region = NULL;
+    seq          = rcache->pgt_seq;
+    ucs_memory_cpu_load_fence();
+    if ((seq & 1) || !ucs_queue_is_empty(&rcache->inv_q)) {
+        goto out;
+    }
+
+    if ((reader->last_region != NULL) && (reader->last_seq == seq)) {
+        /* The page table was not modified since the last lookup, so the last
+         * region found by this thread is still valid */
+        region = reader->last_region;
+        if (start < region->super.start) {
+            region = NULL;
+            goto out;
+        }
+    } else {
+        pgt_region = ucs_pgtable_lookup_concurrent(&rcache->pgtable, start);
+        if (pgt_region == NULL) {
+            goto out;
+        }
+
+        region = ucs_derived_of(pgt_region, ucs_rcache_region_t);
+    }
+
+    if (((start + length) > region->super.end) ||
+        !ucs_rcache_region_test(region, prot, alignment) ||
+        !ucs_rcache_region_try_hold(region)) {
+        region = NULL;
+        goto out;
+    }
+
+    ucs_memory_cpu_load_fence();
+    if (rcache->pgt_seq != seq) {
+        /* The page table was modified during the lookup */
+        stale_region = region;
+        region       = NULL;
+        goto out;
+    }
+
+    reader->last_region = region;
+    reader->last_seq    = seq;
+
+out:
+    ucs_memory_cpu_fence();
+    reader->epoch = 0;
+
+    if (stale_region != NULL) {
+        ucs_rcache_region_put_internal(rcache, stale_region,
+                                       UCS_RCACHE_REGION_PUT_FLAG_TAKE_PGLOCK);
+    }
+
+    return region;
+}
+
 ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
                             size_t alignment, int prot, void *arg,
                             ucs_rcache_region_t **region_p)
 {
     ucs_pgt_addr_t start = (uintptr_t)address;
     ucs_pgt_region_t *pgt_region;
+    ucs_rcache_reader_t *reader;
     ucs_rcache_region_t *region;
 
     ucs_trace_func("rcache=%s, address=%p, length=%zu", rcache->name, address,
                    length);
 
+    if (ucs_likely(rcache->readers.enabled)) {
+        reader = ucs_rcache_reader_get(rcache);
+        if (ucs_likely(reader != NULL)) {
+            UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_GETS, 1);
+            region = ucs_rcache_lookup_lockfree(rcache, reader, start, length,
+                                                alignment, prot);
+            if (ucs_likely(region != NULL)) {
+                ucs_rcache_region_trace(rcache, region, "hold");
+                ucs_rcache_region_validate_pfn(rcache, region);
+                ucs_rcache_region_lru_get(rcache, region);
+                *region_p = region;
+                UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_HITS_FAST,
+                                         1);
+                return UCS_OK;
+            }
+
+            goto out_slow;
+        }
+    }
+
     pthread_rwlock_rdlock(&rcache->pgt_lock);
     UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_GETS, 1);
     if (ucs_queue_is_empty(&rcache->inv_q)) {
@@ -1103,10 +1359,12 @@ ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
     }
     pthread_rwlock_unlock(&rcache->pgt_lock);
 
+out_slow:
     /* Fall back to slow version (with rw lock) in following cases:
      * - invalidation list not empty
      * - could not find cached region
      * - found unregistered region
+     * - page table was modified during a lock-free lookup
      */
     return UCS_PROFILE_CALL(ucs_rcache_create_region, rcache, address, length,
                             alignment, prot, arg, region_p);
@@ -1331,6 +1589,24 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
 
     ucs_queue_head_init(&self->inv_q);
 
+    self->pgt_seq       = 0;
+    self->readers.epoch = 1;
+    ucs_list_head_init(&self->readers.list);
+    status = ucs_spinlock_init(&self->readers.lock, 0);
+    if (status != UCS_OK) {
+        goto err_destroy_mp;
+    }
+
+    /* If no thread-specific key is available, lookups take the page table
+     * lock */
+    ret                   = pthread_key_create(&self->readers.key,
+                                               ucs_rcache_reader_key_destr);
+    self->readers.enabled = (ret == 0);
+    if (!self->readers.enabled) {
+        ucs_debug("%s: pthread_key_create() failed: %s, lock-free lookup is "
+                  "disabled", self->name, strerror(ret));
+    }
+
     /* coverity[missing_lock] */
     self->unreleased_size = 0;
     ucs_list_head_init(&self->gc_list);
@@ -1345,7 +1621,7 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
     if (self->distribution == NULL) {
         ucs_error("failed to allocate rcache regions distribution array");
         status = UCS_ERR_NO_MEMORY;
-        goto err_destroy_mp;
+        goto err_destroy_readers;
     }
 
     status = ucs_rcache_global_list_add(self);
@@ -1370,6 +1646,8 @@ err_remove_vfs:
     ucs_rcache_global_list_remove(self);
 err_destroy_dist:
     ucs_free(self->distribution);
+err_destroy_readers:
+    ucs_rcache_readers_cleanup(self);
 err_destroy_mp:
     ucs_mpool_cleanup(&self->mp, 1);
 err_cleanup_pgtable:
@@ -1407,6 +1685,7 @@ static UCS_CLASS_CLEANUP_FUNC(ucs_rcache_t)
 
     ucs_mpool_cleanup(&self->mp, 1);
     ucs_pgtable_cleanup(&self->pgtable);
+    ucs_rcache_readers_cleanup(self);
     ucs_spinlock_destroy(&self->lock);
     pthread_rwlock_destroy(&self->pgt_lock);
     UCS_STATS_NODE_FREE(self->stats);
@@ -55,6 +55,13 @@ enum {
 };
 
 
+/* Names of rcache stats histograms, in nanoseconds */
+enum {
+    UCS_RCACHE_HIST_MEM_REG,        /* duration of memory registration */
+    UCS_RCACHE_HIST_LAST
+};
+
+
 /* The structure represents a group in registration cache regions distribution.
    Regions are distributed by their size.
  */
@@ -63,12 +70,39 @@ typedef struct ucs_rcache_distribution {
     size_t total_size; /**< Total size of regions in the group */
 } ucs_rcache_distribution_t;
 
+/* Per-thread state of a registration cache reader, used by the lock-free
+   lookup path */
+typedef struct ucs_rcache_reader {
+    volatile uint64_t   epoch;       /**< Reclamation epoch observed by the
+                                          current lookup, or 0 if the thread
+                                          is not inside a lookup */
+    ucs_rcache_region_t *last_region; /**< Last region found by this thread */
+    uint64_t            last_seq;    /**< Page table sequence number at which
+                                          'last_region' was found */
+    ucs_rcache_t        *rcache;     /**< Registration cache of the reader */
+    ucs_list_link_t     list;        /**< Entry in the rcache readers list */
+} ucs_rcache_reader_t;
+
+
 struct ucs_rcache {
     ucs_rcache_params_t params;          /**< rcache parameters (immutable) */
 
     pthread_rwlock_t    pgt_lock;        /**< Protects the page table and all
                                               regions whose refcount is 0 */
     ucs_pgtable_t       pgtable;         /**< page table to hold the regions */
+    volatile uint64_t   pgt_seq;         /**< Page table sequence number. It is
+                                              odd while the page table is being
+                                              modified, and lets lock-free
+                                              readers detect concurrent
+                                              modifications */
+
+    struct {
+        pthread_key_t   key;             /**< Thread-specific reader state */
+        int             enabled;         /**< Whether lock-free lookup is used */
+        volatile uint64_t epoch;         /**< Current reclamation epoch */
+        ucs_spinlock_t  lock;            /**< Protects 'list' */
+        ucs_list_link_t list;            /**< List of all reader states */
+    } readers;
 
 
     ucs_spinlock_t      lock;            /**< Protects 'mp', 'inv_q' and 'gc_list'.
@@ -14,12 +14,18 @@
 #include <ucs/debug/debug_int.h>
 #include <ucs/debug/log.h>
 #include <ucs/sys/lib.h>
+#include <ucs/sys/ptr_arith.h>
 #include <ucs/sys/string.h>
 #include <ucs/sys/sys.h>
 #include <ucs/time/time.h>
+#include <sys/mman.h>
 #include <pthread.h>
 
 
+/* Granularity of growing the stream mode file */
+#define UCS_PROFILE_STREAM_FILE_SEGMENT (4 * UCS_MBYTE)
+
+
 typedef struct ucs_profile_global_location {
     ucs_profile_location_t        super; /*< Location info */
     volatile ucs_profile_loc_id_t *loc_id_p; /*< Back-pointer to location index */
@@ -42,6 +48,17 @@ typedef struct ucs_profile_thread_context {
         int                           wraparound;    /**< Whether log was rotated */
     } log;
 
+    struct {
+        ucs_profile_record_t          *records;      /**< Ring of records */
+        uint64_t                      mask;          /**< Ring size minus 1 */
+        volatile uint64_t             head;          /**< Next record to produce */
+        volatile uint64_t             tail;          /**< Next record to flush */
+        uint64_t                      dropped;       /**< Records dropped because
+                                                          the ring was full */
+        uint64_t                      dropped_flushed; /**< Dropped records
+                                                            reported to the file */
+    } stream;
+
     struct {
         unsigned                      num_locations; /**< Number of valid locations */
         ucs_profile_thread_location_t *locations;    /**< Statistics per location */
@@ -64,6 +81,20 @@ struct ucs_profile_context  {
     pthread_mutex_t               mutex;            /**< Protects updating the locations array */
     pthread_key_t                 tls_key;          /**< TLS key for per-thread context */
     ucs_list_link_t               thread_list;      /**< List of all thread contexts */
+
+    struct {
+        int                       fd;               /**< Stream file descriptor */
+        void                      *map;             /**< Mapped stream file */
+        size_t                    map_length;       /**< Size of the mapping */
+        size_t                    file_length;      /**< Current file size */
+        size_t                    offset;           /**< End of written data */
+        unsigned                  num_locations;    /**< Locations written to
+                                                         the file */
+        double                    interval;         /**< Flush interval */
+        int                       stop;             /**< Stop the flush thread */
+        pthread_cond_t            cond;             /**< Wakes the flush thread */
+        pthread_t                 thread;           /**< Flush thread */
+    } stream;
 };
 
 
@@ -77,6 +108,7 @@ struct ucs_profile_context  {
 const char *ucs_profile_mode_names[] = {
     [UCS_PROFILE_MODE_ACCUM] = "accum",
     [UCS_PROFILE_MODE_LOG]   = "log",
+    [UCS_PROFILE_MODE_STREAM] = "stream",
     [UCS_PROFILE_MODE_LAST]  = NULL
 };
 
@@ -296,7 +328,8 @@ static void ucs_profile_write(ucs_profile_context_t *ctx)
     ucs_config_parser_get_env_vars(&env_strb, " ");
     env_variables = ucs_string_buffer_cstr(&env_strb);
 
-    if (!ctx->profile_mode) {
+    if (!(ctx->profile_mode & (UCS_BIT(UCS_PROFILE_MODE_ACCUM) |
+                               UCS_BIT(UCS_PROFILE_MODE_LOG)))) {
         goto out_free_env;
     }
 
@@ -369,10 +402,11 @@ ucs_profile_thread_init(ucs_profile_context_t *ctx)
         return NULL;
     }
 
-    thread_ctx->tid        = ucs_get_tid();
-    thread_ctx->start_time = ucs_get_time();
-    thread_ctx->end_time   = 0;
-    thread_ctx->pthread_id = pthread_self();
+    thread_ctx->tid          = ucs_get_tid();
+    thread_ctx->start_time   = ucs_get_time();
+    thread_ctx->end_time     = 0;
+    thread_ctx->pthread_id   = pthread_self();
+    thread_ctx->is_completed = 0;
 
     ucs_debug("profiling context %p: start on thread 0x%lx tid %d mode %d",
               thread_ctx, (unsigned long)pthread_self(), ucs_get_tid(),
@@ -393,6 +427,25 @@ ucs_profile_thread_init(ucs_profile_context_t *ctx)
         thread_ctx->log.wraparound = 0;
     }
 
+    /* Initialize stream mode */
+    if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_STREAM)) {
+        num_records = ucs_max(ctx->max_file_size / sizeof(ucs_profile_record_t),
+                              2);
+        num_records = ucs_rounddown_pow2(num_records);
+        thread_ctx->stream.records = ucs_malloc(num_records *
+                                                sizeof(ucs_profile_record_t),
+                                                "profile_stream");
+        if (thread_ctx->stream.records == NULL) {
+            ucs_fatal("failed to allocate profiling stream ring");
+        }
+
+        thread_ctx->stream.mask            = num_records - 1;
+        thread_ctx->stream.head            = 0;
+        thread_ctx->stream.tail            = 0;
+        thread_ctx->stream.dropped         = 0;
+        thread_ctx->stream.dropped_flushed = 0;
+    }
+
     /* Initialize accumulate mode */
     if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
         thread_ctx->accum.num_locations = 0;
@@ -422,6 +475,10 @@ static void ucs_profile_thread_cleanup(unsigned profile_mode,
         ucs_free(ctx->accum.locations);
     }
 
+    if (profile_mode & UCS_BIT(UCS_PROFILE_MODE_STREAM)) {
+        ucs_free(ctx->stream.records);
+    }
+
     ucs_list_del(&ctx->list);
     ucs_free(ctx);
 }
@@ -440,6 +497,354 @@ static void ucs_profile_thread_key_destr(void *data)
     ucs_profile_thread_finalize(ctx);
 }
 
+/* Global lock must be held */
+static void *ucs_profile_stream_reserve(ucs_profile_context_t *ctx, size_t size)
+{
+    size_t new_file_length, new_map_length;
+    void *ptr;
+    int ret;
+
+    if (ctx->stream.map == NULL) {
+        return NULL;
+    }
+
+    new_file_length = ctx->stream.offset + size;
+    if (new_file_length > ctx->stream.file_length) {
+        new_file_length = ucs_align_up(new_file_length,
+                                       UCS_PROFILE_STREAM_FILE_SEGMENT);
+        ret             = ftruncate(ctx->stream.fd, new_file_length);
+        if (ret < 0) {
+            ucs_error("failed to extend profiling file to %zu bytes: %m",
+                      new_file_length);
+            return NULL;
+        }
+
+        ctx->stream.file_length = new_file_length;
+    }
+
+    if (new_file_length > ctx->stream.map_length) {
+        new_map_length = ucs_max(2 * ctx->stream.map_length, new_file_length);
+        ptr            = mmap(NULL, new_map_length, PROT_READ|PROT_WRITE,
+                              MAP_SHARED, ctx->stream.fd, 0);
+        if (ptr == MAP_FAILED) {
+            ucs_error("failed to map %zu bytes of profiling file: %m",
+                      new_map_length);
+            return NULL;
+        }
+
+        munmap(ctx->stream.map, ctx->stream.map_length);
+        ctx->stream.map        = ptr;
+        ctx->stream.map_length = new_map_length;
+    }
+
+    ptr                 = UCS_PTR_BYTE_OFFSET(ctx->stream.map,
+                                              ctx->stream.offset);
+    ctx->stream.offset += size;
+    return ptr;
+}
+
+/* Global lock must be held */
+static ucs_profile_stream_chunk_t *
+ucs_profile_stream_chunk(ucs_profile_context_t *ctx,
+                         ucs_profile_stream_chunk_type_t type, uint32_t tid,
+                         uint64_t count, uint64_t dropped, size_t entry_size)
+{
+    ucs_profile_stream_chunk_t *chunk;
+
+    chunk = ucs_profile_stream_reserve(ctx, sizeof(*chunk) +
+                                            (count * entry_size));
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    chunk->type    = type;
+    chunk->tid     = tid;
+    chunk->count   = count;
+    chunk->dropped = dropped;
+    return chunk;
+}
+
+/* Global lock must be held */
+static void ucs_profile_stream_flush_locations(ucs_profile_context_t *ctx)
+{
+    unsigned count = ctx->num_locations - ctx->stream.num_locations;
+    ucs_profile_location_t *locations;
+    ucs_profile_stream_chunk_t *chunk;
+    unsigned i;
+
+    if (count == 0) {
+        return;
+    }
+
+    chunk = ucs_profile_stream_chunk(ctx, UCS_PROFILE_STREAM_CHUNK_LOCATIONS,
+                                     0, count, 0, sizeof(*locations));
+    if (chunk == NULL) {
+        return;
+    }
+
+    locations = (ucs_profile_location_t*)(chunk + 1);
+    for (i = 0; i < count; ++i) {
+        locations[i] = ctx->locations[ctx->stream.num_locations + i].super;
+    }
+
+    ctx->stream.num_locations = ctx->num_locations;
+}
+
+/* Global lock must be held */
+static void
+ucs_profile_stream_flush_thread(ucs_profile_context_t *ctx,
+                                ucs_profile_thread_context_t *thread_ctx)
+{
+    uint64_t tail    = thread_ctx->stream.tail;
+    uint64_t head    = thread_ctx->stream.head;
+    uint64_t dropped = thread_ctx->stream.dropped;
+    uint64_t count, first_count;
+    ucs_profile_stream_chunk_t *chunk;
+    ucs_profile_record_t *records;
+
+    /* Read the records only after reading the head published by the thread */
+    ucs_memory_cpu_load_fence();
+
+    count = head - tail;
+    if ((count == 0) && (dropped == thread_ctx->stream.dropped_flushed)) {
+        return;
+    }
+
+    chunk = ucs_profile_stream_chunk(ctx, UCS_PROFILE_STREAM_CHUNK_RECORDS,
+                                     thread_ctx->tid, count,
+                                     dropped - thread_ctx->stream.dropped_flushed,
+                                     sizeof(*records));
+    if (chunk == NULL) {
+        return;
+    }
+
+    /* The ring may wrap around, so copy it in up to two parts */
+    records     = (ucs_profile_record_t*)(chunk + 1);
+    first_count = ucs_min(count, thread_ctx->stream.mask + 1 -
+                                 (tail & thread_ctx->stream.mask));
+    memcpy(records, &thread_ctx->stream.records[tail & thread_ctx->stream.mask],
+           first_count * sizeof(*records));
+    memcpy(records + first_count, thread_ctx->stream.records,
+           (count - first_count) * sizeof(*records));
+
+    /* Release the ring entries only after they were copied */
+    ucs_memory_cpu_fence();
+    thread_ctx->stream.tail            = head;
+    thread_ctx->stream.dropped_flushed = dropped;
+}
+
+/* Global lock must be held */
+static void ucs_profile_stream_flush(ucs_profile_context_t *ctx)
+{
+    ucs_profile_thread_context_t *thread_ctx, *tmp;
+    ucs_profile_header_t *header;
+
+    if (ctx->stream.map == NULL) {
+        return;
+    }
+
+    /* New locations are registered with the lock held, so all locations used
+     * by the records flushed below are already known */
+    ucs_profile_stream_flush_locations(ctx);
+
+    ucs_list_for_each_safe(thread_ctx, tmp, &ctx->thread_list, list) {
+        ucs_profile_stream_flush_thread(ctx, thread_ctx);
+        /* Release the threads which exited after their last records were
+         * flushed, since the application could create many short-lived
+         * threads during a long run */
+        if (thread_ctx->is_completed &&
+            (thread_ctx->stream.head == thread_ctx->stream.tail)) {
+            ucs_profile_thread_cleanup(ctx->profile_mode, thread_ctx);
+        }
+    }
+
+    header               = ctx->stream.map;
+    header->threads.size = ctx->stream.offset - header->threads.offset;
+}
+
+/* Global lock must be held */
+static void ucs_profile_stream_trim(ucs_profile_context_t *ctx)
+{
+    int ret;
+
+    if (ctx->stream.file_length == ctx->stream.offset) {
+        return;
+    }
+
+    ret = ftruncate(ctx->stream.fd, ctx->stream.offset);
+    if (ret < 0) {
+        ucs_warn("failed to truncate profiling file to %zu bytes: %m",
+                 ctx->stream.offset);
+        return;
+    }
+
+    ctx->stream.file_length = ctx->stream.offset;
+}
+
+static void *ucs_profile_stream_thread_func(void *arg)
+{
+    ucs_profile_context_t *ctx = arg;
+    struct timespec abstime;
+    long nsec;
+
+    ucs_log_set_thread_name("p");
+
+    pthread_mutex_lock(&ctx->mutex);
+    while (!ctx->stream.stop) {
+        clock_gettime(CLOCK_REALTIME, &abstime);
+        nsec             = abstime.tv_nsec +
+                           (long)(ctx->stream.interval * UCS_NSEC_PER_SEC);
+        abstime.tv_sec  += nsec / UCS_NSEC_PER_SEC;
+        abstime.tv_nsec  = nsec % UCS_NSEC_PER_SEC;
+        pthread_cond_timedwait(&ctx->stream.cond, &ctx->mutex, &abstime);
+        ucs_profile_stream_flush(ctx);
+    }
+    pthread_mutex_unlock(&ctx->mutex);
+
+    return NULL;
+}
+
+static ucs_status_t ucs_profile_stream_open(ucs_profile_context_t *ctx)
+{
+    char fullpath[1024] = {0};
+    char filename[1024] = {0};
+    ucs_string_buffer_t env_strb;
+    const char *env_variables;
+    ucs_profile_header_t *header;
+    ucs_status_t status;
+    size_t env_size;
+    int ret;
+
+    ucs_fill_filename_template(ctx->file_name, filename, sizeof(filename));
+    ucs_expand_path(filename, fullpath, sizeof(fullpath) - 1);
+
+    ctx->stream.fd = open(fullpath, O_RDWR|O_CREAT|O_TRUNC, 0600);
+    if (ctx->stream.fd < 0) {
+        ucs_error("failed to open profiling file '%s': %m", fullpath);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    ctx->stream.file_length   = 0;
+    ctx->stream.offset        = 0;
+    ctx->stream.num_locations = 0;
+    ctx->stream.map_length    = UCS_PROFILE_STREAM_FILE_SEGMENT;
+    ctx->stream.map           = mmap(NULL, ctx->stream.map_length,
+                                     PROT_READ|PROT_WRITE, MAP_SHARED,
+                                     ctx->stream.fd, 0);
+    if (ctx->stream.map == MAP_FAILED) {
+        ucs_error("failed to map profiling file '%s': %m", fullpath);
+        ctx->stream.map = NULL;
+        status          = UCS_ERR_IO_ERROR;
+        goto err_close;
+    }
+
+    ucs_string_buffer_init(&env_strb);
+    ucs_config_parser_get_env_vars(&env_strb, " ");
+    env_variables = ucs_string_buffer_cstr(&env_strb);
+    env_size      = strlen(env_variables);
+
+    header = ucs_profile_stream_reserve(ctx, sizeof(*header) + env_size);
+    if (header == NULL) {
+        ucs_string_buffer_cleanup(&env_strb);
+        status = UCS_ERR_IO_ERROR;
+        goto err_unmap;
+    }
+
+    memset(header, 0, sizeof(*header));
+    ucs_strncpy_safe(header->cmdline, ucs_get_process_cmdline(),
+                     sizeof(header->cmdline));
+    ucs_strncpy_safe(header->hostname, ucs_get_host_name(),
+                     sizeof(header->hostname));
+    ucs_strncpy_safe(header->ucs_path, ucs_sys_get_lib_path(),
+                     sizeof(header->ucs_path));
+    header->version          = UCS_PROFILE_FILE_VERSION;
+    header->pid              = getpid();
+    header->mode             = ctx->profile_mode;
+    header->one_second       = ucs_time_from_sec(1.0);
+    header->env_vars.offset  = sizeof(*header);
+    header->env_vars.size    = env_size;
+    header->locations.offset = sizeof(*header) + env_size;
+    header->threads.offset   = sizeof(*header) + env_size;
+    memcpy(header + 1, env_variables, env_size);
+    ucs_string_buffer_cleanup(&env_strb);
+
+    ctx->stream.stop = 0;
+    ret              = pthread_cond_init(&ctx->stream.cond, NULL);
+    if (ret != 0) {
+        ucs_error("failed to initialize condition variable");
+        status = UCS_ERR_IO_ERROR;
+        goto err_unmap;
+    }
+
+    status = ucs_pthread_create(&ctx->stream.thread,
+                                ucs_profile_stream_thread_func, ctx,
+                                "profile");
+    if (status != UCS_OK) {
+        goto err_cond_destroy;
+    }
+
+    ucs_debug("profiling stream to '%s' every %.3f sec", fullpath,
+              ctx->stream.interval);
+    return UCS_OK;
+
+err_cond_destroy:
+    pthread_cond_destroy(&ctx->stream.cond);
+err_unmap:
+    munmap(ctx->stream.map, ctx->stream.map_length);
+    ctx->stream.map = NULL;
+err_close:
+    close(ctx->stream.fd);
+    return status;
+}
+
+static void ucs_profile_stream_close(ucs_profile_context_t *ctx)
+{
+    if (ctx->stream.map == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&ctx->mutex);
+    ctx->stream.stop = 1;
+    pthread_cond_signal(&ctx->stream.cond);
+    pthread_mutex_unlock(&ctx->mutex);
+    pthread_join(ctx->stream.thread, NULL);
+    pthread_cond_destroy(&ctx->stream.cond);
+
+    pthread_mutex_lock(&ctx->mutex);
+    ucs_profile_stream_flush(ctx);
+    ucs_profile_stream_trim(ctx);
+    munmap(ctx->stream.map, ctx->stream.map_length);
+    ctx->stream.map = NULL;
+    close(ctx->stream.fd);
+    pthread_mutex_unlock(&ctx->mutex);
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucs_profile_stream_record(ucs_profile_thread_context_t *thread_ctx,
+                          ucs_time_t current_time, uint32_t param32,
+                          uint64_t param64, ucs_profile_loc_id_t loc_id)
+{
+    uint64_t head = thread_ctx->stream.head;
+    ucs_profile_record_t *rec;
+
+    if (ucs_unlikely((head - thread_ctx->stream.tail) >
+                     thread_ctx->stream.mask)) {
+        /* The ring is full, the flush thread is behind */
+        ++thread_ctx->stream.dropped;
+        return;
+    }
+
+    rec            = &thread_ctx->stream.records[head & thread_ctx->stream.mask];
+    rec->timestamp = current_time;
+    rec->param64   = param64;
+    rec->param32   = param32;
+    rec->location  = loc_id - 1;
+
+    /* Publish the record to the flush thread */
+    ucs_memory_cpu_store_fence();
+    thread_ctx->stream.head = head + 1;
+}
+
 static ucs_profile_loc_id_t
 ucs_profile_location_id(ucs_profile_context_t *ctx,
                         ucs_profile_global_location_t *loc)
@@ -631,6 +1036,11 @@ void ucs_profile_record(ucs_profile_context_t *ctx, ucs_profile_type_t type,
             thread_ctx->log.wraparound = 1;
         }
     }
+
+    if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_STREAM)) {
+        ucs_profile_stream_record(thread_ctx, current_time, param32, param64,
+                                  loc_id);
+    }
 }
 
 static void ucs_profile_check_active_threads(ucs_profile_context_t *ctx)
@@ -695,6 +1105,13 @@ void ucs_profile_dump(ucs_profile_context_t *ctx)
         pthread_setspecific(ctx->tls_key, NULL);
     }
 
+    /* flush the records which were not streamed yet, so the stream file is
+     * complete at this point */
+    pthread_mutex_lock(&ctx->mutex);
+    ucs_profile_stream_flush(ctx);
+    ucs_profile_stream_trim(ctx);
+    pthread_mutex_unlock(&ctx->mutex);
+
     /* write and cleanup all completed threads (including the current thread) */
     ucs_profile_write(ctx);
     ucs_profile_cleanup_completed_threads(ctx);
@@ -743,13 +1160,32 @@ ucs_status_t ucs_profile_init(unsigned profile_mode, const char *file_name,
     ctx->num_locations    = 0;
     ctx->locations        = NULL;
     ctx->max_locations    = 0;
+    ctx->stream.map       = NULL;
+    ctx->stream.interval  = ucs_global_opts.profile_stream_interval;
 
     if (profile_mode && !strlen(file_name)) {
         // TODO make sure profiling file is writeable
         ucs_warn("profiling file not specified");
     }
 
+    if ((profile_mode & UCS_BIT(UCS_PROFILE_MODE_STREAM)) &&
+        (profile_mode != UCS_BIT(UCS_PROFILE_MODE_STREAM))) {
+        ucs_warn("profiling stream mode cannot be combined with other modes, "
+                 "using only stream mode");
+        ctx->profile_mode = UCS_BIT(UCS_PROFILE_MODE_STREAM);
+    }
+
     pthread_key_create(&(ctx->tls_key), ucs_profile_thread_key_destr);
+
+    if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_STREAM)) {
+        status = ucs_profile_stream_open(ctx);
+        if (status != UCS_OK) {
+            /* Same as other modes, failing to write the profiling data should
+             * not fail the application */
+            ctx->profile_mode = 0;
+        }
+    }
+
     *ctx_p = ctx;
 
     return UCS_OK;
@@ -762,6 +1198,7 @@ free_ctx:
 void ucs_profile_cleanup(ucs_profile_context_t *ctx)
 {
     ucs_profile_dump(ctx);
+    ucs_profile_stream_close(ctx);
     ucs_profile_check_active_threads(ctx);
     ucs_profile_reset_locations(ctx);
     pthread_key_delete(ctx->tls_key);
@@ -28,8 +28,10 @@ BEGIN_C_DECLS
  * Profiling modes
  */
 enum {
-    UCS_PROFILE_MODE_ACCUM, /**< Accumulate elapsed time per location */
-    UCS_PROFILE_MODE_LOG,   /**< Record all events */
+    UCS_PROFILE_MODE_ACCUM,  /**< Accumulate elapsed time per location */
+    UCS_PROFILE_MODE_LOG,    /**< Record all events */
+    UCS_PROFILE_MODE_STREAM, /**< Record all events and flush them to the file
+                                  continuously */
     UCS_PROFILE_MODE_LAST
 };
 
@@ -60,7 +62,31 @@ typedef enum {
  *
  * ] * ucs_profile_thread_header_t::num_threads
  * <env variables string>
+ *
+ * In stream mode, the threads block is a sequence of chunks, which are appended
+ * to the file while the application is running:
+ *
+ * [
+ *    < ucs_profile_stream_chunk_t >
+ *    < ucs_profile_location_t > * ucs_profile_stream_chunk_t::count
+ *      (UCS_PROFILE_STREAM_CHUNK_LOCATIONS)
+ *    or
+ *    < ucs_profile_record_t > * ucs_profile_stream_chunk_t::count
+ *      (UCS_PROFILE_STREAM_CHUNK_RECORDS)
+ * ] * N
+ *
+ * The locations block in the header is empty, and every locations chunk
+ * appends new entries to the global locations array.
+ */
+
+
+/**
+ * Stream mode chunk type
  */
+typedef enum {
+    UCS_PROFILE_STREAM_CHUNK_LOCATIONS, /**< New global locations */
+    UCS_PROFILE_STREAM_CHUNK_RECORDS    /**< Records of a single thread */
+} ucs_profile_stream_chunk_type_t;
 
 
 /**
@@ -132,6 +158,18 @@ typedef struct ucs_profile_record {
     uint32_t                 location;      /**< Location identifier */
 } UCS_S_PACKED ucs_profile_record_t;
 
+/**
+ * Stream mode chunk header
+ */
+typedef struct ucs_profile_stream_chunk {
+    uint32_t                 type;          /**< From ucs_profile_stream_chunk_type_t */
+    uint32_t                 tid;           /**< System thread id of the records */
+    uint64_t                 count;         /**< Number of following entries */
+    uint64_t                 dropped;       /**< Number of records the thread
+                                                 dropped since its previous chunk,
+                                                 because the ring was full */
+} UCS_S_PACKED ucs_profile_stream_chunk_t;
+
 typedef struct ucs_profile_context ucs_profile_context_t;
 typedef short ucs_profile_loc_id_t;
 
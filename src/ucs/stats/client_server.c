@@ -660,6 +660,23 @@ unsigned long ucs_stats_server_rcvd_packets(ucs_stats_server_h server)
    return server->rcvd_packets;
 }
 
+unsigned ucs_stats_server_aggregate_histogram(ucs_stats_server_h server,
+                                              const char *cls_name,
+                                              const char *hist_name,
+                                              ucs_stats_histogram_t *result)
+{
+    unsigned count = 0;
+    ucs_stats_node_t *root;
+
+    memset(result, 0, sizeof(*result));
+    ucs_list_for_each(root, &server->curr_stats, list) {
+        count += ucs_stats_histogram_aggregate(root, cls_name, hist_name,
+                                               result);
+    }
+
+    return count;
+}
+
 static inline int stats_entity_cmp(stats_entity_t *e1, stats_entity_t *e2)
 {
     int addr_diff = e1->in_addr.sin_addr.s_addr < e2->in_addr.sin_addr.s_addr;
@@ -57,6 +57,12 @@ ucs_status_t ucs_stats_node_initv(ucs_stats_node_t *node, ucs_stats_class_t *cls
             return status;
         }
     }
+    for (i = 0; i < cls->num_histograms; ++i) {
+        status = ucs_stats_name_check(cls->histogram_names[i]);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
 
     /* Set up node */
     node->cls = cls;
@@ -64,7 +70,93 @@ ucs_status_t ucs_stats_node_initv(ucs_stats_node_t *node, ucs_stats_class_t *cls
     ucs_list_head_init(&node->children[UCS_STATS_INACTIVE_CHILDREN]);
     ucs_list_head_init(&node->children[UCS_STATS_ACTIVE_CHILDREN]);
     memset(node->counters, 0, cls->num_counters * sizeof(ucs_stats_counter_t));
+    if (cls->num_histograms > 0) {
+        memset(node->histograms, 0,
+               cls->num_histograms * sizeof(ucs_stats_histogram_t));
+    }
 
     return UCS_OK;
 }
 
+void ucs_stats_histogram_merge(ucs_stats_histogram_t *dst,
+                               const ucs_stats_histogram_t *src)
+{
+    unsigned i;
+
+    if (src->count == 0) {
+        return;
+    }
+
+    dst->count += src->count;
+    dst->sum   += src->sum;
+    dst->max    = ucs_max(dst->max, src->max);
+    for (i = 0; i < UCS_STATS_HISTOGRAM_NUM_BUCKETS; ++i) {
+        dst->buckets[i] += src->buckets[i];
+    }
+}
+
+static uint64_t ucs_stats_histogram_bucket_max(unsigned index)
+{
+    unsigned exp, shift;
+
+    if (index < UCS_BIT(UCS_STATS_HISTOGRAM_SUB_BITS)) {
+        return index;
+    }
+
+    exp   = (index >> UCS_STATS_HISTOGRAM_SUB_BITS) +
+            UCS_STATS_HISTOGRAM_SUB_BITS - 1;
+    shift = exp - UCS_STATS_HISTOGRAM_SUB_BITS;
+    return ((UCS_BIT(UCS_STATS_HISTOGRAM_SUB_BITS) +
+             (index & UCS_MASK(UCS_STATS_HISTOGRAM_SUB_BITS)) + 1) << shift) - 1;
+}
+
+uint64_t ucs_stats_histogram_percentile(const ucs_stats_histogram_t *hist,
+                                        double percent)
+{
+    uint64_t rank, acc;
+    unsigned i;
+
+    if (hist->count == 0) {
+        return 0;
+    }
+
+    /* Rank of the percentile value, in the range [1..count] */
+    rank = ucs_max((uint64_t)(hist->count * percent / 100.0 + 0.5), 1);
+    acc  = 0;
+    for (i = 0; i < UCS_STATS_HISTOGRAM_NUM_BUCKETS; ++i) {
+        acc += hist->buckets[i];
+        if (acc >= rank) {
+            return ucs_min(ucs_stats_histogram_bucket_max(i), hist->max);
+        }
+    }
+
+    return hist->max;
+}
+
+unsigned ucs_stats_histogram_aggregate(ucs_stats_node_t *root,
+                                       const char *cls_name,
+                                       const char *hist_name,
+                                       ucs_stats_histogram_t *result)
+{
+    unsigned count = 0;
+    ucs_stats_node_t *child;
+    unsigned i;
+
+    if (!strcmp(root->cls->name, cls_name)) {
+        for (i = 0; i < root->cls->num_histograms; ++i) {
+            if (!strcmp(root->cls->histogram_names[i], hist_name)) {
+                ucs_stats_histogram_merge(result, &root->histograms[i]);
+                ++count;
+            }
+        }
+    }
+
+    ucs_list_for_each(child, &root->children[UCS_STATS_ACTIVE_CHILDREN],
+                      list) {
+        count += ucs_stats_histogram_aggregate(child, cls_name, hist_name,
+                                               result);
+    }
+
+    return count;
+}
+
@@ -31,6 +31,18 @@ enum {
 
 #define UCS_STAT_NAME_MAX          39
 
+/*
+ * Histogram buckets are log-linear: values below 2^SUB_BITS have a bucket
+ * each, and every following power of 2 is split to 2^SUB_BITS buckets of equal
+ * width, so the relative error of a bucket value is below 2^-SUB_BITS.
+ * Values of 2^MAX_BITS or larger are counted in the last bucket.
+ */
+#define UCS_STATS_HISTOGRAM_SUB_BITS    3
+#define UCS_STATS_HISTOGRAM_MAX_BITS    40
+#define UCS_STATS_HISTOGRAM_NUM_BUCKETS \
+    ((UCS_STATS_HISTOGRAM_MAX_BITS - UCS_STATS_HISTOGRAM_SUB_BITS + 1) << \
+     UCS_STATS_HISTOGRAM_SUB_BITS)
+
 #define UCS_STATS_NODE_FMT \
     "%s%s"
 #define UCS_STATS_NODE_ARG(_node) \
@@ -56,9 +68,20 @@ struct ucs_stats_class {
     const char           *name;
     unsigned             num_counters;
     unsigned             class_id;
+    unsigned             num_histograms;
+    const char           **histogram_names;
     const char*          counter_names[];
 };
 
+
+/* Distribution of values, e.g operation latencies in nanoseconds */
+typedef struct ucs_stats_histogram {
+    uint64_t             count;      /* Number of values */
+    uint64_t             sum;        /* Sum of all values */
+    uint64_t             max;        /* Maximal value */
+    uint64_t             buckets[UCS_STATS_HISTOGRAM_NUM_BUCKETS];
+} ucs_stats_histogram_t;
+
 /*
  * ucs_stats_node is used to hold the counters, their classes and the
  * relationship between them.
@@ -129,6 +152,7 @@ struct ucs_stats_node {
     ucs_list_link_t          type_list;          /* nodes with same class/es
                                                     hierarchy */
     ucs_stats_filter_node_t  *filter_node;       /* ptr to type list head */
+    ucs_stats_histogram_t    *histograms;        /* instance histograms */
     ucs_stats_counter_t      counters[1];        /* instance counters */
 };
 
@@ -140,8 +164,90 @@ struct ucs_stats_filter_node {
     int                       type_list_len;      /* length of list */
     int                       ref_count;          /* report node when non zero */
     uint64_t                  counters_bitmask;   /* which counters to print */
+    uint64_t                  histograms_bitmask; /* which histograms to print */
 };
 
+
+/**
+ * @return Index of the histogram bucket which counts @a value.
+ */
+static UCS_F_ALWAYS_INLINE unsigned ucs_stats_histogram_bucket(uint64_t value)
+{
+    unsigned exp;
+
+    if (value < UCS_BIT(UCS_STATS_HISTOGRAM_SUB_BITS)) {
+        return value;
+    }
+
+    if (value >= UCS_BIT(UCS_STATS_HISTOGRAM_MAX_BITS)) {
+        return UCS_STATS_HISTOGRAM_NUM_BUCKETS - 1;
+    }
+
+    exp = ucs_ilog2(value);
+    return ((exp - UCS_STATS_HISTOGRAM_SUB_BITS + 1) <<
+            UCS_STATS_HISTOGRAM_SUB_BITS) |
+           ((value >> (exp - UCS_STATS_HISTOGRAM_SUB_BITS)) &
+            UCS_MASK(UCS_STATS_HISTOGRAM_SUB_BITS));
+}
+
+
+/**
+ * Add a value to a histogram.
+ *
+ * @param hist   Histogram to update.
+ * @param value  Value to add.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucs_stats_histogram_add(ucs_stats_histogram_t *hist, uint64_t value)
+{
+    ++hist->count;
+    hist->sum += value;
+    if (value > hist->max) {
+        hist->max = value;
+    }
+    ++hist->buckets[ucs_stats_histogram_bucket(value)];
+}
+
+
+/**
+ * Add all values of one histogram to another.
+ *
+ * @param dst    Histogram to update.
+ * @param src    Histogram to add.
+ */
+void ucs_stats_histogram_merge(ucs_stats_histogram_t *dst,
+                               const ucs_stats_histogram_t *src);
+
+
+/**
+ * Estimate a percentile of a histogram.
+ *
+ * @param hist     Histogram to query.
+ * @param percent  Percentile to estimate, in the range [0..100].
+ *
+ * @return Upper bound of the bucket which contains the percentile, or 0 if the
+ *         histogram is empty.
+ */
+uint64_t ucs_stats_histogram_percentile(const ucs_stats_histogram_t *hist,
+                                        double percent);
+
+
+/**
+ * Merge all histograms with a given name, in all nodes of a given class in a
+ * statistics tree.
+ *
+ * @param root        Statistics tree root.
+ * @param cls_name    Class name of the nodes to aggregate.
+ * @param hist_name   Histogram name.
+ * @param result      Histogram to add the values to.
+ *
+ * @return Number of merged histograms.
+ */
+unsigned ucs_stats_histogram_aggregate(ucs_stats_node_t *root,
+                                       const char *cls_name,
+                                       const char *hist_name,
+                                       ucs_stats_histogram_t *result);
+
 /**
  * Initialize statistics node.
  *
@@ -262,4 +368,21 @@ void ucs_stats_server_purge_stats(ucs_stats_server_h server);
 unsigned long ucs_stats_server_rcvd_packets(ucs_stats_server_h server);
 
 
+/**
+ * Merge a histogram from all entities, in the statistics returned by the last
+ * call to ucs_stats_server_get_stats.
+ *
+ * @param server      Handle to statistics server.
+ * @param cls_name    Class name of the nodes to aggregate.
+ * @param hist_name   Histogram name.
+ * @param result      Filled with the aggregated histogram.
+ *
+ * @return Number of merged histograms.
+ */
+unsigned ucs_stats_server_aggregate_histogram(ucs_stats_server_h server,
+                                              const char *cls_name,
+                                              const char *hist_name,
+                                              ucs_stats_histogram_t *result);
+
+
 #endif /* LIBSTATS_H_ */
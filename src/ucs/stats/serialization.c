@@ -34,6 +34,13 @@
 #define UCS_STATS_COUNTER_U32        2
 #define UCS_STATS_COUNTER_U64        3
 
+/* Number of histogram buckets to encode at once */
+#define UCS_STATS_HISTOGRAM_CHUNK    64
+
+
+/* Binary format version; version 2 adds histograms */
+#define UCS_STATS_DATA_VERSION       2
+
 
 /* Compression mode */
 #define UCS_STATS_COMPRESSION_NONE   0
@@ -226,6 +233,47 @@ static void ucs_stats_write_counters(ucs_stats_counter_t *counters,
     FWRITE(counter_data, pos - counter_data, stream);
 }
 
+/*
+ * A histogram is written as sets of counters: count, sum, max, and then the
+ * buckets in chunks, to limit the temporary buffer size. Since most buckets
+ * are empty, they take 2 bits each in the counters encoding.
+ */
+static void ucs_stats_read_histogram(ucs_stats_histogram_t *hist, FILE *stream)
+{
+    ucs_stats_counter_t summary[3];
+    unsigned i;
+
+    ucs_stats_read_counters(summary, 3, stream);
+    hist->count = summary[0];
+    hist->sum   = summary[1];
+    hist->max   = summary[2];
+
+    for (i = 0; i < UCS_STATS_HISTOGRAM_NUM_BUCKETS;
+         i += UCS_STATS_HISTOGRAM_CHUNK) {
+        ucs_stats_read_counters(&hist->buckets[i],
+                                ucs_min(UCS_STATS_HISTOGRAM_CHUNK,
+                                        UCS_STATS_HISTOGRAM_NUM_BUCKETS - i),
+                                stream);
+    }
+}
+
+static void
+ucs_stats_write_histogram(const ucs_stats_histogram_t *hist, FILE *stream)
+{
+    ucs_stats_counter_t summary[3] = {hist->count, hist->sum, hist->max};
+    unsigned i;
+
+    ucs_stats_write_counters(summary, 3, stream);
+
+    for (i = 0; i < UCS_STATS_HISTOGRAM_NUM_BUCKETS;
+         i += UCS_STATS_HISTOGRAM_CHUNK) {
+        ucs_stats_write_counters((ucs_stats_counter_t*)&hist->buckets[i],
+                                 ucs_min(UCS_STATS_HISTOGRAM_CHUNK,
+                                         UCS_STATS_HISTOGRAM_NUM_BUCKETS - i),
+                                 stream);
+    }
+}
+
 static void
 ucs_stats_serialize_binary_recurs(FILE *stream, ucs_stats_node_t *node,
                                   ucs_stats_children_sel_t sel,
@@ -236,9 +284,11 @@ ucs_stats_serialize_binary_recurs(FILE *stream, ucs_stats_node_t *node,
     uint32_t filtered_counter_index           = 0;
     ucs_stats_class_t *cls = node->cls;
     ucs_stats_clsid_t *elem, search;
+    ucs_stats_histogram_t histogram;
     ucs_stats_node_t *temp_node;
     ucs_stats_node_t *child;
     uint32_t counter_index;
+    uint32_t histogram_index;
     uint8_t sentinel;
 
     /* Search the class */
@@ -263,6 +313,16 @@ ucs_stats_serialize_binary_recurs(FILE *stream, ucs_stats_node_t *node,
     /* Write counters */
     ucs_stats_write_counters(filtered_counters, filtered_counter_index, stream);
 
+    /* Write histograms, merged the same way as counters */
+    ucs_for_each_bit(histogram_index, filter_node->histograms_bitmask) {
+        memset(&histogram, 0, sizeof(histogram));
+        ucs_list_for_each(temp_node, &filter_node->type_list_head, type_list) {
+            ucs_stats_histogram_merge(&histogram,
+                                      &temp_node->histograms[histogram_index]);
+        }
+        ucs_stats_write_histogram(&histogram, stream);
+    }
+
     /* Children */
     ucs_list_for_each(child, &node->children[sel], list) {
         ucs_stats_serialize_binary_recurs(stream, child, sel, cls_hash);
@@ -287,7 +347,7 @@ ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
     sglib_hashed_ucs_stats_clsid_t_init(cls_hash);
 
     /* Write header */
-    hdr.version     = 1;
+    hdr.version     = UCS_STATS_DATA_VERSION;
     hdr.compression = UCS_STATS_COMPRESSION_NONE;
     hdr.reserved    = 0;
     hdr.num_classes = ucs_stats_get_all_classes_recurs(root, sel, cls_hash);
@@ -301,6 +361,7 @@ ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
     {
         ucs_stats_filter_node_t *filter_node;
         unsigned num_counters_filtered;
+        unsigned num_histograms_filtered;
 
         cls = elem->cls;
         ucs_stats_write_str(cls->name, stream);
@@ -312,6 +373,13 @@ ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
         ucs_for_each_bit(counter, filter_node->counters_bitmask) {
            ucs_stats_write_str(cls->counter_names[counter], stream);
         }
+
+        num_histograms_filtered = ucs_popcount(filter_node->histograms_bitmask);
+        FWRITE_ONE(&num_histograms_filtered, stream);
+
+        ucs_for_each_bit(counter, filter_node->histograms_bitmask) {
+           ucs_stats_write_str(cls->histogram_names[counter], stream);
+        }
         elem->clsid = idx++;
     }
 
@@ -330,6 +398,35 @@ ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
     return UCS_OK;
 }
 
+static void
+ucs_stats_serialize_text_histogram(FILE *stream,
+                                   ucs_stats_filter_node_t *filter_node,
+                                   unsigned index, unsigned indent, int is_sum)
+{
+    ucs_stats_class_t *cls = ucs_list_head(&filter_node->type_list_head,
+                                           ucs_stats_node_t, type_list)->cls;
+    ucs_stats_histogram_t histogram;
+    ucs_stats_node_t *node;
+
+    memset(&histogram, 0, sizeof(histogram));
+    ucs_list_for_each(node, &filter_node->type_list_head, type_list) {
+        ucs_stats_histogram_merge(&histogram, &node->histograms[index]);
+    }
+
+    fprintf(stream,
+            "%*s%s:%scount=%"PRIu64" avg=%"PRIu64" p50=%"PRIu64
+            " p90=%"PRIu64" p99=%"PRIu64" p99.9=%"PRIu64" max=%"PRIu64"%s",
+            UCS_STATS_INDENT(is_sum, indent + 1),
+            cls->histogram_names[index], is_sum ? "{" : " ",
+            histogram.count,
+            (histogram.count > 0) ? (histogram.sum / histogram.count) : 0,
+            ucs_stats_histogram_percentile(&histogram, 50),
+            ucs_stats_histogram_percentile(&histogram, 90),
+            ucs_stats_histogram_percentile(&histogram, 99),
+            ucs_stats_histogram_percentile(&histogram, 99.9),
+            histogram.max, is_sum ? "} " : "\n");
+}
+
 static ucs_status_t
 ucs_stats_serialize_text_recurs_filtered(FILE *stream,
                                          ucs_stats_filter_node_t *filter_node,
@@ -398,6 +495,13 @@ ucs_stats_serialize_text_recurs_filtered(FILE *stream,
         }
     }
 
+    for (i = 0; (i < node->cls->num_histograms) && (i < 64); ++i) {
+        if (filter_node->histograms_bitmask & UCS_BIT(i)) {
+            ucs_stats_serialize_text_histogram(stream, filter_node, i, indent,
+                                               is_sum);
+        }
+    }
+
     ucs_list_for_each(filter_child, &filter_node->children, list) {
         ucs_stats_serialize_text_recurs_filtered(stream, filter_child,
                                                  indent + 1);
@@ -439,6 +543,8 @@ ucs_stats_deserialize_recurs(FILE *stream, ucs_stats_class_t **classes,
     ucs_stats_class_t *cls;
     uint8_t clsid, namelen;
     ucs_status_t status;
+    unsigned i;
+    size_t size;
     void *ptr;
 
     if (headroom >= UINT_MAX) {
@@ -466,15 +572,18 @@ ucs_stats_deserialize_recurs(FILE *stream, ucs_stats_class_t **classes,
         return UCS_ERR_OUT_OF_RANGE; /* Name too long */
     }
 
-    cls = classes[clsid];
-    ptr = malloc(headroom + sizeof *node + sizeof(ucs_stats_counter_t) * cls->num_counters);
+    cls  = classes[clsid];
+    size = headroom + sizeof *node + sizeof(ucs_stats_counter_t) * cls->num_counters;
+    ptr  = malloc(size + sizeof(ucs_stats_histogram_t) * cls->num_histograms);
     if (ptr == NULL) {
         ucs_error("Failed to allocate statistics counters (headroom %zu, %u counters)",
                   headroom, cls->num_counters);
         return UCS_ERR_NO_MEMORY;
     }
 
-    node = UCS_PTR_BYTE_OFFSET(ptr, headroom);
+    node             = UCS_PTR_BYTE_OFFSET(ptr, headroom);
+    node->histograms = (cls->num_histograms > 0) ?
+                       UCS_PTR_BYTE_OFFSET(ptr, size) : NULL;
 
     node->cls = cls;
     FREAD(node->name, namelen, stream);
@@ -485,6 +594,11 @@ ucs_stats_deserialize_recurs(FILE *stream, ucs_stats_class_t **classes,
     /* Read counters */
     ucs_stats_read_counters(node->counters, cls->num_counters, stream);
 
+    /* Read histograms */
+    for (i = 0; i < cls->num_histograms; ++i) {
+        ucs_stats_read_histogram(&node->histograms[i], stream);
+    }
+
     /* Read children */
     do {
         status = ucs_stats_deserialize_recurs(stream, classes, num_classes, 0,
@@ -513,6 +627,10 @@ static void ucs_stats_free_classes(ucs_stats_class_t **classes, unsigned num_cla
         for (j = 0; j < classes[i]->num_counters; ++j) {
             free((char*)classes[i]->counter_names[j]);
         }
+        for (j = 0; j < classes[i]->num_histograms; ++j) {
+            free((char*)classes[i]->histogram_names[j]);
+        }
+        free(classes[i]->histogram_names);
         free(classes[i]);
     }
     free(classes);
@@ -523,7 +641,7 @@ ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
     ucs_stats_data_header_t hdr;
     ucs_stats_root_storage_t *s;
     ucs_stats_class_t **classes, *cls;
-    unsigned i, j, num_counters;
+    unsigned i, j, num_counters, num_histograms;
     ucs_status_t status;
     size_t nread;
     char *name;
@@ -534,7 +652,7 @@ ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
         goto err;
     }
 
-    if (hdr.version != 1) {
+    if ((hdr.version != 1) && (hdr.version != UCS_STATS_DATA_VERSION)) {
         ucs_error("invalid file version");
         status = UCS_ERR_UNSUPPORTED;
         goto err;
@@ -561,6 +679,20 @@ ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
         for (j = 0; j < cls->num_counters; ++j) {
             cls->counter_names[j] = ucs_stats_read_str(stream);
         }
+
+        if (hdr.version >= 2) {
+            FREAD_ONE(&num_histograms, stream);
+        } else {
+            num_histograms = 0;
+        }
+
+        /* coverity[tainted_data] */
+        cls->num_histograms  = num_histograms;
+        cls->histogram_names = malloc(num_histograms *
+                                      sizeof(*cls->histogram_names));
+        for (j = 0; j < cls->num_histograms; ++j) {
+            cls->histogram_names[j] = ucs_stats_read_str(stream);
+        }
         classes[i] = cls;
 
     }
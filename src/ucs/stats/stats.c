@@ -145,6 +145,11 @@ static void ucs_stats_free_class(ucs_stats_class_t *cls)
         ucs_free((void*)cls->counter_names[i]);
     }
 
+    for (i = 0; i < cls->num_histograms; i++) {
+        ucs_free((void*)cls->histogram_names[i]);
+    }
+
+    ucs_free(cls->histogram_names);
     ucs_free((void*)cls->name);
     ucs_free(cls);
 }
@@ -178,6 +183,30 @@ static ucs_stats_class_t *ucs_stats_dup_class(ucs_stats_class_t *cls)
         }
     }
 
+    if (cls->num_histograms == 0) {
+        return class_dup;
+    }
+
+    class_dup->histogram_names = ucs_calloc(cls->num_histograms,
+                                            sizeof(*cls->histogram_names),
+                                            "ucs_stats_class_t histograms");
+    if (class_dup->histogram_names == NULL) {
+        ucs_error("failed to allocate statistics histogram names");
+        goto err_free;
+    }
+
+    for (class_dup->num_histograms = 0;
+         class_dup->num_histograms < cls->num_histograms;
+         class_dup->num_histograms++) {
+        class_dup->histogram_names[class_dup->num_histograms] =
+            ucs_strdup(cls->histogram_names[class_dup->num_histograms],
+                       "ucs_stats_class_t histogram");
+        if (!class_dup->histogram_names[class_dup->num_histograms]) {
+            ucs_error("failed to allocate statistics histogram name");
+            goto err_free;
+        }
+    }
+
     return class_dup;
 
 err_free:
@@ -251,6 +280,7 @@ static void ucs_stats_filter_node_init_root() {
     ucs_list_add_tail(&ucs_stats_context.root_filter_node.type_list_head,
                       &ucs_stats_context.root_node.type_list);
     ucs_stats_context.root_filter_node.counters_bitmask = 0;
+    ucs_stats_context.root_filter_node.histograms_bitmask = 0;
     ucs_stats_context.root_filter_node.ref_count = 0;
     ucs_stats_context.root_filter_node.type_list_len = 1;
     ucs_list_head_init(&ucs_stats_context.root_filter_node.children);
@@ -280,16 +310,23 @@ static void ucs_stats_node_init_root(const char *name, ...)
 static ucs_status_t ucs_stats_node_new(ucs_stats_class_t *cls, ucs_stats_node_t **p_node)
 {
     ucs_stats_node_t *node;
-
-    node = ucs_malloc(sizeof(ucs_stats_node_t) +
-                      sizeof(ucs_stats_counter_t) *
-                      (cls->num_counters > 0 ? cls->num_counters - 1 : 0),
+    size_t size;
+
+    /* Histograms are placed after the counters, in the same allocation */
+    size = sizeof(ucs_stats_node_t) +
+           sizeof(ucs_stats_counter_t) *
+           (cls->num_counters > 0 ? cls->num_counters - 1 : 0);
+    node = ucs_malloc(size + (sizeof(ucs_stats_histogram_t) *
+                              cls->num_histograms),
                       "stats node");
     if (node == NULL) {
         ucs_error("Failed to allocate stats node for %s", cls->name);
         return UCS_ERR_NO_MEMORY;
     }
 
+    node->histograms = (cls->num_histograms > 0) ?
+                       UCS_PTR_BYTE_OFFSET(node, size) : NULL;
+
     *p_node = node;
     return UCS_OK;
 }
@@ -355,6 +392,7 @@ static void ucs_stats_add_to_filter(ucs_stats_node_t *node,
         filter_node->type_list_len = 0;
         filter_node->ref_count = 0;
         filter_node->counters_bitmask = 0;
+        filter_node->histograms_bitmask = 0;
         ucs_list_head_init(&filter_node->children);
         ucs_list_head_init(&filter_node->type_list_head);
         filter_node->parent = filter_parent;
@@ -374,6 +412,15 @@ static void ucs_stats_add_to_filter(ucs_stats_node_t *node,
         }
     }
 
+    for (i = 0; (i < node->cls->num_histograms) && (i < 64); ++i) {
+        filter_index = ucs_config_names_search(&ucs_global_opts.stats_filter,
+                                               node->cls->histogram_names[i]);
+        if (filter_index >= 0) {
+            filter_node->histograms_bitmask |= UCS_BIT(i);
+            found = 1;
+        }
+    }
+
     if (found) {
         temp_filter_node = filter_node;
         while (temp_filter_node != NULL) {
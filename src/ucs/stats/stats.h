@@ -149,6 +149,19 @@ void ucs_stats_node_free(ucs_stats_node_t *node);
                               (long)ucs_time_to_nsec(ucs_get_time() - (_start_time))); \
    }
 
+#define UCS_STATS_UPDATE_HISTOGRAM(_node, _index, _value) \
+    if ((_node) != NULL) { \
+        ucs_stats_histogram_add(&(_node)->histograms[(_index)], (_value)); \
+    }
+
+#define UCS_STATS_UPDATE_HISTOGRAM_TIME(_node, _index, _start_time) \
+    if ((_node) != NULL) { \
+        ucs_compiler_fence(); \
+        ucs_stats_histogram_add(&(_node)->histograms[(_index)], \
+                                (uint64_t)ucs_time_to_nsec(ucs_get_time() - \
+                                                           (_start_time))); \
+    }
+
 #else
 
 #define UCS_STATS_ARG(_arg)
@@ -165,6 +178,8 @@ void ucs_stats_node_free(ucs_stats_node_t *node);
 #define UCS_STATS_START_TIME(_start_time)
 #define UCS_STATS_UPDATE_TIME(_node, _index, _start_time)
 #define UCS_STATS_SET_TIME(_node, _index, _start_time)
+#define UCS_STATS_UPDATE_HISTOGRAM(_node, _index, _value)
+#define UCS_STATS_UPDATE_HISTOGRAM_TIME(_node, _index, _start_time)
 
 #endif
 
@@ -19,6 +19,7 @@
 static ucs_status_t
 dump_stats_recurs(FILE *stream, ucs_stats_node_t *node, unsigned indent)
 {
+    ucs_stats_histogram_t *hist;
     ucs_stats_node_t *child;
     unsigned i;
 
@@ -29,6 +30,19 @@ dump_stats_recurs(FILE *stream, ucs_stats_node_t *node, unsigned indent)
         fprintf(stream, "%*s%s: %" PRIu64 "\n", (indent + 1) * 2, "",
                 node->cls->counter_names[i], node->counters[i]);
     }
+    for (i = 0; i < node->cls->num_histograms; ++i) {
+        hist = &node->histograms[i];
+        fprintf(stream,
+                "%*s%s: count=%" PRIu64 " avg=%" PRIu64 " p50=%" PRIu64
+                " p90=%" PRIu64 " p99=%" PRIu64 " p99.9=%" PRIu64
+                " max=%" PRIu64 "\n",
+                (indent + 1) * 2, "", node->cls->histogram_names[i],
+                hist->count, (hist->count > 0) ? (hist->sum / hist->count) : 0,
+                ucs_stats_histogram_percentile(hist, 50),
+                ucs_stats_histogram_percentile(hist, 90),
+                ucs_stats_histogram_percentile(hist, 99),
+                ucs_stats_histogram_percentile(hist, 99.9), hist->max);
+    }
     ucs_list_for_each(child, &node->children[UCS_STATS_ACTIVE_CHILDREN], list) {
         dump_stats_recurs(stream, child, indent + 1);
     }
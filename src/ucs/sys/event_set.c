@@ -21,19 +21,102 @@
 #include <unistd.h>
 #include <sys/epoll.h>
 
+#ifdef HAVE_IO_URING
+#  include <ucs/arch/cpu.h>
+#  include <ucs/datastruct/khash.h>
+#  include <ucs/type/spinlock.h>
+#  include <ucs/time/time.h>
+#  include <linux/io_uring.h>
+#  include <sys/syscall.h>
+#  include <sys/mman.h>
+#  include <poll.h>
+#endif
+
+
+/* Number of submission queue entries of io_uring event set */
+#define UCS_EVENT_SET_IO_URING_SQ_SIZE  256
+
+/* Number of completion queue entries of io_uring event set, every registered
+ * fd has at most one poll request in flight */
+#define UCS_EVENT_SET_IO_URING_CQ_SIZE  4096
+
+/* Tag of requests which completions should be ignored */
+#define UCS_EVENT_SET_IO_URING_NO_TAG   UINT64_MAX
+
 
 enum {
     UCS_SYS_EVENT_SET_EXTERNAL_EVENT_FD = UCS_BIT(0),
 };
 
+
+#ifdef HAVE_IO_URING
+
+/* File descriptor registered on io_uring event set */
+typedef struct {
+    void                  *callback_data;
+    ucs_event_set_types_t events;
+    int                   armed;    /* Poll request is in flight */
+    uint32_t              gen;      /* Generation of the poll request */
+} ucs_event_set_io_uring_fd_t;
+
+
+KHASH_MAP_INIT_INT(ucs_event_set_io_uring_fds, ucs_event_set_io_uring_fd_t);
+
+
+typedef struct {
+    ucs_spinlock_t        lock;         /* Protects SQ and the fd hash */
+    int                   dispatching;  /* Events are being dispatched,
+                                           defer submission to its end */
+    uint32_t              gen;          /* Last poll request generation */
+
+    struct {
+        unsigned          *head;
+        unsigned          *tail;
+        unsigned          *array;
+        unsigned          *flags;
+        unsigned          mask;
+        unsigned          entries;
+        unsigned          local_tail;   /* Tail including queued SQEs */
+        unsigned          submitted;    /* Tail which was submitted */
+        struct io_uring_sqe *sqes;
+    } sq;
+
+    struct {
+        unsigned          *head;
+        unsigned          *tail;
+        unsigned          mask;
+        struct io_uring_cqe *cqes;
+    } cq;
+
+    void                  *sq_ring;
+    size_t                sq_ring_size;
+    void                  *cq_ring;
+    size_t                cq_ring_size;
+    size_t                sqes_size;
+
+    khash_t(ucs_event_set_io_uring_fds) fds;
+} ucs_event_set_io_uring_t;
+
+#endif /* HAVE_IO_URING */
+
+
 struct ucs_sys_event_set {
-    int      event_fd;
-    unsigned flags;
+    int                      event_fd;
+    unsigned                 flags;
+#ifdef HAVE_IO_URING
+    ucs_event_set_io_uring_t *uring;    /* NULL if epoll is used */
+#endif
 };
 
 const unsigned ucs_sys_event_set_max_wait_events =
     UCS_ALLOCA_MAX_SIZE / sizeof(struct epoll_event);
 
+const char *ucs_event_set_backend_names[] = {
+    [UCS_EVENT_SET_BACKEND_EPOLL]    = "epoll",
+    [UCS_EVENT_SET_BACKEND_IO_URING] = "io_uring",
+    [UCS_EVENT_SET_BACKEND_LAST]     = NULL
+};
+
 
 static inline int ucs_event_set_map_to_raw_events(ucs_event_set_types_t events)
 {
@@ -73,6 +156,610 @@ static inline int ucs_event_set_map_to_events(int raw_events)
     return events;
 }
 
+#ifdef HAVE_IO_URING
+
+static inline unsigned
+ucs_event_set_io_uring_map_to_poll_events(ucs_event_set_types_t events)
+{
+    unsigned poll_events = 0;
+
+    if (events & UCS_EVENT_SET_EVREAD) {
+        poll_events |= POLLIN;
+    }
+    if (events & UCS_EVENT_SET_EVWRITE) {
+        poll_events |= POLLOUT;
+    }
+    if (events & UCS_EVENT_SET_EVERR) {
+        poll_events |= POLLERR;
+    }
+    return poll_events;
+}
+
+static inline ucs_event_set_types_t
+ucs_event_set_io_uring_map_to_events(int poll_events)
+{
+    ucs_event_set_types_t events = 0;
+
+    if (poll_events & POLLIN) {
+        events |= UCS_EVENT_SET_EVREAD;
+    }
+    if (poll_events & POLLOUT) {
+        events |= UCS_EVENT_SET_EVWRITE;
+    }
+    if (poll_events & POLLERR) {
+        events |= UCS_EVENT_SET_EVERR;
+    }
+    return events;
+}
+
+static inline uint64_t ucs_event_set_io_uring_tag(int fd, uint32_t gen)
+{
+    return ((uint64_t)gen << 32) | (uint32_t)fd;
+}
+
+static inline int ucs_event_set_io_uring_enter(ucs_sys_event_set_t *event_set,
+                                               unsigned to_submit,
+                                               unsigned min_complete,
+                                               unsigned flags, const void *arg,
+                                               size_t argsz)
+{
+    return syscall(__NR_io_uring_enter, event_set->event_fd, to_submit,
+                   min_complete, flags, arg, argsz);
+}
+
+/* Must be called with the lock held */
+static ucs_status_t ucs_event_set_io_uring_submit(ucs_sys_event_set_t *event_set)
+{
+    ucs_event_set_io_uring_t *uring = event_set->uring;
+    unsigned to_submit;
+    int ret;
+
+    while (uring->sq.submitted != uring->sq.local_tail) {
+        to_submit = uring->sq.local_tail - uring->sq.submitted;
+        ret       = ucs_event_set_io_uring_enter(event_set, to_submit, 0, 0,
+                                                 NULL, 0);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if ((errno == EAGAIN) || (errno == EBUSY)) {
+                /* the kernel is short of resources, retry on next wait */
+                return UCS_OK;
+            }
+
+            ucs_error("io_uring_enter(fd=%d, to_submit=%u) failed: %m",
+                      event_set->event_fd, to_submit);
+            return UCS_ERR_IO_ERROR;
+        }
+
+        uring->sq.submitted += ret;
+    }
+
+    return UCS_OK;
+}
+
+static inline int
+ucs_event_set_io_uring_cq_overflow(ucs_event_set_io_uring_t *uring)
+{
+    return *(volatile unsigned*)uring->sq.flags & IORING_SQ_CQ_OVERFLOW;
+}
+
+/* Move completions which did not fit the CQ ring from the kernel backlog */
+static ucs_status_t
+ucs_event_set_io_uring_flush_overflow(ucs_sys_event_set_t *event_set)
+{
+    int ret;
+
+    do {
+        ret = ucs_event_set_io_uring_enter(event_set, 0, 0,
+                                           IORING_ENTER_GETEVENTS, NULL, 0);
+    } while ((ret < 0) && (errno == EINTR));
+
+    if (ret < 0) {
+        ucs_error("io_uring_enter(fd=%d, GETEVENTS) failed: %m",
+                  event_set->event_fd);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    return UCS_OK;
+}
+
+/* Must be called with the lock held */
+static struct io_uring_sqe *
+ucs_event_set_io_uring_get_sqe(ucs_sys_event_set_t *event_set)
+{
+    ucs_event_set_io_uring_t *uring = event_set->uring;
+    struct io_uring_sqe *sqe;
+    unsigned index;
+
+    if ((uring->sq.local_tail - *uring->sq.head) >= uring->sq.entries) {
+        /* SQ is full, the kernel consumes the entries during submission */
+        if ((ucs_event_set_io_uring_submit(event_set) != UCS_OK) ||
+            ((uring->sq.local_tail - *uring->sq.head) >= uring->sq.entries)) {
+            ucs_error("io_uring event set %d: submission queue is full",
+                      event_set->event_fd);
+            return NULL;
+        }
+    }
+
+    index                 = uring->sq.local_tail & uring->sq.mask;
+    sqe                   = &uring->sq.sqes[index];
+    uring->sq.array[index] = index;
+    memset(sqe, 0, sizeof(*sqe));
+    ++uring->sq.local_tail;
+
+    ucs_memory_cpu_store_fence();
+    *uring->sq.tail = uring->sq.local_tail;
+    return sqe;
+}
+
+/* Must be called with the lock held */
+static ucs_status_t
+ucs_event_set_io_uring_flush(ucs_sys_event_set_t *event_set)
+{
+    if (event_set->uring->dispatching) {
+        /* submitted in a batch after all events are dispatched */
+        return UCS_OK;
+    }
+
+    return ucs_event_set_io_uring_submit(event_set);
+}
+
+/* Must be called with the lock held */
+static ucs_status_t
+ucs_event_set_io_uring_arm(ucs_sys_event_set_t *event_set, int fd,
+                           ucs_event_set_io_uring_fd_t *entry)
+{
+    ucs_event_set_io_uring_t *uring = event_set->uring;
+    struct io_uring_sqe *sqe;
+
+    sqe = ucs_event_set_io_uring_get_sqe(event_set);
+    if (sqe == NULL) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    entry->gen          = ++uring->gen;
+    entry->armed        = 1;
+    sqe->opcode         = IORING_OP_POLL_ADD;
+    sqe->fd             = fd;
+    sqe->poll32_events  = ucs_event_set_io_uring_map_to_poll_events(
+                                  entry->events);
+    sqe->user_data      = ucs_event_set_io_uring_tag(fd, entry->gen);
+    if (entry->events & UCS_EVENT_SET_EDGE_TRIGGERED) {
+        /* multi-shot poll completes on every wakeup of the file */
+        sqe->len = IORING_POLL_ADD_MULTI;
+    }
+
+    return UCS_OK;
+}
+
+/* Must be called with the lock held */
+static ucs_status_t
+ucs_event_set_io_uring_disarm(ucs_sys_event_set_t *event_set, int fd,
+                              ucs_event_set_io_uring_fd_t *entry)
+{
+    struct io_uring_sqe *sqe;
+
+    if (!entry->armed) {
+        return UCS_OK;
+    }
+
+    sqe = ucs_event_set_io_uring_get_sqe(event_set);
+    if (sqe == NULL) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    /* completions of the removed request are ignored by generation */
+    entry->armed   = 0;
+    sqe->opcode    = IORING_OP_POLL_REMOVE;
+    sqe->fd        = -1;
+    sqe->addr      = ucs_event_set_io_uring_tag(fd, entry->gen);
+    sqe->user_data = UCS_EVENT_SET_IO_URING_NO_TAG;
+    return UCS_OK;
+}
+
+static ucs_status_t
+ucs_event_set_io_uring_add(ucs_sys_event_set_t *event_set, int fd,
+                           ucs_event_set_types_t events, void *callback_data)
+{
+    ucs_event_set_io_uring_t *uring = event_set->uring;
+    ucs_event_set_io_uring_fd_t *entry;
+    ucs_status_t status;
+    khiter_t iter;
+    int ret;
+
+    ucs_spin_lock(&uring->lock);
+
+    iter = kh_put(ucs_event_set_io_uring_fds, &uring->fds, fd, &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        status = UCS_ERR_NO_MEMORY;
+        goto out;
+    } else if (ret == UCS_KH_PUT_KEY_PRESENT) {
+        ucs_error("io_uring event set %d: fd %d is already added",
+                  event_set->event_fd, fd);
+        status = UCS_ERR_ALREADY_EXISTS;
+        goto out;
+    }
+
+    entry                = &kh_val(&uring->fds, iter);
+    entry->callback_data = callback_data;
+    entry->events        = events;
+    entry->armed         = 0;
+
+    status = ucs_event_set_io_uring_arm(event_set, fd, entry);
+    if (status != UCS_OK) {
+        kh_del(ucs_event_set_io_uring_fds, &uring->fds, iter);
+        goto out;
+    }
+
+    status = ucs_event_set_io_uring_flush(event_set);
+
+out:
+    ucs_spin_unlock(&uring->lock);
+    return status;
+}
+
+static ucs_status_t
+ucs_event_set_io_uring_mod(ucs_sys_event_set_t *event_set, int fd,
+                           ucs_event_set_types_t events, void *callback_data)
+{
+    ucs_event_set_io_uring_t *uring = event_set->uring;
+    ucs_event_set_io_uring_fd_t *entry;
+    ucs_status_t status;
+    khiter_t iter;
+
+    ucs_spin_lock(&uring->lock);
+
+    iter = kh_get(ucs_event_set_io_uring_fds, &uring->fds, fd);
+    if (iter == kh_end(&uring->fds)) {
+        ucs_error("io_uring event set %d: fd %d is not found",
+                  event_set->event_fd, fd);
+        status = UCS_ERR_NO_ELEM;
+        goto out;
+    }
+
+    entry                = &kh_val(&uring->fds, iter);
+    entry->callback_data = callback_data;
+    if ((entry->events == events) && entry->armed) {
+        status = UCS_OK;
+        goto out;
+    }
+
+    entry->events = events;
+    status        = ucs_event_set_io_uring_disarm(event_set, fd, entry);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    status = ucs_event_set_io_uring_arm(event_set, fd, entry);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    status = ucs_event_set_io_uring_flush(event_set);
+
+out:
+    ucs_spin_unlock(&uring->lock);
+    return status;
+}
+
+static ucs_status_t
+ucs_event_set_io_uring_del(ucs_sys_event_set_t *event_set, int fd)
+{
+    ucs_event_set_io_uring_t *uring = event_set->uring;
+    ucs_status_t status;
+    khiter_t iter;
+
+    ucs_spin_lock(&uring->lock);
+
+    iter = kh_get(ucs_event_set_io_uring_fds, &uring->fds, fd);
+    if (iter == kh_end(&uring->fds)) {
+        ucs_error("io_uring event set %d: fd %d is not found",
+                  event_set->event_fd, fd);
+        status = UCS_ERR_NO_ELEM;
+        goto out;
+    }
+
+    status = ucs_event_set_io_uring_disarm(event_set, fd,
+                                           &kh_val(&uring->fds, iter));
+    kh_del(ucs_event_set_io_uring_fds, &uring->fds, iter);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    status = ucs_event_set_io_uring_flush(event_set);
+
+out:
+    ucs_spin_unlock(&uring->lock);
+    return status;
+}
+
+static ucs_status_t
+ucs_event_set_io_uring_wait(ucs_sys_event_set_t *event_set,
+                            unsigned *num_events, int timeout_ms,
+                            ucs_event_set_handler_t event_set_handler,
+                            void *arg)
+{
+    ucs_event_set_io_uring_t *uring = event_set->uring;
+    struct io_uring_getevents_arg getevents_arg;
+    ucs_event_set_io_uring_fd_t *entry;
+    struct __kernel_timespec ts;
+    ucs_event_set_types_t events;
+    void *callback_data;
+    struct io_uring_cqe cqe;
+    unsigned head, nready;
+    int overflow_flushed;
+    ucs_status_t status;
+    khiter_t iter;
+    int fd, ret;
+
+    ucs_spin_lock(&uring->lock);
+    status = ucs_event_set_io_uring_submit(event_set);
+    ucs_spin_unlock(&uring->lock);
+    if (status != UCS_OK) {
+        *num_events = 0;
+        return status;
+    }
+
+    if ((timeout_ms != 0) && (*uring->cq.head == *uring->cq.tail)) {
+        memset(&getevents_arg, 0, sizeof(getevents_arg));
+        if (timeout_ms > 0) {
+            ts.tv_sec        = timeout_ms / UCS_MSEC_PER_SEC;
+            ts.tv_nsec       = (timeout_ms % UCS_MSEC_PER_SEC) *
+                               (UCS_NSEC_PER_SEC / UCS_MSEC_PER_SEC);
+            getevents_arg.ts = (uintptr_t)&ts;
+        }
+
+        ret = ucs_event_set_io_uring_enter(event_set, 0, 1,
+                                           IORING_ENTER_GETEVENTS |
+                                           IORING_ENTER_EXT_ARG,
+                                           &getevents_arg,
+                                           sizeof(getevents_arg));
+        if ((ret < 0) && (errno != ETIME)) {
+            *num_events = 0;
+            if (errno == EINTR) {
+                return UCS_INPROGRESS;
+            }
+            ucs_error("io_uring_enter(fd=%d, GETEVENTS) failed: %m",
+                      event_set->event_fd);
+            return UCS_ERR_IO_ERROR;
+        }
+    }
+
+    uring->dispatching = 1;
+    overflow_flushed   = 0;
+
+    /* reap completions from the shared ring without system calls */
+    for (nready = 0; nready < *num_events; ) {
+        head = *uring->cq.head;
+        if (head == *uring->cq.tail) {
+            if (overflow_flushed ||
+                !ucs_event_set_io_uring_cq_overflow(uring)) {
+                break;
+            }
+
+            /* the ring has room now, fetch the completions which overflowed
+             * it, otherwise the kernel rejects new submissions */
+            status = ucs_event_set_io_uring_flush_overflow(event_set);
+            if (status != UCS_OK) {
+                break;
+            }
+
+            overflow_flushed = 1;
+            continue;
+        }
+
+        ucs_memory_cpu_load_fence();
+        cqe = uring->cq.cqes[head & uring->cq.mask];
+        ucs_memory_cpu_fence();
+        *uring->cq.head = head + 1;
+
+        if (cqe.user_data == UCS_EVENT_SET_IO_URING_NO_TAG) {
+            continue;
+        }
+
+        fd = (int)(uint32_t)cqe.user_data;
+
+        ucs_spin_lock(&uring->lock);
+        iter = kh_get(ucs_event_set_io_uring_fds, &uring->fds, fd);
+        if ((iter == kh_end(&uring->fds)) ||
+            (kh_val(&uring->fds, iter).gen != (cqe.user_data >> 32))) {
+            /* the request was removed or replaced */
+            ucs_spin_unlock(&uring->lock);
+            continue;
+        }
+
+        entry = &kh_val(&uring->fds, iter);
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            entry->armed = 0;
+        }
+
+        if (cqe.res < 0) {
+            ucs_debug("io_uring event set %d: poll on fd %d failed: %s",
+                      event_set->event_fd, fd, strerror(-cqe.res));
+            events = UCS_EVENT_SET_EVERR;
+        } else {
+            events = ucs_event_set_io_uring_map_to_events(cqe.res);
+        }
+
+        callback_data = entry->callback_data;
+        ucs_spin_unlock(&uring->lock);
+
+        event_set_handler(callback_data, events, arg);
+        ++nready;
+
+        /* the handler could modify or remove the fd, re-arm level-triggered
+         * poll request if it's still needed */
+        ucs_spin_lock(&uring->lock);
+        iter = kh_get(ucs_event_set_io_uring_fds, &uring->fds, fd);
+        if (iter != kh_end(&uring->fds)) {
+            entry = &kh_val(&uring->fds, iter);
+            if (!entry->armed) {
+                ucs_event_set_io_uring_arm(event_set, fd, entry);
+            }
+        }
+        ucs_spin_unlock(&uring->lock);
+    }
+
+    ucs_spin_lock(&uring->lock);
+    uring->dispatching = 0;
+    status             = ucs_event_set_io_uring_submit(event_set);
+    ucs_spin_unlock(&uring->lock);
+
+    ucs_trace_poll("io_uring event set %d: num_events=%u timeout=%d "
+                   "returned %u", event_set->event_fd, *num_events,
+                   timeout_ms, nready);
+
+    *num_events = nready;
+    return status;
+}
+
+static void ucs_event_set_io_uring_cleanup(ucs_sys_event_set_t *event_set)
+{
+    ucs_event_set_io_uring_t *uring = event_set->uring;
+
+    if (uring->sqes_size != 0) {
+        munmap(uring->sq.sqes, uring->sqes_size);
+    }
+    if ((uring->cq_ring != NULL) && (uring->cq_ring != uring->sq_ring)) {
+        munmap(uring->cq_ring, uring->cq_ring_size);
+    }
+    if (uring->sq_ring != NULL) {
+        munmap(uring->sq_ring, uring->sq_ring_size);
+    }
+
+    kh_destroy_inplace(ucs_event_set_io_uring_fds, &uring->fds);
+    ucs_spinlock_destroy(&uring->lock);
+    ucs_free(uring);
+}
+
+static void *ucs_event_set_io_uring_mmap(int fd, size_t size, off_t offset)
+{
+    void *ptr;
+
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+               fd, offset);
+    if (ptr == MAP_FAILED) {
+        ucs_debug("failed to map io_uring fd %d offset 0x%lx: %m", fd,
+                  (unsigned long)offset);
+        return NULL;
+    }
+
+    return ptr;
+}
+
+static ucs_status_t ucs_event_set_io_uring_init(ucs_sys_event_set_t *event_set)
+{
+    const unsigned required_features = IORING_FEAT_NODROP |
+                                       IORING_FEAT_EXT_ARG;
+    struct io_uring_params params;
+    ucs_event_set_io_uring_t *uring;
+    ucs_status_t status;
+
+    /* Completions are posted by task work which interrupts the waiting
+     * thread, so the ring fd can be also waited on by external poll */
+    memset(&params, 0, sizeof(params));
+    params.flags      = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = UCS_EVENT_SET_IO_URING_CQ_SIZE;
+    event_set->event_fd = syscall(__NR_io_uring_setup,
+                                  UCS_EVENT_SET_IO_URING_SQ_SIZE, &params);
+    if (event_set->event_fd < 0) {
+        ucs_debug("io_uring_setup() failed: %m");
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    if ((params.features & required_features) != required_features) {
+        ucs_debug("io_uring features 0x%x do not include required 0x%x",
+                  params.features, required_features);
+        status = UCS_ERR_UNSUPPORTED;
+        goto err_close;
+    }
+
+    uring = ucs_calloc(1, sizeof(*uring), "ucs_event_set_io_uring");
+    if (uring == NULL) {
+        ucs_error("failed to allocate io_uring event set");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_close;
+    }
+
+    event_set->uring = uring;
+    ucs_spinlock_init(&uring->lock, 0);
+    kh_init_inplace(ucs_event_set_io_uring_fds, &uring->fds);
+
+    uring->sq_ring_size = params.sq_off.array +
+                          (params.sq_entries * sizeof(unsigned));
+    uring->cq_ring_size = params.cq_off.cqes +
+                          (params.cq_entries * sizeof(struct io_uring_cqe));
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        uring->sq_ring_size = ucs_max(uring->sq_ring_size,
+                                      uring->cq_ring_size);
+        uring->cq_ring_size = uring->sq_ring_size;
+    }
+
+    uring->sq_ring = ucs_event_set_io_uring_mmap(event_set->event_fd,
+                                                 uring->sq_ring_size,
+                                                 IORING_OFF_SQ_RING);
+    if (uring->sq_ring == NULL) {
+        status = UCS_ERR_IO_ERROR;
+        goto err_cleanup;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        uring->cq_ring = uring->sq_ring;
+    } else {
+        uring->cq_ring = ucs_event_set_io_uring_mmap(event_set->event_fd,
+                                                     uring->cq_ring_size,
+                                                     IORING_OFF_CQ_RING);
+        if (uring->cq_ring == NULL) {
+            status = UCS_ERR_IO_ERROR;
+            goto err_cleanup;
+        }
+    }
+
+    uring->sq.sqes = ucs_event_set_io_uring_mmap(
+            event_set->event_fd,
+            params.sq_entries * sizeof(struct io_uring_sqe), IORING_OFF_SQES);
+    if (uring->sq.sqes == NULL) {
+        status = UCS_ERR_IO_ERROR;
+        goto err_cleanup;
+    }
+
+    uring->sqes_size     = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring->sq.head       = UCS_PTR_BYTE_OFFSET(uring->sq_ring,
+                                               params.sq_off.head);
+    uring->sq.tail       = UCS_PTR_BYTE_OFFSET(uring->sq_ring,
+                                               params.sq_off.tail);
+    uring->sq.array      = UCS_PTR_BYTE_OFFSET(uring->sq_ring,
+                                               params.sq_off.array);
+    uring->sq.flags      = UCS_PTR_BYTE_OFFSET(uring->sq_ring,
+                                               params.sq_off.flags);
+    uring->sq.mask       = *(unsigned*)UCS_PTR_BYTE_OFFSET(
+                                   uring->sq_ring, params.sq_off.ring_mask);
+    uring->sq.entries    = params.sq_entries;
+    uring->sq.local_tail = *uring->sq.tail;
+    uring->sq.submitted  = uring->sq.local_tail;
+    uring->cq.head       = UCS_PTR_BYTE_OFFSET(uring->cq_ring,
+                                               params.cq_off.head);
+    uring->cq.tail       = UCS_PTR_BYTE_OFFSET(uring->cq_ring,
+                                               params.cq_off.tail);
+    uring->cq.mask       = *(unsigned*)UCS_PTR_BYTE_OFFSET(
+                                   uring->cq_ring, params.cq_off.ring_mask);
+    uring->cq.cqes       = UCS_PTR_BYTE_OFFSET(uring->cq_ring,
+                                               params.cq_off.cqes);
+
+    ucs_debug("created io_uring event set %d: sq_entries %u cq_entries %u",
+              event_set->event_fd, params.sq_entries, params.cq_entries);
+    return UCS_OK;
+
+err_cleanup:
+    ucs_event_set_io_uring_cleanup(event_set);
+    event_set->uring = NULL;
+err_close:
+    close(event_set->event_fd);
+    return status;
+}
+
+#endif /* HAVE_IO_URING */
+
 static ucs_sys_event_set_t *ucs_event_set_alloc(int event_fd, unsigned flags)
 {
     ucs_sys_event_set_t *event_set;
@@ -85,6 +772,9 @@ static ucs_sys_event_set_t *ucs_event_set_alloc(int event_fd, unsigned flags)
 
     event_set->flags    = flags;
     event_set->event_fd = event_fd;
+#ifdef HAVE_IO_URING
+    event_set->uring    = NULL;
+#endif
     return event_set;
 }
 
@@ -125,6 +815,51 @@ err_close_event_fd:
     return status;
 }
 
+ucs_status_t ucs_event_set_create_backend(ucs_sys_event_set_t **event_set_p,
+                                          ucs_event_set_backend_t backend)
+{
+#ifdef HAVE_IO_URING
+    ucs_sys_event_set_t *event_set;
+    ucs_status_t status;
+
+    if (backend == UCS_EVENT_SET_BACKEND_IO_URING) {
+        event_set = ucs_event_set_alloc(-1, 0);
+        if (event_set == NULL) {
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        status = ucs_event_set_io_uring_init(event_set);
+        if (status == UCS_OK) {
+            *event_set_p = event_set;
+            return UCS_OK;
+        }
+
+        ucs_free(event_set);
+        if (status != UCS_ERR_UNSUPPORTED) {
+            return status;
+        }
+    }
+#endif
+
+    if (backend != UCS_EVENT_SET_BACKEND_EPOLL) {
+        ucs_diag("%s event set is not supported, falling back to epoll",
+                 ucs_event_set_backend_names[backend]);
+    }
+
+    return ucs_event_set_create(event_set_p);
+}
+
+ucs_event_set_backend_t ucs_event_set_backend(ucs_sys_event_set_t *event_set)
+{
+#ifdef HAVE_IO_URING
+    if (event_set->uring != NULL) {
+        return UCS_EVENT_SET_BACKEND_IO_URING;
+    }
+#endif
+
+    return UCS_EVENT_SET_BACKEND_EPOLL;
+}
+
 ucs_status_t ucs_event_set_add(ucs_sys_event_set_t *event_set, int fd,
                                ucs_event_set_types_t events,
                                void *callback_data)
@@ -132,6 +867,13 @@ ucs_status_t ucs_event_set_add(ucs_sys_event_set_t *event_set, int fd,
     struct epoll_event raw_event;
     int ret;
 
+#ifdef HAVE_IO_URING
+    if (event_set->uring != NULL) {
+        return ucs_event_set_io_uring_add(event_set, fd, events,
+                                          callback_data);
+    }
+#endif
+
     memset(&raw_event, 0, sizeof(raw_event));
     raw_event.events   = ucs_event_set_map_to_raw_events(events);
     raw_event.data.ptr = callback_data;
@@ -153,6 +895,13 @@ ucs_status_t ucs_event_set_mod(ucs_sys_event_set_t *event_set, int fd,
     struct epoll_event raw_event;
     int ret;
 
+#ifdef HAVE_IO_URING
+    if (event_set->uring != NULL) {
+        return ucs_event_set_io_uring_mod(event_set, fd, events,
+                                          callback_data);
+    }
+#endif
+
     memset(&raw_event, 0, sizeof(raw_event));
     raw_event.events   = ucs_event_set_map_to_raw_events(events);
     raw_event.data.ptr = callback_data;
@@ -171,6 +920,12 @@ ucs_status_t ucs_event_set_del(ucs_sys_event_set_t *event_set, int fd)
 {
     int ret;
 
+#ifdef HAVE_IO_URING
+    if (event_set->uring != NULL) {
+        return ucs_event_set_io_uring_del(event_set, fd);
+    }
+#endif
+
     ret = epoll_ctl(event_set->event_fd, EPOLL_CTL_DEL, fd, NULL);
     if (ret < 0) {
         ucs_error("epoll_ctl(event_fd=%d, DEL, fd=%d) failed: %m",
@@ -193,6 +948,13 @@ ucs_status_t ucs_event_set_wait(ucs_sys_event_set_t *event_set,
     ucs_assert(num_events != NULL);
     ucs_assert(*num_events <= ucs_sys_event_set_max_wait_events);
 
+#ifdef HAVE_IO_URING
+    if (event_set->uring != NULL) {
+        return ucs_event_set_io_uring_wait(event_set, num_events, timeout_ms,
+                                           event_set_handler, arg);
+    }
+#endif
+
     events = ucs_alloca(sizeof(*events) * *num_events);
 
     nready = epoll_wait(event_set->event_fd, events, *num_events, timeout_ms);
@@ -221,6 +983,12 @@ ucs_status_t ucs_event_set_wait(ucs_sys_event_set_t *event_set,
 
 void ucs_event_set_cleanup(ucs_sys_event_set_t *event_set)
 {
+#ifdef HAVE_IO_URING
+    if (event_set->uring != NULL) {
+        ucs_event_set_io_uring_cleanup(event_set);
+    }
+#endif
+
     if (!(event_set->flags & UCS_SYS_EVENT_SET_EXTERNAL_EVENT_FD)) {
         close(event_set->event_fd);
     }
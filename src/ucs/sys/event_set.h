@@ -46,9 +46,23 @@ typedef enum {
     UCS_EVENT_SET_EDGE_TRIGGERED = UCS_BIT(3)
 } ucs_event_set_type_t;
 
+/**
+ * Mechanism used by an event set to wait for events
+ */
+typedef enum {
+    UCS_EVENT_SET_BACKEND_EPOLL,    /* epoll_wait() per wait call */
+    UCS_EVENT_SET_BACKEND_IO_URING, /* io_uring poll requests, submitted in
+                                       batches and reaped from the shared
+                                       completion queue */
+    UCS_EVENT_SET_BACKEND_LAST
+} ucs_event_set_backend_t;
+
 /* The maximum possible number of events based on system constraints */
 extern const unsigned ucs_sys_event_set_max_wait_events;
 
+/* Names of event set backends */
+extern const char *ucs_event_set_backend_names[];
+
 /**
  * Allocate ucs_sys_event_set_t structure and assign provided file
  * descriptor to wait for events on.
@@ -70,6 +84,32 @@ ucs_status_t ucs_event_set_create_from_fd(ucs_sys_event_set_t **event_set_p,
  */
 ucs_status_t ucs_event_set_create(ucs_sys_event_set_t **event_set_p);
 
+/**
+ * Allocate ucs_sys_event_set_t structure which uses the requested backend.
+ * If io_uring is requested but it is not supported by the system, the event
+ * set falls back to epoll.
+ *
+ * The io_uring backend reports level-triggered events, unless
+ * @ref UCS_EVENT_SET_EDGE_TRIGGERED is requested. Its file descriptor becomes
+ * readable when there are pending events.
+ *
+ * @param [out] event_set_p  Event set pointer to initialize.
+ * @param [in]  backend      Requested backend.
+ *
+ * @return UCS_OK on success or an error code on failure.
+ */
+ucs_status_t ucs_event_set_create_backend(ucs_sys_event_set_t **event_set_p,
+                                          ucs_event_set_backend_t backend);
+
+/**
+ * Get the backend which is used by the event set.
+ *
+ * @param [in] event_set     Event set created by ucs_event_set_create.
+ *
+ * @return Event set backend.
+ */
+ucs_event_set_backend_t ucs_event_set_backend(ucs_sys_event_set_t *event_set);
+
 /**
  * Register the target event.
  *
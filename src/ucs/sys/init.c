@@ -19,6 +19,7 @@
 #include <ucs/profile/profile.h>
 #include <ucs/memory/memtype_cache.h>
 #include <ucs/memory/numa.h>
+#include <ucs/memory/numa_arena.h>
 #include <ucs/stats/stats.h>
 #include <ucs/async/async.h>
 #include <ucs/sys/lib.h>
@@ -49,6 +50,7 @@ static UCS_F_NOOPTIMIZE void ucs_check_cpu_flags(void)
         { "sse42", UCS_CPU_FLAG_SSE42 },
         { "avx", UCS_CPU_FLAG_AVX },
         { "avx2", UCS_CPU_FLAG_AVX2 },
+        { "pclmul", UCS_CPU_FLAG_PCLMUL },
         { NULL, UCS_CPU_FLAG_UNKNOWN },
     };
 
@@ -115,6 +117,7 @@ void UCS_F_CTOR ucs_init()
 
     ucs_async_global_init();
     ucs_numa_init();
+    ucs_numa_arena_init();
     ucs_topo_init();
     ucs_rand_seed_init();
     ucs_debug("%s loaded at 0x%lx", ucs_sys_get_lib_path(),
@@ -126,6 +129,7 @@ void UCS_F_CTOR ucs_init()
 static void UCS_F_DTOR ucs_cleanup(void)
 {
     ucs_topo_cleanup();
+    ucs_numa_arena_cleanup();
     ucs_numa_cleanup();
     ucs_async_global_cleanup();
     ucs_profile_cleanup(ucs_profile_default_ctx);
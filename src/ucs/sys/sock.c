@@ -308,6 +308,9 @@ static ucs_status_t ucs_socket_check_errno(int io_errno)
     } else if (io_errno == EPIPE) {
         /* The local end has been shut down */
         return UCS_ERR_CONNECTION_RESET;
+    } else if ((io_errno == ENOBUFS) || (io_errno == ENOMEM)) {
+        /* Out of socket buffers or pinned memory limit was reached */
+        return UCS_ERR_NO_MEMORY;
     }
 
     return UCS_ERR_IO_ERROR;
@@ -623,7 +626,8 @@ ucs_socket_do_io_b(int fd, void *data, size_t length,
 
 static inline ucs_status_t
 ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p,
-                     ucs_socket_iov_func_t iov_func, const char *name)
+                     ucs_socket_iov_func_t iov_func, const char *name,
+                     int flags)
 {
     struct msghdr msg = {
         .msg_iov    = iov,
@@ -631,7 +635,7 @@ ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p
     };
     ssize_t ret;
 
-    ret = iov_func(fd, &msg, MSG_NOSIGNAL);
+    ret = iov_func(fd, &msg, MSG_NOSIGNAL | flags);
     return ucs_socket_handle_io(fd, iov, iov_cnt, length_p, 1, ret, errno, name);
 }
 
@@ -668,7 +672,16 @@ ucs_status_t ucs_socket_recv(int fd, void *data, size_t length)
 ucs_status_t
 ucs_socket_sendv_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p)
 {
-    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, length_p, sendmsg, "sendv");
+    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, length_p, sendmsg, "sendv",
+                                0);
+}
+
+ucs_status_t ucs_socket_sendv_flags_nb(int fd, struct iovec *iov,
+                                       size_t iov_cnt, int flags,
+                                       size_t *length_p)
+{
+    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, length_p, sendmsg, "sendv",
+                                flags);
 }
 
 ucs_status_t ucs_sockaddr_sizeof(const struct sockaddr *addr, size_t *size_p)
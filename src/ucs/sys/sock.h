@@ -322,6 +322,26 @@ ucs_status_t ucs_socket_sendv_nb(int fd, struct iovec *iov, size_t iov_cnt,
                                  size_t *length_p);
 
 
+/**
+ * Non-blocking send operation sends I/O vector on the connected (or bound
+ * connectionless) socket referred to by the file descriptor `fd`, passing
+ * additional flags to sendmsg().
+ *
+ * @param [in]      fd              Socket fd.
+ * @param [in]      iov             A pointer to an array of iovec buffers.
+ * @param [in]      iov_cnt         The number of buffers pointed to by
+ *                                  the iov parameter.
+ * @param [in]      flags           sendmsg flags, e.g. MSG_ZEROCOPY.
+ * @param [out]     length_p        The amount of data transmitted is written to
+ *                                  this argument.
+ *
+ * @return UCS_OK on success or an error code on failure.
+ */
+ucs_status_t ucs_socket_sendv_flags_nb(int fd, struct iovec *iov,
+                                       size_t iov_cnt, int flags,
+                                       size_t *length_p);
+
+
 /**
  * Blocking receive operation receives data from the connected (or bound
  * connectionless) socket referred to by the file descriptor `fd`.
@@ -10,12 +10,110 @@
 
 #include <ucs/time/timer_wheel.h>
 
+#include <ucs/arch/bitops.h>
 #include <ucs/debug/assert.h>
 #include <ucs/debug/log.h>
 #include <ucs/debug/memtrack_int.h>
 #include <ucs/sys/ptr_arith.h>
+#include <limits.h>
 
 
+#define UCS_TWHEEL_LEVEL_SLOTS  UCS_BIT(UCS_TWHEEL_LEVEL_BITS)
+#define UCS_TWHEEL_SLOT_MASK    (UCS_TWHEEL_LEVEL_SLOTS - 1)
+#define UCS_TWHEEL_MAX_TICKS    (UCS_BIT(UCS_TWHEEL_LEVEL_BITS * \
+                                         UCS_TWHEEL_NUM_LEVELS) - 1)
+
+
+static UCS_F_ALWAYS_INLINE ucs_list_link_t *
+ucs_twheel_slot(ucs_twheel_t *t, unsigned level, unsigned index)
+{
+    return &t->wheel[(level * UCS_TWHEEL_LEVEL_SLOTS) + index];
+}
+
+static void ucs_twheel_insert(ucs_twheel_t *t, ucs_wtimer_t *timer)
+{
+    uint64_t delta = timer->expires - t->current;
+    unsigned level, index;
+
+    /* Find the lowest level which covers the expiration time */
+    for (level = 0; level < (UCS_TWHEEL_NUM_LEVELS - 1); ++level) {
+        if (delta < UCS_BIT((level + 1) * UCS_TWHEEL_LEVEL_BITS)) {
+            break;
+        }
+    }
+
+    index = (timer->expires >> (level * UCS_TWHEEL_LEVEL_BITS)) &
+            UCS_TWHEEL_SLOT_MASK;
+    ucs_list_add_tail(ucs_twheel_slot(t, level, index), &timer->list);
+    t->slot_map[level] |= UCS_BIT(index);
+}
+
+/* Move the timers of the current slot of the level to the lower levels, and
+ * return the index of the slot */
+static unsigned ucs_twheel_cascade(ucs_twheel_t *t, unsigned level)
+{
+    unsigned index = (t->current >> (level * UCS_TWHEEL_LEVEL_BITS)) &
+                     UCS_TWHEEL_SLOT_MASK;
+    ucs_list_link_t *slot;
+    ucs_wtimer_t *timer, *tmp;
+    UCS_LIST_HEAD(timers);
+
+    if (!(t->slot_map[level] & UCS_BIT(index))) {
+        return index;
+    }
+
+    slot = ucs_twheel_slot(t, level, index);
+    ucs_list_splice_tail(&timers, slot);
+    ucs_list_head_init(slot);
+    t->slot_map[level] &= ~UCS_BIT(index);
+
+    ucs_list_for_each_safe(timer, tmp, &timers, list) {
+        ucs_twheel_insert(t, timer);
+    }
+
+    return index;
+}
+
+static void ucs_twheel_advance(ucs_twheel_t *t, uint64_t target)
+{
+    ucs_list_link_t *slot;
+    unsigned index, level;
+    uint64_t pending;
+
+    if (t->count == 0) {
+        t->current = target;
+        return;
+    }
+
+    while (t->current < target) {
+        index = t->current & UCS_TWHEEL_SLOT_MASK;
+        if (index == 0) {
+            /* The first level wrapped around, bring the timers of the next
+             * slot of the upper levels closer */
+            level = 1;
+            while ((level < UCS_TWHEEL_NUM_LEVELS) &&
+                   (ucs_twheel_cascade(t, level) == 0)) {
+                ++level;
+            }
+        }
+
+        if (t->slot_map[0] & UCS_BIT(index)) {
+            slot = ucs_twheel_slot(t, 0, index);
+            ucs_list_splice_tail(&t->expired, slot);
+            ucs_list_head_init(slot);
+            t->slot_map[0] &= ~UCS_BIT(index);
+        }
+
+        /* Skip the empty slots up to the next wrap around of the first level */
+        pending    = (t->slot_map[0] >> index) >> 1;
+        t->current = ucs_min(target,
+                             t->current + 1 +
+                             ((pending != 0) ?
+                              ucs_ffs64(pending) :
+                              (UCS_TWHEEL_SLOT_MASK - index)));
+    }
+}
+
 ucs_status_t ucs_twheel_init(ucs_twheel_t *twheel, ucs_time_t resolution,
                              ucs_time_t current_time)
 {
@@ -23,20 +121,27 @@ ucs_status_t ucs_twheel_init(ucs_twheel_t *twheel, ucs_time_t resolution,
 
     twheel->res         = ucs_roundup_pow2(resolution);
     twheel->res_order   = (unsigned) ucs_log2(twheel->res);
-    twheel->num_slots   = 1024;
-    twheel->current     = 0;
+    twheel->num_slots   = UCS_TWHEEL_LEVEL_SLOTS;
+    twheel->current     = current_time >> twheel->res_order;
     twheel->now         = current_time;
-    twheel->wheel       = ucs_malloc(sizeof(*twheel->wheel) * twheel->num_slots,
+    twheel->wheel       = ucs_malloc(sizeof(*twheel->wheel) *
+                                     twheel->num_slots * UCS_TWHEEL_NUM_LEVELS,
                                      "twheel");
     twheel->count       = 0;
     if (twheel->wheel == NULL) {
         return UCS_ERR_NO_MEMORY;
     }
 
-    for (i = 0; i < twheel->num_slots; i++) {
+    for (i = 0; i < (twheel->num_slots * UCS_TWHEEL_NUM_LEVELS); i++) {
         ucs_list_head_init(&twheel->wheel[i]);
     }
 
+    for (i = 0; i < UCS_TWHEEL_NUM_LEVELS; i++) {
+        twheel->slot_map[i] = 0;
+    }
+
+    ucs_list_head_init(&twheel->expired);
+
     ucs_debug("high res timer created log=%d resolution=%lf usec wanted: %lf usec",
               twheel->res_order, ucs_time_to_usec(twheel->res), ucs_time_to_usec(resolution));
     return UCS_OK;
@@ -56,50 +161,52 @@ ucs_status_t ucs_wtimer_init(ucs_wtimer_t *t, ucs_twheel_callback_t cb)
 
 void __ucs_wtimer_add(ucs_twheel_t *t, ucs_wtimer_t *timer, ucs_time_t delta)
 {
-    uint64_t slot;
+    uint64_t ticks;
 
     timer->is_active = 1;
-    slot = delta>>t->res_order;
-    if (ucs_unlikely(slot == 0)) {
+    ticks = delta>>t->res_order;
+    if (ucs_unlikely(ticks == 0)) {
         /* nothing really wrong with adding timer to the current slot. However
          * we want to guard against the case we spend to much time in hi res
          * timer processing */
         ucs_fatal("Timer resolution is too low. Min resolution %lf usec, wanted %lf usec",
                 ucs_time_to_usec(t->res), ucs_time_to_usec(delta));
     }
-    ucs_assert(slot > 0);
+    ucs_assert(ticks > 0);
 
-    if (ucs_unlikely(slot >= t->num_slots)) {
-        slot = t->num_slots - 1;
+    if (ucs_unlikely(ticks > UCS_TWHEEL_MAX_TICKS)) {
+        ticks = UCS_TWHEEL_MAX_TICKS;
     }
 
-    slot = (t->current + slot) % t->num_slots;
-    ucs_assert(slot != t->current);
-
-    ucs_list_add_tail(&t->wheel[slot], &timer->list);
+    timer->expires = t->current + ticks;
+    ucs_twheel_insert(t, timer);
     t->count++;
 }
 
-void __ucs_twheel_sweep(ucs_twheel_t *t, ucs_time_t current_time)
+unsigned __ucs_twheel_sweep_limit(ucs_twheel_t *t, ucs_time_t current_time,
+                                  unsigned max_timers)
 {
+    uint64_t target = current_time >> t->res_order;
+    unsigned count  = 0;
     ucs_wtimer_t *timer;
-    uint64_t slot;
 
-    slot   = (current_time - t->now) >> t->res_order;
-    t->now = current_time;
+    if (target > t->current) {
+        t->now = current_time;
+        ucs_twheel_advance(t, target);
+    }
 
-    if (ucs_unlikely(slot >= t->num_slots)) {
-        slot = t->num_slots - 1;
+    while ((count < max_timers) && !ucs_list_is_empty(&t->expired)) {
+        timer = ucs_list_extract_head(&t->expired, ucs_wtimer_t, list);
+        timer->is_active = 0;
+        t->count--;
+        timer->cb(timer);
+        ++count;
     }
 
-    slot = (t->current + slot) % t->num_slots;
+    return count;
+}
 
-    for (; t->current != slot; t->current = (t->current+1) % t->num_slots) {
-        while (!ucs_list_is_empty(&t->wheel[t->current])) {
-            timer = ucs_list_extract_head(&t->wheel[t->current], ucs_wtimer_t, list);
-            timer->is_active = 0;
-            timer->cb(timer);
-            t->count--;
-        }
-    }
+void __ucs_twheel_sweep(ucs_twheel_t *t, ucs_time_t current_time)
+{
+    __ucs_twheel_sweep_limit(t, current_time, UINT_MAX);
 }
@@ -12,6 +12,15 @@
 #include <ucs/debug/log.h>
 
 
+/* Number of slot index bits in every level of the timer wheel */
+#define UCS_TWHEEL_LEVEL_BITS   6
+
+
+/* Number of levels in the timer wheel; timers which are scheduled beyond the
+ * range of the last level are expired at the end of its range */
+#define UCS_TWHEEL_NUM_LEVELS   4
+
+
 /* Forward declarations */
 typedef struct ucs_wtimer       ucs_wtimer_t;
 typedef struct ucs_timer_wheel  ucs_twheel_t;
@@ -29,17 +38,32 @@ typedef void (*ucs_twheel_callback_t)(ucs_wtimer_t *self);
 struct ucs_wtimer {
     ucs_twheel_callback_t  cb;         /* User callback */
     ucs_list_link_t        list;       /* Link in the list of timers */
+    uint64_t               expires;    /* Expiration tick */
     int                    is_active;
 };
 
 
+/**
+ * Hierarchical timer wheel.
+ *
+ * Every level has @a num_slots slots, and a slot of level L covers
+ * num_slots^L ticks of the wheel resolution. Timers are added to the lowest
+ * level which covers their expiration time, and moved to lower levels when the
+ * wheel reaches their slot, so adding and removing a timer takes O(1)
+ * regardless of the number of timers and of their expiration time.
+ * Due slots are moved to the expired list as a whole, and the timers are
+ * dispatched from that list.
+ */
 struct ucs_timer_wheel {
     ucs_time_t             res;
     ucs_time_t             now;        /* when wheel was last updated */
-    uint64_t               current;
-    ucs_list_link_t        *wheel;
+    uint64_t               current;    /* Current tick */
+    ucs_list_link_t        *wheel;     /* Slots of all levels */
+    uint64_t               slot_map[UCS_TWHEEL_NUM_LEVELS]; /* Slots which may
+                                                               be non-empty */
+    ucs_list_link_t        expired;    /* Expired timers to dispatch */
     unsigned               res_order;
-    unsigned               num_slots;
+    unsigned               num_slots;  /* Number of slots in every level */
     unsigned               count;
 };
 
@@ -48,7 +72,8 @@ struct ucs_timer_wheel {
  * Initialize the timer queue.
  *
  * @param twheel        Timer queue to initialize.
- * @param resolution    Timer resolution. Timer wheel range is from now to now + UCS_TWHEEL_NSLOTS * res
+ * @param resolution    Timer resolution. Timer wheel range is from now to
+ *                      now + res * 2^(UCS_TWHEEL_LEVEL_BITS * UCS_TWHEEL_NUM_LEVELS)
  * @param current_time  Current time to initialize the timer with.
  */
 ucs_status_t ucs_twheel_init(ucs_twheel_t *twheel, ucs_time_t resolution,
@@ -83,11 +108,40 @@ ucs_status_t ucs_wtimer_init(ucs_wtimer_t *t, ucs_twheel_callback_t cb);
 void __ucs_twheel_sweep(ucs_twheel_t *t, ucs_time_t current_time);
 static inline void ucs_twheel_sweep(ucs_twheel_t *t, ucs_time_t current_time)
 {
-    if (ucs_unlikely(current_time - t->now >= t->res)) {
+    if (ucs_unlikely((current_time >> t->res_order) > t->current)) {
         __ucs_twheel_sweep(t, current_time);
     }
 }
 
+
+/**
+ * Go through the timers in the timer queue, dispatch up to @a max_timers
+ * expired timers.
+ *
+ * @param twheel        Timer wheel to dispatch timers on.
+ * @param current_time  Current time to dispatch the timers for.
+ * @param max_timers    Maximal number of timers to dispatch.
+ *
+ * @return Number of dispatched timers.
+ *
+ * @note Expired timers which were not dispatched remain active, and are
+ *       dispatched by the following calls before the timers which expire
+ *       later.
+ */
+unsigned __ucs_twheel_sweep_limit(ucs_twheel_t *t, ucs_time_t current_time,
+                                  unsigned max_timers);
+static inline unsigned
+ucs_twheel_sweep_limit(ucs_twheel_t *t, ucs_time_t current_time,
+                       unsigned max_timers)
+{
+    if (ucs_likely(((current_time >> t->res_order) <= t->current) &&
+                   ucs_list_is_empty(&t->expired))) {
+        return 0;
+    }
+
+    return __ucs_twheel_sweep_limit(t, current_time, max_timers);
+}
+
 /**
  * Get current time
  */
@@ -28,3 +28,12 @@ AC_CHECK_DECLS([IPPROTO_TCP, SOL_SOCKET, SO_KEEPALIVE,
                 [#include <netinet/in.h>]])
 AS_IF([test "x$tcp_keepalive_happy" != "xno"],
       [AC_DEFINE([UCT_TCP_EP_KEEPALIVE], 1, [Enable TCP keepalive configuration])]);
+
+AC_CHECK_DECLS([SO_ZEROCOPY, MSG_ZEROCOPY, SO_EE_ORIGIN_ZEROCOPY,
+                SO_EE_CODE_ZEROCOPY_COPIED],
+               [],
+               [tcp_zerocopy_happy=no],
+               [[#include <sys/socket.h>]
+                [#include <linux/errqueue.h>]])
+AS_IF([test "x$tcp_zerocopy_happy" != "xno"],
+      [AC_DEFINE([UCT_TCP_EP_ZEROCOPY], 1, [Enable TCP MSG_ZEROCOPY support])]);
@@ -159,6 +159,53 @@ void uct_mm_ep_cleanup_remote_segs(uct_mm_ep_t *ep)
     kh_destroy_inplace(uct_mm_remote_seg, &ep->remote_segs);
 }
 
+/* Give the unused reserved elements back to the receiver. The elements are
+ * marked as written, so the receiver would not wait for them, and flagged to
+ * be skipped since they carry no data */
+static void uct_mm_ep_cancel_reserved(uct_mm_ep_t *ep)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                           uct_mm_iface_t);
+    uct_mm_fifo_element_t *elem;
+    uint8_t elem_flags;
+
+    if (ep->reserve.head == ep->reserve.end) {
+        return;
+    }
+
+    ucs_trace("ep %p: releasing reserved FIFO elements [%" PRIu64 "..%" PRIu64
+              ")", ep, ep->reserve.head, ep->reserve.end);
+
+    for (; ep->reserve.head != ep->reserve.end; ++ep->reserve.head) {
+        elem       = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems,
+                                                ep->reserve.head &
+                                                iface->fifo_mask);
+        elem_flags = UCT_MM_FIFO_ELEM_FLAG_SKIP;
+        if (ep->reserve.head & iface->config.fifo_size) {
+            elem_flags |= UCT_MM_FIFO_ELEM_FLAG_OWNER;
+        }
+        elem->flags = elem_flags;
+    }
+
+    ucs_list_del(&ep->reserve.list);
+}
+
+void uct_mm_ep_release_reserved(uct_mm_iface_t *iface, int force)
+{
+    uct_mm_ep_t *ep, *tmp;
+
+    /* The receiver can't proceed beyond a reserved element until it's written,
+     * so release the reservation of an endpoint which did not send anything
+     * since the previous call */
+    ucs_list_for_each_safe(ep, tmp, &iface->reserved_eps, reserve.list) {
+        if (force || ep->reserve.idle) {
+            uct_mm_ep_cancel_reserved(ep);
+        } else {
+            ep->reserve.idle = 1;
+        }
+    }
+}
+
 static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, const uct_ep_params_t *params)
 {
     uct_mm_iface_t            *iface = ucs_derived_of(params->iface, uct_mm_iface_t);
@@ -198,6 +245,9 @@ static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, const uct_ep_params_t *params)
     /* Initialize remote FIFO control structure */
     uct_mm_iface_set_fifo_ptrs(fifo_ptr, &self->fifo_ctl, &self->fifo_elems);
     self->cached_tail = self->fifo_ctl->tail;
+    self->reserve.head = 0;
+    self->reserve.end  = 0;
+    self->reserve.idle = 0;
     ucs_arbiter_elem_init(&self->arb_elem);
 
     status = uct_ep_keepalive_init(&self->keepalive, self->fifo_ctl->pid);
@@ -221,6 +271,7 @@ err:
 static UCS_CLASS_CLEANUP_FUNC(uct_mm_ep_t)
 {
     uct_mm_ep_pending_purge(&self->super.super, NULL, NULL);
+    uct_mm_ep_cancel_reserved(self);
     uct_mm_ep_cleanup_remote_segs(self);
     ucs_free(self->remote_iface_addr);
 }
@@ -231,7 +282,7 @@ UCS_CLASS_DEFINE_DELETE_FUNC(uct_mm_ep_t, uct_ep_t);
 
 
 static inline ucs_status_t
-uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t head,
+uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t head, unsigned count,
                           uct_mm_fifo_element_t **elem)
 {
     uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface, uct_mm_iface_t);
@@ -240,18 +291,43 @@ uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t head,
 
     elem_index = head & iface->fifo_mask;
     *elem      = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems, elem_index);
-    new_head   = (head + 1) & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED;
+    new_head   = (head + count) & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED;
 
-    /* try to get ownership of the head element */
+    /* try to get ownership of the head element, and the elements following it
+     * if working in batch mode */
     prev_head = ucs_atomic_cswap64(ucs_unaligned_ptr(&ep->fifo_ctl->head), head,
                                    new_head);
     if (prev_head != head) {
         return UCS_ERR_NO_RESOURCE;
     }
 
+    if (count > 1) {
+        /* the rest of the elements are used by the next sends */
+        ep->reserve.head = (head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED) + 1;
+        ep->reserve.end  = new_head;
+        ep->reserve.idle = 0;
+        ucs_list_add_tail(&iface->reserved_eps, &ep->reserve.list);
+    }
+
     return UCS_OK;
 }
 
+static UCS_F_ALWAYS_INLINE uint64_t
+uct_mm_ep_get_reserved_elem(uct_mm_ep_t *ep, uct_mm_iface_t *iface,
+                            uct_mm_fifo_element_t **elem)
+{
+    uint64_t head = ep->reserve.head++;
+
+    *elem            = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems,
+                                                  head & iface->fifo_mask);
+    ep->reserve.idle = 0;
+    if (ep->reserve.head == ep->reserve.end) {
+        ucs_list_del(&ep->reserve.list);
+    }
+
+    return head;
+}
+
 static inline void uct_mm_ep_update_cached_tail(uct_mm_ep_t *ep)
 {
     ucs_memory_cpu_load_fence();
@@ -289,11 +365,18 @@ static UCS_F_ALWAYS_INLINE ssize_t uct_mm_ep_am_common_send(
     void *base_address;
     uint8_t elem_flags;
     uint64_t head;
+    unsigned count;
     ucs_iov_iter_t iov_iter;
     void *desc_data;
 
     UCT_CHECK_AM_ID(am_id);
 
+    if (ep->reserve.head != ep->reserve.end) {
+        /* use an element reserved by one of the previous sends */
+        head = uct_mm_ep_get_reserved_elem(ep, iface, &elem);
+        goto fill;
+    }
+
 retry:
     head = ep->fifo_ctl->head;
     /* check if there is room in the remote process's receive FIFO to write */
@@ -315,13 +398,20 @@ retry:
         }
     }
 
-    status = uct_mm_ep_get_remote_elem(ep, head, &elem);
+    /* in batch mode, reserve as many elements as the FIFO has room for */
+    count  = ucs_min(iface->config.fifo_batch,
+                     iface->config.fifo_size -
+                     ((head - ep->cached_tail) &
+                      ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED));
+    status = uct_mm_ep_get_remote_elem(ep, head, count, &elem);
     if (status != UCS_OK) {
         ucs_assert(status == UCS_ERR_NO_RESOURCE);
         ucs_trace_poll("couldn't get an available FIFO element. retrying");
         goto retry;
     }
 
+fill:
+
     switch (send_op) {
     case UCT_MM_SEND_AM_SHORT:
         /* write to the remote FIFO */
@@ -443,7 +533,8 @@ ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_
 static inline int uct_mm_ep_has_tx_resources(uct_mm_ep_t *ep)
 {
     uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface, uct_mm_iface_t);
-    return UCT_MM_EP_IS_ABLE_TO_SEND(ep->fifo_ctl->head, ep->cached_tail,
+    return (ep->reserve.head != ep->reserve.end) ||
+           UCT_MM_EP_IS_ABLE_TO_SEND(ep->fifo_ctl->head, ep->cached_tail,
                                      iface->config.fifo_size);
 }
 
@@ -554,6 +645,9 @@ ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
 {
     uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
 
+    /* let the receiver go past the elements this endpoint has reserved */
+    uct_mm_ep_cancel_reserved(ep);
+
     if (!uct_mm_ep_has_tx_resources(ep)) {
         if (!ucs_arbiter_group_is_empty(&ep->arb_group)) {
             return UCS_ERR_NO_RESOURCE;
@@ -49,6 +49,14 @@ typedef struct uct_mm_ep {
     ucs_arbiter_elem_t         arb_elem;
 
     uct_keepalive_info_t       keepalive; /* keepalive info */
+
+    /* FIFO elements reserved in advance, when working in batch FIFO mode */
+    struct {
+        uint64_t               head;  /* next reserved element to write */
+        uint64_t               end;   /* end of the reserved range */
+        int                    idle;  /* no sends since last iface progress */
+        ucs_list_link_t        list;  /* entry in iface->reserved_eps */
+    } reserve;
 } uct_mm_ep_t;
 
 
@@ -81,6 +89,8 @@ ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
                                                   ucs_arbiter_elem_t *elem,
                                                   void *arg);
 
+void uct_mm_ep_release_reserved(uct_mm_iface_t *iface, int force);
+
 int uct_mm_ep_is_connected(const uct_ep_h tl_ep,
                            const uct_ep_is_connected_params_t *params);
 
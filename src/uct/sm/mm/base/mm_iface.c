@@ -27,6 +27,13 @@
 #define UCT_MM_IFACE_OVERHEAD 10e-9
 #define UCT_MM_IFACE_LATENCY  ucs_linear_func_make(80e-9, 0)
 
+
+static const char *uct_mm_fifo_mode_names[] = {
+    [UCT_MM_FIFO_MODE_SINGLE] = "single",
+    [UCT_MM_FIFO_MODE_BATCH]  = "batch",
+    [UCT_MM_FIFO_MODE_LAST]   = NULL
+};
+
 ucs_config_field_t uct_mm_iface_config_table[] = {
     {"SM_", "ALLOC=md,mmap,heap;BW=15360MBs", NULL,
      ucs_offsetof(uct_mm_iface_config_t, super),
@@ -64,6 +71,33 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
      "Maximal number of receive completions to pick during RX poll",
      ucs_offsetof(uct_mm_iface_config_t, fifo_max_poll), UCS_CONFIG_TYPE_ULUNITS},
 
+    {"FIFO_MODE", "single",
+     "How a sender acquires elements of the remote receive FIFO:\n"
+     " single - Acquire one element per message by an atomic operation on the\n"
+     "          shared FIFO head.\n"
+     " batch  - Reserve up to FIFO_BATCH elements by one atomic operation and\n"
+     "          fill them by the following messages. This reduces contention on\n"
+     "          the FIFO head when many senders target the same receiver, at the\n"
+     "          cost of delaying messages of other senders until the reserved\n"
+     "          elements are either filled or released.",
+     ucs_offsetof(uct_mm_iface_config_t, fifo_mode),
+     UCS_CONFIG_TYPE_ENUM(uct_mm_fifo_mode_names)},
+
+    {"FIFO_BATCH", "8",
+     "Maximal number of FIFO elements to reserve by one atomic operation when\n"
+     "FIFO_MODE is 'batch'.",
+     ucs_offsetof(uct_mm_iface_config_t, fifo_batch), UCS_CONFIG_TYPE_UINT},
+
+    {"POLL_BACKOFF_MAX", "0",
+     "Maximal number of consecutive iface progress calls which skip polling\n"
+     "an idle receive FIFO. Once the FIFO was found empty several times in a\n"
+     "row, it is polled with exponentially growing intervals up to this value,\n"
+     "and polling resumes as soon as the FIFO head shows a new message. This\n"
+     "reduces the cost of progressing many idle interfaces, at the expense of\n"
+     "up to this number of progress calls of additional receive latency.\n"
+     "0 disables the backoff.",
+     ucs_offsetof(uct_mm_iface_config_t, poll_backoff_max), UCS_CONFIG_TYPE_UINT},
+
     {"ERROR_HANDLING", "n", "Expose error handling support capability",
      ucs_offsetof(uct_mm_iface_config_t, error_handling), UCS_CONFIG_TYPE_BOOL},
 
@@ -164,6 +198,7 @@ ucs_status_t uct_mm_iface_flush(uct_iface_h tl_iface, unsigned flags,
         return UCS_ERR_UNSUPPORTED;
     }
 
+    uct_mm_ep_release_reserved(ucs_derived_of(tl_iface, uct_mm_iface_t), 1);
     ucs_memory_cpu_store_fence();
     UCT_TL_IFACE_STAT_FLUSH(ucs_derived_of(tl_iface, uct_base_iface_t));
     return UCS_OK;
@@ -310,6 +345,11 @@ static UCS_F_ALWAYS_INLINE void uct_mm_iface_process_recv(uct_mm_iface_t *iface)
         return;
     }
 
+    if (ucs_unlikely(elem->flags & UCT_MM_FIFO_ELEM_FLAG_SKIP)) {
+        /* the element was reserved by a sender and released unused */
+        return;
+    }
+
     /* check the memory pool to make sure that there is a new descriptor available */
     if (ucs_unlikely(iface->last_recv_desc == NULL)) {
         UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
@@ -397,6 +437,63 @@ uct_mm_iface_fifo_window_adjust(uct_mm_iface_t *iface,
     }
 }
 
+static UCS_F_ALWAYS_INLINE void
+uct_mm_iface_poll_backoff_reset(uct_mm_iface_t *iface)
+{
+    iface->poll_backoff.empty_polls = 0;
+    iface->poll_backoff.interval    = 0;
+    iface->poll_backoff.countdown   = 0;
+}
+
+/* Return nonzero if the receive FIFO should not be polled by this progress
+ * call */
+static UCS_F_ALWAYS_INLINE int
+uct_mm_iface_poll_backoff_skip(uct_mm_iface_t *iface)
+{
+    uint64_t head;
+
+    if (ucs_likely(iface->poll_backoff.countdown == 0)) {
+        return 0;
+    }
+
+    if (--iface->poll_backoff.countdown > 0) {
+        return 1;
+    }
+
+    /* interval expired - ring the doorbell, i.e check if any sender advanced
+     * the FIFO head beyond what was already read */
+    head = iface->recv_fifo_ctl->head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED;
+    if (head != iface->read_index) {
+        uct_mm_iface_poll_backoff_reset(iface);
+        return 0;
+    }
+
+    iface->poll_backoff.interval  = ucs_min(iface->poll_backoff.interval * 2,
+                                            iface->config.poll_backoff_max);
+    iface->poll_backoff.countdown = iface->poll_backoff.interval;
+    return 1;
+}
+
+static UCS_F_ALWAYS_INLINE void
+uct_mm_iface_poll_backoff_update(uct_mm_iface_t *iface, unsigned count)
+{
+    if (ucs_likely(iface->config.poll_backoff_max == 0)) {
+        return;
+    }
+
+    if (count != 0) {
+        iface->poll_backoff.empty_polls = 0;
+        return;
+    }
+
+    if (++iface->poll_backoff.empty_polls >= UCT_MM_IFACE_POLL_BACKOFF_THRESH) {
+        /* start skipping with the shortest interval */
+        iface->poll_backoff.empty_polls = 0;
+        iface->poll_backoff.interval    = 1;
+        iface->poll_backoff.countdown   = 1;
+    }
+}
+
 static unsigned uct_mm_iface_progress(uct_iface_h tl_iface)
 {
     uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
@@ -406,19 +503,27 @@ static unsigned uct_mm_iface_progress(uct_iface_h tl_iface)
     ucs_assert(iface->fifo_poll_count >= UCT_MM_IFACE_FIFO_MIN_POLL);
 
     /* progress receive */
-    do {
-        count = uct_mm_iface_poll_fifo(iface);
-        ucs_assert(count < 2);
-        total_count += count;
-        ucs_assert(total_count < UINT_MAX);
-    } while ((count != 0) && (total_count < iface->fifo_poll_count));
-
-    uct_mm_iface_fifo_window_adjust(iface, total_count);
+    if (!uct_mm_iface_poll_backoff_skip(iface)) {
+        do {
+            count = uct_mm_iface_poll_fifo(iface);
+            ucs_assert(count < 2);
+            total_count += count;
+            ucs_assert(total_count < UINT_MAX);
+        } while ((count != 0) && (total_count < iface->fifo_poll_count));
+
+        uct_mm_iface_fifo_window_adjust(iface, total_count);
+        uct_mm_iface_poll_backoff_update(iface, total_count);
+    }
 
     /* progress the pending sends (if there are any) */
     ucs_arbiter_dispatch(&iface->arbiter, 1, uct_mm_ep_process_pending,
                          &total_count);
 
+    /* release FIFO elements reserved by idle endpoints */
+    if (ucs_unlikely(!ucs_list_is_empty(&iface->reserved_eps))) {
+        uct_mm_ep_release_reserved(iface, 0);
+    }
+
     return total_count;
 }
 
@@ -437,6 +542,12 @@ uct_mm_iface_event_fd_arm(uct_iface_h tl_iface, unsigned events)
     uint64_t head, prev_head;
     int ret;
 
+    /* the peers could be waiting for the elements we have reserved */
+    uct_mm_ep_release_reserved(iface, 1);
+
+    /* poll the FIFO right away when woken up */
+    uct_mm_iface_poll_backoff_reset(iface);
+
     if ((events & UCT_EVENT_SEND_COMP) &&
         !ucs_arbiter_is_empty(&iface->arbiter)) {
         /* if we have outstanding send operations, can't go to sleep */
@@ -732,9 +843,10 @@ static void uct_mm_iface_log_created(uct_mm_iface_t *iface)
     uct_mm_seg_t *seg = iface->recv_fifo_mem.memh;
 
     ucs_debug("created mm iface %p FIFO id 0x%"PRIx64
-              " va %p size %zu (%u x %u elems)",
+              " va %p size %zu (%u x %u elems) fifo_batch %u",
               iface, seg->seg_id, seg->address, seg->length,
-              iface->config.fifo_elem_size, iface->config.fifo_size);
+              iface->config.fifo_elem_size, iface->config.fifo_size,
+              iface->config.fifo_batch);
 }
 
 static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
@@ -789,6 +901,13 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                       /* trim by the maximum unsigned integer value */
                                       ucs_min(mm_config->fifo_max_poll, UINT_MAX));
 
+    self->config.fifo_batch        = (mm_config->fifo_mode ==
+                                      UCT_MM_FIFO_MODE_BATCH) ?
+                                     ucs_max(ucs_min(mm_config->fifo_batch,
+                                                     mm_config->fifo_size),
+                                             1) :
+                                     1;
+    self->config.poll_backoff_max  = mm_config->poll_backoff_max;
     self->config.extra_cap_flags   = (mm_config->error_handling == UCS_YES) ?
                                      UCT_IFACE_FLAG_ERRHANDLE_PEER_FAILURE :
                                      0ul;
@@ -804,6 +923,7 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                       UCT_IFACE_PARAM_FIELD_RX_HEADROOM) ?
                                      params->rx_headroom : 0;
     self->release_desc.cb          = uct_mm_iface_release_desc;
+    uct_mm_iface_poll_backoff_reset(self);
 
     /* Allocate the receive FIFO */
     status = uct_iface_mem_alloc(&self->super.super.super,
@@ -873,6 +993,7 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
     }
 
     ucs_arbiter_init(&self->arbiter);
+    ucs_list_head_init(&self->reserved_eps);
     uct_mm_iface_log_created(self);
 
     return UCS_OK;
@@ -15,6 +15,7 @@
 #include <ucs/arch/cpu.h>
 #include <ucs/debug/memtrack_int.h>
 #include <ucs/datastruct/arbiter.h>
+#include <ucs/datastruct/list.h>
 #include <ucs/sys/compiler.h>
 #include <ucs/sys/ptr_arith.h>
 #include <ucs/sys/sys.h>
@@ -29,9 +30,28 @@ enum {
 
     /* Whether the element data is inline or in receive descriptor */
     UCT_MM_FIFO_ELEM_FLAG_INLINE = UCS_BIT(1),
+
+    /* The element was reserved by a sender but released without data, the
+       receiver should skip it */
+    UCT_MM_FIFO_ELEM_FLAG_SKIP   = UCS_BIT(2)
 };
 
 
+/**
+ * How senders acquire elements of the remote receive FIFO
+ */
+typedef enum {
+    /* Acquire a single element per send operation */
+    UCT_MM_FIFO_MODE_SINGLE,
+
+    /* Reserve a batch of elements with one atomic operation and fill them by
+       subsequent send operations */
+    UCT_MM_FIFO_MODE_BATCH,
+
+    UCT_MM_FIFO_MODE_LAST
+} uct_mm_fifo_mode_t;
+
+
 #define UCT_MM_FIFO_CTL_SIZE \
     ucs_align_up(sizeof(uct_mm_fifo_ctl_t), UCS_SYS_CACHE_LINE_SIZE)
 
@@ -84,6 +104,13 @@ enum {
 #define UCT_MM_IFACE_FIFO_AI_VALUE              1 /* FIFO window += AI value */
 #define UCT_MM_IFACE_FIFO_MD_FACTOR             2 /* FIFO window /= MD factor */
 
+/* Exponential backoff of receive FIFO polling. After the given number of
+ * consecutive empty polls, the FIFO is polled only once in an interval of
+ * iface progress calls, which doubles every time the FIFO is found empty, up to
+ * a configured limit. The FIFO head, which is advanced by every sender, serves
+ * as a doorbell: the interval is reset when it moves past the read index. */
+#define UCT_MM_IFACE_POLL_BACKOFF_THRESH       16
+
 /* If this bit is set in fifo_ctl.head, trigger async event on the receiver  */
 #define UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED      UCS_BIT(63)
 
@@ -115,6 +142,10 @@ typedef struct uct_mm_iface_config {
                                                    * shared memory buffers */
     unsigned                 fifo_elem_size;      /* Size of the FIFO element size */
     int                      error_handling; /* Exposing of error handling cap */
+    uct_mm_fifo_mode_t       fifo_mode;      /* How to acquire FIFO elements */
+    unsigned                 fifo_batch;     /* Elements to reserve at once */
+    unsigned                 poll_backoff_max; /* Max. progress calls to skip
+                                                  polling an idle FIFO */
     uct_iface_mpool_config_t mp;
     uct_mm_iface_overhead_t  overhead;
 } uct_mm_iface_config_t;
@@ -219,6 +250,15 @@ typedef struct uct_mm_iface {
     int                     fifo_prev_wnd_cons;  /* Was FIFO window size fully consumed by
                                                   * the previous call to iface progress */
 
+    struct {
+        unsigned            empty_polls;  /* Consecutive polls which found the
+                                           * FIFO empty */
+        unsigned            interval;     /* Current polling interval, in iface
+                                           * progress calls */
+        unsigned            countdown;    /* Progress calls left until the
+                                           * next doorbell check */
+    } poll_backoff;
+
     ucs_mpool_t             recv_desc_mp;
     uct_mm_recv_desc_t      *last_recv_desc;  /* next receive descriptor to use */
 
@@ -227,6 +267,8 @@ typedef struct uct_mm_iface {
     size_t                  rx_headroom;
     ucs_arbiter_t           arbiter;
     uct_recv_desc_t         release_desc;
+    ucs_list_link_t         reserved_eps;     /* endpoints which hold reserved
+                                                 elements in a remote FIFO */
 
     struct {
         unsigned                fifo_size;
@@ -234,6 +276,10 @@ typedef struct uct_mm_iface {
         /* size of the receive descriptor (for payload) */
         unsigned                seg_size;
         unsigned                fifo_max_poll;
+        /* number of FIFO elements to reserve by one atomic operation */
+        unsigned                fifo_batch;
+        /* maximal polling interval of an idle FIFO, 0 - no backoff */
+        unsigned                poll_backoff_max;
         uint64_t                extra_cap_flags;
         uct_mm_iface_overhead_t overhead;
     } config;
@@ -13,6 +13,7 @@
 #include <uct/base/uct_iov.inl>
 #include <ucs/sys/sock.h>
 #include <ucs/sys/string.h>
+#include <ucs/datastruct/array.h>
 #include <ucs/datastruct/conn_match.h>
 #include <ucs/datastruct/ptr_map.inl>
 #include <ucs/algorithm/crc.h>
@@ -114,7 +115,23 @@ enum {
     /* EP is on EP PTR map. */
     UCT_TCP_EP_FLAG_ON_PTR_MAP         = UCS_BIT(9),
     /* EP has some operations done without flush */
-    UCT_TCP_EP_FLAG_NEED_FLUSH         = UCS_BIT(10)
+    UCT_TCP_EP_FLAG_NEED_FLUSH         = UCS_BIT(10),
+    /* Zcopy TX operation in progress is sent with MSG_ZEROCOPY, so its
+     * completion is reported by the kernel on the socket error queue. */
+    UCT_TCP_EP_FLAG_ZEROCOPY_TX        = UCS_BIT(11),
+    /* EP received AM data which waits for dispatch on the iface RX batch */
+    UCT_TCP_EP_FLAG_RX_BATCHED         = UCS_BIT(12)
+};
+
+
+/**
+ * TCP iface statistics counters
+ */
+enum {
+    UCT_TCP_IFACE_STAT_RX_WAKEUPS,
+    UCT_TCP_IFACE_STAT_RX_EPS,
+    UCT_TCP_IFACE_STAT_RX_AM,
+    UCT_TCP_IFACE_STAT_LAST
 };
 
 
@@ -261,6 +278,34 @@ typedef struct uct_tcp_ep_put_completion {
 } uct_tcp_ep_put_completion_t;
 
 
+/**
+ * TCP MSG_ZEROCOPY completion, waiting for the kernel to release the pages
+ * of a sent buffer
+ */
+typedef struct uct_tcp_ep_zerocopy_completion {
+    uct_completion_t              *comp;           /* User's completion of
+                                                    * AM Zcopy or flush */
+    uint32_t                      wait_sn;         /* Number of zero-copy sends
+                                                    * which have to be released
+                                                    * by the kernel */
+    ucs_queue_elem_t              elem;            /* Element in TCP EP zero-copy
+                                                    * completion queue */
+} uct_tcp_ep_zerocopy_completion_t;
+
+
+/**
+ * Range of zero-copy sends released by the kernel out of order
+ */
+typedef struct uct_tcp_ep_zerocopy_range {
+    uint32_t                      first;
+    uint32_t                      last;
+} uct_tcp_ep_zerocopy_range_t;
+
+
+UCS_ARRAY_DECLARE_TYPE(uct_tcp_ep_zerocopy_ranges_t, unsigned,
+                       uct_tcp_ep_zerocopy_range_t);
+
+
 /**
  * TCP endpoint communication context
  */
@@ -281,6 +326,10 @@ typedef struct uct_tcp_ep_ctx {
 typedef struct uct_tcp_ep_zcopy_tx {
     uct_tcp_am_hdr_t              super;     /* UCT TCP AM header */
     uct_completion_t              *comp;     /* Local UCT completion object */
+    uct_tcp_ep_zerocopy_completion_t *zerocopy_comp; /* Completion record used
+                                                      * if sent with MSG_ZEROCOPY */
+    size_t                        zerocopy_iov_index; /* First IOV that can be
+                                                       * sent with MSG_ZEROCOPY */
     size_t                        iov_index; /* Current IOV index */
     size_t                        iov_cnt;   /* Number of IOVs that should be sent */
     struct iovec                  iov[0];    /* IOVs that should be sent */
@@ -349,6 +398,15 @@ struct uct_tcp_ep {
     ucs_queue_head_t              pending_q;    /* Pending operations */
     ucs_queue_head_t              put_comp_q;   /* Flush completions waiting for
                                                  * outstanding PUTs acknowledgment */
+    struct {
+        uint32_t                      sn;       /* Number of sends done with
+                                                 * MSG_ZEROCOPY on the socket */
+        uint32_t                      acked;    /* Number of sends released by
+                                                 * the kernel, in order */
+        ucs_queue_head_t              comp_q;   /* Completions waiting for the
+                                                 * kernel to release the pages */
+        uct_tcp_ep_zerocopy_ranges_t  ooo;      /* Ranges released out of order */
+    } zerocopy;
     union {
         ucs_list_link_t           list;         /* List element to insert into TCP EP list */
         ucs_conn_match_elem_t     elem;         /* Connection matching element, used by EPs
@@ -384,11 +442,22 @@ typedef struct uct_tcp_iface {
                                                       * (0/1 for each EP) */
     ucs_range_spec_t              port_range;        /** Range of ports to use for bind() */
 
+    struct {
+        uct_tcp_ep_t              *eps[UCT_TCP_MAX_EVENTS]; /* EPs with received
+                                                             * AM data which was
+                                                             * not dispatched yet */
+        unsigned                  count;             /* Number of EPs in the batch */
+    } rx_batch;
+
+    UCS_STATS_NODE_DECLARE(stats)
+
     struct {
         size_t                    tx_seg_size;       /* TX AM buffer size */
         size_t                    rx_seg_size;       /* RX AM buffer size */
         size_t                    sendv_thresh;      /* Minimum size of user's payload from which
                                                       * non-blocking vector send should be used */
+        size_t                    zerocopy_thresh;   /* Minimum size of AM Zcopy payload from
+                                                      * which MSG_ZEROCOPY should be used */
         size_t                    max_iov;           /* Maximum supported IOVs limited by
                                                       * user configuration and service buffers
                                                       * (TCP protocol and user's AM headers) */
@@ -405,6 +474,8 @@ typedef struct uct_tcp_iface {
         int                       put_enable;        /* Enable PUT Zcopy operation support */
         int                       conn_nb;           /* Use non-blocking connect() */
         unsigned                  max_poll;          /* Number of events to poll per socket*/
+        int                       rx_batch;          /* Receive from all ready sockets
+                                                      * before dispatching AM handlers */
         uint8_t                   max_conn_retries;  /* How many connection establishment attempts
                                                       * should be done if dropped connection was
                                                       * detected due to lack of system resources */
@@ -441,10 +512,12 @@ typedef struct uct_tcp_iface_config {
     size_t                         rx_seg_size;
     size_t                         max_iov;
     size_t                         sendv_thresh;
+    size_t                         zerocopy_thresh;
     int                            prefer_default;
     int                            put_enable;
     int                            conn_nb;
     unsigned                       max_poll;
+    int                            rx_batch;
     unsigned                       max_conn_retries;
     int                            sockopt_nodelay;
     uct_tcp_send_recv_buf_config_t sockopt;
@@ -588,6 +661,14 @@ void uct_tcp_ep_mod_events(uct_tcp_ep_t *ep, ucs_event_set_types_t add,
 
 void uct_tcp_ep_pending_queue_dispatch(uct_tcp_ep_t *ep);
 
+unsigned uct_tcp_ep_progress_zerocopy(uct_tcp_ep_t *ep);
+
+unsigned uct_tcp_ep_progress_rx_batch(uct_tcp_ep_t *ep);
+
+unsigned uct_tcp_ep_dispatch_rx_batch(uct_tcp_ep_t *ep);
+
+unsigned uct_tcp_iface_rx_batch_dispatch(uct_tcp_iface_t *iface);
+
 ucs_status_t uct_tcp_ep_am_short(uct_ep_h uct_ep, uint8_t am_id, uint64_t header,
                                  const void *payload, unsigned length);
 
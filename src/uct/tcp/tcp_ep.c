@@ -12,6 +12,9 @@
 #include "tcp/tcp.h"
 
 #include <ucs/async/async.h>
+#ifdef UCT_TCP_EP_ZEROCOPY
+#  include <linux/errqueue.h>
+#endif
 
 
 /* Forward declarations */
@@ -130,6 +133,27 @@ int uct_tcp_ep_is_self(const uct_tcp_ep_t *ep)
     return uct_tcp_iface_is_self_addr(iface, (struct sockaddr*)&ep->peer_addr);
 }
 
+static void uct_tcp_ep_rx_batch_remove(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    unsigned i;
+
+    if (!(ep->flags & UCT_TCP_EP_FLAG_RX_BATCHED)) {
+        return;
+    }
+
+    for (i = 0; i < iface->rx_batch.count; ++i) {
+        if (iface->rx_batch.eps[i] == ep) {
+            /* The slot is skipped by the batch dispatch */
+            iface->rx_batch.eps[i] = NULL;
+            break;
+        }
+    }
+
+    ep->flags &= ~UCT_TCP_EP_FLAG_RX_BATCHED;
+}
+
 static void uct_tcp_ep_cleanup(uct_tcp_ep_t *ep)
 {
     if (ep->tx.buf != NULL) {
@@ -241,6 +265,10 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_tcp_iface_t *iface, int fd,
     ucs_list_head_init(&self->list);
     ucs_queue_head_init(&self->pending_q);
     ucs_queue_head_init(&self->put_comp_q);
+    ucs_queue_head_init(&self->zerocopy.comp_q);
+    ucs_array_init_dynamic(&self->zerocopy.ooo);
+    self->zerocopy.sn    = 0;
+    self->zerocopy.acked = 0;
 
     if (dest_addr != NULL) {
         memcpy(&self->peer_addr[0], dest_addr, iface->config.sockaddr_len);
@@ -341,13 +369,76 @@ uct_tcp_ep_tx_completed(uct_tcp_ep_t *ep, size_t sent_length)
     ep->tx.offset      += sent_length;
 }
 
+static void uct_tcp_ep_zerocopy_comp_push(uct_tcp_ep_t *ep,
+                                          uct_tcp_ep_zerocopy_completion_t *zcomp,
+                                          uct_completion_t *comp)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    zcomp->comp    = comp;
+    zcomp->wait_sn = ep->zerocopy.sn;
+    ucs_queue_push(&ep->zerocopy.comp_q, &zcomp->elem);
+    uct_tcp_iface_outstanding_inc(iface);
+
+    /* zero-copy notifications are reported as socket errors */
+    uct_tcp_ep_mod_events(ep, UCS_EVENT_SET_EVERR, 0);
+}
+
+static void uct_tcp_ep_zerocopy_comp_purge(uct_tcp_ep_t *ep,
+                                           ucs_status_t status, int all)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_zerocopy_completion_t *zcomp;
+
+    ucs_queue_for_each_extract(zcomp, &ep->zerocopy.comp_q, elem,
+                               all || UCS_CIRCULAR_COMPARE32(zcomp->wait_sn, <=,
+                                                             ep->zerocopy.acked)) {
+        if (zcomp->comp != NULL) {
+            uct_invoke_completion(zcomp->comp, status);
+        }
+        ucs_mpool_put_inline(zcomp);
+        uct_tcp_iface_outstanding_dec(iface);
+    }
+
+    if (ucs_queue_is_empty(&ep->zerocopy.comp_q) && (ep->fd != -1)) {
+        uct_tcp_ep_mod_events(ep, 0, UCS_EVENT_SET_EVERR);
+    }
+}
+
+/* Returns nonzero if completion was deferred until the kernel releases the
+ * buffers sent with MSG_ZEROCOPY */
+static int uct_tcp_ep_zerocopy_tx_completed(uct_tcp_ep_t *ep,
+                                            uct_tcp_ep_zerocopy_completion_t *zcomp,
+                                            uct_completion_t *comp,
+                                            ucs_status_t status)
+{
+    ep->flags &= ~UCT_TCP_EP_FLAG_ZEROCOPY_TX;
+
+    if ((status != UCS_OK) ||
+        (ep->zerocopy.acked == ep->zerocopy.sn)) {
+        ucs_mpool_put_inline(zcomp);
+        return 0;
+    }
+
+    uct_tcp_ep_zerocopy_comp_push(ep, zcomp, comp);
+    return 1;
+}
+
 static UCS_F_ALWAYS_INLINE void
-uct_tcp_ep_zcopy_completed(uct_tcp_ep_t *ep, uct_completion_t *comp,
+uct_tcp_ep_zcopy_completed(uct_tcp_ep_t *ep, uct_tcp_ep_zcopy_tx_t *ctx,
                            ucs_status_t status)
 {
     ep->flags &= ~UCT_TCP_EP_FLAG_ZCOPY_TX;
-    if (comp != NULL) {
-        uct_invoke_completion(comp, status);
+    if (ucs_unlikely(ep->flags & UCT_TCP_EP_FLAG_ZEROCOPY_TX) &&
+        uct_tcp_ep_zerocopy_tx_completed(ep, ctx->zerocopy_comp, ctx->comp,
+                                         status)) {
+        return;
+    }
+
+    if (ctx->comp != NULL) {
+        uct_invoke_completion(ctx->comp, status);
     }
 }
 
@@ -361,7 +452,7 @@ static void uct_tcp_ep_purge(uct_tcp_ep_t *ep, ucs_status_t status)
 
     if (ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX) {
         ctx = (uct_tcp_ep_zcopy_tx_t*)ep->tx.buf;
-        uct_tcp_ep_zcopy_completed(ep, ctx->comp, status);
+        uct_tcp_ep_zcopy_completed(ep, ctx, status);
         uct_tcp_ep_tx_completed(ep, ep->tx.length - ep->tx.offset);
     }
 
@@ -369,6 +460,8 @@ static void uct_tcp_ep_purge(uct_tcp_ep_t *ep, ucs_status_t status)
         uct_invoke_completion(put_comp->comp, status);
         ucs_mpool_put_inline(put_comp);
     }
+
+    uct_tcp_ep_zerocopy_comp_purge(ep, status, 1);
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
@@ -393,6 +486,7 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
 
     uct_tcp_ep_remove_ctx_cap(self, UCT_TCP_EP_CTX_CAPS);
     uct_tcp_ep_purge(self, UCS_ERR_CANCELED);
+    ucs_array_cleanup_dynamic(&self->zerocopy.ooo);
 
     if (self->flags & UCT_TCP_EP_FLAG_FAILED) {
         /* a failed EP callback can be still scheduled on the UCT worker,
@@ -405,6 +499,7 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
 
     ucs_callbackq_remove_oneshot(&iface->super.worker->super.progress_q, self,
                                  uct_tcp_ep_progress_rx_remove_filter, self);
+    uct_tcp_ep_rx_batch_remove(self);
 
     uct_tcp_ep_cleanup(self);
     uct_tcp_cm_change_conn_state(self, UCT_TCP_EP_CONN_STATE_CLOSED);
@@ -731,10 +826,13 @@ void uct_tcp_ep_replace_ep(uct_tcp_ep_t *to_ep, uct_tcp_ep_t *from_ep)
     to_ep->conn_retries++;
 
     uct_tcp_ep_ctx_move(&to_ep->tx, &from_ep->tx);
+    uct_tcp_ep_rx_batch_remove(from_ep);
     uct_tcp_ep_ctx_move(&to_ep->rx, &from_ep->rx);
 
     ucs_queue_splice(&to_ep->pending_q, &from_ep->pending_q);
     ucs_queue_splice(&to_ep->put_comp_q, &from_ep->put_comp_q);
+    /* the internal EP doesn't send AM Zcopy, so it has no zero-copy state */
+    ucs_assert(ucs_queue_is_empty(&from_ep->zerocopy.comp_q));
 
     to_ep->flags |= from_ep->flags & (UCT_TCP_EP_FLAG_ZCOPY_TX           |
                                       UCT_TCP_EP_FLAG_PUT_RX             |
@@ -1126,6 +1224,155 @@ static inline ssize_t uct_tcp_ep_send(uct_tcp_ep_t *ep)
     return sent_length;
 }
 
+#ifdef UCT_TCP_EP_ZEROCOPY
+static void uct_tcp_ep_zerocopy_ack(uct_tcp_ep_t *ep, uint32_t first,
+                                    uint32_t last)
+{
+    uct_tcp_ep_zerocopy_range_t *range;
+    int merged;
+
+    if (first != ep->zerocopy.acked) {
+        /* keep the range until all preceding sends are released */
+        range = ucs_array_append(&ep->zerocopy.ooo,
+                                 ucs_fatal("tcp_ep %p: failed to save "
+                                           "zero-copy range", ep));
+        range->first = first;
+        range->last  = last;
+        return;
+    }
+
+    ep->zerocopy.acked = last + 1;
+
+    do {
+        merged = 0;
+        ucs_array_for_each(range, &ep->zerocopy.ooo) {
+            if (range->first == ep->zerocopy.acked) {
+                ep->zerocopy.acked = range->last + 1;
+                *range             = *ucs_array_last(&ep->zerocopy.ooo);
+                ucs_array_pop_back(&ep->zerocopy.ooo);
+                merged = 1;
+                break;
+            }
+        }
+    } while (merged);
+}
+#endif /* UCT_TCP_EP_ZEROCOPY */
+
+unsigned uct_tcp_ep_progress_zerocopy(uct_tcp_ep_t *ep)
+{
+#ifdef UCT_TCP_EP_ZEROCOPY
+    char control[CMSG_SPACE(sizeof(struct sock_extended_err))];
+    struct sock_extended_err *serr;
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+    uint32_t prev_acked;
+    ssize_t ret;
+
+    if (ep->zerocopy.acked == ep->zerocopy.sn) {
+        return 0;
+    }
+
+    prev_acked = ep->zerocopy.acked;
+
+    for (;;) {
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof(control);
+
+        ret = recvmsg(ep->fd, &msg, MSG_ERRQUEUE);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                ucs_debug("tcp_ep %p: recvmsg(fd=%d, MSG_ERRQUEUE) failed: %m",
+                          ep, ep->fd);
+            }
+            break;
+        }
+
+        for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+             cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (!(((cmsg->cmsg_level == SOL_IP) &&
+                   (cmsg->cmsg_type == IP_RECVERR)) ||
+                  ((cmsg->cmsg_level == SOL_IPV6) &&
+                   (cmsg->cmsg_type == IPV6_RECVERR)))) {
+                continue;
+            }
+
+            serr = (struct sock_extended_err*)CMSG_DATA(cmsg);
+            if ((serr->ee_errno != 0) ||
+                (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)) {
+                continue;
+            }
+
+            ucs_trace_data("tcp_ep %p: zero-copy sends %u..%u released%s", ep,
+                           serr->ee_info, serr->ee_data,
+                           (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) ?
+                           " (copied)" : "");
+            uct_tcp_ep_zerocopy_ack(ep, serr->ee_info, serr->ee_data);
+        }
+    }
+
+    if (ep->zerocopy.acked == prev_acked) {
+        return 0;
+    }
+
+    uct_tcp_ep_zerocopy_comp_purge(ep, UCS_OK, 0);
+    return 1;
+#else
+    return 0;
+#endif /* UCT_TCP_EP_ZEROCOPY */
+}
+
+static ucs_status_t
+uct_tcp_ep_sendv_zerocopy(uct_tcp_ep_t *ep, struct iovec *iov, size_t iov_cnt,
+                          size_t hdr_iov_cnt, size_t *length_p)
+{
+    size_t hdr_length = 0;
+    size_t length;
+    ucs_status_t status;
+
+    if (hdr_iov_cnt != 0) {
+        /* headers may be reused as soon as the operation returns, so they are
+         * always copied to the socket */
+        status = ucs_socket_sendv_nb(ep->fd, iov, hdr_iov_cnt, &hdr_length);
+        if ((status != UCS_OK) ||
+            (hdr_length < ucs_iovec_total_length(iov, hdr_iov_cnt))) {
+            *length_p = hdr_length;
+            return status;
+        }
+
+        iov     += hdr_iov_cnt;
+        iov_cnt -= hdr_iov_cnt;
+    }
+
+#ifdef UCT_TCP_EP_ZEROCOPY
+    status = ucs_socket_sendv_flags_nb(ep->fd, iov, iov_cnt, MSG_ZEROCOPY,
+                                       &length);
+    if (status == UCS_OK) {
+        /* the kernel numbers every successful MSG_ZEROCOPY send */
+        ep->zerocopy.sn++;
+    } else if (status == UCS_ERR_NO_MEMORY) {
+        /* the limit of locked memory was reached, copy the payload */
+        status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, &length);
+    }
+#else
+    status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, &length);
+#endif /* UCT_TCP_EP_ZEROCOPY */
+
+    if ((status == UCS_ERR_NO_PROGRESS) && (hdr_length != 0)) {
+        status = UCS_OK;
+    } else if (status != UCS_OK) {
+        *length_p = 0;
+        return status;
+    }
+
+    *length_p = hdr_length + length;
+    return UCS_OK;
+}
+
 static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
 {
     uct_tcp_ep_zcopy_tx_t *ctx = (uct_tcp_ep_zcopy_tx_t*)ep->tx.buf;
@@ -1135,8 +1382,17 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
     ucs_assertv((ep->tx.offset < ep->tx.length) &&
                 (ctx->iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, &ctx->iov[ctx->iov_index],
-                                 ctx->iov_cnt - ctx->iov_index, &sent_length);
+    if (ucs_likely(!(ep->flags & UCT_TCP_EP_FLAG_ZEROCOPY_TX))) {
+        status = ucs_socket_sendv_nb(ep->fd, &ctx->iov[ctx->iov_index],
+                                     ctx->iov_cnt - ctx->iov_index,
+                                     &sent_length);
+    } else {
+        status = uct_tcp_ep_sendv_zerocopy(ep, &ctx->iov[ctx->iov_index],
+                                           ctx->iov_cnt - ctx->iov_index,
+                                           ucs_max(ctx->zerocopy_iov_index,
+                                                   ctx->iov_index) -
+                                           ctx->iov_index, &sent_length);
+    }
     if (ucs_unlikely(status != UCS_OK)) {
         if (status == UCS_ERR_NO_PROGRESS) {
             ucs_assert(sent_length == 0);
@@ -1144,7 +1400,7 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
         }
 
         status = uct_tcp_ep_handle_send_err(ep, status);
-        uct_tcp_ep_zcopy_completed(ep, ctx->comp, status);
+        uct_tcp_ep_zcopy_completed(ep, ctx, status);
         return status;
     }
 
@@ -1154,7 +1410,7 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
         ucs_iov_advance(ctx->iov, ctx->iov_cnt,
                         &ctx->iov_index, sent_length);
     } else {
-        uct_tcp_ep_zcopy_completed(ep, ctx->comp, UCS_OK);
+        uct_tcp_ep_zcopy_completed(ep, ctx, UCS_OK);
     }
 
     ucs_assert(sent_length <= SSIZE_MAX);
@@ -1368,6 +1624,7 @@ uct_tcp_ep_comp_recv_am(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
                        hdr + 1, hdr->length,
                        "RECV: ep %p fd %d received %zu/%zu bytes",
                        ep, ep->fd, ep->rx.offset, ep->rx.length);
+    UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_TCP_IFACE_STAT_RX_AM, 1);
     uct_iface_invoke_am(&iface->super, hdr->am_id, hdr + 1, hdr->length, 0);
 }
 
@@ -1431,17 +1688,13 @@ static inline void uct_tcp_ep_handle_put_req(uct_tcp_ep_t *ep,
     ep->flags |= UCT_TCP_EP_FLAG_PUT_RX;
 }
 
-static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
+static unsigned uct_tcp_ep_am_rx_recv(uct_tcp_ep_t *ep)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                             uct_tcp_iface_t);
-    unsigned handled       = 0;
     uct_tcp_am_hdr_t *hdr;
     size_t recv_length;
     size_t recvd_length;
-    size_t remaining;
-
-    ucs_trace_func("ep=%p", ep);
 
     if (!uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
         if (ucs_unlikely(uct_tcp_ep_ctx_buf_alloc(
@@ -1467,9 +1720,16 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
         recv_length  = ucs_max(0, (ssize_t)(hdr->length - recvd_length));
     }
 
-    if (!uct_tcp_ep_recv(ep, recv_length)) {
-        goto out;
-    }
+    return uct_tcp_ep_recv(ep, recv_length);
+}
+
+static unsigned uct_tcp_ep_am_rx_dispatch(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    unsigned handled       = 0;
+    uct_tcp_am_hdr_t *hdr;
+    size_t remaining;
 
     /* Parse received active messages */
     while (uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
@@ -1547,6 +1807,60 @@ out:
     return handled;
 }
 
+static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
+{
+    ucs_trace_func("ep=%p", ep);
+
+    if (!uct_tcp_ep_am_rx_recv(ep)) {
+        return 0;
+    }
+
+    return uct_tcp_ep_am_rx_dispatch(ep);
+}
+
+unsigned uct_tcp_ep_progress_rx_batch(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    unsigned count         = 0;
+
+    ucs_trace_func("ep=%p", ep);
+
+    if ((ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED) ||
+        (ep->flags & UCT_TCP_EP_FLAG_PUT_RX)) {
+        /* Only AM data of connected EPs is received in batches */
+        return uct_tcp_ep_cm_state[ep->conn_state].rx_progress(ep);
+    }
+
+    if (ep->flags & UCT_TCP_EP_FLAG_RX_BATCHED) {
+        /* The socket stays readable until the received data is dispatched */
+        return 0;
+    }
+
+    if (iface->rx_batch.count == UCT_TCP_MAX_EVENTS) {
+        count = uct_tcp_iface_rx_batch_dispatch(iface);
+    }
+
+    if (uct_tcp_ep_am_rx_recv(ep)) {
+        ep->flags |= UCT_TCP_EP_FLAG_RX_BATCHED;
+        iface->rx_batch.eps[iface->rx_batch.count++] = ep;
+    }
+
+    return count;
+}
+
+unsigned uct_tcp_ep_dispatch_rx_batch(uct_tcp_ep_t *ep)
+{
+    ucs_assert(ep->flags & UCT_TCP_EP_FLAG_RX_BATCHED);
+    ep->flags &= ~UCT_TCP_EP_FLAG_RX_BATCHED;
+
+    if (!uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
+        return 0;
+    }
+
+    return uct_tcp_ep_am_rx_dispatch(ep);
+}
+
 static inline ucs_status_t
 uct_tcp_ep_am_prepare(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
                       uint8_t am_id, uct_tcp_am_hdr_t **hdr)
@@ -1746,7 +2060,14 @@ uct_tcp_ep_am_sendv(uct_tcp_ep_t *ep, int short_sendv, uct_tcp_am_hdr_t *hdr,
     ucs_assertv((ep->tx.length <= send_limit) &&
                 (iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, &sent_length);
+    if (ucs_likely(!(ep->flags & UCT_TCP_EP_FLAG_ZEROCOPY_TX))) {
+        status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, &sent_length);
+    } else {
+        status = uct_tcp_ep_sendv_zerocopy(
+                ep, iov, iov_cnt,
+                ucs_derived_of(hdr, uct_tcp_ep_zcopy_tx_t)->zerocopy_iov_index,
+                &sent_length);
+    }
     if (ucs_unlikely((status != UCS_OK) && (status != UCS_ERR_NO_PROGRESS))) {
         return uct_tcp_ep_handle_send_err(ep, status);
     }
@@ -2005,6 +2326,7 @@ uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id
     }
 
     /* User-defined payload */
+    ctx->zerocopy_iov_index = ctx->iov_cnt;
     ucs_iov_iter_init(&uct_iov_iter);
     io_vec_cnt       = iovcnt;
     *zcopy_payload_p = uct_iov_to_iovec(&ctx->iov[ctx->iov_cnt], &io_vec_cnt,
@@ -2024,6 +2346,7 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
     uct_tcp_iface_t *iface     = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
     uct_tcp_ep_zcopy_tx_t *ctx = NULL;
     size_t payload_length      = 0;
+    uct_tcp_ep_zerocopy_completion_t *zcomp;
     ucs_status_t status;
 
     UCT_CHECK_LENGTH(header_length + uct_iov_total_length(iov, iovcnt), 0,
@@ -2040,9 +2363,24 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
 
     ctx->super.length = payload_length + header_length;
 
+    zcomp = NULL;
+    if (ucs_unlikely((payload_length >= iface->config.zerocopy_thresh) &&
+                     (payload_length > 0))) {
+        /* allocate the completion record in advance, since the operation
+         * can't fail after the payload was handed to the kernel */
+        zcomp = ucs_mpool_get_inline(&iface->tx_mpool);
+        if (zcomp != NULL) {
+            ctx->zerocopy_comp = zcomp;
+            ep->flags         |= UCT_TCP_EP_FLAG_ZEROCOPY_TX;
+        }
+    }
+
     status = uct_tcp_ep_am_sendv(ep, 0, &ctx->super, iface->config.rx_seg_size,
                                  header, ctx->iov, ctx->iov_cnt);
     if (ucs_unlikely(status != UCS_OK)) {
+        if (ep->flags & UCT_TCP_EP_FLAG_ZEROCOPY_TX) {
+            uct_tcp_ep_zerocopy_tx_completed(ep, zcomp, comp, status);
+        }
         return status;
     }
 
@@ -2054,6 +2392,11 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
         return UCS_INPROGRESS;
     }
 
+    if (ucs_unlikely(ep->flags & UCT_TCP_EP_FLAG_ZEROCOPY_TX) &&
+        uct_tcp_ep_zerocopy_tx_completed(ep, zcomp, comp, UCS_OK)) {
+        return UCS_INPROGRESS;
+    }
+
     return UCS_OK;
 }
 
@@ -2190,7 +2533,10 @@ void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
 ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
                               uct_completion_t *comp)
 {
-    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_ep_t *ep       = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_tcp_iface_t);
+    uct_tcp_ep_zerocopy_completion_t *zcomp;
+    int zerocopy_wait;
     ucs_status_t status;
 
     if (ucs_unlikely(flags & UCT_FLUSH_FLAG_CANCEL)) {
@@ -2215,18 +2561,43 @@ ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
         ucs_assert(ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK);
     }
 
+    zerocopy_wait = !ucs_queue_is_empty(&ep->zerocopy.comp_q);
+    if (!zerocopy_wait && !(ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK)) {
+        UCT_TL_EP_STAT_FLUSH(&ep->super);
+        return UCS_OK;
+    }
+
+    zcomp = NULL;
+    if (zerocopy_wait && (comp != NULL)) {
+        zcomp = ucs_mpool_get_inline(&iface->tx_mpool);
+        if (ucs_unlikely(zcomp == NULL)) {
+            ucs_error("tcp_ep %p: unable to allocate zero-copy completion "
+                      "from mpool", ep);
+            return UCS_ERR_NO_MEMORY;
+        }
+    }
+
     if (ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK) {
         status = uct_tcp_ep_put_comp_add(ep, comp, ep->tx.put_sn);
         if (status != UCS_OK) {
+            if (zcomp != NULL) {
+                ucs_mpool_put_inline(zcomp);
+            }
             return status;
         }
 
-        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
-        return UCS_INPROGRESS;
+        if (zcomp != NULL) {
+            /* wait for both PUT ACK and release of zero-copy buffers */
+            ++comp->count;
+        }
     }
 
-    UCT_TL_EP_STAT_FLUSH(&ep->super);
-    return UCS_OK;
+    if (zcomp != NULL) {
+        uct_tcp_ep_zerocopy_comp_push(ep, zcomp, comp);
+    }
+
+    UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+    return UCS_INPROGRESS;
 }
 
 ucs_status_t
@@ -12,6 +12,7 @@
 
 #include <ucs/async/async.h>
 #include <ucs/sys/string.h>
+#include <ucs/config/global_opts.h>
 #include <ucs/config/types.h>
 #include <sys/socket.h>
 #include <sys/poll.h>
@@ -23,6 +24,26 @@
 
 extern ucs_class_t UCS_CLASS_DECL_NAME(uct_tcp_iface_t);
 
+#ifdef ENABLE_STATS
+static ucs_stats_class_t uct_tcp_iface_stats_class = {
+    .name          = "tcp_iface",
+    .num_counters  = UCT_TCP_IFACE_STAT_LAST,
+    .class_id      = UCS_STATS_CLASS_ID_INVALID,
+    .counter_names = {
+        [UCT_TCP_IFACE_STAT_RX_WAKEUPS] = "rx_wakeups",
+        [UCT_TCP_IFACE_STAT_RX_EPS]     = "rx_eps",
+        [UCT_TCP_IFACE_STAT_RX_AM]      = "rx_am"
+    }
+};
+#endif
+
+
+/* Progress state passed to the event set callback */
+typedef struct {
+    unsigned count;  /* Number of progressed operations */
+    unsigned rx_eps; /* Number of EPs whose sockets were readable */
+} uct_tcp_iface_progress_arg_t;
+
 static ucs_config_field_t uct_tcp_iface_config_table[] = {
   {"", "MAX_NUM_EPS=256", NULL,
    ucs_offsetof(uct_tcp_iface_config_t, super),
@@ -45,6 +66,13 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Threshold for switching from send() to sendmsg() for short active messages",
    ucs_offsetof(uct_tcp_iface_config_t, sendv_thresh), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"ZEROCOPY_THRESH", "inf",
+   "Threshold for sending AM Zcopy payload with MSG_ZEROCOPY flag, which lets\n"
+   "the kernel transmit user buffers without copying them to the socket. The\n"
+   "operation is completed only after the kernel releases the buffers.\n"
+   "inf - disable MSG_ZEROCOPY",
+   ucs_offsetof(uct_tcp_iface_config_t, zerocopy_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
   {"PREFER_DEFAULT", "y",
    "Give higher priority to the default network interface on the host",
    ucs_offsetof(uct_tcp_iface_config_t, prefer_default), UCS_CONFIG_TYPE_BOOL},
@@ -62,6 +90,12 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Number of times to poll on a ready socket. 0 - no polling, -1 - until drained",
    ucs_offsetof(uct_tcp_iface_config_t, max_poll), UCS_CONFIG_TYPE_UINT},
 
+  {"RX_BATCH", "n",
+   "Receive data from all ready sockets returned by a single poll before\n"
+   "dispatching the active message handlers. It reduces the per-message\n"
+   "progress overhead when many endpoints receive data at the same time.",
+   ucs_offsetof(uct_tcp_iface_config_t, rx_batch), UCS_CONFIG_TYPE_BOOL},
+
   {UCT_TCP_CONFIG_MAX_CONN_RETRIES, "25",
    "How many connection establishment attempts should be done if dropped "
    "connection was detected due to lack of system resources",
@@ -379,24 +413,55 @@ static void uct_tcp_iface_handle_events(void *callback_data,
                                         ucs_event_set_types_t events,
                                         void *arg)
 {
-    unsigned *count  = (unsigned*)arg;
-    uct_tcp_ep_t *ep = (uct_tcp_ep_t*)callback_data;
+    uct_tcp_iface_progress_arg_t *progress_arg = arg;
+    uct_tcp_ep_t *ep                           = callback_data;
+    uct_tcp_iface_t *iface                     =
+            ucs_derived_of(ep->super.super.iface, uct_tcp_iface_t);
 
     ucs_assertv(ep->conn_state != UCT_TCP_EP_CONN_STATE_CLOSED, "ep=%p", ep);
 
+    if (events & UCS_EVENT_SET_EVERR) {
+        progress_arg->count += uct_tcp_ep_progress_zerocopy(ep);
+    }
     if (events & UCS_EVENT_SET_EVREAD) {
-        *count += uct_tcp_ep_cm_state[ep->conn_state].rx_progress(ep);
+        ++progress_arg->rx_eps;
+        if (iface->config.rx_batch) {
+            progress_arg->count += uct_tcp_ep_progress_rx_batch(ep);
+        } else {
+            progress_arg->count +=
+                    uct_tcp_ep_cm_state[ep->conn_state].rx_progress(ep);
+        }
     }
     if (events & UCS_EVENT_SET_EVWRITE) {
-        *count += uct_tcp_ep_cm_state[ep->conn_state].tx_progress(ep);
+        progress_arg->count += uct_tcp_ep_cm_state[ep->conn_state].tx_progress(ep);
+    }
+}
+
+unsigned uct_tcp_iface_rx_batch_dispatch(uct_tcp_iface_t *iface)
+{
+    unsigned count = 0;
+    uct_tcp_ep_t *ep;
+    unsigned i;
+
+    /* An AM handler may destroy EPs from the batch, which resets their slots */
+    for (i = 0; i < iface->rx_batch.count; ++i) {
+        ep = iface->rx_batch.eps[i];
+        if (ep != NULL) {
+            iface->rx_batch.eps[i] = NULL;
+            count                 += uct_tcp_ep_dispatch_rx_batch(ep);
+        }
     }
+
+    iface->rx_batch.count = 0;
+    return count;
 }
 
 unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
 {
-    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
-    unsigned max_events    = iface->config.max_poll;
-    unsigned count         = 0;
+    uct_tcp_iface_t *iface                = ucs_derived_of(tl_iface,
+                                                           uct_tcp_iface_t);
+    unsigned max_events                   = iface->config.max_poll;
+    uct_tcp_iface_progress_arg_t progress = {0, 0};
     unsigned read_events;
     ucs_status_t status;
 
@@ -404,7 +469,11 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
         read_events = ucs_min(ucs_sys_event_set_max_wait_events, max_events);
         status = ucs_event_set_wait(iface->event_set, &read_events,
                                     0, uct_tcp_iface_handle_events,
-                                    (void *)&count);
+                                    (void *)&progress);
+        if (iface->rx_batch.count != 0) {
+            progress.count += uct_tcp_iface_rx_batch_dispatch(iface);
+        }
+
         max_events -= read_events;
         ucs_trace_poll("iface=%p ucs_event_set_wait() returned %d: "
                        "read events=%u, total=%u",
@@ -413,7 +482,13 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
     } while ((max_events > 0) && (read_events == UCT_TCP_MAX_EVENTS) &&
              ((status == UCS_OK) || (status == UCS_INPROGRESS)));
 
-    return count;
+    if (progress.rx_eps != 0) {
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_TCP_IFACE_STAT_RX_WAKEUPS, 1);
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_TCP_IFACE_STAT_RX_EPS,
+                                 progress.rx_eps);
+    }
+
+    return progress.count;
 }
 
 static ucs_status_t uct_tcp_iface_flush(uct_iface_h tl_iface, unsigned flags,
@@ -468,6 +543,25 @@ uct_tcp_iface_connect_handler(int listen_fd, ucs_event_set_types_t events,
     }
 }
 
+static void uct_tcp_iface_set_zerocopy(uct_tcp_iface_t *iface, int fd)
+{
+#ifdef UCT_TCP_EP_ZEROCOPY
+    int optval = 1;
+
+    if (iface->config.zerocopy_thresh == UCS_MEMUNITS_INF) {
+        return;
+    }
+
+    /* MSG_ZEROCOPY is silently ignored on sockets without SO_ZEROCOPY, so
+     * disable it for the whole interface if the kernel does not support it */
+    if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &optval, sizeof(optval)) < 0) {
+        ucs_diag("tcp_iface %p: failed to set SO_ZEROCOPY on fd %d (%m), "
+                 "MSG_ZEROCOPY is disabled", iface, fd);
+        iface->config.zerocopy_thresh = UCS_MEMUNITS_INF;
+    }
+#endif /* UCT_TCP_EP_ZEROCOPY */
+}
+
 ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd,
                                        int set_nb)
 {
@@ -493,6 +587,8 @@ ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd,
         return status;
     }
 
+    uct_tcp_iface_set_zerocopy(iface, fd);
+
     return ucs_tcp_base_set_syn_cnt(fd, iface->config.syn_cnt);
 }
 
@@ -687,6 +783,16 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         self->config.sendv_thresh = UCS_MEMUNITS_INF;
     }
 
+#ifdef UCT_TCP_EP_ZEROCOPY
+    self->config.zerocopy_thresh = config->zerocopy_thresh;
+#else
+    if (config->zerocopy_thresh != UCS_MEMUNITS_INF) {
+        ucs_diag("tcp_iface %p: MSG_ZEROCOPY is not supported, ignoring "
+                 "zerocopy threshold", self);
+    }
+    self->config.zerocopy_thresh = UCS_MEMUNITS_INF;
+#endif /* UCT_TCP_EP_ZEROCOPY */
+
     /* Maximum IOV count allowed by user's configuration (considering TCP
      * protocol and user's AM headers that use 1st and 2nd IOVs
      * correspondingly) and system constraints */
@@ -718,6 +824,7 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     self->config.put_enable        = config->put_enable;
     self->config.conn_nb           = config->conn_nb;
     self->config.max_poll          = config->max_poll;
+    self->config.rx_batch          = config->rx_batch;
     self->config.max_conn_retries  = config->max_conn_retries;
     self->config.syn_cnt           = config->syn_cnt;
     self->sockopt.nodelay          = config->sockopt_nodelay;
@@ -728,6 +835,7 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     self->config.ep_bind_src_addr  = config->ep_bind_src_addr;
     self->port_range.first         = config->port_range.first;
     self->port_range.last          = config->port_range.last;
+    self->rx_batch.count           = 0;
 
     if (config->keepalive.idle != UCS_MEMUNITS_AUTO) {
         /* TCP iface configuration sets the keepalive interval */
@@ -802,19 +910,28 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     status = UCS_PTR_MAP_INIT(tcp_ep, &self->ep_ptr_map);
     ucs_assert_always(status == UCS_OK);
 
-    status = ucs_event_set_create(&self->event_set);
+    status = ucs_event_set_create_backend(&self->event_set,
+                                          ucs_global_opts.event_set_backend);
     if (status != UCS_OK) {
         status = UCS_ERR_IO_ERROR;
         goto err_cleanup_rx_mpool;
     }
 
-    status = uct_tcp_iface_listener_init(self);
+    status = UCS_STATS_NODE_ALLOC(&self->stats, &uct_tcp_iface_stats_class,
+                                  self->super.stats, "-%p", self);
     if (status != UCS_OK) {
         goto err_cleanup_event_set;
     }
 
+    status = uct_tcp_iface_listener_init(self);
+    if (status != UCS_OK) {
+        goto err_release_stats;
+    }
+
     return UCS_OK;
 
+err_release_stats:
+    UCS_STATS_NODE_FREE(self->stats);
 err_cleanup_event_set:
     ucs_event_set_cleanup(self->event_set);
 err_cleanup_rx_mpool:
@@ -891,6 +1008,7 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_iface_t)
 
     ucs_close_fd(&self->listen_fd);
     ucs_event_set_cleanup(self->event_set);
+    UCS_STATS_NODE_FREE(self->stats);
 }
 
 UCS_CLASS_DEFINE(uct_tcp_iface_t, uct_base_iface_t);
@@ -247,6 +247,7 @@ void test_perf::test_params_init(const test_spec &test,
     params.ucp.send_datatype    = (ucp_perf_datatype_t)test.data_layout;
     params.ucp.recv_datatype    = (ucp_perf_datatype_t)test.data_layout;
     params.ucp.am_hdr_size      = 0;
+    params.ucp.pattern          = UCX_PERF_PATTERN_PAIR;
     params.ucp.is_daemon_mode   = 0;
     params.ucp.dmn_local_addr   = {};
     params.ucp.dmn_remote_addr  = {};
@@ -11,6 +11,7 @@
 extern "C" {
 #include <ucp/core/ucp_context.h>
 #include <ucp/core/ucp_mm.h>
+#include <ucp/core/ucp_mm_prereg.h>
 #include <ucp/core/ucp_rkey.h>
 #include <ucp/core/ucp_ep.inl>
 #include <ucp/dt/dt.h>
@@ -1033,6 +1034,50 @@ UCS_TEST_P(test_ucp_mmap, rndv_mpool_mdesc_no_rcache)
     }
 }
 
+UCS_TEST_SKIP_COND_P(test_ucp_mmap, mem_prereg,
+                     get_variant_value() == VARIANT_NO_RCACHE, "MEM_PREREG=y",
+                     "MEM_PREREG_MIN_SIZE=64k")
+{
+    const size_t size     = 4 * UCS_MBYTE;
+    ucp_context_h context = sender().ucph();
+
+    if (context->prereg == NULL) {
+        UCS_TEST_SKIP_R("memory pre-registration is not supported");
+    }
+
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(MAP_FAILED, ptr);
+
+    /* Memory which was unmapped before progress must not be registered */
+    void *unmapped = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(MAP_FAILED, unmapped);
+    munmap(unmapped, size);
+
+    for (int i = 0; (i < 1000) && (context->prereg->count > 0); ++i) {
+        progress();
+    }
+
+    ucp_mem_map_params_t params;
+    params.field_mask = UCP_MEM_MAP_PARAM_FIELD_ADDRESS |
+                        UCP_MEM_MAP_PARAM_FIELD_LENGTH;
+    params.address    = UCS_PTR_BYTE_OFFSET(ptr, size / 2);
+    params.length     = size / 4;
+
+    ucp_mem_h memh;
+    ASSERT_UCS_OK(ucp_mem_map(context, &params, &memh));
+    ASSERT_NE(nullptr, memh->parent);
+    EXPECT_TRUE(memh->parent->flags & UCP_MEMH_FLAG_PREREG);
+    EXPECT_LE(ucp_memh_address(memh->parent), ptr);
+    EXPECT_GE(UCS_PTR_BYTE_OFFSET(ucp_memh_address(memh->parent),
+                                  ucp_memh_length(memh->parent)),
+              UCS_PTR_BYTE_OFFSET(ptr, size));
+    ASSERT_UCS_OK(ucp_mem_unmap(context, memh));
+
+    munmap(ptr, size);
+}
+
 UCP_INSTANTIATE_TEST_CASE_GPU_AWARE(test_ucp_mmap)
 
 class test_ucp_mmap_atomic : public test_ucp_mmap {
@@ -637,6 +637,63 @@ UCS_TEST_P(test_ucp_peer_failure_keepalive, kill_receiver,
 UCP_INSTANTIATE_TEST_CASE(test_ucp_peer_failure_keepalive)
 
 
+class test_ucp_keepalive_jitter : public test_ucp_peer_failure {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant>& variants) {
+        add_variant_with_value(variants, UCP_FEATURE_AM, TEST_AM, "am");
+    }
+
+protected:
+    static const int NUM_EPS = 128;
+
+    void init() {
+        test_ucp_peer_failure::init();
+        for (int i = 0; i < NUM_EPS; ++i) {
+            sender().connect(&receiver(), get_ep_params(), i);
+        }
+        flush_worker(sender());
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_ucp_keepalive_jitter, idle_eps, RUNNING_ON_VALGRIND,
+                     "KEEPALIVE_INTERVAL=0.05s", "KEEPALIVE_NUM_EPS=16") {
+    ucp_worker_h worker = sender().worker();
+    std::vector<double> progress_usec;
+    size_t round_count;
+    ucs_time_t start, end, deadline;
+
+    if (ucp_ep_config(sender().ep())->key.keepalive_lane == UCP_NULL_LANE) {
+        UCS_TEST_SKIP_R("no keepalive lane");
+    }
+
+    /* Measure the duration of every progress call while endpoints are idle,
+     * so they are checked by keepalive */
+    round_count = worker->keepalive.round_count;
+    deadline    = ucs_get_time() + ucs_time_from_sec(0.5 *
+                                                     ucs::test_time_multiplier());
+    do {
+        start = ucs_get_time();
+        ucp_worker_progress(worker);
+        end   = ucs_get_time();
+        progress_usec.push_back(ucs_time_to_usec(end - start));
+        receiver().progress();
+    } while (end < deadline);
+
+    EXPECT_GT(worker->keepalive.round_count, round_count);
+    EXPECT_EQ(0, m_err_count);
+
+    std::sort(progress_usec.begin(), progress_usec.end());
+    UCS_TEST_MESSAGE << NUM_EPS << " eps, "
+                     << (worker->keepalive.round_count - round_count)
+                     << " keepalive rounds, progress latency: median "
+                     << progress_usec[progress_usec.size() / 2] << " us, 99% "
+                     << progress_usec[(progress_usec.size() * 99) / 100]
+                     << " us, max " << progress_usec.back() << " us";
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_keepalive_jitter, tcp, "tcp")
+
+
 class test_ucp_peer_failure_rndv_abort : public test_ucp_peer_failure {
 public:
     static void get_test_variants(std::vector<ucp_test_variant> &variants)
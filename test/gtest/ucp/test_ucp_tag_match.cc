@@ -14,6 +14,7 @@ extern "C" {
 #include <ucp/core/ucp_types.h>
 #include <ucp/rndv/proto_rndv.h>
 #include <ucp/core/ucp_ep.inl>
+#include <ucp/tag/tag_match.h>
 }
 
 using namespace ucs; /* For vector<char> serialization */
@@ -495,6 +496,51 @@ UCS_TEST_P(test_ucp_tag_match, send_recv_nb_exp) {
     request_free(my_recv_req);
 }
 
+UCS_TEST_P(test_ucp_tag_match, send_recv_exp_mask_classes,
+           "TM_MASK_CLASSES=2") {
+    static const ucp_tag_t tag = 0x1111222233334444ul;
+    /* More distinct masks than mask classes, so some of the requests are
+     * kept in the wildcard queue */
+    static const ucp_tag_t tag_masks[] = {
+        0xffff0000ffff0000ul, UCP_TAG_MASK_FULL, 0x00000000fffffffful, 0,
+        0xffff0000ffff0000ul, 0xffffffff00000000ul, UCP_TAG_MASK_FULL
+    };
+    static const size_t num_reqs = ucs_static_array_size(tag_masks);
+    std::vector<uint64_t> recv_data(num_reqs, 0);
+    std::vector<request*> rreqs;
+    uint64_t recv_nomatch = 0;
+
+    /* Request in a mask class which should not match any of the messages */
+    request *rreq_nomatch = recv_nb(&recv_nomatch, sizeof(recv_nomatch),
+                                    DATATYPE, ~tag, tag_masks[0]);
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(rreq_nomatch));
+
+    for (size_t i = 0; i < num_reqs; ++i) {
+        request *rreq = recv_nb(&recv_data[i], sizeof(recv_data[i]), DATATYPE,
+                                tag, tag_masks[i]);
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(rreq));
+        rreqs.push_back(rreq);
+    }
+
+    /* Messages must be matched in the order the requests were posted */
+    for (uint64_t i = 0; i < num_reqs; ++i) {
+        uint64_t send_data = i + 1;
+        send_b(&send_data, sizeof(send_data), DATATYPE, tag);
+    }
+
+    for (size_t i = 0; i < num_reqs; ++i) {
+        wait_and_validate(rreqs[i]);
+        EXPECT_EQ(i + 1, recv_data[i]) << "tag_mask " << std::hex
+                                        << tag_masks[i];
+    }
+
+    ucp_request_cancel(receiver().worker(), rreq_nomatch);
+    wait(rreq_nomatch);
+    EXPECT_EQ(UCS_ERR_CANCELED, rreq_nomatch->status);
+    EXPECT_EQ(0ul, recv_nomatch);
+    request_free(rreq_nomatch);
+}
+
 UCS_TEST_P(test_ucp_tag_match, send_nb_multiple_recv_unexp) {
     const unsigned      num_requests = 1000;
     ucp_tag_recv_info_t info;
@@ -566,6 +612,91 @@ UCS_TEST_P(test_ucp_tag_match, sync_send_unexp) {
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match)
 
+class test_ucp_tag_match_unexp_array : public test_ucp_tag {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant>& variants) {
+        ucp_params_t params    = get_ctx_params();
+        params.field_mask     |= UCP_PARAM_FIELD_TAG_SENDER_MASK;
+        params.tag_sender_mask = SENDER_MASK;
+        add_variant(variants, params);
+    }
+
+    virtual void init() {
+        modify_config("TM_UNEXP_BINS", "4");
+        test_ucp_tag::init();
+    }
+
+protected:
+    static const ucp_tag_t SENDER_MASK = 0xffff000000000000ul;
+    static const unsigned  NUM_SENDERS = 8;
+    static const unsigned  NUM_VALUES  = 16;
+
+    static ucp_tag_t make_tag(unsigned sender, unsigned value) {
+        return (static_cast<ucp_tag_t>(sender) << 48) | value;
+    }
+
+    /* Receive all messages which match the tag, and check they are received
+     * in the order they were sent */
+    void recv_ordered(ucp_tag_t tag, ucp_tag_t tag_mask, unsigned count) {
+        uint64_t prev_data = 0;
+
+        for (unsigned i = 0; i < count; ++i) {
+            ucp_tag_recv_info_t info;
+            uint64_t recv_data;
+
+            ucs_status_t status = recv_b(&recv_data, sizeof(recv_data),
+                                         DATATYPE, tag, tag_mask, &info);
+            ASSERT_UCS_OK(status);
+            EXPECT_EQ(0ul, (info.sender_tag ^ tag) & tag_mask);
+            EXPECT_EQ(m_sent_data[info.sender_tag], recv_data);
+            EXPECT_LT(prev_data, recv_data);
+            prev_data = recv_data;
+            m_sent_data.erase(info.sender_tag);
+        }
+    }
+
+    std::map<ucp_tag_t, uint64_t> m_sent_data;
+};
+
+UCS_TEST_P(test_ucp_tag_match_unexp_array, recv_order) {
+    ucp_tag_recv_info_t info;
+    uint64_t send_data = 0;
+
+    for (unsigned value = 0; value < NUM_VALUES; ++value) {
+        for (unsigned sender = 0; sender < NUM_SENDERS; ++sender) {
+            ucp_tag_t tag     = make_tag(sender, value);
+            m_sent_data[tag] = ++send_data;
+            send_b(&send_data, sizeof(send_data), DATATYPE, tag);
+        }
+    }
+
+    wait_for_unexpected_msg(receiver().worker(), 10.0);
+    short_progress_loop();
+
+    /* Probe without removing the message */
+    ucp_tag_message_h message = ucp_tag_probe_nb(receiver().worker(),
+                                                 make_tag(3, 2),
+                                                 UCP_TAG_MASK_FULL, 0, &info);
+    ASSERT_TRUE(message != NULL);
+    EXPECT_EQ(make_tag(3, 2), info.sender_tag);
+
+    /* Specific sender and value */
+    recv_ordered(make_tag(3, 2), UCP_TAG_MASK_FULL, 1);
+
+    /* Sender wildcard */
+    recv_ordered(make_tag(0, 1), ~SENDER_MASK, NUM_SENDERS);
+
+    /* Specific sender, any value */
+    recv_ordered(make_tag(5, 0), SENDER_MASK, NUM_VALUES - 1);
+
+    /* Everything else */
+    recv_ordered(0, 0, m_sent_data.size());
+
+    EXPECT_TRUE(ucp_tag_unexp_is_empty(&receiver().worker()->tm));
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match_unexp_array)
+
 class test_ucp_tag_match_rndv : public test_ucp_tag_match {
 public:
     enum {
@@ -1055,3 +1186,90 @@ UCS_TEST_P(test_ucp_tag_match_rndv_align, recv_align)
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match_rndv_align)
+
+class test_ucp_tag_match_csum : public test_ucp_tag {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant>& variants) {
+        add_variant(variants, get_ctx_params());
+    }
+
+    virtual void init() {
+        modify_config("PAYLOAD_CHECKSUM", "y");
+        test_ucp_tag::init();
+    }
+};
+
+UCS_TEST_P(test_ucp_tag_match_csum, send_recv)
+{
+    const size_t sizes[] = { 0, 8, 1000, 5000, 300 * UCS_KBYTE };
+
+    for (unsigned i = 0; i < ucs_static_array_size(sizes); ++i) {
+        for (int expected = 0; expected <= 1; ++expected) {
+            const size_t size = sizes[i];
+            std::vector<char> sendbuf(size), recvbuf(size);
+            ucp_tag_recv_info_t info;
+            ucs_status_t status;
+            request *rreq;
+
+            ucs::fill_random(sendbuf);
+            if (expected) {
+                rreq = recv_nb(recvbuf.data(), size, DATATYPE, 0x1337, 0xffff);
+                send_b(sendbuf.data(), size, DATATYPE, 0x1337);
+                wait(rreq);
+                status = rreq->status;
+                request_free(rreq);
+            } else {
+                request *sreq = send_nb(sendbuf.data(), size, DATATYPE,
+                                        0x1337);
+                short_progress_loop();
+                status = recv_b(recvbuf.data(), size, DATATYPE, 0x1337,
+                                0xffff, &info);
+                if (sreq != NULL) {
+                    wait(sreq);
+                    request_free(sreq);
+                }
+            }
+
+            EXPECT_EQ(UCS_OK, status) << "size=" << size
+                                      << " expected=" << expected;
+            EXPECT_EQ(sendbuf, recvbuf);
+        }
+    }
+}
+
+UCS_TEST_P(test_ucp_tag_match_csum, rndv_data_mismatch, "RNDV_THRESH=0",
+           "RNDV_SCHEME=get_zcopy")
+{
+    const size_t size = 64 * UCS_KBYTE;
+    std::vector<char> sendbuf(size), recvbuf(size);
+
+    /* Complete wireup on both sides before progressing only the receiver */
+    request *rreq = recv_nb(recvbuf.data(), size, DATATYPE, 0x1337, 0xffff);
+    send_b(sendbuf.data(), size, DATATYPE, 0x1337);
+    wait(rreq);
+    request_free(rreq);
+
+    ucs::fill_random(sendbuf);
+    rreq = recv_nb(recvbuf.data(), size, DATATYPE, 0x1337, 0xffff);
+    request *sreq = send_nb(sendbuf.data(), size, DATATYPE, 0x1337);
+    ASSERT_UCS_PTR_OK(sreq);
+    ASSERT_NE(nullptr, sreq);
+
+    /* Complete the receive without progressing the sender, so the ATS with
+     * the checksum is handled only after the send buffer was modified */
+    while (!rreq->completed) {
+        receiver().progress();
+    }
+    EXPECT_EQ(UCS_OK, rreq->status);
+    EXPECT_EQ(sendbuf, recvbuf);
+    request_free(rreq);
+
+    sendbuf[size / 2] ^= 0xff;
+
+    scoped_log_handler wrap_diag(wrap_errors_logger);
+    wait(sreq);
+    EXPECT_EQ(UCS_ERR_IO_ERROR, sreq->status);
+    request_free(sreq);
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_tag_match_csum, shm, "shm")
@@ -9,6 +9,10 @@
 
 #include <common/test_helpers.h>
 
+extern "C" {
+#include <ucp/core/ucp_worker.h>
+}
+
 #if _OPENMP
 #include "omp.h"
 #endif
@@ -74,4 +78,50 @@ UCS_TEST_P(test_ucp_tag_mt, send_recv) {
 #endif
 }
 
+UCS_TEST_P(test_ucp_tag_mt, req_cache_scaling) {
+    const unsigned num_threads = mt_num_threads();
+    const unsigned num_iters   = 2000 / ucs::test_time_multiplier();
+
+    if (get_variant_thread_type() == MULTI_THREAD_WORKER) {
+        EXPECT_TRUE(receiver().worker()->flags & UCP_WORKER_FLAG_REQ_TCACHE);
+    }
+
+#if _OPENMP && ENABLE_MT
+    std::vector<unsigned> thread_counts;
+    for (unsigned nthreads = 1; nthreads < num_threads; nthreads *= 2) {
+        thread_counts.push_back(nthreads);
+    }
+    thread_counts.push_back(num_threads);
+
+    for (auto nthreads : thread_counts) {
+        ucs_time_t start_time = ucs_get_time();
+
+#pragma omp parallel for num_threads(nthreads)
+        for (int i = 0; i < (int)nthreads; i++) {
+            ucp_tag_t tag = 0x4000 + i;
+            uint64_t send_data, recv_data;
+
+            /* Every iteration allocates and releases an internal receive
+             * request, from the thread cache on a multi-threaded worker */
+            for (unsigned iter = 0; iter < num_iters; ++iter) {
+                send_data = iter;
+                recv_data = 0;
+
+                request *rreq = recv_nb(&recv_data, sizeof(recv_data),
+                                        DATATYPE, tag, 0xffff, NULL, i);
+                send_b(&send_data, sizeof(send_data), DATATYPE, tag, NULL, i);
+                wait(rreq, NULL, i);
+                request_free(rreq);
+                EXPECT_EQ(send_data, recv_data);
+            }
+        }
+
+        double elapsed = ucs_time_to_sec(ucs_get_time() - start_time);
+        UCS_TEST_MESSAGE << nthreads << " threads: "
+                         << (nthreads * num_iters / elapsed / 1e3)
+                         << "k send/recv per second";
+    }
+#endif
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_mt)
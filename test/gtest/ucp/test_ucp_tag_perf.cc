@@ -17,15 +17,20 @@ public:
     }
 
 protected:
-    static const size_t    COUNT    = 8192;
-    static const ucp_tag_t TAG_MASK = 0xffffffffffffffffUL;
-
-    double check_perf(size_t count, bool is_exp);
-    void check_scalability(double max_growth, bool is_exp);
+    static const size_t    COUNT         = 8192;
+    static const ucp_tag_t TAG_MASK      = 0xffffffffffffffffUL;
+    /* Ignore the upper half of the tag, like a receive from any source */
+    static const ucp_tag_t WILDCARD_MASK = 0x00000000ffffffffUL;
+
+    double check_perf(size_t count, bool is_exp, ucp_tag_t tag_mask);
+    void check_scalability(double max_growth, bool is_exp,
+                           ucp_tag_t tag_mask = TAG_MASK);
+    void report_match_cost(bool is_exp, ucp_tag_t tag_mask);
     void do_sends(size_t count);
 };
 
-double test_ucp_tag_perf::check_perf(size_t count, bool is_exp)
+double
+test_ucp_tag_perf::check_perf(size_t count, bool is_exp, ucp_tag_t tag_mask)
 {
     ucs_time_t start_time;
 
@@ -33,7 +38,7 @@ double test_ucp_tag_perf::check_perf(size_t count, bool is_exp)
         std::vector<request*> rreqs;
 
         for (size_t i = 0; i < count; ++i) {
-            request *rreq = recv_nb(NULL, 0, DATATYPE, i, TAG_MASK);
+            request *rreq = recv_nb(NULL, 0, DATATYPE, i, tag_mask);
             assert(!UCS_PTR_IS_ERR(rreq));
             EXPECT_FALSE(rreq->completed);
             rreqs.push_back(rreq);
@@ -51,11 +56,11 @@ double test_ucp_tag_perf::check_perf(size_t count, bool is_exp)
 
         send_b(NULL, 0, DATATYPE, 0xdeadbeef);
         do_sends(count);
-        recv_b(NULL, 0, DATATYPE, 0xdeadbeef, TAG_MASK, &info);
+        recv_b(NULL, 0, DATATYPE, 0xdeadbeef, tag_mask, &info);
 
         start_time = ucs_get_time();
         for (size_t i = 0; i < count; ++i) {
-            recv_b(NULL, 0, DATATYPE, i, TAG_MASK, &info);
+            recv_b(NULL, 0, DATATYPE, i, tag_mask, &info);
         }
     }
 
@@ -71,7 +76,8 @@ void test_ucp_tag_perf::do_sends(size_t count)
     }
 }
 
-void test_ucp_tag_perf::check_scalability(double max_growth, bool is_exp)
+void test_ucp_tag_perf::check_scalability(double max_growth, bool is_exp,
+                                          ucp_tag_t tag_mask)
 {
     double prev_time = 0.0, total_growth = 0.0, avg_growth;
     size_t n = 0;
@@ -86,7 +92,7 @@ void test_ucp_tag_perf::check_scalability(double max_growth, bool is_exp)
             size_t iters = 10 * ucs_max(1ul, COUNT / count);
             double total_time = 0;
             for (size_t i = 0; i < iters; ++i) {
-                total_time += check_perf(count, is_exp);
+                total_time += check_perf(count, is_exp, tag_mask);
             }
 
             double time = total_time / iters;
@@ -114,6 +120,21 @@ void test_ucp_tag_perf::check_scalability(double max_growth, bool is_exp)
     ADD_FAILURE() << "Tag matching is not scalable";
 }
 
+void test_ucp_tag_perf::report_match_cost(bool is_exp, ucp_tag_t tag_mask)
+{
+    for (size_t count = 1; count <= COUNT; count *= 8) {
+        size_t iters      = ucs_max(1ul, COUNT / count);
+        double total_time = 0;
+        for (size_t i = 0; i < iters; ++i) {
+            total_time += check_perf(count, is_exp, tag_mask);
+        }
+
+        UCS_TEST_MESSAGE << "queue depth " << count << ": "
+                         << (total_time / iters) * UCS_NSEC_PER_SEC
+                         << " nsec per match";
+    }
+}
+
 UCS_TEST_P(test_ucp_tag_perf, multi_exp) {
     check_scalability(1.5, true);
 }
@@ -122,4 +143,26 @@ UCS_TEST_P(test_ucp_tag_perf, multi_unexp) {
     check_scalability(1.5, false);
 }
 
+UCS_TEST_P(test_ucp_tag_perf, multi_exp_wildcard, "TM_MASK_CLASSES=4") {
+    check_scalability(1.5, true, WILDCARD_MASK);
+}
+
+UCS_TEST_P(test_ucp_tag_perf, exp_wildcard_match_cost) {
+    report_match_cost(true, WILDCARD_MASK);
+}
+
+UCS_TEST_P(test_ucp_tag_perf, exp_wildcard_match_cost_mask_classes,
+           "TM_MASK_CLASSES=4") {
+    report_match_cost(true, WILDCARD_MASK);
+}
+
+UCS_TEST_P(test_ucp_tag_perf, unexp_wildcard_match_cost) {
+    report_match_cost(false, WILDCARD_MASK);
+}
+
+UCS_TEST_P(test_ucp_tag_perf, unexp_wildcard_match_cost_array,
+           "TM_UNEXP_BINS=1") {
+    report_match_cost(false, WILDCARD_MASK);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_perf)
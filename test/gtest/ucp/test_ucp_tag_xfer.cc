@@ -1085,6 +1085,22 @@ public:
         return UCS_STATS_GET_COUNTER(worker_stats(receiver()), counter);
     }
 
+    void validate_latency_histograms() {
+#ifdef ENABLE_STATS
+        ucs_stats_node_t *tx_stats = worker_stats(sender());
+        ucs_stats_node_t *rx_stats = worker_stats(receiver());
+
+        if ((tx_stats == NULL) || (rx_stats == NULL)) {
+            return;
+        }
+
+        EXPECT_GT(tx_stats->histograms[UCP_WORKER_STAT_HIST_TAG_SEND].count,
+                  0ul);
+        EXPECT_GT(rx_stats->histograms[UCP_WORKER_STAT_HIST_TAG_RECV].count,
+                  0ul);
+#endif
+    }
+
     void validate_counters(unsigned tx_counter, unsigned rx_counter) {
         uint64_t cnt;
         cnt = UCS_STATS_GET_COUNTER(ep_stats(sender()), tx_counter);
@@ -1197,6 +1213,7 @@ UCS_TEST_P(test_ucp_tag_stats, rndv_expected, "RNDV_THRESH=1000") {
     test_run_xfer(true, true, true, false, false);
     validate_counters(UCP_EP_STAT_TAG_TX_RNDV, UCP_WORKER_STAT_RNDV_RX_EXP);
     validate_rndv_counters();
+    validate_latency_histograms();
 }
 
 UCS_TEST_P(test_ucp_tag_stats, rndv_unexpected, "RNDV_THRESH=1000") {
@@ -122,6 +122,147 @@ UCS_TEST_F(test_algorithm, crc32) {
     EXPECT_EQ(0xa684c7c6ul, ucs_crc32(0, test_str.c_str(), test_str.size()));
 }
 
+class test_crc : public test_algorithm {
+protected:
+    /* Bit-at-a-time reference of a reflected CRC32 */
+    static uint32_t crc32_ref(uint32_t poly, uint32_t prev_crc,
+                              const void *buffer, size_t size)
+    {
+        const uint8_t *p = static_cast<const uint8_t*>(buffer);
+        uint32_t crc     = ~prev_crc;
+
+        for (size_t i = 0; i < size; ++i) {
+            crc ^= p[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (-(int)(crc & 1) & poly);
+            }
+        }
+
+        return ~crc;
+    }
+
+    static std::vector<uint8_t> random_buffer(size_t size)
+    {
+        std::vector<uint8_t> buffer(size);
+
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i] = ucs::rand();
+        }
+
+        return buffer;
+    }
+
+    static const uint32_t CRC32_POLY  = 0xedb88320ul;
+    static const uint32_t CRC32C_POLY = 0x82f63b78ul;
+};
+
+UCS_TEST_F(test_crc, crc32_long) {
+    for (int i = 0; i < 100 / ucs::test_time_multiplier(); ++i) {
+        size_t size                 = ucs::rand() % 4096;
+        size_t offset               = ucs::rand() % 8;
+        std::vector<uint8_t> buffer = random_buffer(size + offset);
+
+        ASSERT_EQ(crc32_ref(CRC32_POLY, i, &buffer[offset], size),
+                  ucs_crc32(i, &buffer[offset], size))
+                << "size=" << size << " offset=" << offset;
+    }
+}
+
+UCS_TEST_F(test_crc, crc32c) {
+    std::vector<uint8_t> zeros(32, 0), ones(32, 0xff);
+    std::string test_str = "123456789";
+
+    for (int impl = 0; impl < UCS_CRC32C_IMPL_LAST; ++impl) {
+        ucs_crc32c_impl_t crc_impl = static_cast<ucs_crc32c_impl_t>(impl);
+        if (!ucs_crc32c_impl_is_supported(crc_impl)) {
+            UCS_TEST_MESSAGE << ucs_crc32c_impl_names[impl]
+                             << " is not supported";
+            continue;
+        }
+
+        UCS_TEST_MESSAGE << "checking " << ucs_crc32c_impl_names[impl];
+        EXPECT_EQ(0u, ucs_crc32c_impl(crc_impl, 0, NULL, 0));
+        EXPECT_EQ(0xe3069283ul, ucs_crc32c_impl(crc_impl, 0, test_str.c_str(),
+                                                test_str.size()));
+        EXPECT_EQ(0x8a9136aaul, ucs_crc32c_impl(crc_impl, 0, &zeros[0],
+                                                zeros.size()));
+        EXPECT_EQ(0x62a8ab43ul, ucs_crc32c_impl(crc_impl, 0, &ones[0],
+                                                ones.size()));
+    }
+
+    EXPECT_EQ(0xe3069283ul, ucs_crc32c(0, test_str.c_str(), test_str.size()));
+}
+
+UCS_TEST_F(test_crc, crc32c_impls) {
+    for (int i = 0; i < 200 / ucs::test_time_multiplier(); ++i) {
+        /* cover the multi-stream blocks of the fastest kernels */
+        size_t size                 = ucs::rand() % (16 * UCS_KBYTE);
+        size_t offset               = ucs::rand() % 8;
+        size_t split                = ucs::rand() % (size + 1);
+        std::vector<uint8_t> buffer = random_buffer(size + offset);
+        const uint8_t *data         = &buffer[offset];
+        uint32_t expected           = crc32_ref(CRC32C_POLY, i, data, size);
+
+        for (int impl = 0; impl < UCS_CRC32C_IMPL_LAST; ++impl) {
+            ucs_crc32c_impl_t crc_impl = static_cast<ucs_crc32c_impl_t>(impl);
+            if (!ucs_crc32c_impl_is_supported(crc_impl)) {
+                continue;
+            }
+
+            ASSERT_EQ(expected, ucs_crc32c_impl(crc_impl, i, data, size))
+                    << ucs_crc32c_impl_names[impl] << ": size=" << size
+                    << " offset=" << offset;
+
+            /* CRC of the buffer can be calculated by parts */
+            ASSERT_EQ(expected,
+                      ucs_crc32c_impl(crc_impl,
+                                      ucs_crc32c_impl(crc_impl, i, data, split),
+                                      data + split, size - split))
+                    << ucs_crc32c_impl_names[impl] << ": size=" << size
+                    << " split=" << split;
+        }
+
+        ASSERT_EQ(expected, ucs_crc32c(i, data, size));
+    }
+}
+
+UCS_TEST_SKIP_COND_F(test_crc, perf, RUNNING_ON_VALGRIND) {
+    const size_t size           = 256 * UCS_KBYTE;
+    const double total_size     = 256.0 * UCS_MBYTE /
+                                  ucs::test_time_multiplier();
+    const int iters             = total_size / size;
+    std::vector<uint8_t> buffer = random_buffer(size);
+    volatile uint32_t crc       = 0;
+    ucs_time_t start_time;
+    double gbps;
+
+    start_time = ucs_get_time();
+    for (int i = 0; i < iters; ++i) {
+        crc = ucs_crc32(crc, &buffer[0], size);
+    }
+    gbps = iters * size / ucs_time_to_sec(ucs_get_time() - start_time) /
+           UCS_GBYTE;
+    UCS_TEST_MESSAGE << "crc32 slice8: " << gbps << " GB/s";
+
+    for (int impl = 0; impl < UCS_CRC32C_IMPL_LAST; ++impl) {
+        ucs_crc32c_impl_t crc_impl = static_cast<ucs_crc32c_impl_t>(impl);
+        if (!ucs_crc32c_impl_is_supported(crc_impl)) {
+            continue;
+        }
+
+        start_time = ucs_get_time();
+        for (int i = 0; i < iters; ++i) {
+            crc = ucs_crc32c_impl(crc_impl, crc, &buffer[0], size);
+        }
+        gbps = iters * size / ucs_time_to_sec(ucs_get_time() - start_time) /
+               UCS_GBYTE;
+        UCS_TEST_MESSAGE << "crc32c " << ucs_crc32c_impl_names[impl] << ": "
+                         << gbps << " GB/s";
+    }
+
+    UCS_TEST_MESSAGE << "not validating performance";
+}
+
 UCS_TEST_F(test_algorithm, string_distance) {
     // Empty strings
     EXPECT_EQ(0u, ucs_string_distance("", ""));
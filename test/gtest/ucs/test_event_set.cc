@@ -19,6 +19,7 @@ static const int   UCS_EVENT_SET_EXTRA_NUM    = 0xFF;
 
 enum {
     UCS_EVENT_SET_EXTERNAL_FD = UCS_BIT(0),
+    UCS_EVENT_SET_IO_URING    = UCS_BIT(1)
 };
 
 class test_event_set : public ucs::test_base,
@@ -96,11 +97,20 @@ protected:
 
         if (GetParam() & UCS_EVENT_SET_EXTERNAL_FD) {
             status = ucs_event_set_create_from_fd(&m_event_set, m_ext_fd);
+        } else if (GetParam() & UCS_EVENT_SET_IO_URING) {
+            status = ucs_event_set_create_backend(
+                    &m_event_set, UCS_EVENT_SET_BACKEND_IO_URING);
         } else {
             status = ucs_event_set_create(&m_event_set);
         }
         ASSERT_UCS_OK(status);
         EXPECT_TRUE(m_event_set != NULL);
+
+        if ((GetParam() & UCS_EVENT_SET_IO_URING) &&
+            (ucs_event_set_backend(m_event_set) !=
+             UCS_EVENT_SET_BACKEND_IO_URING)) {
+            UCS_TEST_MESSAGE << "io_uring is not supported, using epoll";
+        }
     }
 
     void event_set_cleanup() {
@@ -279,7 +289,64 @@ UCS_TEST_P(test_event_set, ucs_event_set_trig_modes) {
     event_set_cleanup();
 }
 
+UCS_TEST_P(test_event_set, ucs_event_set_mod_del_many) {
+    static const int num_pipes = 64;
+    std::vector<int> fds(num_pipes * 2);
+    unsigned count;
+
+    event_set_init(event_set_tmo_func);
+    thread_barrier();
+
+    for (int i = 0; i < num_pipes; ++i) {
+        ASSERT_EQ(0, pipe(&fds[i * 2]));
+        event_set_ctl(EVENT_SET_OP_ADD, fds[i * 2], UCS_EVENT_SET_EVREAD);
+    }
+
+    /* readable only after data is written */
+    event_set_wait(0u, 0, event_set_func3, NULL);
+    for (int i = 0; i < num_pipes; ++i) {
+        ASSERT_EQ(1, write(fds[i * 2 + 1], "x", 1));
+    }
+
+    /* level-triggered events are reported until the data is read */
+    for (int iter = 0; iter < 3; ++iter) {
+        count = 0;
+        while (count < num_pipes) {
+            unsigned nread = ucs_sys_event_set_max_wait_events;
+            ASSERT_UCS_OK(ucs_event_set_wait(m_event_set, &nread, 1000,
+                                             event_set_func4, NULL));
+            ASSERT_GT(nread, 0u);
+            count += nread;
+        }
+        EXPECT_EQ(unsigned(num_pipes), count);
+    }
+
+    /* stop waiting for read on half of the pipes and remove the rest */
+    for (int i = 0; i < num_pipes; ++i) {
+        if (i % 2) {
+            event_set_ctl(EVENT_SET_OP_MOD, fds[i * 2], 0);
+        } else {
+            event_set_ctl(EVENT_SET_OP_DEL, fds[i * 2], 0);
+        }
+    }
+
+    event_set_wait(0u, 0, event_set_func3, NULL);
+
+    for (int i = 0; i < num_pipes; ++i) {
+        if (i % 2) {
+            event_set_ctl(EVENT_SET_OP_DEL, fds[i * 2], 0);
+        }
+        close(fds[i * 2]);
+        close(fds[i * 2 + 1]);
+    }
+
+    event_set_cleanup();
+}
+
 INSTANTIATE_TEST_SUITE_P(ext_fd, test_event_set,
                         ::testing::Values(static_cast<int>(
                                               UCS_EVENT_SET_EXTERNAL_FD)));
 INSTANTIATE_TEST_SUITE_P(int_fd, test_event_set, ::testing::Values(0));
+INSTANTIATE_TEST_SUITE_P(io_uring, test_event_set,
+                        ::testing::Values(static_cast<int>(
+                                              UCS_EVENT_SET_IO_URING)));
@@ -7,11 +7,18 @@
 #include <common/test.h>
 extern "C" {
 #include <ucs/datastruct/mpool.h>
+#include <ucs/datastruct/mpool_tcache.inl>
 }
 
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
 #include <limits.h>
+#include <algorithm>
+#include <random>
 #include <vector>
 #include <queue>
+#include <thread>
 
 class test_mpool : public ucs::test {
 protected:
@@ -367,6 +374,98 @@ UCS_TEST_F(test_mpool, leak_check) {
     EXPECT_EQ(5u, leak_count);
 }
 
+UCS_TEST_F(test_mpool, tcache_quota) {
+    const unsigned num_elems = 10;
+    ucs_mpool_tcache_t tcache;
+    ucs_mpool_t mp;
+
+    ASSERT_UCS_OK(setup_mpool(&mp, data_size, 4, num_elems));
+    ASSERT_UCS_OK(ucs_mpool_tcache_init(&tcache, &mp, 4));
+
+    std::vector<void*> objs;
+    for (unsigned i = 0; i < num_elems; ++i) {
+        void *obj = ucs_mpool_tcache_get_inline(&tcache);
+        ASSERT_TRUE(obj != NULL);
+        objs.push_back(obj);
+    }
+
+    EXPECT_EQ(nullptr, ucs_mpool_tcache_get_inline(&tcache));
+
+    for (auto obj : objs) {
+        ucs_mpool_tcache_put_inline(&tcache, obj);
+    }
+
+    /* Objects cached by the thread are returned to the central pool */
+    ucs_mpool_tcache_flush(&tcache);
+    for (unsigned i = 0; i < num_elems; ++i) {
+        objs[i] = ucs_mpool_get(&mp);
+        EXPECT_TRUE(objs[i] != NULL);
+    }
+    for (auto obj : objs) {
+        ucs_mpool_put(obj);
+    }
+
+    ucs_mpool_tcache_cleanup(&tcache);
+    ucs_mpool_cleanup(&mp, 1);
+}
+
+UCS_TEST_F(test_mpool, tcache_threads) {
+    const unsigned num_threads = 8;
+    const unsigned num_iters   = 10000 / ucs::test_time_multiplier();
+    const unsigned num_objs    = 100;
+    ucs_mpool_tcache_t tcache;
+    ucs_mpool_t mp;
+
+    ASSERT_UCS_OK(setup_mpool(&mp, data_size, 64, UINT_MAX));
+    ASSERT_UCS_OK(ucs_mpool_tcache_init(&tcache, &mp, 16));
+
+    /* Objects allocated by one thread are released by another one, and every
+     * thread returns its magazine to the central pool when it exits */
+    std::vector<std::vector<void*>> objs(num_threads);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (unsigned iter = 0; iter < num_iters; ++iter) {
+                unsigned count = ucs::rand() % num_objs;
+                std::vector<void*> local;
+
+                for (unsigned i = 0; i < count; ++i) {
+                    void *obj = ucs_mpool_tcache_get_inline(&tcache);
+                    if (obj == NULL) {
+                        break;
+                    }
+
+                    memset(obj, t, data_size);
+                    local.push_back(obj);
+                }
+
+                for (auto obj : local) {
+                    EXPECT_EQ(t, *(uint8_t*)obj);
+                    ucs_mpool_tcache_put_inline(&tcache, obj);
+                }
+            }
+
+            for (unsigned i = 0; i < num_objs; ++i) {
+                objs[t].push_back(ucs_mpool_tcache_get_inline(&tcache));
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (auto &thread_objs : objs) {
+        for (auto obj : thread_objs) {
+            ASSERT_TRUE(obj != NULL);
+            ucs_mpool_tcache_put_inline(&tcache, obj);
+        }
+    }
+
+    ucs_mpool_tcache_cleanup(&tcache);
+    ucs_mpool_cleanup(&mp, 1);
+}
+
 class test_mpool_grow : public test_mpool {
 public:
     void run_grow_test(double grow_factor,
@@ -495,3 +594,149 @@ UCS_TEST_SKIP_COND_F(test_mpool_fifo, alloc_release, !ENABLE_DEBUG_DATA)
 
     ucs_mpool_cleanup(&mp, 0); // skip individual put as obj could be corrupted
 }
+
+class test_mpool_numa_arena : public test_mpool {
+public:
+    void init()
+    {
+        modify_config("MPOOL_NUMA_ARENA", "tests_arena*");
+        test_mpool::init();
+    }
+
+protected:
+    struct bench_result {
+        double   alloc_nsec;  /* Average get() time, including pool growth */
+        double   access_nsec; /* Average random object access time */
+        uint64_t tlb_misses;  /* dTLB read misses during the access phase */
+    };
+
+    ucs_status_t init_pool(ucs_mpool_t *mp, const char *name, size_t elem_size,
+                           unsigned elems_per_chunk)
+    {
+        static ucs_mpool_ops_t mpool_ops = {ucs_mpool_chunk_malloc,
+                                            ucs_mpool_chunk_free, NULL, NULL,
+                                            NULL};
+        ucs_mpool_params_t mp_params;
+
+        ucs_mpool_params_reset(&mp_params);
+        mp_params.elem_size       = elem_size;
+        mp_params.elems_per_chunk = elems_per_chunk;
+        mp_params.grow_factor     = 2.0;
+        mp_params.ops             = &mpool_ops;
+        mp_params.name            = name;
+        return ucs_mpool_init(&mp_params, mp);
+    }
+
+    static int open_tlb_counter()
+    {
+        struct perf_event_attr attr = {};
+
+        attr.type           = PERF_TYPE_HW_CACHE;
+        attr.size           = sizeof(attr);
+        attr.config         = PERF_COUNT_HW_CACHE_DTLB |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    bench_result bench(const char *name, unsigned num_elems, unsigned num_iters)
+    {
+        const size_t elem_size = 256;
+        std::vector<void*> objs(num_elems);
+        bench_result result    = {};
+        ucs_mpool_t mp;
+        uint64_t sum           = 0;
+
+        ucs_status_t status = init_pool(&mp, name, elem_size, 256);
+        ucs_assert_always(status == UCS_OK);
+
+        ucs_time_t start = ucs_get_time();
+        for (auto &obj : objs) {
+            obj = ucs_mpool_get(&mp);
+            ucs_assert_always(obj != NULL);
+            memset(obj, 0, elem_size);
+        }
+        result.alloc_nsec = ucs_time_to_nsec(ucs_get_time() - start) /
+                            num_elems;
+
+        std::vector<void*> order(objs);
+        std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+        int fd = open_tlb_counter();
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+
+        start = ucs_get_time();
+        for (unsigned iter = 0; iter < num_iters; ++iter) {
+            for (auto obj : order) {
+                sum += ++(*(volatile uint64_t*)obj);
+            }
+        }
+        result.access_nsec = ucs_time_to_nsec(ucs_get_time() - start) /
+                             (num_elems * (double)num_iters);
+
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &result.tlb_misses, sizeof(result.tlb_misses)) !=
+                sizeof(result.tlb_misses)) {
+                result.tlb_misses = 0;
+            }
+            close(fd);
+        }
+
+        EXPECT_EQ((uint64_t)num_elems * num_iters * (num_iters + 1) / 2, sum);
+
+        for (auto obj : objs) {
+            ucs_mpool_put(obj);
+        }
+        ucs_mpool_cleanup(&mp, 1);
+        return result;
+    }
+};
+
+UCS_TEST_F(test_mpool_numa_arena, alloc_release) {
+    const unsigned num_elems = 10000;
+    std::vector<void*> objs;
+    ucs_mpool_t mp, heap_mp;
+
+    ASSERT_UCS_OK(init_pool(&mp, "tests_arena", data_size, 16));
+    ASSERT_UCS_OK(init_pool(&heap_mp, "tests", data_size, 16));
+    EXPECT_TRUE(mp.data->numa_arena);
+    EXPECT_FALSE(heap_mp.data->numa_arena);
+
+    for (unsigned i = 0; i < num_elems; ++i) {
+        void *obj = ucs_mpool_get(&mp);
+        ASSERT_NE(nullptr, obj);
+        EXPECT_EQ(0ul, (uintptr_t)obj % UCS_SYS_CACHE_LINE_SIZE);
+        memset(obj, i, data_size);
+        objs.push_back(obj);
+    }
+
+    for (unsigned i = 0; i < num_elems; ++i) {
+        EXPECT_EQ((uint8_t)i, *(uint8_t*)objs[i]);
+        ucs_mpool_put(objs[i]);
+    }
+
+    ucs_mpool_cleanup(&heap_mp, 1);
+    ucs_mpool_cleanup(&mp, 1);
+}
+
+UCS_TEST_SKIP_COND_F(test_mpool_numa_arena, bench, RUNNING_ON_VALGRIND) {
+    const unsigned num_elems = 262144 / ucs::test_time_multiplier();
+    const unsigned num_iters = 8;
+
+    for (const char *name : {"tests_heap", "tests_arena"}) {
+        bench_result result = bench(name, num_elems, num_iters);
+
+        UCS_TEST_MESSAGE << name << ": alloc " << result.alloc_nsec
+                         << " nsec/obj, access " << result.access_nsec
+                         << " nsec/obj, dTLB misses "
+                         << ((result.tlb_misses != 0) ?
+                             ucs::to_string(result.tlb_misses) : "n/a");
+    }
+}
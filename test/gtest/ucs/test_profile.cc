@@ -15,6 +15,7 @@ extern "C" {
 
 #include <pthread.h>
 #include <fstream>
+#include <map>
 
 class scoped_profile {
 public:
@@ -110,6 +111,13 @@ protected:
     void test_env(const void **ptr, const ucs_profile_block_header_t &env_vars);
 
     void do_test(unsigned int_mode, const std::string &str_mode);
+
+    typedef std::map<uint32_t, std::vector<ucs_profile_record_t> >
+            stream_records_t;
+
+    void read_stream(const std::string &data,
+                     std::vector<ucs_profile_location_t> &locations,
+                     stream_records_t &records, uint64_t *dropped);
 };
 
 static int sum(int a, int b)
@@ -407,6 +415,43 @@ void test_profile::do_test(unsigned int_mode, const std::string& str_mode)
     EXPECT_EQ(&data[data.size()], ptr) << data.size();
 }
 
+void test_profile::read_stream(const std::string &data,
+                               std::vector<ucs_profile_location_t> &locations,
+                               stream_records_t &records, uint64_t *dropped)
+{
+    /* coverity[tainted_data_downcast] */
+    const ucs_profile_header_t *hdr =
+                    reinterpret_cast<const ucs_profile_header_t*>(&data[0]);
+    const char *ptr = &data[hdr->threads.offset];
+    const char *end = ptr + hdr->threads.size;
+
+    ASSERT_LE(hdr->threads.offset + hdr->threads.size, data.size());
+
+    *dropped = 0;
+    while (ptr < end) {
+        const ucs_profile_stream_chunk_t *chunk =
+                reinterpret_cast<const ucs_profile_stream_chunk_t*>(ptr);
+        ptr += sizeof(*chunk);
+        if (chunk->type == UCS_PROFILE_STREAM_CHUNK_LOCATIONS) {
+            const ucs_profile_location_t *locs =
+                    reinterpret_cast<const ucs_profile_location_t*>(ptr);
+            locations.insert(locations.end(), locs, locs + chunk->count);
+            ptr += chunk->count * sizeof(*locs);
+        } else {
+            ASSERT_EQ(UCS_PROFILE_STREAM_CHUNK_RECORDS, (int)chunk->type);
+            const ucs_profile_record_t *recs =
+                    reinterpret_cast<const ucs_profile_record_t*>(ptr);
+            std::vector<ucs_profile_record_t> &thread_recs =
+                    records[chunk->tid];
+            thread_recs.insert(thread_recs.end(), recs, recs + chunk->count);
+            ptr      += chunk->count * sizeof(*recs);
+            *dropped += chunk->dropped;
+        }
+    }
+
+    EXPECT_EQ(end, ptr);
+}
+
 UCS_TEST_P(test_profile, accum) {
     do_test(UCS_BIT(UCS_PROFILE_MODE_ACCUM), "accum");
 }
@@ -420,6 +465,95 @@ UCS_TEST_P(test_profile, log_accum) {
             "log,accum");
 }
 
+UCS_TEST_P(test_profile, stream) {
+    const int ITER = 5;
+    std::vector<ucs_profile_location_t> locations;
+    stream_records_t records;
+    uint64_t dropped;
+
+    scoped_profile p(*this, PROFILE_FILENAME, "stream");
+    run_profiled_code(ITER);
+
+    std::string data = p.read();
+    const void *ptr  = &data[0];
+
+    /* coverity[tainted_data_downcast] */
+    const ucs_profile_header_t *hdr =
+                    reinterpret_cast<const ucs_profile_header_t*>(ptr);
+    read_stream(data, locations, records, &dropped);
+    test_header(hdr, UCS_BIT(UCS_PROFILE_MODE_STREAM), &ptr,
+                locations.size());
+    test_env(&ptr, hdr->env_vars);
+    EXPECT_EQ(&data[hdr->threads.offset], ptr);
+    EXPECT_EQ(data.size(), hdr->threads.offset + hdr->threads.size);
+    EXPECT_EQ(0u, dropped);
+
+    test_locations(&locations[0], locations.size(), &ptr);
+
+    EXPECT_EQ(size_t(num_threads()), records.size());
+    for (stream_records_t::iterator it = records.begin(); it != records.end();
+         ++it) {
+        EXPECT_NE(m_tids.end(), m_tids.find(it->first));
+        EXPECT_EQ(NUM_LOCAITONS * ITER, it->second.size());
+
+        uint64_t prev_ts = 0;
+        int nesting      = 0;
+        for (size_t i = 0; i < it->second.size(); ++i) {
+            const ucs_profile_record_t *rec = &it->second[i];
+
+            ASSERT_LT(rec->location, locations.size());
+            EXPECT_GE(rec->timestamp, prev_ts);
+            prev_ts = rec->timestamp;
+
+            const ucs_profile_location_t *loc = &locations[rec->location];
+            if (loc->type == UCS_PROFILE_TYPE_SCOPE_BEGIN) {
+                ++nesting;
+            } else if (loc->type == UCS_PROFILE_TYPE_SCOPE_END) {
+                --nesting;
+            }
+
+            test_nesting(loc, nesting, "code", 1);
+            test_nesting(loc, nesting, "sample", 2);
+            test_nesting(loc, nesting, "sum", 1);
+        }
+    }
+}
+
+UCS_TEST_P(test_profile, stream_background) {
+    const int ITER     = 5;
+    size_t exp_records = NUM_LOCAITONS * ITER * num_threads();
+    std::vector<ucs_profile_location_t> locations;
+    stream_records_t records;
+    uint64_t dropped;
+    size_t num_records;
+
+    modify_config("PROFILE_STREAM_INTERVAL", "1ms");
+    scoped_profile p(*this, PROFILE_FILENAME, "stream");
+    run_profiled_code(ITER);
+
+    /* The records should be flushed to the file without an explicit dump */
+    ucs_time_t deadline = ucs_get_time() +
+                          ucs_time_from_sec(10.0 * ucs::test_time_multiplier());
+    do {
+        std::ifstream f(PROFILE_FILENAME);
+        std::string data((std::istreambuf_iterator<char>(f)),
+                         std::istreambuf_iterator<char>());
+
+        locations.clear();
+        records.clear();
+        read_stream(data, locations, records, &dropped);
+
+        num_records = 0;
+        for (stream_records_t::iterator it = records.begin();
+             it != records.end(); ++it) {
+            num_records += it->second.size();
+        }
+    } while ((num_records < exp_records) && (ucs_get_time() < deadline));
+
+    EXPECT_EQ(exp_records, num_records);
+    EXPECT_EQ(NUM_LOCAITONS, locations.size());
+}
+
 INSTANTIATE_TEST_SUITE_P(st, test_profile, ::testing::Values(1));
 INSTANTIATE_TEST_SUITE_P(mt, test_profile, ::testing::Values(2, 4, 8));
 
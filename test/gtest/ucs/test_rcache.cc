@@ -74,7 +74,8 @@ protected:
         uint32_t            id;
     };
 
-    test_rcache() : m_reg_count(0), m_ptr(NULL), m_comp_count(0)
+    test_rcache() :
+        m_reg_count(0), m_ptr(NULL), m_comp_count(0), m_stop(false)
     {
     }
 
@@ -190,6 +191,7 @@ protected:
     ucs::handle<ucs_rcache_t*> m_rcache;
     void * volatile m_ptr;
     size_t m_comp_count;
+    volatile bool m_stop;
 
 private:
 
@@ -678,6 +680,90 @@ UCS_MT_TEST_F(test_rcache, shared_region, 6) {
     shared_free(mem);
 }
 
+/* Lock-free lookups from several threads, while another thread remaps the
+ * memory and invalidates the cached regions */
+UCS_MT_TEST_F(test_rcache, mt_lookup_remap, 6) {
+    static const size_t num_chunks = 16;
+    const size_t chunk_size        = 16 * ucs_get_page_size();
+    const unsigned num_remaps      = 500 / ucs::test_time_multiplier();
+    bool is_writer;
+    uint32_t id;
+    region *r;
+    char *mem;
+
+    if (barrier()) {
+        m_ptr  = alloc_pages(num_chunks * chunk_size, PROT_READ | PROT_WRITE);
+        m_stop = false;
+    }
+    is_writer = barrier();
+    mem       = (char*)m_ptr;
+
+    if (is_writer) {
+        for (unsigned i = 0; i < num_remaps; ++i) {
+            char *chunk = mem + ((i % num_chunks) * chunk_size);
+
+            r  = get(chunk, chunk_size);
+            id = r->id;
+            put(r);
+
+            /* Replacing the mapping generates an unmap event */
+            void *ptr = mmap(chunk, chunk_size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+            EXPECT_EQ((void*)chunk, ptr) << strerror(errno);
+
+            r = get(chunk, chunk_size);
+            EXPECT_NE(id, r->id) << "got a stale region after remap";
+            put(r);
+        }
+
+        m_stop = true;
+    } else {
+        for (unsigned i = 0; !m_stop; ++i) {
+            char *chunk = mem + ((i % num_chunks) * chunk_size);
+            char *ptr   = chunk + UCS_PGT_ADDR_ALIGN;
+            size_t size = chunk_size / 2;
+
+            r = get(ptr, size);
+            EXPECT_LE(r->super.super.start, (uintptr_t)ptr);
+            EXPECT_GE(r->super.super.end, (uintptr_t)ptr + size);
+            put(r);
+        }
+    }
+
+    if (barrier()) {
+        munmap(mem, num_chunks * chunk_size);
+    }
+}
+
+UCS_MT_TEST_F(test_rcache, mt_lookup_perf, 4) {
+    static const size_t size = UCS_MBYTE;
+    const unsigned iters     = RUNNING_ON_VALGRIND ? 1000 :
+                               (2000000 / ucs::test_time_multiplier());
+    ucs_time_t start_time;
+    region *r;
+
+    void *mem = shared_malloc(size);
+
+    /* Register the region once, so all following lookups hit the cache */
+    if (barrier()) {
+        put(get(mem, size));
+    }
+    barrier();
+
+    start_time = ucs_get_time();
+    for (unsigned i = 0; i < iters; ++i) {
+        r = get(mem, size);
+        put(r);
+    }
+
+    UCS_TEST_MESSAGE << "get+put: "
+                     << (ucs_time_to_nsec(ucs_get_time() - start_time) / iters)
+                     << " nsec, " << num_threads() << " threads";
+    barrier();
+
+    shared_free(mem);
+}
+
 class test_rcache_no_register : public test_rcache {
 protected:
     bool m_fail_reg;
@@ -33,6 +33,8 @@ public:
         m_data_stats_class->counter_names[2] = "counter2";
         m_data_stats_class->counter_names[3] = "counter3";
         m_data_stats_class->class_id         = UCS_STATS_CLASS_ID_INVALID;
+        m_data_stats_class->num_histograms   = NUM_HISTOGRAMS;
+        m_data_stats_class->histogram_names  = m_histogram_names;
     }
 
     ~stats_test() {
@@ -78,6 +80,7 @@ public:
             UCS_STATS_UPDATE_COUNTER(data_nodes[i], 1, 20);
             UCS_STATS_UPDATE_COUNTER(data_nodes[i], 2, 30);
             UCS_STATS_UPDATE_COUNTER(data_nodes[i], 3, 40);
+            UCS_STATS_UPDATE_HISTOGRAM(data_nodes[i], 0, histogram_value(i));
         }
 
         /* make sure our original node is ok */
@@ -105,6 +108,7 @@ public:
         EXPECT_EQ((unsigned)0, cat_node->cls->num_counters);
 
         ucs_stats_node_t *data_node;
+        unsigned index = 0;
         ucs_list_for_each(data_node, &cat_node->children[UCS_STATS_ACTIVE_CHILDREN], list) {
             EXPECT_EQ(std::string("data"),     std::string(data_node->cls->name));
             EXPECT_EQ(unsigned(NUM_COUNTERS),  data_node->cls->num_counters);
@@ -114,15 +118,31 @@ public:
             EXPECT_EQ((unsigned)20, data_node->counters[1]);
             EXPECT_EQ((unsigned)30, data_node->counters[2]);
             EXPECT_EQ((unsigned)40, data_node->counters[3]);
+
+            ASSERT_EQ(unsigned(NUM_HISTOGRAMS), data_node->cls->num_histograms);
+            EXPECT_EQ(std::string("histogram0"),
+                      std::string(data_node->cls->histogram_names[0]));
+            EXPECT_EQ(1ul, data_node->histograms[0].count);
+            EXPECT_EQ(histogram_value(index), data_node->histograms[0].sum);
+            EXPECT_EQ(histogram_value(index), data_node->histograms[0].max);
+            ++index;
         }
     }
 
+    static uint64_t histogram_value(unsigned index) {
+        return 1000 * (index + 1);
+    }
+
 protected:
     static const unsigned NUM_COUNTERS   = 4;
+    static const unsigned NUM_HISTOGRAMS = 1;
+    static const char     *m_histogram_names[NUM_HISTOGRAMS];
 
     ucs_stats_class_t *m_data_stats_class;
 };
 
+const char *stats_test::m_histogram_names[] = {"histogram0"};
+
 class stats_udp_test : public stats_test {
 public:
     virtual void init() {
@@ -249,6 +269,12 @@ public:
                 pos = data.find(value, pos);
                 EXPECT_NE(pos, std::string::npos) << value << " not found";
             }
+
+            std::string hist_value = ucs::to_string(histogram_value(i));
+            std::string hist       = "histogram0: count=1 avg=" + hist_value +
+                                     " p50=" + hist_value;
+            pos = data.find(hist, pos);
+            EXPECT_NE(pos, std::string::npos) << hist << " not found";
         }
         close_pipes();
     }
@@ -311,6 +337,40 @@ UCS_TEST_F(stats_udp_test, report) {
     free_nodes(cat_node, data_nodes);
 }
 
+UCS_TEST_F(stats_udp_test, aggregate_histogram) {
+    ucs_stats_node_t       *cat_node;
+    ucs_stats_node_t       *data_nodes[NUM_DATA_NODES] = {NULL};
+    ucs_stats_histogram_t  hist;
+    uint64_t               sum = 0;
+
+    prepare_nodes(&cat_node, data_nodes);
+    wait_for_stats();
+
+    ucs_stats_server_get_stats(m_server);
+    EXPECT_EQ(unsigned(NUM_DATA_NODES),
+              ucs_stats_server_aggregate_histogram(m_server, "data",
+                                                   "histogram0", &hist));
+    EXPECT_EQ(0u, ucs_stats_server_aggregate_histogram(m_server, "data",
+                                                       "histogram1", &hist));
+    EXPECT_EQ(0ul, hist.count);
+
+    ucs_stats_server_aggregate_histogram(m_server, "data", "histogram0", &hist);
+    for (unsigned i = 0; i < NUM_DATA_NODES; ++i) {
+        sum += histogram_value(i);
+    }
+    EXPECT_EQ(uint64_t(NUM_DATA_NODES), hist.count);
+    EXPECT_EQ(sum, hist.sum);
+    EXPECT_EQ(histogram_value(NUM_DATA_NODES - 1), hist.max);
+
+    uint64_t median = histogram_value(NUM_DATA_NODES / 2 - 1);
+    uint64_t p50    = ucs_stats_histogram_percentile(&hist, 50);
+    EXPECT_GE(p50, median);
+    EXPECT_LE(p50, median + (median >> UCS_STATS_HISTOGRAM_SUB_BITS));
+
+    ucs_stats_server_purge_stats(m_server);
+    free_nodes(cat_node, data_nodes);
+}
+
 UCS_TEST_F(stats_file_test, report) {
     ucs_stats_node_t       *cat_node;
     ucs_stats_node_t       *data_nodes[NUM_DATA_NODES] = {NULL};
@@ -371,6 +431,58 @@ UCS_MT_TEST_F(stats_file_test, mt_add_remove, 10) {
     }
 }
 
+class stats_histogram_test : public ucs::test {
+};
+
+UCS_TEST_F(stats_histogram_test, percentile) {
+    const uint64_t max_value = 100000;
+    const double percents[]  = {1, 10, 50, 90, 99, 99.9};
+    ucs_stats_histogram_t hist;
+    uint64_t value, expected;
+
+    memset(&hist, 0, sizeof(hist));
+    EXPECT_EQ(0ul, ucs_stats_histogram_percentile(&hist, 50));
+
+    for (value = 1; value <= max_value; ++value) {
+        ucs_stats_histogram_add(&hist, value);
+    }
+
+    EXPECT_EQ(max_value, hist.count);
+    EXPECT_EQ(max_value * (max_value + 1) / 2, hist.sum);
+    EXPECT_EQ(max_value, hist.max);
+    EXPECT_EQ(max_value, ucs_stats_histogram_percentile(&hist, 100));
+
+    /* The estimate is an upper bound, within the width of a bucket */
+    for (unsigned i = 0; i < ucs_static_array_size(percents); ++i) {
+        expected = max_value * percents[i] / 100;
+        value    = ucs_stats_histogram_percentile(&hist, percents[i]);
+        EXPECT_GE(value, expected) << percents[i];
+        EXPECT_LE(value, expected + (expected >> UCS_STATS_HISTOGRAM_SUB_BITS))
+                << percents[i];
+    }
+}
+
+UCS_TEST_F(stats_histogram_test, buckets) {
+    unsigned prev = 0;
+    unsigned bucket;
+
+    /* Small values have a bucket each */
+    for (uint64_t value = 0; value < UCS_BIT(UCS_STATS_HISTOGRAM_SUB_BITS);
+         ++value) {
+        EXPECT_EQ(value, ucs_stats_histogram_bucket(value));
+    }
+
+    for (unsigned exp = 0; exp < 64; ++exp) {
+        bucket = ucs_stats_histogram_bucket(UCS_BIT(exp));
+        EXPECT_GE(bucket, prev);
+        EXPECT_LT(bucket, unsigned(UCS_STATS_HISTOGRAM_NUM_BUCKETS));
+        prev = bucket;
+    }
+
+    EXPECT_EQ(unsigned(UCS_STATS_HISTOGRAM_NUM_BUCKETS - 1),
+              ucs_stats_histogram_bucket(UINT64_MAX));
+}
+
 UCS_TEST_F(stats_aggregate_sum_test, report) {
     ucs_stats_node_t *cat_node;
     ucs_stats_node_t *data_nodes[NUM_DATA_NODES] = {NULL};
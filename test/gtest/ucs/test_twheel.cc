@@ -257,3 +257,120 @@ UCS_TEST_F(twheel, delayed_sweep) {
     GTEST_FAIL() << "Timers were not triggered after timeout";
 }
 
+
+UCS_TEST_F(twheel, levels) {
+    static const int n_timers = 1000;
+    std::vector<struct hr_timer> t(n_timers);
+    ucs_time_t start = m_wheel.now;
+    ucs_time_t now;
+
+    /* Spread the timers over all levels of the wheel */
+    init_timerv(&t[0], n_timers);
+    for (int i = 0; i < n_timers; i++) {
+        t[i].d = m_wheel.res *
+                 (1 + (ucs::rand() % (UCS_BIT(UCS_TWHEEL_LEVEL_BITS *
+                                             UCS_TWHEEL_NUM_LEVELS) - 2)));
+        t[i].end_time = 0;
+        ASSERT_EQ(UCS_OK, ucs_wtimer_add(&m_wheel, &t[i].timer, t[i].d));
+        t[i].start_time = start;
+    }
+
+    /* Advance the time by one tick at a time around the expiration of every
+     * timer, and by large steps otherwise */
+    now = start;
+    while (!ucs_twheel_is_empty(&m_wheel)) {
+        ucs_time_t next = UCS_TIME_INFINITY;
+        for (int i = 0; i < n_timers; i++) {
+            if (t[i].end_time == 0) {
+                next = ucs_min(next, start + t[i].d - m_wheel.res);
+            }
+        }
+
+        now = ucs_max(now + m_wheel.res, next);
+        ucs_twheel_sweep(&m_wheel, now);
+    }
+
+    for (int i = 0; i < n_timers; i++) {
+        ASSERT_NE((ucs_time_t)0, t[i].end_time) << "timer " << i;
+        EXPECT_GE(t[i].end_time - t[i].start_time, t[i].d - m_wheel.res)
+                << "timer " << i;
+        EXPECT_LE(t[i].end_time - t[i].start_time, t[i].d + 2 * m_wheel.res)
+                << "timer " << i;
+    }
+}
+
+UCS_TEST_F(twheel, sweep_limit) {
+    static const int n_timers = 100;
+    static const unsigned max_timers = 30;
+    std::vector<struct hr_timer> t(n_timers);
+    ucs_time_t now;
+    unsigned count;
+
+    init_timerv(&t[0], n_timers);
+    for (int i = 0; i < n_timers; i++) {
+        set_timer_delta(&t[i], 0);
+        add_timer(&t[i]);
+    }
+
+    /* Remove some expired timers before they are dispatched */
+    now   = m_wheel.now + (m_wheel.res * m_wheel.num_slots);
+    count = ucs_twheel_sweep_limit(&m_wheel, now, max_timers);
+    EXPECT_EQ(max_timers, count);
+    for (int i = 0; i < n_timers; i += 10) {
+        ucs_wtimer_remove(&m_wheel, &t[i].timer);
+    }
+
+    /* The rest are dispatched without advancing the time */
+    while (!ucs_twheel_is_empty(&m_wheel)) {
+        count = ucs_twheel_sweep_limit(&m_wheel, now, max_timers);
+        EXPECT_GT(count, 0u);
+        EXPECT_LE(count, max_timers);
+    }
+
+    for (int i = 0; i < n_timers; i++) {
+        EXPECT_EQ((i >= (int)max_timers) && ((i % 10) == 0),
+                  t[i].end_time == 0) << "timer " << i;
+    }
+}
+
+UCS_TEST_SKIP_COND_F(twheel, bench, RUNNING_ON_VALGRIND) {
+    static const int max_ticks = UCS_BIT(20);
+    std::vector<struct hr_timer> t;
+    ucs_time_t start, now;
+
+    for (int n_timers = 1000; n_timers <= 100000 * ucs::test_time_multiplier();
+         n_timers *= 10) {
+        t.resize(n_timers);
+        init_timerv(&t[0], n_timers);
+        for (int i = 0; i < n_timers; i++) {
+            t[i].d = m_wheel.res * (1 + (ucs::rand() % max_ticks));
+        }
+
+        start = ucs_get_time();
+        for (int i = 0; i < n_timers; i++) {
+            ucs_wtimer_add(&m_wheel, &t[i].timer, t[i].d);
+        }
+        double add_nsec = ucs_time_to_nsec(ucs_get_time() - start) / n_timers;
+
+        start = ucs_get_time();
+        for (int i = 0; i < n_timers; i += 2) {
+            ucs_wtimer_remove(&m_wheel, &t[i].timer);
+        }
+        double remove_nsec = ucs_time_to_nsec(ucs_get_time() - start) /
+                             (n_timers / 2);
+
+        /* Sweep with a simulated time, 64 ticks at a time */
+        now   = m_wheel.now;
+        start = ucs_get_time();
+        while (!ucs_twheel_is_empty(&m_wheel)) {
+            now += m_wheel.res * 64;
+            ucs_twheel_sweep(&m_wheel, now);
+        }
+        double sweep_nsec = ucs_time_to_nsec(ucs_get_time() - start) /
+                            (n_timers / 2);
+
+        UCS_TEST_MESSAGE << n_timers << " timers: add " << add_nsec
+                         << " ns, remove " << remove_nsec
+                         << " ns, expire " << sweep_nsec << " ns";
+    }
+}
@@ -288,3 +288,174 @@ UCS_TEST_P(test_uct_tcp, check_addr_len)
 
 
 _UCT_INSTANTIATE_TEST_CASE(test_uct_tcp, tcp)
+
+
+class test_uct_tcp_zerocopy : public uct_test {
+public:
+    static const uint8_t AM_ID = 1;
+
+    test_uct_tcp_zerocopy() : m_sender(NULL), m_receiver(NULL), m_am_count(0)
+    {
+    }
+
+    void init() {
+        modify_config("TCP_ZEROCOPY_THRESH", "1k");
+        uct_test::init();
+
+        m_receiver = create_entity(0);
+        m_entities.push_back(m_receiver);
+        m_sender = create_entity(0);
+        m_entities.push_back(m_sender);
+        m_sender->connect(0, *m_receiver, 0);
+
+        ASSERT_UCS_OK(uct_iface_set_am_handler(m_receiver->iface(), AM_ID,
+                                               am_handler, this, 0));
+    }
+
+    static ucs_status_t
+    am_handler(void *arg, void *data, size_t length, unsigned flags) {
+        test_uct_tcp_zerocopy *self = static_cast<test_uct_tcp_zerocopy*>(arg);
+
+        mem_buffer::pattern_check(data, length, self->m_am_count);
+        ++self->m_am_count;
+        return UCS_OK;
+    }
+
+    static void completion_cb(uct_completion_t *comp) {
+        EXPECT_UCS_OK(comp->status);
+    }
+
+protected:
+    entity   *m_sender;
+    entity   *m_receiver;
+    unsigned m_am_count;
+};
+
+UCS_TEST_P(test_uct_tcp_zerocopy, am_zcopy)
+{
+    const unsigned num_sends = 100 / ucs::test_time_multiplier();
+    const size_t length      = ucs_min(64 * UCS_KBYTE,
+                                       m_sender->iface_attr().cap.am.max_zcopy);
+    uct_tcp_ep_t *ep         = (uct_tcp_ep_t*)m_sender->ep(0);
+    uct_tcp_iface_t *iface   = (uct_tcp_iface_t*)m_sender->iface();
+    uct_completion_t comp;
+    ucs_status_t status;
+
+    mapped_buffer buffer(length, 0, *m_sender);
+    UCS_TEST_GET_BUFFER_IOV(iov, iovcnt, buffer.ptr(), buffer.length(),
+                            buffer.memh(), 1);
+
+    for (unsigned i = 0; i < num_sends; ++i) {
+        buffer.pattern_fill(i);
+
+        comp.func   = completion_cb;
+        comp.count  = 1;
+        comp.status = UCS_OK;
+        do {
+            status = uct_ep_am_zcopy(m_sender->ep(0), AM_ID, NULL, 0, iov,
+                                     iovcnt, 0, &comp);
+            progress();
+        } while (status == UCS_ERR_NO_RESOURCE);
+        ASSERT_UCS_OK_OR_INPROGRESS(status);
+
+        if (status == UCS_OK) {
+            --comp.count;
+        }
+
+        /* the buffer can't be modified until the kernel releases it */
+        wait_for_value(&comp.count, 0, true);
+        ASSERT_EQ(0, comp.count);
+    }
+
+    wait_for_value(&m_am_count, num_sends, true);
+    EXPECT_EQ(num_sends, m_am_count);
+
+    flush();
+    EXPECT_TRUE(ucs_queue_is_empty(&ep->zerocopy.comp_q));
+    EXPECT_EQ(ep->zerocopy.sn, ep->zerocopy.acked);
+    if (iface->config.zerocopy_thresh == UCS_MEMUNITS_INF) {
+        UCS_TEST_MESSAGE << "MSG_ZEROCOPY is not supported";
+    } else {
+        EXPECT_GT(ep->zerocopy.sn, 0u);
+    }
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_tcp_zerocopy, tcp)
+
+class test_uct_tcp_rx_batch : public uct_test {
+public:
+    static const uint8_t  AM_ID       = 1;
+    static const unsigned NUM_SENDERS = 8;
+
+    test_uct_tcp_rx_batch() : m_receiver(NULL), m_am_count(0)
+    {
+    }
+
+    void init() {
+        modify_config("TCP_RX_BATCH", "y");
+        uct_test::init();
+
+        m_receiver = create_entity(0);
+        m_entities.push_back(m_receiver);
+
+        for (unsigned i = 0; i < NUM_SENDERS; ++i) {
+            entity *sender = create_entity(0);
+            m_entities.push_back(sender);
+            m_senders.push_back(sender);
+            sender->connect(0, *m_receiver, i);
+        }
+
+        m_next_sn.resize(NUM_SENDERS, 0);
+        ASSERT_UCS_OK(uct_iface_set_am_handler(m_receiver->iface(), AM_ID,
+                                               am_handler, this, 0));
+    }
+
+    static ucs_status_t
+    am_handler(void *arg, void *data, size_t length, unsigned flags) {
+        test_uct_tcp_rx_batch *self = static_cast<test_uct_tcp_rx_batch*>(arg);
+        uint64_t hdr                = *static_cast<uint64_t*>(data);
+        unsigned sender             = hdr >> 32;
+
+        /* messages from every sender must be dispatched in order */
+        EXPECT_LT(sender, (unsigned)NUM_SENDERS);
+        EXPECT_EQ(self->m_next_sn[sender], hdr & UCS_MASK(32));
+        ++self->m_next_sn[sender];
+        ++self->m_am_count;
+        return UCS_OK;
+    }
+
+protected:
+    entity                *m_receiver;
+    std::vector<entity*>  m_senders;
+    std::vector<uint32_t> m_next_sn;
+    unsigned              m_am_count;
+};
+
+UCS_TEST_P(test_uct_tcp_rx_batch, many_senders)
+{
+    const unsigned num_sends = 1000 / ucs::test_time_multiplier();
+    uct_tcp_iface_t *iface   = (uct_tcp_iface_t*)m_receiver->iface();
+    std::vector<char> payload(64, 'x');
+    ucs_status_t status;
+    uint64_t hdr;
+
+    for (unsigned sn = 0; sn < num_sends; ++sn) {
+        for (unsigned i = 0; i < NUM_SENDERS; ++i) {
+            hdr = ((uint64_t)i << 32) | sn;
+            do {
+                status = uct_ep_am_short(m_senders[i]->ep(0), AM_ID, hdr,
+                                         &payload[0], payload.size());
+                progress();
+            } while (status == UCS_ERR_NO_RESOURCE);
+            ASSERT_UCS_OK(status);
+        }
+    }
+
+    wait_for_value(&m_am_count, num_sends * NUM_SENDERS, true);
+    EXPECT_EQ(num_sends * NUM_SENDERS, m_am_count);
+    EXPECT_EQ(0u, iface->rx_batch.count);
+
+    flush();
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_tcp_rx_batch, tcp)
@@ -98,6 +98,8 @@ public:
         }
     }
 
+    void test_am_bcopy();
+
     static const size_t NUM_SENDERS = 10;
 
 protected:
@@ -107,9 +109,7 @@ protected:
 };
 
 
-UCS_TEST_SKIP_COND_P(test_many2one_am, am_bcopy,
-                     !check_caps(UCT_IFACE_FLAG_AM_BCOPY |
-                                 UCT_IFACE_FLAG_CB_SYNC))
+void test_many2one_am::test_am_bcopy()
 {
     const unsigned num_sends = 1000 / ucs::test_time_multiplier();
     ucs_status_t status;
@@ -170,4 +170,30 @@ UCS_TEST_SKIP_COND_P(test_many2one_am, am_bcopy,
     buffers.clear();
 }
 
+UCS_TEST_SKIP_COND_P(test_many2one_am, am_bcopy,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC))
+{
+    test_am_bcopy();
+}
+
 UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_many2one_am)
+
+
+class test_many2one_am_fifo_batch : public test_many2one_am {
+public:
+    void init() {
+        modify_config("MM_FIFO_MODE", "batch", SETENV_IF_NOT_EXIST);
+        modify_config("MM_FIFO_BATCH", "4", SETENV_IF_NOT_EXIST);
+        test_many2one_am::init();
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_many2one_am_fifo_batch, am_bcopy,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC))
+{
+    test_am_bcopy();
+}
+
+UCT_INSTANTIATE_MM_TEST_CASE(test_many2one_am_fifo_batch)
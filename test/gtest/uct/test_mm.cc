@@ -218,6 +218,49 @@ UCS_TEST_SKIP_COND_P(test_uct_mm, open_for_posix,
     free(recv_buffer);
 }
 
+UCS_TEST_SKIP_COND_P(test_uct_mm, poll_backoff,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_CB_SYNC),
+                     "MM_POLL_BACKOFF_MAX=32")
+{
+    const unsigned backoff_max = 32;
+    uint64_t send_data         = 0xdeadbeef;
+    uint64_t test_mm_hdr       = 0xbeef;
+    recv_desc_t *recv_buffer;
+    unsigned num_progress;
+    ucs_status_t status;
+
+    recv_buffer = (recv_desc_t *)malloc(sizeof(*recv_buffer) +
+                                        sizeof(uint64_t));
+    uct_iface_set_am_handler(m_e2->iface(), 0, mm_am_handler, recv_buffer, 0);
+
+    for (int i = 0; i < 5; ++i) {
+        recv_buffer->length = 0;
+
+        /* let the receiver reach the maximal polling interval */
+        for (unsigned j = 0; j < 100 * backoff_max; ++j) {
+            m_e2->progress();
+        }
+
+        status = uct_ep_am_short(m_e1->ep(0), 0, test_mm_hdr, &send_data,
+                                 sizeof(send_data));
+        ASSERT_UCS_OK(status);
+
+        /* the message must be noticed within one polling interval */
+        num_progress = 0;
+        while (recv_buffer->length == 0) {
+            ASSERT_LE(num_progress, backoff_max);
+            m_e2->progress();
+            ++num_progress;
+        }
+
+        ASSERT_EQ(sizeof(send_data), recv_buffer->length);
+        EXPECT_EQ(send_data, *(uint64_t*)(recv_buffer + 1));
+    }
+
+    free(recv_buffer);
+}
+
 UCS_TEST_SKIP_COND_P(test_uct_mm, alloc,
                      !check_md_caps(UCT_MD_FLAG_ALLOC)) {
 